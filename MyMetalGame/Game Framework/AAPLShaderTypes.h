@@ -11,6 +11,13 @@ struct AAPLVertex
     packed_float4   color;
 };
 
+// VertexFormatCompact で使用する頂点（位置は半精度浮動小数点数、色はRGBA8）
+struct AAPLVertexCompact
+{
+    uint16_t        position[2];
+    uint32_t        color;
+};
+
 struct AAPLVertexFull
 {
     simd::float3    position;
@@ -0,0 +1,25 @@
+//
+//  BatchMode.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef BatchMode_hpp
+#define BatchMode_hpp
+
+
+/// 描画コマンドの処理方法を表す列挙型
+enum BatchMode
+{
+    /// 描画関数を呼び出した順番にそのまま描画します。ブレンドモードを変更するたびにバッチが吐き出されます。
+    BatchModeImmediate,
+
+    /// 描画コマンドをフレームの終わりまで溜めておき、描画状態ごとに並べ替えてからまとめて描画します。
+    /// 同じレイヤ内で描画順序が結果に影響する場合は、呼び出し順序が維持されます。
+    BatchModeDeferred,
+};
+
+
+#endif /* BatchMode_hpp */
@@ -0,0 +1,1908 @@
+//
+//  BatchRenderer.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "RenderBackend.hpp"
+#include "SimpleDraw.hpp"
+#include "Input.hpp"
+#include "Time.hpp"
+#include "Settings.hpp"
+#include "BlendMode.hpp"
+#include "BatchMode.hpp"
+#include "DrawCommandList.hpp"
+#include "InstanceShapes.hpp"
+#include "VertexFormat.hpp"
+#include "Mathf.hpp"
+#include "DrawStats.hpp"
+#include "Sprite.hpp"
+#include "TextureAtlas.hpp"
+#include "TransformStack.hpp"
+#include "Camera2D.hpp"
+#include "RenderTargetPool.hpp"
+#include "Rect.hpp"
+#include "StaticMesh2D.hpp"
+#include "FrameTimeStats.hpp"
+#include "SimulationThread.hpp"
+#include "Coroutine.hpp"
+#include "TimerService.hpp"
+#include "Tween.hpp"
+#include "InputRecording.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "DebugSupport.hpp"
+
+#ifdef __APPLE__
+#include <os/log.h>
+#else
+#include <cstdio>
+#endif
+
+
+static size_t       sPassCount;
+static BlendMode    sBlendMode;
+static VertexFormat sVertexFormat;
+static size_t       sBatchedPolygonCount;
+static size_t       sBatchedVertexCount;
+static unsigned     sBatchTextureID;
+static char         *sVertexBuffer;
+static size_t       sVertexBufferSize;
+static size_t       sVertexBufferOffset;
+static char         *sVertexBufferPointer;
+static char         *sVertexBufferPointerStart;
+static char         *sVertexBufferPointerEdge;
+static uint16_t     *sIndexBuffer;
+static size_t       sIndexBufferSize;
+static size_t       sIndexBufferOffset;         // 要素数ではなくバイト数
+static uint16_t     *sIndexBufferPointer;
+static uint16_t     *sIndexBufferPointerEdge;
+
+static BatchMode                sBatchMode = BatchModeImmediate;
+static int                      sLayer;
+static float                    sDepth;
+
+/// 遅延描画モードで記録した描画内容です。パイプライン化した更新では、シミュレーションのスレッドが一方に記録している間に、
+/// メインスレッドがもう一方の（前のフレームで記録された）内容をエンコードします。
+struct DeferredFrame
+{
+    DrawCommandList             commandList;
+    std::vector<BatchVertex>    vertices;
+    std::vector<SpriteVertex>   spriteVertices;
+
+    // 以下はフレーム単位の情報で、パイプライン化した更新でエンコードするときに使う
+    bool        hasClearColor;
+    Color       clearColor;
+    bool        hasCamera;
+    Camera2D    camera;
+    std::vector<FrameCaptureRequest>    frameCaptures;
+    uint32_t    culledTriangleCount;
+    double      updateTime;
+    double      frameTime;
+    int         frameCount;
+
+    /// 記録済みの描画コマンドと頂点だけを破棄する
+    void ClearCommands()
+    {
+        commandList.Reset();
+        vertices.clear();
+        spriteVertices.clear();
+    }
+
+    /// フレームの始めの状態に戻す
+    void Reset()
+    {
+        ClearCommands();
+        hasClearColor = false;
+        hasCamera = false;
+        frameCaptures.clear();
+        culledTriangleCount = 0;
+        updateTime = 0.0;
+        frameTime = 0.0;
+        frameCount = 0;
+    }
+};
+
+static DeferredFrame    sDeferredFrames[2];
+static DeferredFrame    *sRecordingFrame = &sDeferredFrames[0];     // 描画関数が記録する先
+
+static const int    kAtlasPageSize = 2048;
+static const int    kAtlasPadding = 2;
+
+static TextureAtlasPacker               sAtlasPacker(kAtlasPageSize, kAtlasPageSize, kAtlasPadding);
+static std::atomic<unsigned>            sAtlasPageCount(0);     // パイプライン化した更新では、ページの追加とエンコードが別のスレッドで行われる
+
+static const int        kMaxRenderTargetCount = DrawCommandList::kMaxTextureID - kRenderTargetTextureIDBase + 1;
+
+static RenderTargetPool                 sRenderTargetPool(4 + 8);   // BGRA8のカラーと、Depth32Float_Stencil8の深度・ステンシル
+static int                              sCurrentRenderTarget = -1;
+
+/// 転送済みの静的メッシュの大きさ（記録し直して大きさが変わったら、全体を転送し直す）
+struct StaticMeshUploadSize
+{
+    uint32_t    vertexCount;
+    uint32_t    indexCount;
+};
+
+static std::vector<StaticMesh2D *>          sStaticMeshes;
+static std::vector<StaticMeshUploadSize>    sStaticMeshUploadSizes;
+static int                                  sRecordingStaticMesh = -1;
+
+static_assert(sizeof(StaticMeshVertex) == sizeof(BatchVertex), "StaticMeshVertex must have the same layout as AAPLVertex");
+
+static TransformStack   sTransformStack;
+static bool             sIsIdentityTransform = true;
+static BatchFloat2      sTransformAxisX;        // 現在の変換の1行目（m00, m01）
+static BatchFloat2      sTransformAxisY;        // 現在の変換の2行目（m10, m11）
+static BatchFloat2      sTransformOrigin;       // 現在の変換の平行移動（tx, ty）
+
+static std::vector<Game::Rect>  sClipRectStack;    // 変換を適用したあとの座標での、親と交差させたクリップ矩形
+static bool             sHasClipRect = false;
+static bool             sIsClipRectEmpty = false;
+
+static int              sUniforms2DCount;
+static Camera2D         sCamera;
+static bool             sHasCamera = false;
+
+static DrawStats        sDrawStats;
+static DrawStats        sLastDrawStats;
+static DrawStatsHistory sDrawStatsHistory;
+static bool             sIsDrawStatsOverlayEnabled = false;
+static int              sEncodeTimerDepth = 0;
+static double           sEncodeStartTime;
+
+static std::atomic<bool>    sIsPipelinedUpdateRequested(false);     // シミュレーションのスレッドから設定され、メインスレッドで読まれる
+static BatchMode        sBatchModeBeforePipeline = BatchModeImmediate;
+static bool             sIsPipelineActive = false;          // 描画関数がシミュレーションのスレッドで呼ばれている間はtrue
+static bool             sIsSimulationInFlight = false;
+static bool             sHasCompletedFrameStats = false;    // メインスレッドがエンコードを終えた、まだシミュレーション側に渡していない統計
+static DrawStats        sCompletedFrameStats;
+static double           sCompletedFrameTime;
+static bool             sHasSimulationFrameStats = false;   // シミュレーションのスレッドが次のフレームの始めに反映する統計
+static DrawStats        sSimulationFrameStats;
+static double           sSimulationFrameTime;
+
+static const size_t kMaxBatchVertexCount = 0x10000;   // 16ビットのインデックスで参照できる頂点数
+static const int    kMaxCameraChangeCount = 16;     // 1フレームの中でカメラを切り替えられる回数
+
+
+void Start();
+void Update();
+
+/// ゲーム側でFixedUpdate()を定義しなかった場合に使われる、何もしないデフォルトの実装
+__attribute__((weak)) void FixedUpdate()
+{
+    // Do nothing
+}
+
+void FlushVertexRendering();
+void FlushDeferredRendering();
+
+
+static double GetStatsTime()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// スコープの間をエンコードの時間として計測する（入れ子になった場合は一番外側だけを計測する）
+struct EncodeTimer
+{
+    EncodeTimer()
+    {
+        if (sEncodeTimerDepth++ == 0) {
+            sEncodeStartTime = GetStatsTime();
+        }
+    }
+
+    ~EncodeTimer()
+    {
+        if (--sEncodeTimerDepth == 0) {
+            sDrawStats.encodeTime += GetStatsTime() - sEncodeStartTime;
+        }
+    }
+};
+
+static void CountDrawCall(BlendMode blendMode, uint32_t vertexCount, uint32_t triangleCount)
+{
+    sDrawStats.drawCallCount++;
+    sDrawStats.vertexCount += vertexCount;
+    sDrawStats.triangleCount += triangleCount;
+    sDrawStats.blendModeTriangleCounts[(blendMode <= BlendModeXOR)? blendMode: BlendModeNone] += triangleCount;
+}
+
+const DrawStats& GetLastDrawStats()
+{
+    return sLastDrawStats;
+}
+
+const DrawStatsHistory& GetDrawStatsHistory()
+{
+    return sDrawStatsHistory;
+}
+
+void SetDrawStatsOverlayEnabled(bool isEnabled)
+{
+    sIsDrawStatsOverlayEnabled = isEnabled;
+}
+
+bool IsDrawStatsOverlayEnabled()
+{
+    return sIsDrawStatsOverlayEnabled;
+}
+
+static void UpdateTransformCache()
+{
+    const Transform2D& transform = sTransformStack.Current();
+    sIsIdentityTransform = sTransformStack.IsIdentity();
+    sTransformAxisX = BatchFloat2 { transform.m00, transform.m01 };
+    sTransformAxisY = BatchFloat2 { transform.m10, transform.m11 };
+    sTransformOrigin = BatchFloat2 { transform.tx, transform.ty };
+}
+
+/// カメラの射影を、このフレームのユニフォームバッファの次の領域に書き込む
+static void WriteUniforms2D(bool hasCamera, const Camera2D& camera)
+{
+    if (sUniforms2DCount >= kMaxCameraChangeCount) {
+        AbortGame("1フレームの中でカメラを切り替えられる回数（%d回）を超えました。", kMaxCameraChangeCount);
+    }
+    if (hasCamera) {
+        __BackendWriteUniforms2D(sUniforms2DCount, camera.GetViewProjectionMatrix());
+    } else {
+        __BackendWriteUniforms2D(sUniforms2DCount, Matrix4x4::identity);
+    }
+    sUniforms2DCount++;
+}
+
+/// テクスチャIDが、作成済みのアトラスのページか使用中のレンダーターゲットを指しているかどうかを判定する
+static bool IsValidTextureID(unsigned textureID)
+{
+    if (textureID >= kRenderTargetTextureIDBase) {
+        return sRenderTargetPool.IsInUse((int)(textureID - kRenderTargetTextureIDBase));
+    }
+    return (textureID != 0 && textureID <= sAtlasPageCount.load(std::memory_order_acquire));
+}
+
+/// エンコードに使う状態をフレームの始めに戻す（パイプライン化した更新ではメインスレッドで呼ばれる）
+static void InitEncodingState()
+{
+    sBatchedPolygonCount = 0;
+    sBatchedVertexCount = 0;
+    sBatchTextureID = 0;
+    sVertexBufferOffset = 0;
+    sVertexBufferPointer = sVertexBuffer;
+    sVertexBufferPointerStart = sVertexBufferPointer;
+    sVertexBufferPointerEdge = sVertexBufferPointer + sVertexBufferSize;
+    sIndexBufferOffset = 0;
+    sIndexBufferPointer = sIndexBuffer;
+    sIndexBufferPointerEdge = (uint16_t *)((char *)sIndexBuffer + sIndexBufferSize);
+    sPassCount = 0;
+    sUniforms2DCount = 0;
+
+    sDrawStats.Reset();
+    sDrawStats.vertexBufferCapacity = sVertexBufferSize;
+}
+
+/// 描画関数が使う状態をフレームの始めに戻す（パイプライン化した更新ではシミュレーションのスレッドで呼ばれる）
+static void InitRecordingState()
+{
+    sBlendMode = BlendModeAlpha;
+    sVertexFormat = VertexFormatStandard;
+    sLayer = 0;
+    sDepth = 0.0f;
+    sRecordingFrame->Reset();
+
+    sTransformStack.Reset();
+    UpdateTransformCache();
+    sClipRectStack.clear();
+    sHasClipRect = false;
+    sIsClipRectEmpty = false;
+
+    // パイプライン化した更新では、カメラの射影はエンコードするときにメインスレッドで書き込む
+    if (!sIsPipelineActive) {
+        WriteUniforms2D(sHasCamera, sCamera);
+    }
+}
+
+static void InitRenderingState()
+{
+    InitEncodingState();
+    InitRecordingState();
+    sDrawStats.frameCount = Time::frameCount;
+}
+
+void __InitBatchRenderer(char *vertexBuffer, size_t vertexBufferSize, uint16_t *indexBuffer, size_t indexBufferSize)
+{
+    sVertexBuffer = vertexBuffer;
+    sVertexBufferSize = vertexBufferSize;
+    sIndexBuffer = indexBuffer;
+    sIndexBufferSize = indexBufferSize;
+    InitEncodingState();
+    InitRecordingState();
+}
+
+/// パイプライン化した更新の間は使えない関数が呼ばれたら、ゲームを終了する
+static void CheckNotPipelined(const char *functionName)
+{
+    if (sIsPipelineActive) {
+        AbortGame("%s()は、パイプライン化した更新（SetPipelinedUpdateEnabled(true)）の間は使用できません。", functionName);
+    }
+}
+
+/// 描画先をクリアするだけのパスをエンコードする
+static void EncodeClear(const Color& color)
+{
+    if (__BackendEncodeClear(color)) {
+        sPassCount++;
+        sDrawStats.passCount++;
+    }
+}
+
+void Clear(const Color& color)
+{
+    // パイプライン化した更新では、クリアする色を記録しておき、エンコードするときに最初のパスとしてクリアする
+    if (sIsPipelineActive) {
+        sRecordingFrame->ClearCommands();
+        sRecordingFrame->hasClearColor = true;
+        sRecordingFrame->clearColor = color;
+        return;
+    }
+
+    EncodeTimer encodeTimer;
+
+    // 未処理の頂点バッファが溜まっていれば破棄する
+    if (sBatchedPolygonCount > 0) {
+        sBatchedPolygonCount = 0;
+        sBatchedVertexCount = 0;
+        sVertexBufferPointer = sVertexBufferPointerStart;
+        sIndexBufferPointer = (uint16_t *)((char *)sIndexBuffer + sIndexBufferOffset);
+    }
+    sRecordingFrame->ClearCommands();
+
+    EncodeClear(color);
+}
+
+void SetBlendMode(BlendMode blendMode)
+{
+    // 遅延描画モードではブレンドモードはソートキーに記録されるだけなので、ここでは吐き出さない
+    if (sBatchMode == BatchModeDeferred) {
+        sBlendMode = blendMode;
+        return;
+    }
+
+    // 頂点バッファが溜まっていれば吐き出す
+    if (sBatchedPolygonCount > 0) {
+        FlushVertexRendering();
+    }
+    sBlendMode = blendMode;
+}
+
+void PrewarmBlendModes(const std::vector<BlendMode>& blendModes)
+{
+    CheckNotPipelined("PrewarmBlendModes");
+    __BackendPrewarmPipelines(blendModes);
+}
+
+void SetLayer(int layer)
+{
+    // レイヤと深度はソートキーに記録されるだけなので、即時描画モードでも吐き出す必要はない
+    sLayer = layer;
+}
+
+int GetLayer()
+{
+    return sLayer;
+}
+
+void SetDepth(float depth)
+{
+    sDepth = depth;
+}
+
+float GetDepth()
+{
+    return sDepth;
+}
+
+void SetBatchMode(BatchMode batchMode)
+{
+    if (batchMode == sBatchMode) {
+        return;
+    }
+    if (sIsPipelineActive) {
+        AbortGame("パイプライン化した更新（SetPipelinedUpdateEnabled(true)）の間は、BatchModeDeferredから切り替えられません。");
+    }
+
+    // モードを切り替える前に、それまでの描画内容を呼び出し順のまま吐き出しておく
+    if (sBatchedPolygonCount > 0) {
+        FlushVertexRendering();
+    }
+    if (sRecordingFrame->commandList.Count() > 0) {
+        FlushDeferredRendering();
+    }
+    sBatchMode = batchMode;
+}
+
+void SetVertexFormat(VertexFormat vertexFormat)
+{
+    // 遅延描画モードでは頂点フォーマットはソートキーに記録され、吐き出すときに変換される
+    if (sBatchMode == BatchModeDeferred) {
+        sVertexFormat = vertexFormat;
+        return;
+    }
+
+    // フォーマットが変わるとパイプラインも変わるので、溜まっている頂点を吐き出す
+    if (sBatchedPolygonCount > 0 && vertexFormat != sVertexFormat) {
+        FlushVertexRendering();
+    }
+    sVertexFormat = vertexFormat;
+}
+
+void PushMatrix()
+{
+    sTransformStack.Push();
+}
+
+void PopMatrix()
+{
+    if (!sTransformStack.Pop()) {
+        AbortGame("PushMatrix()と対応していないPopMatrix()が呼び出されました。");
+    }
+    UpdateTransformCache();
+}
+
+void ResetMatrix()
+{
+    sTransformStack.Load(Transform2D::Identity());
+    UpdateTransformCache();
+}
+
+void Translate(float x, float y)
+{
+    sTransformStack.Translate(x, y);
+    UpdateTransformCache();
+}
+
+void Translate(const Vector2& pos)
+{
+    Translate(pos.x, pos.y);
+}
+
+void Rotate(float rad)
+{
+    sTransformStack.Rotate(rad);
+    UpdateTransformCache();
+}
+
+void Scale(float scale)
+{
+    Scale(scale, scale);
+}
+
+void Scale(float x, float y)
+{
+    sTransformStack.Scale(x, y);
+    UpdateTransformCache();
+}
+
+void MultiplyMatrix(const Matrix4x4& matrix)
+{
+    sTransformStack.Multiply(Transform2D::FromMatrix(matrix));
+    UpdateTransformCache();
+}
+
+Matrix4x4 GetMatrix()
+{
+    return sTransformStack.Current().ToMatrix();
+}
+
+/// カメラの射影はパスの途中で変えられないので、それまでの描画内容を吐き出してから新しい領域に書き込む
+static void ChangeCamera()
+{
+    // パイプライン化した更新では、フレーム全体で1つのカメラを使うので、描画を記録する前に設定しておく必要がある
+    if (sIsPipelineActive) {
+        if (sRecordingFrame->commandList.Count() > 0) {
+            AbortGame("パイプライン化した更新（SetPipelinedUpdateEnabled(true)）の間は、カメラは描画の前に設定する必要があります。");
+        }
+        return;
+    }
+
+    if (sBatchedPolygonCount > 0) {
+        FlushVertexRendering();
+    }
+    if (sRecordingFrame->commandList.Count() > 0) {
+        FlushDeferredRendering();
+    }
+    WriteUniforms2D(sHasCamera, sCamera);
+}
+
+void SetCamera(const Camera2D& camera)
+{
+    sCamera = camera;
+    sHasCamera = true;
+    ChangeCamera();
+}
+
+void ResetCamera()
+{
+    if (!sHasCamera) {
+        return;
+    }
+    sHasCamera = false;
+    ChangeCamera();
+}
+
+/// 現在の変換を適用した位置を計算する（2要素のベクタ演算で、積和2回で済ませる）
+static inline BatchFloat2 TransformPosition(float x, float y)
+{
+    return sTransformAxisX * x + sTransformAxisY * y + sTransformOrigin;
+}
+
+static inline Vector2 ApplyTransform(const Vector2& pos)
+{
+    if (sIsIdentityTransform) {
+        return pos;
+    }
+    BatchFloat2 p = TransformPosition(pos.x, pos.y);
+    return Vector2(p[0], p[1]);
+}
+
+/// 変換を適用したあとの座標でのAABBが、クリップ矩形の完全に外側にあるかどうかを判定する
+static inline bool IsOutsideClipRect(float minX, float minY, float maxX, float maxY)
+{
+    if (sIsClipRectEmpty) {
+        return true;
+    }
+    return !sClipRectStack.back().Overlaps(Game::Rect::MinMaxRect(minX, minY, maxX, maxY));
+}
+
+static inline bool IsOutsideClipRect(const Vector2& p1, const Vector2& p2, const Vector2& p3)
+{
+    return IsOutsideClipRect(std::min(std::min(p1.x, p2.x), p3.x), std::min(std::min(p1.y, p2.y), p3.y),
+                             std::max(std::max(p1.x, p2.x), p3.x), std::max(std::max(p1.y, p2.y), p3.y));
+}
+
+/// 変換前の座標でのAABBの4隅を変換し、変換後の座標でのAABBを求める
+static void TransformBounds(float& minX, float& minY, float& maxX, float& maxY)
+{
+    if (sIsIdentityTransform) {
+        return;
+    }
+    BatchFloat2 p1 = TransformPosition(minX, minY);
+    BatchFloat2 p2 = TransformPosition(maxX, minY);
+    BatchFloat2 p3 = TransformPosition(maxX, maxY);
+    BatchFloat2 p4 = TransformPosition(minX, maxY);
+    minX = std::min(std::min(p1[0], p2[0]), std::min(p3[0], p4[0]));
+    minY = std::min(std::min(p1[1], p2[1]), std::min(p3[1], p4[1]));
+    maxX = std::max(std::max(p1[0], p2[0]), std::max(p3[0], p4[0]));
+    maxY = std::max(std::max(p1[1], p2[1]), std::max(p3[1], p4[1]));
+}
+
+/// クリップ矩形はエンコーダのシザー矩形になるので、それまでの描画内容を吐き出してから切り替える
+static void FlushForClipRectChange()
+{
+    if (sBatchedPolygonCount > 0) {
+        FlushVertexRendering();
+    }
+    if (sRecordingFrame->commandList.Count() > 0) {
+        FlushDeferredRendering();
+    }
+}
+
+void PushClipRect(const Game::Rect& rect)
+{
+    CheckNotPipelined("PushClipRect");
+    FlushForClipRectChange();
+
+    float minX = rect.xMin();
+    float minY = rect.yMin();
+    float maxX = rect.xMax();
+    float maxY = rect.yMax();
+    TransformBounds(minX, minY, maxX, maxY);
+
+    // 親のクリップ矩形と交差させる
+    if (sHasClipRect) {
+        const Game::Rect& parent = sClipRectStack.back();
+        minX = std::max(minX, parent.xMin());
+        minY = std::max(minY, parent.yMin());
+        maxX = std::min(maxX, parent.xMax());
+        maxY = std::min(maxY, parent.yMax());
+    }
+    sIsClipRectEmpty = (minX >= maxX || minY >= maxY) || (sHasClipRect && sIsClipRectEmpty);
+    if (sIsClipRectEmpty) {
+        maxX = minX;
+        maxY = minY;
+    }
+    sClipRectStack.push_back(Game::Rect::MinMaxRect(minX, minY, maxX, maxY));
+    sHasClipRect = true;
+}
+
+void PopClipRect()
+{
+    if (sClipRectStack.empty()) {
+        AbortGame("PushClipRect()と対応していないPopClipRect()が呼び出されました。");
+    }
+    FlushForClipRectChange();
+
+    sClipRectStack.pop_back();
+    sHasClipRect = !sClipRectStack.empty();
+    sIsClipRectEmpty = false;
+    if (sHasClipRect) {
+        const Game::Rect& rect = sClipRectStack.back();
+        sIsClipRectEmpty = (rect.width <= 0.0f || rect.height <= 0.0f);
+    }
+}
+
+/// 現在の描画先（レンダーターゲットまたはビュー）のピクセル単位の大きさを取得する
+static void GetPassSize(float& outWidth, float& outHeight)
+{
+    if (sCurrentRenderTarget >= 0) {
+        const RenderTargetSlot& slot = sRenderTargetPool.GetSlot(sCurrentRenderTarget);
+        outWidth = (float)slot.width;
+        outHeight = (float)slot.height;
+        return;
+    }
+    __BackendGetViewSize(outWidth, outHeight);
+}
+
+/// クリップ矩形をカメラで射影して、描画先のピクセル単位のシザー矩形を設定する。
+/// シザー矩形が空になって何も描画されない場合はfalseを返す。
+static bool ApplyClipRect()
+{
+    if (!sHasClipRect) {
+        return true;
+    }
+    if (sIsClipRectEmpty) {
+        return false;
+    }
+
+    float width, height;
+    GetPassSize(width, height);
+
+    const Game::Rect& rect = sClipRectStack.back();
+    Vector2 corners[4] = {
+        Vector2(rect.xMin(), rect.yMin()), Vector2(rect.xMax(), rect.yMin()),
+        Vector2(rect.xMax(), rect.yMax()), Vector2(rect.xMin(), rect.yMax()),
+    };
+    Matrix4x4 viewProjection;
+    if (sHasCamera) {
+        viewProjection = sCamera.GetViewProjectionMatrix();
+    } else {
+        viewProjection = Matrix4x4::identity;
+    }
+    float minX = width, minY = height, maxX = 0.0f, maxY = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        // クリップ座標はY軸が上向きで、シザー矩形は左上が原点になる
+        Vector2 clipPos = viewProjection * corners[i];
+        float x = (clipPos.x + 1.0f) * 0.5f * width;
+        float y = (1.0f - clipPos.y) * 0.5f * height;
+        minX = std::min(minX, x);
+        minY = std::min(minY, y);
+        maxX = std::max(maxX, x);
+        maxY = std::max(maxY, y);
+    }
+    minX = std::max(floorf(minX), 0.0f);
+    minY = std::max(floorf(minY), 0.0f);
+    maxX = std::min(ceilf(maxX), width);
+    maxY = std::min(ceilf(maxY), height);
+    if (minX >= maxX || minY >= maxY) {
+        return false;
+    }
+
+    __BackendSetScissorRect((int)minX, (int)minY, (int)(maxX - minX), (int)(maxY - minY));
+    return true;
+}
+
+static inline size_t GetVertexStride(VertexFormat vertexFormat)
+{
+    return (vertexFormat == VertexFormatCompact)? sizeof(BatchVertexCompact): sizeof(BatchVertex);
+}
+
+static inline PipelineVertexLayout GetVertexLayout(VertexFormat vertexFormat)
+{
+    return (vertexFormat == VertexFormatCompact)? PipelineVertexLayoutCompact: PipelineVertexLayoutStandard;
+}
+
+static inline BatchVertex MakeVertex(const Vector2& pos, const Color& color)
+{
+    BatchVertex vertex;
+    vertex.position = BatchFloat2 { pos.x, pos.y };
+    vertex.color = BatchPackedFloat4 { color.r, color.g, color.b, color.a };
+    return vertex;
+}
+
+// 位置と色をそれぞれ1回のベクタストアで書き込む（頂点バッファはライトコンバインドなので、先頭から順に埋めていく）
+static inline void WriteStandardVertex(BatchVertex *vertex, BatchFloat2 pos, const Color& color)
+{
+    vertex->position = pos;
+    vertex->color = BatchPackedFloat4 { color.r, color.g, color.b, color.a };
+}
+
+static inline void WriteStandardVertex(BatchVertex *vertex, const Vector2& pos, const Color& color)
+{
+    WriteStandardVertex(vertex, BatchFloat2 { pos.x, pos.y }, color);
+}
+
+static inline void WriteCompactVertex(BatchVertexCompact *vertex, float x, float y, const Color& color)
+{
+    vertex->position[0] = Mathf::FloatToHalf(x);
+    vertex->position[1] = Mathf::FloatToHalf(y);
+    vertex->color = color.ToRGBA8();
+}
+
+static inline void WriteCompactVertex(BatchVertexCompact *vertex, const BatchVertex& src)
+{
+    Color color(src.color[0], src.color[1], src.color[2], src.color[3]);
+    WriteCompactVertex(vertex, src.position[0], src.position[1], color);
+}
+
+/// 即時描画のバッチの1頂点あたりのバイト数（テクスチャを使うバッチはスプライトの頂点になる）
+static inline size_t GetBatchVertexStride()
+{
+    return (sBatchTextureID != 0)? sizeof(SpriteVertex): GetVertexStride(sVertexFormat);
+}
+
+/// 即時描画のバッチにvertexCount個の頂点とindexCount個のインデックスを追加する領域を確保し、追加する頂点の先頭のインデックスを返す。
+/// textureIDには、図形の場合は0を、スプライトの場合はアトラスのページのテクスチャIDを指定する。
+static uint16_t ReserveBatch(unsigned textureID, size_t vertexCount, size_t indexCount)
+{
+    // テクスチャが変わる場合と、16ビットのインデックスで参照できる範囲を超える場合は、それまでのバッチを吐き出す
+    if (sBatchedPolygonCount > 0 && (textureID != sBatchTextureID || sBatchedVertexCount + vertexCount > kMaxBatchVertexCount)) {
+        FlushVertexRendering();
+    }
+    sBatchTextureID = textureID;
+
+    // ポリゴンの数が設定された最大個数を超えていないことをチェックする
+    if (sVertexBufferPointer + GetBatchVertexStride() * vertexCount > sVertexBufferPointerEdge ||
+        sIndexBufferPointer + indexCount > sIndexBufferPointerEdge) {
+        AbortGame("頂点バッファのメモリ領域を超えてポリゴン情報を格納しようとしました。（最大ポリゴン数は約 %u）", METAL_MAX_POLYGON_COUNT);
+    }
+
+    uint16_t baseVertex = (uint16_t)sBatchedVertexCount;
+    sBatchedVertexCount += vertexCount;
+    return baseVertex;
+}
+
+static inline void WriteBatchVertex(const Vector2& pos, const Color& color)
+{
+    if (sVertexFormat == VertexFormatCompact) {
+        WriteCompactVertex((BatchVertexCompact *)sVertexBufferPointer, pos.x, pos.y, color);
+        sVertexBufferPointer += sizeof(BatchVertexCompact);
+    } else {
+        WriteStandardVertex((BatchVertex *)sVertexBufferPointer, pos, color);
+        sVertexBufferPointer += sizeof(BatchVertex);
+    }
+}
+
+/// 頂点をまとめて書き込む。colorStepに0を指定すると、すべての頂点にcolors[0]を使う。
+/// 変換が単位行列でなければ、書き込みながら変換を適用する（単位行列のときは変換の計算そのものを省く）。
+static void WriteBatchVertices(const Vector2 *positions, const Color *colors, size_t colorStep, size_t vertexCount)
+{
+    if (!sIsIdentityTransform) {
+        if (sVertexFormat == VertexFormatCompact) {
+            BatchVertexCompact *vertex = (BatchVertexCompact *)sVertexBufferPointer;
+            for (size_t i = 0; i < vertexCount; i++) {
+                BatchFloat2 p = TransformPosition(positions[i].x, positions[i].y);
+                WriteCompactVertex(vertex++, p[0], p[1], colors[i * colorStep]);
+            }
+            sVertexBufferPointer = (char *)vertex;
+        } else {
+            BatchVertex *vertex = (BatchVertex *)sVertexBufferPointer;
+            for (size_t i = 0; i < vertexCount; i++) {
+                WriteStandardVertex(vertex++, TransformPosition(positions[i].x, positions[i].y), colors[i * colorStep]);
+            }
+            sVertexBufferPointer = (char *)vertex;
+        }
+        return;
+    }
+
+    if (sVertexFormat == VertexFormatCompact) {
+        BatchVertexCompact *vertex = (BatchVertexCompact *)sVertexBufferPointer;
+        for (size_t i = 0; i < vertexCount; i++) {
+            WriteCompactVertex(vertex++, positions[i].x, positions[i].y, colors[i * colorStep]);
+        }
+        sVertexBufferPointer = (char *)vertex;
+    } else {
+        BatchVertex *vertex = (BatchVertex *)sVertexBufferPointer;
+        for (size_t i = 0; i < vertexCount; i++) {
+            WriteStandardVertex(vertex++, positions[i], colors[i * colorStep]);
+        }
+        sVertexBufferPointer = (char *)vertex;
+    }
+}
+
+/// 遅延描画モードで、三角形の頂点列をステージング用の頂点配列に書き込んでコマンドとして記録する。
+/// 遅延描画ではインデックスを使わないので、indicesが指定されていれば頂点列に展開する。
+static void RecordDeferredTriangles(const Vector2 *positions, const Color *colors, size_t colorStep, const uint16_t *indices, size_t vertexCount)
+{
+    if (sRecordingFrame->commandList.NeedsFlush()) {
+        FlushDeferredRendering();
+    }
+    uint32_t firstVertex = (uint32_t)sRecordingFrame->vertices.size();
+    sRecordingFrame->vertices.resize(firstVertex + vertexCount);
+    BatchVertex *vertex = &sRecordingFrame->vertices[firstVertex];
+    if (sIsIdentityTransform) {
+        for (size_t i = 0; i < vertexCount; i++) {
+            size_t index = indices? indices[i]: i;
+            WriteStandardVertex(vertex++, positions[index], colors[index * colorStep]);
+        }
+    } else {
+        for (size_t i = 0; i < vertexCount; i++) {
+            size_t index = indices? indices[i]: i;
+            WriteStandardVertex(vertex++, TransformPosition(positions[index].x, positions[index].y), colors[index * colorStep]);
+        }
+    }
+    sRecordingFrame->commandList.Record(sLayer, sDepth, sBlendMode, sVertexFormat, 0, firstVertex, (uint32_t)vertexCount);
+}
+
+void FillTriangle(const Vector2& p1, const Vector2& p2, const Vector2& p3, const Color& c1, const Color& c2, const Color& c3)
+{
+    Vector2 t1 = ApplyTransform(p1);
+    Vector2 t2 = ApplyTransform(p2);
+    Vector2 t3 = ApplyTransform(p3);
+
+    // 静的メッシュの記録中は、メッシュに追加するだけで描画はしない
+    if (sRecordingStaticMesh >= 0) {
+        sStaticMeshes[sRecordingStaticMesh]->AddTriangle(t1, t2, t3, c1, c2, c3);
+        return;
+    }
+
+    // クリップ矩形の完全に外側にある三角形は、頂点を書き込む前に捨てる
+    if (sHasClipRect && IsOutsideClipRect(t1, t2, t3)) {
+        sRecordingFrame->culledTriangleCount++;
+        return;
+    }
+
+    // 遅延描画モードでは、ステージング用の頂点配列に書き込んでコマンドとして記録する
+    if (sBatchMode == BatchModeDeferred) {
+        if (sRecordingFrame->commandList.NeedsFlush()) {
+            FlushDeferredRendering();
+        }
+        uint32_t firstVertex = (uint32_t)sRecordingFrame->vertices.size();
+        sRecordingFrame->vertices.push_back(MakeVertex(t1, c1));
+        sRecordingFrame->vertices.push_back(MakeVertex(t2, c2));
+        sRecordingFrame->vertices.push_back(MakeVertex(t3, c3));
+        sRecordingFrame->commandList.Record(sLayer, sDepth, sBlendMode, sVertexFormat, 0, firstVertex, 3);
+        return;
+    }
+
+    // 頂点バッファとインデックスバッファにデータを書き込む
+    uint16_t baseVertex = ReserveBatch(0, 3, 3);
+    WriteBatchVertex(t1, c1);
+    WriteBatchVertex(t2, c2);
+    WriteBatchVertex(t3, c3);
+
+    sIndexBufferPointer[0] = baseVertex;
+    sIndexBufferPointer[1] = baseVertex + 1;
+    sIndexBufferPointer[2] = baseVertex + 2;
+    sIndexBufferPointer += 3;
+
+    sBatchedPolygonCount++;
+}
+
+void FillTriangles(const Vector2 *positions, const Color *colors, size_t vertexCount)
+{
+    // 3の倍数に満たない端数の頂点は無視する
+    vertexCount -= vertexCount % 3;
+    if (vertexCount == 0) {
+        return;
+    }
+
+    if (sRecordingStaticMesh >= 0) {
+        sStaticMeshes[sRecordingStaticMesh]->AddTriangles(positions, colors, 1, vertexCount, nullptr, 0, sTransformStack.Current());
+        return;
+    }
+
+    // クリップ矩形があれば、三角形ごとに判定して外側のものを捨てる
+    if (sHasClipRect) {
+        for (size_t i = 0; i < vertexCount; i += 3) {
+            FillTriangle(positions[i], positions[i + 1], positions[i + 2], colors[i], colors[i + 1], colors[i + 2]);
+        }
+        return;
+    }
+
+    if (sBatchMode == BatchModeDeferred) {
+        RecordDeferredTriangles(positions, colors, 1, nullptr, vertexCount);
+        return;
+    }
+
+    // 1つのバッチで参照できる頂点数ごとに区切って書き込む（0xffffは3の倍数）
+    while (vertexCount > 0) {
+        size_t count = std::min(vertexCount, kMaxBatchVertexCount - 1);
+        uint16_t baseVertex = ReserveBatch(0, count, count);
+        WriteBatchVertices(positions, colors, 1, count);
+
+        uint16_t *index = sIndexBufferPointer;
+        for (size_t i = 0; i < count; i++) {
+            *index++ = (uint16_t)(baseVertex + i);
+        }
+        sIndexBufferPointer = index;
+
+        sBatchedPolygonCount += count / 3;
+        positions += count;
+        colors += count;
+        vertexCount -= count;
+    }
+}
+
+/// 頂点を共有する三角形をまとめて書き込む。colorStepに0を指定すると、すべての頂点にcolors[0]を使う。
+static void FillIndexedTriangles(const Vector2 *positions, const Color *colors, size_t colorStep, size_t vertexCount, const uint16_t *indices, size_t indexCount)
+{
+    // 3の倍数に満たない端数のインデックスは無視する
+    indexCount -= indexCount % 3;
+    vertexCount = std::min(vertexCount, kMaxBatchVertexCount);
+    if (indexCount == 0 || vertexCount == 0) {
+        return;
+    }
+
+    if (sRecordingStaticMesh >= 0) {
+        sStaticMeshes[sRecordingStaticMesh]->AddTriangles(positions, colors, colorStep, vertexCount, indices, indexCount, sTransformStack.Current());
+        return;
+    }
+
+    // 頂点を共有する図形は、全体のAABBがクリップ矩形の外側にあればまとめて捨てる
+    if (sHasClipRect) {
+        float minX = positions[0].x, minY = positions[0].y, maxX = minX, maxY = minY;
+        for (size_t i = 1; i < vertexCount; i++) {
+            minX = std::min(minX, positions[i].x);
+            minY = std::min(minY, positions[i].y);
+            maxX = std::max(maxX, positions[i].x);
+            maxY = std::max(maxY, positions[i].y);
+        }
+        TransformBounds(minX, minY, maxX, maxY);
+        if (IsOutsideClipRect(minX, minY, maxX, maxY)) {
+            sRecordingFrame->culledTriangleCount += (uint32_t)(indexCount / 3);
+            return;
+        }
+    }
+
+    if (sBatchMode == BatchModeDeferred) {
+        RecordDeferredTriangles(positions, colors, colorStep, indices, indexCount);
+        return;
+    }
+
+    // 頂点は1回だけ書き込み、インデックスをバッチ内の位置にずらして共有する
+    uint16_t baseVertex = ReserveBatch(0, vertexCount, indexCount);
+    WriteBatchVertices(positions, colors, colorStep, vertexCount);
+
+    uint16_t *index = sIndexBufferPointer;
+    for (size_t i = 0; i < indexCount; i++) {
+        *index++ = (uint16_t)(baseVertex + indices[i]);
+    }
+    sIndexBufferPointer = index;
+
+    sBatchedPolygonCount += indexCount / 3;
+}
+
+void FillTriangles(const Vector2 *positions, const Color *colors, const uint16_t *indices, size_t indexCount)
+{
+    // 参照されている頂点の数はインデックスの最大値から求める
+    size_t vertexCount = 0;
+    for (size_t i = 0; i < indexCount; i++) {
+        vertexCount = std::max(vertexCount, (size_t)indices[i] + 1);
+    }
+    FillIndexedTriangles(positions, colors, 1, vertexCount, indices, indexCount);
+}
+
+void FillTriangles(const Vector2 *positions, size_t vertexCount, const uint16_t *indices, size_t indexCount, const Color& color)
+{
+    // 頂点数を超えるインデックスがあると、頂点配列の外側を読み出してしまう
+    for (size_t i = 0; i < indexCount; i++) {
+        if (indices[i] >= vertexCount) {
+            AbortGame("頂点数（%lu）以上のインデックス（%u）が指定されました。", (unsigned long)vertexCount, (unsigned)indices[i]);
+        }
+    }
+    FillIndexedTriangles(positions, &color, 0, vertexCount, indices, indexCount);
+}
+
+void DrawSpriteQuad(unsigned textureID, const SpriteVertex vertices[4])
+{
+    if (!IsValidTextureID(textureID)) {
+        return;
+    }
+    if (sRecordingStaticMesh >= 0) {
+        AbortGame("静的メッシュにはスプライトを記録できません。");
+    }
+    if (sCurrentRenderTarget >= 0 && textureID == kRenderTargetTextureIDBase + sCurrentRenderTarget) {
+        AbortGame("描画中のレンダーターゲット（ID: %d）を、そのターゲット自身に描画することはできません。", sCurrentRenderTarget);
+    }
+
+    // 変換が設定されていれば、位置だけを変換したコピーを使う
+    SpriteVertex transformedVertices[4];
+    if (!sIsIdentityTransform) {
+        for (int i = 0; i < 4; i++) {
+            transformedVertices[i] = vertices[i];
+            BatchFloat2 p = TransformPosition(vertices[i].x, vertices[i].y);
+            transformedVertices[i].x = p[0];
+            transformedVertices[i].y = p[1];
+        }
+        vertices = transformedVertices;
+    }
+
+    if (sHasClipRect) {
+        float minX = vertices[0].x, minY = vertices[0].y, maxX = minX, maxY = minY;
+        for (int i = 1; i < 4; i++) {
+            minX = std::min(minX, vertices[i].x);
+            minY = std::min(minY, vertices[i].y);
+            maxX = std::max(maxX, vertices[i].x);
+            maxY = std::max(maxY, vertices[i].y);
+        }
+        if (IsOutsideClipRect(minX, minY, maxX, maxY)) {
+            sRecordingFrame->culledTriangleCount += 2;
+            return;
+        }
+    }
+
+    // 遅延描画ではインデックスを使わないので、2つの三角形に展開してページごとのコマンドとして記録する
+    if (sBatchMode == BatchModeDeferred) {
+        if (sRecordingFrame->commandList.NeedsFlush()) {
+            FlushDeferredRendering();
+        }
+        uint32_t firstVertex = (uint32_t)sRecordingFrame->spriteVertices.size();
+        static const int kQuadIndices[6] = { 0, 1, 2, 0, 2, 3 };
+        for (int i = 0; i < 6; i++) {
+            sRecordingFrame->spriteVertices.push_back(vertices[kQuadIndices[i]]);
+        }
+        sRecordingFrame->commandList.Record(sLayer, sDepth, sBlendMode, VertexFormatStandard, textureID, firstVertex, 6);
+        return;
+    }
+
+    // 同じページのスプライトは、1つのバッチにまとめて描画される
+    uint16_t baseVertex = ReserveBatch(textureID, 4, 6);
+    memcpy(sVertexBufferPointer, vertices, sizeof(SpriteVertex) * 4);
+    sVertexBufferPointer += sizeof(SpriteVertex) * 4;
+
+    sIndexBufferPointer[0] = baseVertex;
+    sIndexBufferPointer[1] = baseVertex + 1;
+    sIndexBufferPointer[2] = baseVertex + 2;
+    sIndexBufferPointer[3] = baseVertex;
+    sIndexBufferPointer[4] = baseVertex + 2;
+    sIndexBufferPointer[5] = baseVertex + 3;
+    sIndexBufferPointer += 6;
+
+    sBatchedPolygonCount += 2;
+}
+
+
+static void AdvanceVertexBuffer(size_t byteCount)
+{
+    sVertexBufferOffset += byteCount;
+    sVertexBufferOffset = ((sVertexBufferOffset - 1) & ~(size_t)0xff) + 0x100;
+    sVertexBufferPointer = sVertexBuffer + sVertexBufferOffset;
+    sVertexBufferPointerStart = sVertexBufferPointer;
+
+    sDrawStats.bytesWritten += byteCount;
+    sDrawStats.peakVertexBufferBytes = std::max(sDrawStats.peakVertexBufferBytes, sVertexBufferOffset);
+}
+
+void FlushVertexRendering()
+{
+    EncodeTimer encodeTimer;
+
+    if (__BackendBeginPass("MyRenderEncoder")) {
+        size_t indexCount = sBatchedPolygonCount * 3;
+
+        if (sBatchTextureID != 0) {
+            __BackendSetPipeline(PipelineShaderSprite, sBlendMode, PipelineVertexLayoutSprite);
+            __BackendSetTexture(sBatchTextureID);
+        } else {
+            __BackendSetPipeline(PipelineShaderSimpleDraw, sBlendMode, GetVertexLayout(sVertexFormat));
+        }
+        // シザー矩形が空なら描画は行わず、クリップで捨てた三角形として数える
+        bool isVisible = ApplyClipRect();
+        if (isVisible) {
+            __BackendDrawIndexedTriangles(sVertexBufferOffset, sIndexBufferOffset, (uint32_t)indexCount);
+        }
+        __BackendEndPass();
+
+        sDrawStats.flushCount++;
+        sDrawStats.passCount++;
+        sDrawStats.pipelineSwitchCount++;
+        sDrawStats.bytesWritten += sizeof(uint16_t) * indexCount;
+        if (isVisible) {
+            CountDrawCall(sBlendMode, (uint32_t)sBatchedVertexCount, (uint32_t)sBatchedPolygonCount);
+        } else {
+            sDrawStats.culledTriangleCount += (uint32_t)sBatchedPolygonCount;
+        }
+
+        AdvanceVertexBuffer(GetBatchVertexStride() * sBatchedVertexCount);
+
+        // インデックスバッファのオフセットは4バイト境界に揃える
+        sIndexBufferOffset += sizeof(uint16_t) * indexCount;
+        sIndexBufferOffset = (sIndexBufferOffset + 3) & ~(size_t)3;
+        sIndexBufferPointer = (uint16_t *)((char *)sIndexBuffer + sIndexBufferOffset);
+
+        sBatchedPolygonCount = 0;
+        sBatchedVertexCount = 0;
+    }
+}
+
+/// 記録した描画コマンドを並べ替えて、1つのパスにエンコードする。useClipRectがfalseの場合はクリップ矩形を適用しない。
+static void EncodeDeferredFrame(DeferredFrame& frame, bool useClipRect)
+{
+    EncodeTimer encodeTimer;
+
+    if (__BackendBeginPass("MyDeferredRenderEncoder")) {
+        // 描画状態ごとに並べ替えて、同じ状態が連続する範囲をまとめる
+        frame.commandList.Sort();
+        const std::vector<DrawRun>& runs = frame.commandList.BuildRuns();
+        const std::vector<DrawCommand>& commands = frame.commandList.Commands();
+
+        // シザー矩形が空なら何も描画されないので、頂点のコピーもパイプラインの切り替えも行わず、クリップで捨てた三角形として数える
+        bool isVisible = !useClipRect || ApplyClipRect();
+        if (!isVisible) {
+            for (const DrawRun& run : runs) {
+                sDrawStats.culledTriangleCount += run.vertexCount / 3;
+            }
+        }
+
+        // まとめた範囲ごとにパイプラインを切り替えるだけで、パスは1つで済ませる
+        for (size_t i = 0; isVisible && i < runs.size(); i++) {
+            const DrawRun& run = runs[i];
+            bool isSprite = (run.textureID != 0);
+            size_t stride = isSprite? sizeof(SpriteVertex): GetVertexStride(run.vertexFormat);
+            if (sVertexBufferPointer + stride * run.vertexCount > sVertexBufferPointerEdge) {
+                AbortGame("頂点バッファのメモリ領域を超えてポリゴン情報を格納しようとしました。（最大ポリゴン数は約 %u）", METAL_MAX_POLYGON_COUNT);
+            }
+
+            // 並べ替えた順番で、範囲ごとの頂点フォーマットに変換しながら頂点バッファにコピーする
+            char *p = sVertexBufferPointer;
+            for (uint32_t j = run.firstCommand; j < run.firstCommand + run.commandCount; j++) {
+                const DrawCommand& command = commands[j];
+                if (isSprite) {
+                    memcpy(p, &frame.spriteVertices[command.firstVertex], sizeof(SpriteVertex) * command.vertexCount);
+                    p += stride * command.vertexCount;
+                    continue;
+                }
+                const BatchVertex *src = &frame.vertices[command.firstVertex];
+                if (run.vertexFormat == VertexFormatCompact) {
+                    BatchVertexCompact *dst = (BatchVertexCompact *)p;
+                    for (uint32_t k = 0; k < command.vertexCount; k++) {
+                        WriteCompactVertex(dst++, src[k]);
+                    }
+                } else {
+                    memcpy(p, src, sizeof(BatchVertex) * command.vertexCount);
+                }
+                p += stride * command.vertexCount;
+            }
+
+            const DrawRun *prevRun = (i > 0)? &runs[i - 1]: nullptr;
+            if (!prevRun || run.blendMode != prevRun->blendMode || run.vertexFormat != prevRun->vertexFormat || isSprite != (prevRun->textureID != 0)) {
+                if (isSprite) {
+                    __BackendSetPipeline(PipelineShaderSprite, run.blendMode, PipelineVertexLayoutSprite);
+                } else {
+                    __BackendSetPipeline(PipelineShaderSimpleDraw, run.blendMode, GetVertexLayout(run.vertexFormat));
+                }
+                sDrawStats.pipelineSwitchCount++;
+            }
+            if (isSprite && (!prevRun || run.textureID != prevRun->textureID)) {
+                __BackendSetTexture(run.textureID);
+            }
+            __BackendDrawTriangles(sVertexBufferOffset, run.vertexCount);
+            CountDrawCall(run.blendMode, run.vertexCount, run.vertexCount / 3);
+
+            AdvanceVertexBuffer(stride * run.vertexCount);
+        }
+        __BackendEndPass();
+
+        sDrawStats.flushCount++;
+        sDrawStats.passCount++;
+    }
+
+    frame.ClearCommands();
+}
+
+void FlushDeferredRendering()
+{
+    // パイプライン化した更新では、記録した内容はフレームの終わりにメインスレッドでまとめてエンコードする
+    if (sIsPipelineActive) {
+        AbortGame("パイプライン化した更新（SetPipelinedUpdateEnabled(true)）の間は、記録した描画をフレームの途中で吐き出せません。（1フレームでの描画状態の切り替えが多すぎる可能性があります）");
+    }
+    EncodeDeferredFrame(*sRecordingFrame, true);
+}
+
+static void DrawInstancesImpl(const InstanceData *instances, size_t count, int shapeOverride)
+{
+    CheckNotPipelined("DrawInstances");
+    if (count == 0) {
+        return;
+    }
+    if (sRecordingStaticMesh >= 0) {
+        AbortGame("静的メッシュにはインスタンス描画を記録できません。");
+    }
+    EncodeTimer encodeTimer;
+
+    // インスタンス描画は即座にエンコードするので、それまでの描画内容を先に吐き出しておく
+    if (sBatchedPolygonCount > 0) {
+        FlushVertexRendering();
+    }
+    if (sRecordingFrame->commandList.Count() > 0) {
+        FlushDeferredRendering();
+    }
+
+    size_t dataSize = sizeof(InstanceData) * count;
+    if (sVertexBufferPointer + dataSize > sVertexBufferPointerEdge) {
+        AbortGame("頂点バッファのメモリ領域を超えてインスタンス情報を格納しようとしました。（インスタンス数: %lu）", (unsigned long)count);
+    }
+
+    if (__BackendBeginPass("MyInstancedRenderEncoder")) {
+        // インスタンス情報はそのままコピーするだけで、頂点への展開は頂点シェーダで行う。
+        // 変換が設定されていれば、インスタンスごとの軸と平行移動に掛け合わせておく。
+        if (sIsIdentityTransform) {
+            memcpy(sVertexBufferPointer, instances, dataSize);
+        } else {
+            InstanceData *dst = (InstanceData *)sVertexBufferPointer;
+            for (size_t i = 0; i < count; i++) {
+                InstanceData instance = instances[i];
+                BatchFloat2 axisX = sTransformAxisX * instance.axisX[0] + sTransformAxisY * instance.axisX[1];
+                BatchFloat2 axisY = sTransformAxisX * instance.axisY[0] + sTransformAxisY * instance.axisY[1];
+                BatchFloat2 translation = TransformPosition(instance.translation[0], instance.translation[1]);
+                instance.axisX[0] = axisX[0];
+                instance.axisX[1] = axisX[1];
+                instance.axisY[0] = axisY[0];
+                instance.axisY[1] = axisY[1];
+                instance.translation[0] = translation[0];
+                instance.translation[1] = translation[1];
+                dst[i] = instance;
+            }
+        }
+
+        uint32_t vertexCount = (shapeOverride >= 0)? GetInstanceShapeInfos()[shapeOverride].vertexCount: GetInstanceShapeMaxVertexCount();
+        __BackendSetPipeline(PipelineShaderInstanced, sBlendMode, PipelineVertexLayoutNone);
+        if (ApplyClipRect()) {
+            __BackendDrawInstances(sVertexBufferOffset, vertexCount, (uint32_t)count, shapeOverride);
+        }
+        __BackendEndPass();
+
+        sDrawStats.flushCount++;
+        sDrawStats.passCount++;
+        sDrawStats.pipelineSwitchCount++;
+        CountDrawCall(sBlendMode, vertexCount * (uint32_t)count, vertexCount / 3 * (uint32_t)count);
+
+        AdvanceVertexBuffer(dataSize);
+    }
+}
+
+void DrawInstances(InstanceShape shape, const InstanceData *instances, size_t count)
+{
+    DrawInstancesImpl(instances, count, (int)shape);
+}
+
+void DrawInstances(const InstanceData *instances, size_t count)
+{
+    DrawInstancesImpl(instances, count, -1);
+}
+
+
+static void CheckRenderTargetID(int targetID)
+{
+    if (!sRenderTargetPool.IsInUse(targetID)) {
+        AbortGame("無効なレンダーターゲットのIDが指定されました。（ID: %d）", targetID);
+    }
+}
+
+int CreateRenderTarget(int width, int height)
+{
+    CheckNotPipelined("CreateRenderTarget");
+    if (width <= 0 || height <= 0) {
+        AbortGame("レンダーターゲットの大きさが不正です。（%dx%d）", width, height);
+    }
+
+    bool needsTexture;
+    int targetID = sRenderTargetPool.Acquire(width, height, needsTexture);
+    if (targetID >= kMaxRenderTargetCount) {
+        AbortGame("作成できるレンダーターゲットの数（%d個）を超えました。", kMaxRenderTargetCount);
+    }
+    if (needsTexture) {
+        __BackendCreateRenderTarget(targetID, width, height);
+    }
+    return targetID;
+}
+
+void ReleaseRenderTarget(int targetID)
+{
+    CheckNotPipelined("ReleaseRenderTarget");
+    CheckRenderTargetID(targetID);
+    if (targetID == sCurrentRenderTarget) {
+        AbortGame("描画中のレンダーターゲット（ID: %d）は解放できません。", targetID);
+    }
+    sRenderTargetPool.Release(targetID);
+}
+
+void TrimRenderTargets()
+{
+    CheckNotPipelined("TrimRenderTargets");
+    for (int targetID : sRenderTargetPool.Trim()) {
+        __BackendReleaseRenderTarget(targetID);
+    }
+}
+
+void BeginRenderTarget(int targetID)
+{
+    CheckNotPipelined("BeginRenderTarget");
+    CheckRenderTargetID(targetID);
+    if (sCurrentRenderTarget >= 0) {
+        AbortGame("レンダーターゲットへの描画を入れ子にすることはできません。（ID: %d）", targetID);
+    }
+
+    // それまでの描画内容は、切り替える前の描画先に吐き出しておく
+    if (sBatchedPolygonCount > 0) {
+        FlushVertexRendering();
+    }
+    if (sRecordingFrame->commandList.Count() > 0) {
+        FlushDeferredRendering();
+    }
+
+    __BackendSetRenderTarget(targetID);
+    sCurrentRenderTarget = targetID;
+}
+
+void EndRenderTarget()
+{
+    if (sCurrentRenderTarget < 0) {
+        AbortGame("BeginRenderTarget()と対応していないEndRenderTarget()が呼び出されました。");
+    }
+    if (sBatchedPolygonCount > 0) {
+        FlushVertexRendering();
+    }
+    if (sRecordingFrame->commandList.Count() > 0) {
+        FlushDeferredRendering();
+    }
+    sRenderTargetPool.MarkRendered(sCurrentRenderTarget, Time::frameCount);
+    __BackendSetRenderTarget(-1);
+    sCurrentRenderTarget = -1;
+}
+
+void InvalidateRenderTarget(int targetID)
+{
+    sRenderTargetPool.Invalidate(targetID);
+}
+
+bool IsRenderTargetValid(int targetID)
+{
+    return sRenderTargetPool.IsContentValid(targetID);
+}
+
+AtlasImage GetRenderTargetImage(int targetID)
+{
+    CheckRenderTargetID(targetID);
+    const RenderTargetSlot& slot = sRenderTargetPool.GetSlot(targetID);
+
+    // テクスチャ全体を1枚の画像として扱う（テクスチャ座標は上が0なので、描画した向きのまま表示される）
+    AtlasImage image;
+    image.textureID = kRenderTargetTextureIDBase + (unsigned)targetID;
+    image.u0 = 0.0f;
+    image.v0 = 0.0f;
+    image.u1 = 1.0f;
+    image.v1 = 1.0f;
+    image.width = slot.width;
+    image.height = slot.height;
+    return image;
+}
+
+size_t GetRenderTargetMemoryUsage()
+{
+    return sRenderTargetPool.InUseBytes() + sRenderTargetPool.PooledBytes();
+}
+
+
+void __RequestFrameCapture(const FrameCaptureRequest& request)
+{
+    // パイプライン化した更新では、ビューの設定はメインスレッドでしか変えられないので、フレームと一緒に渡してエンコードするときに登録する
+    if (sIsPipelineActive) {
+        sRecordingFrame->frameCaptures.push_back(request);
+        return;
+    }
+    __BackendAddFrameCapture(request);
+}
+
+
+static void CheckStaticMeshID(int meshID)
+{
+    if (meshID < 0 || meshID >= (int)sStaticMeshes.size() || !sStaticMeshes[meshID]) {
+        AbortGame("無効な静的メッシュのIDが指定されました。（ID: %d）", meshID);
+    }
+}
+
+/// 初回（または記録し直して大きさが変わった場合）は頂点とインデックスの全体を、それ以外は書き換えられた頂点の範囲だけを転送する
+static void UploadStaticMesh(int meshID)
+{
+    StaticMesh2D *mesh = sStaticMeshes[meshID];
+    StaticMeshUploadSize& uploadSize = sStaticMeshUploadSizes[meshID];
+    bool isFullUpload = (uploadSize.vertexCount != mesh->VertexCount() || uploadSize.indexCount != mesh->IndexCount());
+
+    if (isFullUpload) {
+        uploadSize.vertexCount = mesh->VertexCount();
+        uploadSize.indexCount = mesh->IndexCount();
+        sDrawStats.bytesWritten += sizeof(StaticMeshVertex) * uploadSize.vertexCount + sizeof(uint32_t) * uploadSize.indexCount;
+    } else {
+        for (const StaticMeshRange& range : mesh->DirtyRanges()) {
+            sDrawStats.bytesWritten += sizeof(StaticMeshVertex) * range.count;
+        }
+    }
+    __BackendUploadStaticMesh(meshID, *mesh, isFullUpload);
+    mesh->ClearDirtyRanges();
+}
+
+static void BeginStaticMeshImpl(int meshID)
+{
+    CheckNotPipelined("BeginStaticMesh");
+    if (sRecordingStaticMesh >= 0) {
+        AbortGame("静的メッシュの記録を入れ子にすることはできません。");
+    }
+    sStaticMeshes[meshID]->Clear();
+    sRecordingStaticMesh = meshID;
+}
+
+void BeginStaticMesh()
+{
+    sStaticMeshes.push_back(new StaticMesh2D());
+    sStaticMeshUploadSizes.push_back(StaticMeshUploadSize { 0, 0 });
+    BeginStaticMeshImpl((int)sStaticMeshes.size() - 1);
+}
+
+void BeginStaticMesh(int meshID)
+{
+    CheckStaticMeshID(meshID);
+    BeginStaticMeshImpl(meshID);
+}
+
+int EndStaticMesh()
+{
+    if (sRecordingStaticMesh < 0) {
+        AbortGame("BeginStaticMesh()と対応していないEndStaticMesh()が呼び出されました。");
+    }
+    int meshID = sRecordingStaticMesh;
+    sRecordingStaticMesh = -1;
+
+    if (sStaticMeshes[meshID]->IndexCount() > 0) {
+        UploadStaticMesh(meshID);
+    }
+    return meshID;
+}
+
+void UpdateStaticMesh(int meshID, uint32_t firstVertex, const Vector2 *positions, const Color *colors, size_t count)
+{
+    CheckNotPipelined("UpdateStaticMesh");
+    CheckStaticMeshID(meshID);
+    if (!sStaticMeshes[meshID]->UpdateVertices(firstVertex, positions, colors, count)) {
+        AbortGame("静的メッシュの頂点数を超えて書き換えようとしました。（ID: %d, 頂点数: %u）", meshID, sStaticMeshes[meshID]->VertexCount());
+    }
+}
+
+void ReleaseStaticMesh(int meshID)
+{
+    CheckNotPipelined("ReleaseStaticMesh");
+    CheckStaticMeshID(meshID);
+    if (meshID == sRecordingStaticMesh) {
+        AbortGame("記録中の静的メッシュ（ID: %d）は解放できません。", meshID);
+    }
+    delete sStaticMeshes[meshID];
+    sStaticMeshes[meshID] = nullptr;
+    sStaticMeshUploadSizes[meshID] = StaticMeshUploadSize { 0, 0 };
+    __BackendReleaseStaticMesh(meshID);
+}
+
+uint32_t GetStaticMeshVertexCount(int meshID)
+{
+    CheckStaticMeshID(meshID);
+    return sStaticMeshes[meshID]->VertexCount();
+}
+
+static void DrawStaticMeshImpl(int meshID, const Transform2D& transform, const Color& tint)
+{
+    CheckNotPipelined("DrawStaticMesh");
+    CheckStaticMeshID(meshID);
+    if (sRecordingStaticMesh >= 0) {
+        AbortGame("静的メッシュの記録中に静的メッシュを描画することはできません。");
+    }
+    StaticMesh2D *mesh = sStaticMeshes[meshID];
+    uint32_t indexCount = mesh->IndexCount();
+    if (indexCount == 0) {
+        return;
+    }
+    EncodeTimer encodeTimer;
+
+    // メッシュ全体がクリップ矩形の外側にあれば、描画しない
+    if (sHasClipRect) {
+        float minX, minY, maxX, maxY;
+        mesh->GetBounds(minX, minY, maxX, maxY);
+        Vector2 corners[4] = {
+            transform.Apply(Vector2(minX, minY)), transform.Apply(Vector2(maxX, minY)),
+            transform.Apply(Vector2(maxX, maxY)), transform.Apply(Vector2(minX, maxY)),
+        };
+        minX = maxX = corners[0].x;
+        minY = maxY = corners[0].y;
+        for (int i = 1; i < 4; i++) {
+            minX = std::min(minX, corners[i].x);
+            minY = std::min(minY, corners[i].y);
+            maxX = std::max(maxX, corners[i].x);
+            maxY = std::max(maxY, corners[i].y);
+        }
+        if (IsOutsideClipRect(minX, minY, maxX, maxY)) {
+            sDrawStats.culledTriangleCount += indexCount / 3;
+            return;
+        }
+    }
+
+    if (mesh->IsDirty()) {
+        UploadStaticMesh(meshID);
+    }
+
+    // 静的メッシュは即座にエンコードするので、それまでの描画内容を先に吐き出しておく
+    if (sBatchedPolygonCount > 0) {
+        FlushVertexRendering();
+    }
+    if (sRecordingFrame->commandList.Count() > 0) {
+        FlushDeferredRendering();
+    }
+
+    if (__BackendBeginPass("MyStaticMeshRenderEncoder")) {
+        __BackendSetPipeline(PipelineShaderStaticMesh, sBlendMode, PipelineVertexLayoutStandard);
+        if (ApplyClipRect()) {
+            __BackendDrawStaticMesh(meshID, transform, tint, indexCount);
+        }
+        __BackendEndPass();
+
+        sDrawStats.flushCount++;
+        sDrawStats.passCount++;
+        sDrawStats.pipelineSwitchCount++;
+        CountDrawCall(sBlendMode, mesh->VertexCount(), indexCount / 3);
+    }
+}
+
+void DrawStaticMesh(int meshID, const Color& tint)
+{
+    DrawStaticMeshImpl(meshID, sTransformStack.Current(), tint);
+}
+
+void DrawStaticMesh(int meshID, const Matrix4x4& transform, const Color& tint)
+{
+    DrawStaticMeshImpl(meshID, Transform2D::FromMatrix(transform).Then(sTransformStack.Current()), tint);
+}
+
+
+/// アトラスのページを必要な数だけ作成する
+static void PrepareAtlasPages()
+{
+    // ページは作成してから数を増やすので、他のスレッドからは作成済みのページだけが見える
+    unsigned pageCount = sAtlasPageCount.load(std::memory_order_relaxed);
+    while ((int)pageCount < sAtlasPacker.PageCount()) {
+        if (pageCount >= kMaxAtlasPageCount) {
+            AbortGame("アトラスのページ数が上限（%u）を超えました。", kMaxAtlasPageCount);
+        }
+        __BackendCreateAtlasPage((int)pageCount, kAtlasPageSize);
+        sAtlasPageCount.store(++pageCount, std::memory_order_release);
+    }
+}
+
+/// 配置済みの領域にピクセル列を書き込み、その領域を表す画像を作成する
+static AtlasImage UploadToAtlas(const AtlasRegion& region, const uint8_t *pixels)
+{
+    __BackendUploadAtlasRegion(region, pixels);
+
+    AtlasImage image;
+    image.textureID = (unsigned)region.page + 1;
+    image.u0 = (float)region.x / kAtlasPageSize;
+    image.v0 = (float)region.y / kAtlasPageSize;
+    image.u1 = (float)(region.x + region.width) / kAtlasPageSize;
+    image.v1 = (float)(region.y + region.height) / kAtlasPageSize;
+    image.width = region.width;
+    image.height = region.height;
+    return image;
+}
+
+AtlasImage CreateImage(const uint8_t *pixels, int width, int height)
+{
+    AtlasRegion region;
+    if (!sAtlasPacker.Pack(width, height, region)) {
+        AbortGame("画像（%dx%d）はアトラスのページ（%dx%d）に収まりません。", width, height, kAtlasPageSize, kAtlasPageSize);
+    }
+    PrepareAtlasPages();
+    return UploadToAtlas(region, pixels);
+}
+
+std::vector<AtlasImage> LoadImages(const std::vector<std::string>& names)
+{
+    std::vector<std::vector<uint8_t>> pixels(names.size());
+    std::vector<AtlasRegion> sizes(names.size());
+    for (size_t i = 0; i < names.size(); i++) {
+        if (!__BackendDecodeImage(names[i], pixels[i], sizes[i].width, sizes[i].height)) {
+            AbortGame("画像ファイル\"%s\"の読み込みに失敗しました。", names[i].c_str());
+        }
+    }
+
+    // すべての画像の大きさが分かってから、まとめてアトラスに詰め込む
+    std::vector<AtlasRegion> regions;
+    if (!sAtlasPacker.PackAll(sizes, regions)) {
+        for (size_t i = 0; i < regions.size(); i++) {
+            if (regions[i].page < 0) {
+                AbortGame("画像\"%s\"（%dx%d）はアトラスのページ（%dx%d）に収まりません。", names[i].c_str(),
+                          sizes[i].width, sizes[i].height, kAtlasPageSize, kAtlasPageSize);
+            }
+        }
+    }
+    PrepareAtlasPages();
+
+    std::vector<AtlasImage> ret(names.size());
+    for (size_t i = 0; i < names.size(); i++) {
+        ret[i] = UploadToAtlas(regions[i], pixels[i].data());
+    }
+    return ret;
+}
+
+AtlasImage LoadImage(const std::string& name)
+{
+    return LoadImages(std::vector<std::string>(1, name))[0];
+}
+
+
+void SetPipelinedUpdateEnabled(bool isEnabled)
+{
+    sIsPipelinedUpdateRequested.store(isEnabled, std::memory_order_relaxed);
+}
+
+bool IsPipelinedUpdateEnabled()
+{
+    return sIsPipelinedUpdateRequested.load(std::memory_order_relaxed);
+}
+
+/// フレームの統計を確定させて、履歴とフレーム時間の分布に記録する
+static void CommitFrameStats(const DrawStats& stats, double frameTime)
+{
+    sLastDrawStats = stats;
+    sDrawStatsHistory.Push(stats);
+
+    // フレーム時間の分布を記録し、指定された間隔でログに出力する
+    __RecordFrameTimes(frameTime, stats.updateTime, stats.encodeTime, stats.commitTime);
+    int frameTimeLogInterval = GetFrameTimeLogInterval();
+    if (frameTimeLogInterval > 0 && (stats.frameCount + 1) % frameTimeLogInterval == 0) {
+#ifdef __APPLE__
+        os_log(OS_LOG_DEFAULT, "%{public}s", FormatFrameTimeStats().c_str());
+#else
+        fprintf(stderr, "%s\n", FormatFrameTimeStats().c_str());
+#endif
+    }
+}
+
+/// 1つ以上のパスをエンコードしていれば、フレームを提出して、その時間をコミットの時間として計測する
+static void SubmitFrame()
+{
+    if (sPassCount > 0) {
+        double commitStartTime = GetStatsTime();
+        __BackendSubmitFrame();
+        sDrawStats.commitTime = GetStatsTime() - commitStartTime;
+    }
+    __BackendEndFrame();
+}
+
+/// ゲームが設定したカメラ・変換・クリップ矩形・描画状態に関係なく、統計のオーバーレイを画面の座標で最前面に描画して、元の状態に戻す
+static void DrawStatsOverlayOnScreen()
+{
+    BlendMode blendMode = sBlendMode;
+    VertexFormat vertexFormat = sVertexFormat;
+    int layer = sLayer;
+    float depth = sDepth;
+    bool hasCamera = sHasCamera;
+
+    // クリップ矩形はシザー矩形になるので、それまでの描画内容を吐き出してから外す
+    std::vector<Game::Rect> clipRects;
+    bool hasClipRect = sHasClipRect;
+    bool isClipRectEmpty = sIsClipRectEmpty;
+    if (hasClipRect) {
+        FlushForClipRectChange();
+        clipRects.swap(sClipRectStack);
+        sHasClipRect = false;
+        sIsClipRectEmpty = false;
+    }
+
+    sTransformStack.Push();
+    sTransformStack.Load(Transform2D::Identity());
+    if (hasCamera) {
+        if (sIsPipelineActive) {
+            // パイプライン化した更新ではフレーム全体で1つのカメラを使うので、カメラの射影を打ち消す変換で描画する
+            sTransformStack.Load(Transform2D::FromMatrix(sCamera.GetViewProjectionMatrix().Inverse()));
+        } else {
+            sHasCamera = false;
+            ChangeCamera();
+        }
+    }
+    UpdateTransformCache();
+
+    SetBlendMode(BlendModeAlpha);
+    SetVertexFormat(VertexFormatStandard);
+    sLayer = 32767;
+    sDepth = 0.0f;
+    DrawStatsOverlay(sDrawStatsHistory);
+
+    sLayer = layer;
+    sDepth = depth;
+    SetBlendMode(blendMode);
+    SetVertexFormat(vertexFormat);
+    if (hasCamera && !sIsPipelineActive) {
+        sHasCamera = true;
+        ChangeCamera();
+    }
+    sTransformStack.Pop();
+    UpdateTransformCache();
+    if (hasClipRect) {
+        FlushForClipRectChange();
+        sClipRectStack.swap(clipRects);
+        sHasClipRect = true;
+        sIsClipRectEmpty = isClipRectEmpty;
+    }
+}
+
+/// シミュレーションのスレッドで、1フレーム分の更新を行って描画内容を記録する
+static void SimulateFrame()
+{
+    // 統計はゲームから参照されるので、メインスレッドがエンコードを終えたフレームの統計はこのスレッドで反映する
+    if (sHasSimulationFrameStats) {
+        CommitFrameStats(sSimulationFrameStats, sSimulationFrameTime);
+        sHasSimulationFrameStats = false;
+    }
+
+    Input::__UpdateTriggers();
+    Time::__Update();
+    __RecordInputFrame();
+
+    InitRecordingState();
+
+    Time::__RunFixedUpdate(FixedUpdate);
+
+    double updateStartTime = GetStatsTime();
+    Update();
+    __UpdateTimers();
+    __UpdateTweens();
+    __UpdateCoroutines();
+    sRecordingFrame->updateTime = GetStatsTime() - updateStartTime;
+
+    if (sIsDrawStatsOverlayEnabled) {
+        DrawStatsOverlayOnScreen();
+    }
+
+    sRecordingFrame->hasCamera = sHasCamera;
+    sRecordingFrame->camera = sCamera;
+    sRecordingFrame->frameTime = Time::unscaledDeltaTime;
+    sRecordingFrame->frameCount = Time::frameCount;
+
+    Time::frameCount++;
+}
+
+static SimulationThread& GetSimulationThread()
+{
+    static SimulationThread thread(SimulateFrame);
+    return thread;
+}
+
+/// 最新の入力と、エンコードを終えたフレームの統計を渡して、シミュレーションのスレッドで次のフレームの更新を始める
+static void KickSimulation()
+{
+    if (sHasCompletedFrameStats) {
+        sSimulationFrameStats = sCompletedFrameStats;
+        sSimulationFrameTime = sCompletedFrameTime;
+        sHasSimulationFrameStats = true;
+        sHasCompletedFrameStats = false;
+    }
+    Input::__PublishInput();
+    __ApplyInputReplay();
+    GetSimulationThread().Kick();
+    sIsSimulationInFlight = true;
+}
+
+/// パイプライン化した更新で、シミュレーションのスレッドが記録し終えたフレームをエンコードする。
+/// エンコードしている間に、シミュレーションのスレッドでは次のフレームの更新が並行して進められる。
+static void RunPipelinedFrame()
+{
+    // パイプラインを始めるフレームでは、まだ記録済みのフレームがないので、このフレームの更新が終わるのを待つことになる
+    if (!sIsSimulationInFlight) {
+        sBatchModeBeforePipeline = sBatchMode;
+        SetBatchMode(BatchModeDeferred);
+        sIsPipelineActive = true;
+        KickSimulation();
+    }
+    GetSimulationThread().Wait();
+    sIsSimulationInFlight = false;
+
+    // 記録し終えたフレームと記録先を入れ替えてから、停止が要求されていなければ次のフレームの更新を始める
+    DeferredFrame& frame = *sRecordingFrame;
+    sRecordingFrame = (sRecordingFrame == &sDeferredFrames[0])? &sDeferredFrames[1]: &sDeferredFrames[0];
+    bool isContinuing = sIsPipelinedUpdateRequested.load(std::memory_order_relaxed);
+    if (isContinuing) {
+        KickSimulation();
+    } else {
+        // 記録中の頂点はないので、吐き出さずにパイプライン化する前の描画モードに戻す
+        sIsPipelineActive = false;
+        sBatchMode = sBatchModeBeforePipeline;
+        if (sHasCompletedFrameStats) {
+            CommitFrameStats(sCompletedFrameStats, sCompletedFrameTime);
+            sHasCompletedFrameStats = false;
+        }
+    }
+
+    InitEncodingState();
+    {
+        EncodeTimer encodeTimer;
+        WriteUniforms2D(frame.hasCamera, frame.camera);
+        if (frame.hasClearColor) {
+            EncodeClear(frame.clearColor);
+        }
+        if (frame.commandList.Count() > 0) {
+            EncodeDeferredFrame(frame, false);
+        }
+    }
+
+    for (const FrameCaptureRequest& request : frame.frameCaptures) {
+        __BackendAddFrameCapture(request);
+    }
+    SubmitFrame();
+
+    // 記録側の統計を合わせて、次にシミュレーションのスレッドを動かすときに渡す
+    sDrawStats.frameCount = frame.frameCount;
+    sDrawStats.updateTime = frame.updateTime;
+    sDrawStats.culledTriangleCount = frame.culledTriangleCount;
+    if (isContinuing) {
+        sCompletedFrameStats = sDrawStats;
+        sCompletedFrameTime = frame.frameTime;
+        sHasCompletedFrameStats = true;
+    } else {
+        CommitFrameStats(sDrawStats, frame.frameTime);
+    }
+}
+
+void __RunFrame()
+{
+    // パイプライン化した更新では、このフレームの更新と前のフレームのエンコードを別のスレッドで並行して行う
+    if (sIsPipelinedUpdateRequested.load(std::memory_order_relaxed) || sIsSimulationInFlight) {
+        RunPipelinedFrame();
+        return;
+    }
+
+    Input::__PublishInput();
+    __ApplyInputReplay();
+    Input::__UpdateTriggers();
+    Time::__Update();
+    __RecordInputFrame();
+
+    InitRenderingState();
+
+    // 固定間隔のシミュレーションは、描画を伴うUpdate()の前に、必要な回数だけまとめて進めておく
+    Time::__RunFixedUpdate(FixedUpdate);
+
+    // Update()の中で行われたエンコードの時間は、Update()の時間から除いておく
+    double updateStartTime = GetStatsTime();
+    Update();
+    __UpdateTimers();
+    __UpdateTweens();
+    __UpdateCoroutines();
+    sDrawStats.updateTime = GetStatsTime() - updateStartTime - sDrawStats.encodeTime;
+
+    if (sCurrentRenderTarget >= 0) {
+        AbortGame("BeginRenderTarget()に対応するEndRenderTarget()が呼び出されないまま、フレームが終了しました。");
+    }
+
+    if (sIsDrawStatsOverlayEnabled) {
+        DrawStatsOverlayOnScreen();
+    }
+
+    // バッチ処理のデータがあれば吐き出す
+    if (sBatchedPolygonCount > 0) {
+        FlushVertexRendering();
+    }
+    if (sRecordingFrame->commandList.Count() > 0) {
+        FlushDeferredRendering();
+    }
+
+    // このフレームで新しく作成したパイプラインがあれば、次回の起動のために保存しておく
+    SubmitFrame();
+
+    sDrawStats.culledTriangleCount += sRecordingFrame->culledTriangleCount;
+    CommitFrameStats(sDrawStats, Time::unscaledDeltaTime);
+
+    Time::frameCount++;
+}
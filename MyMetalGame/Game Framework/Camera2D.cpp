@@ -0,0 +1,51 @@
+//
+//  Camera2D.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "Camera2D.hpp"
+#include <cmath>
+
+
+Camera2D::Camera2D()
+    : position(0.0f, 0.0f), zoom(1.0f), rotation(0.0f), viewportSize(2.0f, 2.0f)
+{
+    // ビューポートの大きさの初期値は2x2なので、そのままではクリップ座標と同じ範囲が映る
+}
+
+Camera2D::Camera2D(const Vector2& viewportSize)
+    : position(0.0f, 0.0f), zoom(1.0f), rotation(0.0f), viewportSize(viewportSize)
+{
+    // Do nothing
+}
+
+Matrix4x4 Camera2D::GetViewProjectionMatrix() const
+{
+    // カメラの位置を原点に移動し、カメラの回転を打ち消してから、ビューポートの大きさでクリップ座標に合わせる
+    // 名前付きの変数を返すとMatrix4x4の暗黙のコピーコンストラクタが使われるので、一時オブジェクトのまま返す
+    return Matrix4x4::Translation(-position.x, -position.y)
+         * Matrix4x4::RotationZ(-rotation)
+         * Matrix4x4::Scale(2.0f * zoom / viewportSize.x, 2.0f * zoom / viewportSize.y);
+}
+
+Vector2 Camera2D::ScreenToWorld(const Vector2& screenPos) const
+{
+    float x = (screenPos.x - viewportSize.x / 2) / zoom;
+    float y = (screenPos.y - viewportSize.y / 2) / zoom;
+    float c = cosf(rotation);
+    float s = sinf(rotation);
+    return Vector2(x * c - y * s + position.x, x * s + y * c + position.y);
+}
+
+Vector2 Camera2D::WorldToScreen(const Vector2& worldPos) const
+{
+    float x = worldPos.x - position.x;
+    float y = worldPos.y - position.y;
+    float c = cosf(rotation);
+    float s = sinf(rotation);
+    return Vector2((x * c + y * s) * zoom + viewportSize.x / 2, (-x * s + y * c) * zoom + viewportSize.y / 2);
+}
+
@@ -0,0 +1,50 @@
+//
+//  Camera2D.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef Camera2D_hpp
+#define Camera2D_hpp
+
+#include "Matrix4x4.hpp"
+#include "Vector2.hpp"
+
+
+/// 2次元の描画に使用するカメラです。
+/// ワールド座標のpositionが画面の中央に映り、zoomが1.0のときにワールド座標の1がビューポートの1ピクセルに対応します。
+/// SetCamera()で設定すると、SimpleDrawのすべての描画にこのカメラの射影が適用されます。
+struct Camera2D
+{
+    /// 画面の中央に映すワールド座標
+    Vector2 position;
+
+    /// 拡大率（大きくするとズームインします）
+    float   zoom;
+
+    /// カメラの回転（ラジアン）。正の値を指定すると、映る内容は時計回りに回転します。
+    float   rotation;
+
+    /// ビューポートの大きさ（ピクセル）
+    Vector2 viewportSize;
+
+    /// コンストラクタ。原点を中心とした、拡大率1.0・回転なしのカメラを作成します。
+    Camera2D();
+
+    /// コンストラクタ。ビューポートの大きさを指定してカメラを作成します。
+    Camera2D(const Vector2& viewportSize);
+
+    /// ワールド座標をクリップ座標（-1.0〜1.0）に変換する行列を作成します。
+    Matrix4x4   GetViewProjectionMatrix() const;
+
+    /// ビューポート上の座標（左下が原点のピクセル単位）をワールド座標に変換します。
+    Vector2     ScreenToWorld(const Vector2& screenPos) const;
+
+    /// ワールド座標をビューポート上の座標（左下が原点のピクセル単位）に変換します。
+    Vector2     WorldToScreen(const Vector2& worldPos) const;
+};
+
+
+#endif /* Camera2D_hpp */
@@ -12,6 +12,7 @@
 #include "StringSupport.hpp"
 #include "Globals.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 
@@ -287,6 +288,15 @@ Color Color::Red(float red) const
     return ret;
 }
 
+unsigned Color::ToRGBA8() const
+{
+    unsigned r8 = (unsigned)(std::min(std::max(r, 0.0f), 1.0f) * 255.0f + 0.5f);
+    unsigned g8 = (unsigned)(std::min(std::max(g, 0.0f), 1.0f) * 255.0f + 0.5f);
+    unsigned b8 = (unsigned)(std::min(std::max(b, 0.0f), 1.0f) * 255.0f + 0.5f);
+    unsigned a8 = (unsigned)(std::min(std::max(a, 0.0f), 1.0f) * 255.0f + 0.5f);
+    return r8 | (g8 << 8) | (b8 << 16) | (a8 << 24);
+}
+
 
 std::string Color::ToString() const
 {
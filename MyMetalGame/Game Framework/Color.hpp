@@ -198,6 +198,9 @@ struct Color : public GMObject
     /// 現在の色を元に、赤の要素を指定した値に変更した色を作成します。
     Color   Red(float red) const;
 
+    /// 各色成分を0〜255に量子化して、メモリ上でR, G, B, Aの順に並ぶ32ビットの整数（RGBA8）にパックします。
+    unsigned    ToRGBA8() const;
+
     /// ベクトルの各要素を見やすくフォーマットした文字列を返します。
     std::string ToString() const override;
 
@@ -0,0 +1,355 @@
+//
+//  Coroutine.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "Coroutine.hpp"
+#include "DebugSupport.hpp"
+#include "Time.hpp"
+#include <algorithm>
+#include <new>
+#include <vector>
+
+
+#pragma mark - コルーチンのフレームのプール
+
+static const size_t kFrameSizeClasses[] = { 128, 256, 512, 1024, 2048, 4096 };
+static const int    kFrameSizeClassCount = (int)(sizeof(kFrameSizeClasses) / sizeof(kFrameSizeClasses[0]));
+static const int    kFramesPerChunk = 64;
+
+struct FreeFrame
+{
+    FreeFrame   *next;
+};
+
+// 解放されたフレームはサイズの区分ごとの空きリストに戻し、チャンクそのものはプログラムの終了まで解放しない
+static FreeFrame    *sFreeFrames[kFrameSizeClassCount];
+
+static int GetFrameSizeClass(size_t size)
+{
+    for (int i = 0; i < kFrameSizeClassCount; i++) {
+        if (size <= kFrameSizeClasses[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void *Coroutine::promise_type::operator new(size_t size)
+{
+    // 大きすぎるフレームはプールに入れずに、そのままヒープから確保する
+    int sizeClass = GetFrameSizeClass(size);
+    if (sizeClass < 0) {
+        return ::operator new(size);
+    }
+
+    if (!sFreeFrames[sizeClass]) {
+        size_t frameSize = kFrameSizeClasses[sizeClass];
+        char *chunk = (char *)::operator new(frameSize * kFramesPerChunk);
+        for (int i = kFramesPerChunk - 1; i >= 0; i--) {
+            FreeFrame *frame = (FreeFrame *)(chunk + frameSize * i);
+            frame->next = sFreeFrames[sizeClass];
+            sFreeFrames[sizeClass] = frame;
+        }
+    }
+
+    FreeFrame *frame = sFreeFrames[sizeClass];
+    sFreeFrames[sizeClass] = frame->next;
+    return frame;
+}
+
+void Coroutine::promise_type::operator delete(void *p, size_t size)
+{
+    int sizeClass = GetFrameSizeClass(size);
+    if (sizeClass < 0) {
+        ::operator delete(p);
+        return;
+    }
+    FreeFrame *frame = (FreeFrame *)p;
+    frame->next = sFreeFrames[sizeClass];
+    sFreeFrames[sizeClass] = frame;
+}
+
+void Coroutine::promise_type::unhandled_exception()
+{
+    AbortGame("コルーチンの中で捕捉されない例外が発生しました。");
+}
+
+
+#pragma mark - スケジューラ
+
+/// StartCoroutine()で開始したコルーチンの情報。終了したスロットは世代を進めて再利用する。
+struct CoroutineSlot
+{
+    std::coroutine_handle<Coroutine::promise_type>  root;
+    uint32_t    generation;
+    int         nextFreeIndex;
+    bool        isResuming;
+    bool        isStopRequested;
+};
+
+/// 中断しているコルーチンが待っている条件。コルーチンが停止された後も残っていることがあるので、再開する前に世代を確認する。
+struct CoroutineWait
+{
+    std::coroutine_handle<>     handle;
+    int             slotIndex;
+    uint32_t        generation;
+    double          wakeTime;       // WaitForSeconds: 再開するTime::time
+    int             frameCount;     // WaitForFrames: 再開するTime::frameCount、WaitForKeyDown: 待ち始めたTime::frameCount
+    KeyCodeType     keyMask;
+    bool            (*test)(void *awaiter);
+    void            *awaiter;
+};
+
+static std::vector<CoroutineSlot>   sSlots;
+static int                          sFreeSlotIndex = -1;
+static int                          sRunningCoroutineCount = 0;
+
+// 時間とフレーム数は、最も早く再開するものが先頭に来るヒープで管理する
+static std::vector<CoroutineWait>   sTimeWaits;
+static std::vector<CoroutineWait>   sFrameWaits;
+static std::vector<CoroutineWait>   sKeyWaits;
+static std::vector<CoroutineWait>   sPredicateWaits;
+static std::vector<CoroutineWait>   sScratchWaits;
+
+static bool IsLaterTime(const CoroutineWait& a, const CoroutineWait& b)
+{
+    return (a.wakeTime > b.wakeTime);
+}
+
+static bool IsLaterFrame(const CoroutineWait& a, const CoroutineWait& b)
+{
+    return (a.frameCount > b.frameCount);
+}
+
+static bool IsWaitAlive(const CoroutineWait& wait)
+{
+    const CoroutineSlot& slot = sSlots[wait.slotIndex];
+    return (slot.root && slot.generation == wait.generation && !slot.isStopRequested);
+}
+
+static void ReleaseSlot(int index)
+{
+    CoroutineSlot& slot = sSlots[index];
+    slot.root.destroy();
+    slot.root = nullptr;
+    slot.generation++;
+    slot.isResuming = false;
+    slot.isStopRequested = false;
+    slot.nextFreeIndex = sFreeSlotIndex;
+    sFreeSlotIndex = index;
+    sRunningCoroutineCount--;
+}
+
+/// コルーチンを再開し、終了したか、実行中に停止された場合は破棄する
+static void ResumeCoroutine(int slotIndex, std::coroutine_handle<> handle)
+{
+    // 再開したコルーチンの中でStartCoroutine()が呼ばれるとsSlotsが伸びることがあるので、参照は持ち越さない
+    sSlots[slotIndex].isResuming = true;
+    handle.resume();
+    sSlots[slotIndex].isResuming = false;
+
+    if (sSlots[slotIndex].root.done() || sSlots[slotIndex].isStopRequested) {
+        ReleaseSlot(slotIndex);
+    }
+}
+
+static CoroutineWait MakeWait(std::coroutine_handle<Coroutine::promise_type> handle)
+{
+    const Coroutine::promise_type& promise = handle.promise();
+    if (promise.slotIndex < 0) {
+        AbortGame("StartCoroutine()で開始されていないコルーチンの中で待機しようとしました。");
+    }
+
+    CoroutineWait wait;
+    wait.handle = handle;
+    wait.slotIndex = promise.slotIndex;
+    wait.generation = promise.generation;
+    wait.wakeTime = 0.0;
+    wait.frameCount = 0;
+    wait.keyMask = 0;
+    wait.test = nullptr;
+    wait.awaiter = nullptr;
+    return wait;
+}
+
+void __WaitForScaledTime(std::coroutine_handle<Coroutine::promise_type> handle, double wakeTime)
+{
+    CoroutineWait wait = MakeWait(handle);
+    wait.wakeTime = wakeTime;
+    sTimeWaits.push_back(wait);
+    std::push_heap(sTimeWaits.begin(), sTimeWaits.end(), IsLaterTime);
+}
+
+void __WaitForFrameCount(std::coroutine_handle<Coroutine::promise_type> handle, int wakeFrameCount)
+{
+    CoroutineWait wait = MakeWait(handle);
+    wait.frameCount = wakeFrameCount;
+    sFrameWaits.push_back(wait);
+    std::push_heap(sFrameWaits.begin(), sFrameWaits.end(), IsLaterFrame);
+}
+
+void __WaitForKeyDown(std::coroutine_handle<Coroutine::promise_type> handle, KeyCodeType keyMask)
+{
+    CoroutineWait wait = MakeWait(handle);
+    wait.frameCount = Time::frameCount;
+    wait.keyMask = keyMask;
+    sKeyWaits.push_back(wait);
+}
+
+void __WaitForPredicate(std::coroutine_handle<Coroutine::promise_type> handle, bool (*test)(void *awaiter), void *awaiter)
+{
+    CoroutineWait wait = MakeWait(handle);
+    wait.test = test;
+    wait.awaiter = awaiter;
+    sPredicateWaits.push_back(wait);
+}
+
+void WaitForSeconds::await_suspend(std::coroutine_handle<Coroutine::promise_type> handle)
+{
+    // スケールした時間の絶対値で待つので、待っている途中でtimeScaleが変わってもそのまま反映される
+    __WaitForScaledTime(handle, Time::time + seconds);
+}
+
+void WaitForFrames::await_suspend(std::coroutine_handle<Coroutine::promise_type> handle)
+{
+    __WaitForFrameCount(handle, Time::frameCount + frameCount);
+}
+
+void WaitForKeyDown::await_suspend(std::coroutine_handle<Coroutine::promise_type> handle)
+{
+    __WaitForKeyDown(handle, keyMask);
+}
+
+CoroutineHandle StartCoroutine(Coroutine coroutine)
+{
+    CoroutineHandle ret;
+    std::coroutine_handle<Coroutine::promise_type> handle = coroutine.__Release();
+    if (!handle) {
+        return ret;
+    }
+
+    int index = sFreeSlotIndex;
+    if (index >= 0) {
+        sFreeSlotIndex = sSlots[index].nextFreeIndex;
+    } else {
+        index = (int)sSlots.size();
+        CoroutineSlot slot;
+        slot.root = nullptr;
+        slot.generation = 0;
+        slot.isResuming = false;
+        slot.isStopRequested = false;
+        sSlots.push_back(slot);
+    }
+    sSlots[index].root = handle;
+    sSlots[index].nextFreeIndex = -1;
+    sRunningCoroutineCount++;
+
+    handle.promise().slotIndex = index;
+    handle.promise().generation = sSlots[index].generation;
+    ret.index = index;
+    ret.generation = sSlots[index].generation;
+
+    ResumeCoroutine(index, handle);
+    return ret;
+}
+
+void StopCoroutine(const CoroutineHandle& handle)
+{
+    if (!IsCoroutineRunning(handle)) {
+        return;
+    }
+
+    // 実行中のフレームは破棄できないので、中断したところで破棄する
+    if (sSlots[handle.index].isResuming) {
+        sSlots[handle.index].isStopRequested = true;
+    } else {
+        ReleaseSlot(handle.index);
+    }
+}
+
+void StopAllCoroutines()
+{
+    for (int i = 0; i < (int)sSlots.size(); i++) {
+        if (!sSlots[i].root) {
+            continue;
+        }
+        if (sSlots[i].isResuming) {
+            sSlots[i].isStopRequested = true;
+        } else {
+            ReleaseSlot(i);
+        }
+    }
+}
+
+bool IsCoroutineRunning(const CoroutineHandle& handle)
+{
+    if (handle.index < 0 || handle.index >= (int)sSlots.size()) {
+        return false;
+    }
+    const CoroutineSlot& slot = sSlots[handle.index];
+    return (slot.root && slot.generation == handle.generation && !slot.isStopRequested);
+}
+
+int GetRunningCoroutineCount()
+{
+    return sRunningCoroutineCount;
+}
+
+/// リストの中で条件を満たしたものを再開し、残りはリストに戻す（再開したコルーチンが新しく待ち始めたものは、次のフレームから判定される）
+template <typename Condition>
+static void ResumeReadyWaits(std::vector<CoroutineWait>& waits, const Condition& isReady)
+{
+    sScratchWaits.swap(waits);
+    for (const CoroutineWait& wait : sScratchWaits) {
+        if (!IsWaitAlive(wait)) {
+            continue;
+        }
+        if (isReady(wait)) {
+            ResumeCoroutine(wait.slotIndex, wait.handle);
+        } else {
+            waits.push_back(wait);
+        }
+    }
+    sScratchWaits.clear();
+}
+
+void __UpdateCoroutines()
+{
+    double time = Time::time;
+    while (!sTimeWaits.empty() && sTimeWaits.front().wakeTime <= time) {
+        std::pop_heap(sTimeWaits.begin(), sTimeWaits.end(), IsLaterTime);
+        CoroutineWait wait = sTimeWaits.back();
+        sTimeWaits.pop_back();
+        if (IsWaitAlive(wait)) {
+            ResumeCoroutine(wait.slotIndex, wait.handle);
+        }
+    }
+
+    int frameCount = Time::frameCount;
+    while (!sFrameWaits.empty() && sFrameWaits.front().frameCount <= frameCount) {
+        std::pop_heap(sFrameWaits.begin(), sFrameWaits.end(), IsLaterFrame);
+        CoroutineWait wait = sFrameWaits.back();
+        sFrameWaits.pop_back();
+        if (IsWaitAlive(wait)) {
+            ResumeCoroutine(wait.slotIndex, wait.handle);
+        }
+    }
+
+    // キーが押されていないフレームでは、キーを待っているコルーチンを調べる必要はない
+    if (!sKeyWaits.empty() && Input::GetKeyDown(KeyCode::Any)) {
+        ResumeReadyWaits(sKeyWaits, [frameCount](const CoroutineWait& wait) {
+            return (wait.frameCount < frameCount && Input::GetKeyDown(wait.keyMask));
+        });
+    }
+
+    if (!sPredicateWaits.empty()) {
+        ResumeReadyWaits(sPredicateWaits, [](const CoroutineWait& wait) {
+            return wait.test(wait.awaiter);
+        });
+    }
+}
+
@@ -0,0 +1,263 @@
+//
+//  Coroutine.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef Coroutine_hpp
+#define Coroutine_hpp
+
+#include "Input.hpp"
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+
+/// StartCoroutine()で開始したコルーチンを識別するためのハンドルです。コルーチンが終了すると無効になります。
+struct CoroutineHandle
+{
+    int         index;
+    uint32_t    generation;
+
+    CoroutineHandle()
+        : index(-1), generation(0)
+    {
+        // Do nothing
+    }
+};
+
+
+/// 時間やフレームをまたいで処理を進めるコルーチンの型です。co_awaitを含む関数の戻り値の型として使い、StartCoroutine()に渡して実行します。
+///
+///     Coroutine FadeOut() {
+///         co_await WaitForSeconds(2.0f);
+///         ...
+///     }
+///
+/// コルーチンの中で別のコルーチンをco_awaitすると、そのコルーチンが終了するまで待ちます。
+/// コルーチンはUpdate()の直後に、待っている条件が変化しうるときにだけ再開されます。Update()を実行するスレッド以外からは使わないでください。
+class Coroutine
+{
+public:
+    struct promise_type
+    {
+        int                         slotIndex;
+        uint32_t                    generation;
+        std::coroutine_handle<>     continuation;
+
+        promise_type()
+            : slotIndex(-1), generation(0)
+        {
+            // Do nothing
+        }
+
+        /// コルーチンのフレームはプールから割り当てるので、大量のコルーチンを作っても毎回ヒープを確保しません。
+        static void *operator new(size_t size);
+        static void operator delete(void *p, size_t size);
+
+        Coroutine get_return_object()
+        {
+            return Coroutine(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept { return false; }
+
+            // 他のコルーチンからco_awaitされていた場合は、そのコルーチンに制御を戻す
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+            {
+                std::coroutine_handle<> continuation = handle.promise().continuation;
+                return (continuation? continuation: std::noop_coroutine());
+            }
+
+            void await_resume() noexcept {}
+        };
+
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void return_void() {}
+        void unhandled_exception();
+    };
+
+    /// 他のコルーチンの終了を待つための待機オブジェクト
+    struct Awaiter
+    {
+        std::coroutine_handle<promise_type> child;
+
+        bool await_ready() { return (!child || child.done()); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> parent)
+        {
+            child.promise().slotIndex = parent.promise().slotIndex;
+            child.promise().generation = parent.promise().generation;
+            child.promise().continuation = parent;
+            return child;
+        }
+
+        void await_resume() {}
+    };
+
+public:
+    Coroutine()
+        : handle(nullptr)
+    {
+        // Do nothing
+    }
+
+    explicit Coroutine(std::coroutine_handle<promise_type> handle_)
+        : handle(handle_)
+    {
+        // Do nothing
+    }
+
+    Coroutine(Coroutine&& other) noexcept
+        : handle(std::exchange(other.handle, nullptr))
+    {
+        // Do nothing
+    }
+
+    Coroutine& operator=(Coroutine&& other) noexcept
+    {
+        if (this != &other) {
+            if (handle) {
+                handle.destroy();
+            }
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+
+    Coroutine(const Coroutine&) = delete;
+    Coroutine& operator=(const Coroutine&) = delete;
+
+    ~Coroutine()
+    {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    Awaiter operator co_await() && { return Awaiter { handle }; }
+
+    std::coroutine_handle<promise_type> __Release() { return std::exchange(handle, nullptr); }
+
+private:
+    std::coroutine_handle<promise_type>     handle;
+
+};
+
+
+/// コルーチンを開始します。最初のco_awaitまではこの場で実行され、それ以降はフレームごとに必要に応じて再開されます。
+CoroutineHandle     StartCoroutine(Coroutine coroutine);
+
+/// 実行中のコルーチンを停止して破棄します。すでに終了したコルーチンのハンドルを渡した場合は何もしません。
+/// 実行中のコルーチンの中から自分自身を停止した場合は、次にco_awaitで中断したところで破棄されます。
+void    StopCoroutine(const CoroutineHandle& handle);
+
+/// 実行中のコルーチンをすべて停止して破棄します。
+void    StopAllCoroutines();
+
+/// コルーチンがまだ終了していないかどうかを判定します。
+bool    IsCoroutineRunning(const CoroutineHandle& handle);
+
+/// 終了していないコルーチンの数を取得します。
+int     GetRunningCoroutineCount();
+
+/// 待っている条件が満たされたコルーチンを再開します。フレームごとにUpdate()の直後に呼び出されます。
+void    __UpdateCoroutines();
+
+void    __WaitForScaledTime(std::coroutine_handle<Coroutine::promise_type> handle, double wakeTime);
+void    __WaitForFrameCount(std::coroutine_handle<Coroutine::promise_type> handle, int wakeFrameCount);
+void    __WaitForKeyDown(std::coroutine_handle<Coroutine::promise_type> handle, KeyCodeType keyMask);
+void    __WaitForPredicate(std::coroutine_handle<Coroutine::promise_type> handle, bool (*test)(void *awaiter), void *awaiter);
+
+
+/// 指定した秒数が経過するまで待ちます。経過時間はTime::deltaTimeと同じくTime::timeScaleでスケールされ、待っている途中でtimeScaleを変えた場合も反映されます。
+struct WaitForSeconds
+{
+    float   seconds;
+
+    explicit WaitForSeconds(float seconds_)
+        : seconds(seconds_)
+    {
+        // Do nothing
+    }
+
+    bool await_ready() const { return (seconds <= 0.0f); }
+    void await_suspend(std::coroutine_handle<Coroutine::promise_type> handle);
+    void await_resume() const {}
+};
+
+
+/// 指定したフレーム数が経過するまで待ちます。WaitForFrames(1)で次のフレームに再開します。
+struct WaitForFrames
+{
+    int     frameCount;
+
+    explicit WaitForFrames(int frameCount_)
+        : frameCount(frameCount_)
+    {
+        // Do nothing
+    }
+
+    bool await_ready() const { return (frameCount <= 0); }
+    void await_suspend(std::coroutine_handle<Coroutine::promise_type> handle);
+    void await_resume() const {}
+};
+
+
+/// 指定したキーのいずれかが押されたフレームまで待ちます。待ち始めたフレームで押されていた分は数えず、必ず次のフレーム以降に再開します。
+/// キーが押されたフレームにだけ判定するので、キーを待っているコルーチンが多くても、入力のないフレームのコストはかかりません。
+struct WaitForKeyDown
+{
+    KeyCodeType keyMask;
+
+    explicit WaitForKeyDown(KeyCodeType keyMask_)
+        : keyMask(keyMask_)
+    {
+        // Do nothing
+    }
+
+    bool await_ready() const { return false; }
+    void await_suspend(std::coroutine_handle<Coroutine::promise_type> handle);
+    void await_resume() const {}
+};
+
+
+/// 条件の関数がtrueを返すまで待ちます。待ち始めた時点ですでにtrueならそのまま進みます。
+/// 条件がいつ変わるかは分からないので、待っている間は毎フレーム条件の関数が呼び出されます。
+template <typename Predicate>
+struct WaitUntilAwaiter
+{
+    Predicate   predicate;
+
+    bool await_ready() { return predicate(); }
+
+    void await_suspend(std::coroutine_handle<Coroutine::promise_type> handle)
+    {
+        __WaitForPredicate(handle, &WaitUntilAwaiter::Test, this);
+    }
+
+    void await_resume() const {}
+
+    static bool Test(void *awaiter)
+    {
+        return ((WaitUntilAwaiter *)awaiter)->predicate();
+    }
+};
+
+template <typename Predicate>
+WaitUntilAwaiter<Predicate> WaitUntil(Predicate predicate)
+{
+    return WaitUntilAwaiter<Predicate> { std::move(predicate) };
+}
+
+
+#endif /* Coroutine_hpp */
+
@@ -7,8 +7,13 @@
 //
 
 #include "DebugSupport.hpp"
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
 #include <execinfo.h>
+#if defined(__APPLE__)
 #include <os/log.h>
+#endif
 
 
 void AbortGame(const char *format, ...)
@@ -19,8 +24,14 @@ void AbortGame(const char *format, ...)
     vsprintf(buffer, format, marker);
     va_end(marker);
 
+#if defined(__APPLE__)
     os_log(OS_LOG_DEFAULT, "<<<< Error >>>> %s", buffer);
     os_log(OS_LOG_DEFAULT, "/--- Backtrace ---\\");
+#else
+    // ヘッドレスの実行ではunified loggingがないので、標準エラー出力に書き出す
+    fprintf(stderr, "<<<< Error >>>> %s\n", buffer);
+    fprintf(stderr, "/--- Backtrace ---\\\n");
+#endif
     void* trace[256];
     int n = backtrace(trace, sizeof(trace) / sizeof(trace[0]));
     backtrace_symbols_fd(trace, n, 2);
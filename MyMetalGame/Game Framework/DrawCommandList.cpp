@@ -0,0 +1,241 @@
+//
+//  DrawCommandList.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "DrawCommandList.hpp"
+#include <algorithm>
+
+
+static const int    kLayerShift         = 48;
+static const int    kDepthShift         = 32;
+static const int    kSegmentShift       = 16;
+static const int    kBlendModeShift     = 12;
+static const int    kVertexFormatShift  = 11;
+
+
+/// 64ビットのキーを8ビットずつ下位から安定ソートする（LSD基数ソート）。
+/// すべての要素が同じバケットに入る桁は並びが変わらないので、そのパスは省略する。
+static void RadixSortCommands(std::vector<DrawCommand>& commands, std::vector<DrawCommand>& buffer)
+{
+    size_t count = commands.size();
+    if (count < 2) {
+        return;
+    }
+    buffer.resize(count);
+
+    // 8パス分のヒストグラムを1回の走査でまとめて作成する
+    uint32_t histograms[8][256] = {};
+    for (const DrawCommand& command : commands) {
+        uint64_t key = command.key;
+        for (int pass = 0; pass < 8; pass++) {
+            histograms[pass][(key >> (pass * 8)) & 0xff]++;
+        }
+    }
+
+    DrawCommand *src = commands.data();
+    DrawCommand *dst = buffer.data();
+    bool isSwapped = false;
+
+    for (int pass = 0; pass < 8; pass++) {
+        int shift = pass * 8;
+        uint32_t *histogram = histograms[pass];
+        if (histogram[(src[0].key >> shift) & 0xff] == count) {
+            continue;
+        }
+
+        uint32_t offsets[256];
+        uint32_t sum = 0;
+        for (int i = 0; i < 256; i++) {
+            offsets[i] = sum;
+            sum += histogram[i];
+        }
+        for (size_t i = 0; i < count; i++) {
+            dst[offsets[(src[i].key >> shift) & 0xff]++] = src[i];
+        }
+        std::swap(src, dst);
+        isSwapped = !isSwapped;
+    }
+
+    if (isSwapped) {
+        commands.swap(buffer);
+    }
+}
+
+
+/// キーに格納できる範囲にレイヤ番号を制限する。
+static int ClampLayer(int layer)
+{
+    return std::min(std::max(layer, -32768), 32767);
+}
+
+
+uint64_t DrawCommandList::MakeSortKey(int layer, float depth, unsigned segment, BlendMode blendMode, VertexFormat vertexFormat, unsigned textureID)
+{
+    uint64_t layerBits = (uint64_t)(ClampLayer(layer) + 32768);
+
+    // 奥にあるもの（深度の大きいもの）から先に描画されるように反転して格納する
+    float clampedDepth = (depth > 0.0f)? std::min(depth, 1.0f): 0.0f;
+    uint64_t depthBits = 0xffff - (uint64_t)(clampedDepth * 0xffff + 0.5f);
+
+    uint64_t segmentBits = std::min(segment, kMaxSegment);
+    uint64_t blendModeBits = (uint64_t)blendMode & 0xf;
+    uint64_t vertexFormatBits = (uint64_t)vertexFormat & 0x1;
+    uint64_t textureBits = std::min(textureID, kMaxTextureID);
+
+    return (layerBits << kLayerShift) | (depthBits << kDepthShift) | (segmentBits << kSegmentShift) | (blendModeBits << kBlendModeShift) | (vertexFormatBits << kVertexFormatShift) | textureBits;
+}
+
+BlendMode DrawCommandList::BlendModeOfKey(uint64_t key)
+{
+    return (BlendMode)((key >> kBlendModeShift) & 0xf);
+}
+
+VertexFormat DrawCommandList::VertexFormatOfKey(uint64_t key)
+{
+    return (VertexFormat)((key >> kVertexFormatShift) & 0x1);
+}
+
+unsigned DrawCommandList::TextureIDOfKey(uint64_t key)
+{
+    return (unsigned)(key & kMaxTextureID);
+}
+
+bool DrawCommandList::IsOrderIndependent(BlendMode blendMode)
+{
+    // 加算・乗算・スクリーンは同じモード同士であれば合成の順番を入れ替えても結果が変わらない
+    return (blendMode == BlendModeAdd || blendMode == BlendModeMultiply || blendMode == BlendModeScreen);
+}
+
+DrawCommandList::DrawCommandList()
+{
+    Reset();
+}
+
+void DrawCommandList::Reset()
+{
+    commands.clear();
+    runs.clear();
+    layerBuckets.clear();
+    lastBucketIndex = 0;
+    maxSegment = 0;
+}
+
+DrawLayerBucket& DrawCommandList::GetLayerBucket(int layer)
+{
+    // 同じレイヤへの記録が続くことが多いので、直前のバケットから調べる。レイヤの種類は少ないので線形探索で十分
+    if (lastBucketIndex < layerBuckets.size() && layerBuckets[lastBucketIndex].layer == layer) {
+        return layerBuckets[lastBucketIndex];
+    }
+    for (size_t i = 0; i < layerBuckets.size(); i++) {
+        if (layerBuckets[i].layer == layer) {
+            lastBucketIndex = i;
+            return layerBuckets[i];
+        }
+    }
+
+    DrawLayerBucket bucket;
+    bucket.layer = layer;
+    bucket.hasLastState = false;
+    bucket.lastBlendMode = BlendModeNone;
+    bucket.lastVertexFormat = VertexFormatStandard;
+    bucket.lastTextureID = 0;
+    bucket.segment = 0;
+    layerBuckets.push_back(bucket);
+    lastBucketIndex = layerBuckets.size() - 1;
+    return layerBuckets.back();
+}
+
+void DrawCommandList::Record(int layer, float depth, BlendMode blendMode, VertexFormat vertexFormat, unsigned textureID, uint32_t firstVertex, uint32_t vertexCount)
+{
+    // 描画順序が結果に影響する状態の切り替えがあれば、新しいセグメントを開始する。
+    // セグメントをまたいだ並べ替えは行われないので、その範囲では呼び出し順序が維持される。
+    // 頂点フォーマットとテクスチャはキーでセグメントより下位にあり、同じセグメント内で並べ替えられてしまうので、
+    // 順序に依存するブレンドモードでは、これらの切り替えでも新しいセグメントを開始する。
+    // 異なるレイヤのコマンドはレイヤの順に描画されるので、状態の比較とセグメントの管理はレイヤごとに行う。
+    layer = ClampLayer(layer);
+    DrawLayerBucket& bucket = GetLayerBucket(layer);
+    if (bucket.hasLastState) {
+        bool isStateChanged = (vertexFormat != bucket.lastVertexFormat || textureID != bucket.lastTextureID);
+        if (blendMode != bucket.lastBlendMode || (isStateChanged && !IsOrderIndependent(blendMode))) {
+            bucket.segment++;
+            maxSegment = std::max(maxSegment, bucket.segment);
+        }
+    }
+    bucket.hasLastState = true;
+    bucket.lastBlendMode = blendMode;
+    bucket.lastVertexFormat = vertexFormat;
+    bucket.lastTextureID = textureID;
+
+    uint64_t key = MakeSortKey(layer, depth, bucket.segment, blendMode, vertexFormat, textureID);
+
+    // 直前のコマンドと同じキーで頂点が連続していれば延長する
+    if (!commands.empty()) {
+        DrawCommand& last = commands.back();
+        if (last.key == key && last.firstVertex + last.vertexCount == firstVertex) {
+            last.vertexCount += vertexCount;
+            return;
+        }
+    }
+
+    DrawCommand command;
+    command.key = key;
+    command.firstVertex = firstVertex;
+    command.vertexCount = vertexCount;
+    commands.push_back(command);
+}
+
+void DrawCommandList::Sort()
+{
+    RadixSortCommands(commands, sortBuffer);
+}
+
+const std::vector<DrawRun>& DrawCommandList::BuildRuns()
+{
+    runs.clear();
+    for (uint32_t i = 0; i < (uint32_t)commands.size(); i++) {
+        const DrawCommand& command = commands[i];
+        BlendMode blendMode = BlendModeOfKey(command.key);
+        VertexFormat vertexFormat = VertexFormatOfKey(command.key);
+        unsigned textureID = TextureIDOfKey(command.key);
+
+        if (!runs.empty() && runs.back().blendMode == blendMode && runs.back().vertexFormat == vertexFormat && runs.back().textureID == textureID) {
+            runs.back().commandCount++;
+            runs.back().vertexCount += command.vertexCount;
+        } else {
+            DrawRun run;
+            run.blendMode = blendMode;
+            run.vertexFormat = vertexFormat;
+            run.textureID = textureID;
+            run.firstCommand = i;
+            run.commandCount = 1;
+            run.vertexCount = command.vertexCount;
+            runs.push_back(run);
+        }
+    }
+    return runs;
+}
+
+const std::vector<DrawCommand>& DrawCommandList::Commands() const
+{
+    return commands;
+}
+
+size_t DrawCommandList::Count() const
+{
+    return commands.size();
+}
+
+bool DrawCommandList::NeedsFlush() const
+{
+    return (maxSegment >= kMaxSegment);
+}
+
+size_t DrawCommandList::LayerCount() const
+{
+    return layerBuckets.size();
+}
+
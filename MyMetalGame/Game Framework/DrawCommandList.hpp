@@ -0,0 +1,150 @@
+//
+//  DrawCommandList.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef DrawCommandList_hpp
+#define DrawCommandList_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BlendMode.hpp"
+#include "VertexFormat.hpp"
+
+
+/// 遅延描画モードで記録される1つの描画コマンドです。
+/// 頂点データそのものは持たず、ステージング用の頂点配列内の範囲だけを記録します。
+struct DrawCommand
+{
+    /// 並べ替えに使用する64ビットのキー（上位から レイヤ16 / 深度16 / セグメント16 / ブレンドモード4 / 頂点フォーマット1 / テクスチャ11）
+    uint64_t    key;
+
+    /// ステージング用の頂点配列内での開始位置
+    uint32_t    firstVertex;
+
+    /// 頂点数
+    uint32_t    vertexCount;
+};
+
+
+/// 並べ替えたあとのコマンド列のうち、同じ描画状態で連続している範囲です。1回の描画呼び出しにまとめられます。
+struct DrawRun
+{
+    /// この範囲で使用するブレンドモード
+    BlendMode   blendMode;
+
+    /// この範囲で使用する頂点フォーマット
+    VertexFormat    vertexFormat;
+
+    /// この範囲で使用するテクスチャのID（0はテクスチャなし）
+    unsigned    textureID;
+
+    /// 並べ替え後のコマンド配列内での開始位置
+    uint32_t    firstCommand;
+
+    /// この範囲に含まれるコマンド数
+    uint32_t    commandCount;
+
+    /// この範囲に含まれる頂点の総数
+    uint32_t    vertexCount;
+};
+
+
+/// レイヤごとに、直前に記録した描画状態と現在のセグメント番号を保持するバケットです。
+struct DrawLayerBucket
+{
+    /// レイヤ番号
+    int         layer;
+
+    /// このレイヤにコマンドを記録済みかどうか
+    bool        hasLastState;
+
+    /// 直前に記録したブレンドモード
+    BlendMode   lastBlendMode;
+
+    /// 直前に記録した頂点フォーマット
+    VertexFormat    lastVertexFormat;
+
+    /// 直前に記録したテクスチャのID
+    unsigned    lastTextureID;
+
+    /// このレイヤの現在のセグメント番号
+    unsigned    segment;
+};
+
+
+/// 描画コマンドを記録し、フレームの終わりに描画状態ごとに並べ替えて、連続する同じ状態の描画をまとめるためのクラスです。
+/// Metalには依存していないため、CPUだけで動作を確認できます。
+class DrawCommandList
+{
+public:
+    /// 各フィールドを指定してソートキーを作成します。
+    /// layerが大きいほど後に（手前に）描画され、depthが大きいほど先に（奥に）描画されます。depthは0.0〜1.0に制限されます。
+    static uint64_t     MakeSortKey(int layer, float depth, unsigned segment, BlendMode blendMode, VertexFormat vertexFormat, unsigned textureID);
+
+    /// ソートキーからブレンドモードを取り出します。
+    static BlendMode    BlendModeOfKey(uint64_t key);
+
+    /// ソートキーから頂点フォーマットを取り出します。
+    static VertexFormat VertexFormatOfKey(uint64_t key);
+
+    /// ソートキーからテクスチャIDを取り出します。
+    static unsigned     TextureIDOfKey(uint64_t key);
+
+    /// 描画順序を入れ替えても結果が変わらないブレンドモードかどうかを判定します。
+    static bool         IsOrderIndependent(BlendMode blendMode);
+
+    /// セグメント番号の上限です。これを超える前に記録済みのコマンドを吐き出す必要があります。
+    static constexpr unsigned   kMaxSegment = 0xffff;
+
+    /// テクスチャIDの上限です。
+    static constexpr unsigned   kMaxTextureID = 0x7ff;
+
+public:
+    DrawCommandList();
+
+    /// 記録済みのコマンドをすべて破棄します。
+    void    Reset();
+
+    /// 頂点範囲を描画コマンドとして記録します。直前のコマンドと同じキーで頂点が連続していれば、そのコマンドを延長します。
+    /// 描画順序を保つためのセグメントはレイヤごとに管理されるので、レイヤを行き来しながら記録しても、別のレイヤの状態の切り替えで分断されることはありません。
+    void    Record(int layer, float depth, BlendMode blendMode, VertexFormat vertexFormat, unsigned textureID, uint32_t firstVertex, uint32_t vertexCount);
+
+    /// 記録済みのコマンドをソートキーの順に安定ソートします（LSD基数ソート）。
+    void    Sort();
+
+    /// ソート済みのコマンド列から、同じ描画状態が連続する範囲を作成します。
+    const std::vector<DrawRun>&     BuildRuns();
+
+    /// 記録済みの（Sort()の後はソート済みの）コマンド列を取得します。
+    const std::vector<DrawCommand>& Commands() const;
+
+    /// 記録済みのコマンド数を取得します。
+    size_t  Count() const;
+
+    /// セグメント番号が上限に達していて、コマンドを吐き出す必要があるかどうかを判定します。
+    bool    NeedsFlush() const;
+
+    /// これまでにコマンドを記録したレイヤの数を取得します。
+    size_t  LayerCount() const;
+
+private:
+    DrawLayerBucket&    GetLayerBucket(int layer);
+
+private:
+    std::vector<DrawCommand>    commands;
+    std::vector<DrawCommand>    sortBuffer;
+    std::vector<DrawRun>        runs;
+
+    std::vector<DrawLayerBucket>    layerBuckets;
+    size_t      lastBucketIndex;
+    unsigned    maxSegment;
+
+};
+
+
+#endif /* DrawCommandList_hpp */
@@ -0,0 +1,169 @@
+//
+//  DrawStats.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "DrawStats.hpp"
+#include "SimpleDraw.hpp"
+#include <algorithm>
+#include <cstring>
+
+
+// オーバーレイの表示領域（クリップ座標）
+static const float  kOverlayLeft        = -0.98f;
+static const float  kOverlayBottom      = -0.98f;
+static const float  kOverlayWidth       = 0.6f;
+static const float  kOverlayHeight      = 0.3f;
+
+// グラフの縦軸の最大値（この時間で高さいっぱいになる）
+static const double kOverlayMaxTime     = 1.0 / 30;
+
+
+void DrawStats::Reset()
+{
+    memset(this, 0, sizeof(DrawStats));
+}
+
+float DrawStats::PeakVertexBufferUsage() const
+{
+    if (vertexBufferCapacity == 0) {
+        return 0.0f;
+    }
+    return (float)peakVertexBufferBytes / vertexBufferCapacity;
+}
+
+
+DrawStatsHistory::DrawStatsHistory()
+{
+    Clear();
+}
+
+void DrawStatsHistory::Clear()
+{
+    head = 0;
+    count = 0;
+}
+
+void DrawStatsHistory::Push(const DrawStats& stats)
+{
+    head = (head + 1) % kCapacity;
+    entries[head] = stats;
+    count = std::min(count + 1, kCapacity);
+}
+
+int DrawStatsHistory::Count() const
+{
+    return count;
+}
+
+const DrawStats& DrawStatsHistory::Get(int framesAgo) const
+{
+    return entries[(head - framesAgo % kCapacity + kCapacity) % kCapacity];
+}
+
+DrawStats DrawStatsHistory::Average() const
+{
+    DrawStats ret;
+    ret.Reset();
+    if (count == 0) {
+        return ret;
+    }
+
+    // 合計は64ビットで取ってから割る
+    uint64_t triangleCount = 0;
+    uint64_t culledTriangleCount = 0;
+    uint64_t vertexCount = 0;
+    uint64_t flushCount = 0;
+    uint64_t passCount = 0;
+    uint64_t drawCallCount = 0;
+    uint64_t pipelineSwitchCount = 0;
+    uint64_t blendModeTriangleCounts[BlendModeXOR + 1] = {};
+    uint64_t bytesWritten = 0;
+
+    for (int i = 0; i < count; i++) {
+        const DrawStats& stats = Get(i);
+        triangleCount += stats.triangleCount;
+        culledTriangleCount += stats.culledTriangleCount;
+        vertexCount += stats.vertexCount;
+        flushCount += stats.flushCount;
+        passCount += stats.passCount;
+        drawCallCount += stats.drawCallCount;
+        pipelineSwitchCount += stats.pipelineSwitchCount;
+        for (int j = 0; j <= BlendModeXOR; j++) {
+            blendModeTriangleCounts[j] += stats.blendModeTriangleCounts[j];
+        }
+        bytesWritten += stats.bytesWritten;
+        ret.peakVertexBufferBytes = std::max(ret.peakVertexBufferBytes, stats.peakVertexBufferBytes);
+        ret.vertexBufferCapacity = std::max(ret.vertexBufferCapacity, stats.vertexBufferCapacity);
+        ret.updateTime += stats.updateTime;
+        ret.encodeTime += stats.encodeTime;
+        ret.commitTime += stats.commitTime;
+    }
+
+    ret.frameCount = Get(0).frameCount;
+    ret.triangleCount = (uint32_t)(triangleCount / count);
+    ret.culledTriangleCount = (uint32_t)(culledTriangleCount / count);
+    ret.vertexCount = (uint32_t)(vertexCount / count);
+    ret.flushCount = (uint32_t)(flushCount / count);
+    ret.passCount = (uint32_t)(passCount / count);
+    ret.drawCallCount = (uint32_t)(drawCallCount / count);
+    ret.pipelineSwitchCount = (uint32_t)(pipelineSwitchCount / count);
+    for (int j = 0; j <= BlendModeXOR; j++) {
+        ret.blendModeTriangleCounts[j] = (uint32_t)(blendModeTriangleCounts[j] / count);
+    }
+    ret.bytesWritten = (size_t)(bytesWritten / count);
+    ret.updateTime /= count;
+    ret.encodeTime /= count;
+    ret.commitTime /= count;
+    return ret;
+}
+
+
+static void FillOverlayRect(float x, float y, float width, float height, const Color& color)
+{
+    Vector2 p1(x, y);
+    Vector2 p2(x + width, y);
+    Vector2 p3(x + width, y + height);
+    Vector2 p4(x, y + height);
+    FillTriangle(p1, p2, p3, color);
+    FillTriangle(p1, p3, p4, color);
+}
+
+void DrawStatsOverlay(const DrawStatsHistory& history)
+{
+    // 背景
+    FillOverlayRect(kOverlayLeft, kOverlayBottom, kOverlayWidth, kOverlayHeight, Color(0.0f, 0.0f, 0.0f, 0.6f));
+
+    // 三角形の数の縦軸は、表示中の最大値に合わせる
+    uint32_t maxTriangleCount = 1;
+    for (int i = 0; i < history.Count(); i++) {
+        maxTriangleCount = std::max(maxTriangleCount, history.Get(i).triangleCount);
+    }
+
+    // 右端を最新のフレームとして、1フレームにつき1本の棒を描く（下からUpdateの時間、エンコードの時間）
+    float barWidth = kOverlayWidth / DrawStatsHistory::kCapacity;
+    Color updateColor(0.3f, 0.9f, 0.4f, 0.9f);
+    Color encodeColor(1.0f, 0.6f, 0.2f, 0.9f);
+    Color triangleColor(0.4f, 0.7f, 1.0f, 0.9f);
+    for (int i = 0; i < history.Count(); i++) {
+        const DrawStats& stats = history.Get(i);
+        float x = kOverlayLeft + kOverlayWidth - barWidth * (i + 1);
+        float updateHeight = (float)std::min(stats.updateTime / kOverlayMaxTime, 1.0) * kOverlayHeight;
+        float encodeHeight = (float)std::min(stats.encodeTime / kOverlayMaxTime, 1.0) * kOverlayHeight;
+        encodeHeight = std::min(encodeHeight, kOverlayHeight - updateHeight);
+        FillOverlayRect(x, kOverlayBottom, barWidth, updateHeight, updateColor);
+        FillOverlayRect(x, kOverlayBottom + updateHeight, barWidth, encodeHeight, encodeColor);
+
+        // 三角形の数は棒の上に点で示す
+        float triangleY = kOverlayBottom + kOverlayHeight * stats.triangleCount / maxTriangleCount;
+        FillOverlayRect(x, triangleY - barWidth / 2, barWidth, barWidth, triangleColor);
+    }
+
+    // 60fpsの目安の線
+    float lineY = kOverlayBottom + (float)(1.0 / 60 / kOverlayMaxTime) * kOverlayHeight;
+    FillOverlayRect(kOverlayLeft, lineY, kOverlayWidth, 0.004f, Color(1.0f, 1.0f, 1.0f, 0.5f));
+}
+
@@ -0,0 +1,123 @@
+//
+//  DrawStats.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef DrawStats_hpp
+#define DrawStats_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include "BlendMode.hpp"
+
+
+/// 1フレームの描画処理の統計情報です。
+struct DrawStats
+{
+    /// 統計を取ったフレームの番号（Time::frameCount）
+    int         frameCount;
+
+    /// GPUに送った三角形の数
+    uint32_t    triangleCount;
+
+    /// クリップ矩形の外側にあるため、頂点を書き込む前に捨てた三角形の数（クリップ矩形が画面の外にあってシザー矩形が空になり、描画しなかった三角形も含みます）
+    uint32_t    culledTriangleCount;
+
+    /// GPUに送った頂点の数（インスタンス描画では、頂点シェーダで展開された頂点の数）
+    uint32_t    vertexCount;
+
+    /// 頂点バッファに書き込んだバイト数
+    size_t      bytesWritten;
+
+    /// バッチを吐き出した回数（即時描画・遅延描画・インスタンス描画の合計）
+    uint32_t    flushCount;
+
+    /// 作成したレンダーパスの数。このレンダラでは1つのパスに1つのレンダーコマンドエンコーダを使います。
+    uint32_t    passCount;
+
+    /// 描画コマンド（drawPrimitives）の発行回数
+    uint32_t    drawCallCount;
+
+    /// パイプラインの切り替え回数
+    uint32_t    pipelineSwitchCount;
+
+    /// ブレンドモードごとの三角形の数
+    uint32_t    blendModeTriangleCounts[BlendModeXOR + 1];
+
+    /// 頂点バッファの使用量の最大値（バイト）
+    size_t      peakVertexBufferBytes;
+
+    /// 頂点バッファの容量（バイト）
+    size_t      vertexBufferCapacity;
+
+    /// Update()の実行にかかったCPU時間（秒）。Update()内で行われたエンコードの時間は含みません。
+    double      updateTime;
+
+    /// 描画コマンドのエンコードにかかったCPU時間（秒）
+    double      encodeTime;
+
+    /// ドローアブルの表示の登録とコマンドバッファのコミットにかかったCPU時間（秒）
+    double      commitTime;
+
+    /// すべての値を0にします。
+    void    Reset();
+
+    /// 頂点バッファの使用率の最大値（0.0〜1.0）を取得します。
+    float   PeakVertexBufferUsage() const;
+};
+
+
+/// 直近のフレームの統計情報を一定数だけ保持するリングバッファです。
+class DrawStatsHistory
+{
+public:
+    /// 保持するフレーム数
+    static constexpr int    kCapacity = 120;
+
+public:
+    DrawStatsHistory();
+
+    /// 保持している統計情報をすべて破棄します。
+    void    Clear();
+
+    /// 統計情報を追加します。保持できる数を超えた場合は、最も古いものが破棄されます。
+    void    Push(const DrawStats& stats);
+
+    /// 保持している統計情報の数を取得します。
+    int     Count() const;
+
+    /// framesAgoフレーム前の統計情報を取得します。0が最新です。
+    const DrawStats&    Get(int framesAgo) const;
+
+    /// 保持している統計情報の平均を取得します。ピーク値と容量は最大値、フレーム番号は最新のものになります。
+    DrawStats   Average() const;
+
+private:
+    DrawStats   entries[kCapacity];
+    int         head;
+    int         count;
+
+};
+
+
+/// 直前のフレームの描画統計を取得します。
+const DrawStats&        GetLastDrawStats();
+
+/// 直近のフレームの描画統計の履歴を取得します。
+const DrawStatsHistory& GetDrawStatsHistory();
+
+/// 描画統計のオーバーレイ表示を有効にするかどうかを設定します。
+/// 有効にすると、Update()の後に画面左下にフレームごとのCPU時間と三角形の数のグラフが描画されます（オーバーレイ自体の描画も統計に含まれます）。
+void    SetDrawStatsOverlayEnabled(bool isEnabled);
+
+/// 描画統計のオーバーレイ表示が有効かどうかを取得します。
+bool    IsDrawStatsOverlayEnabled();
+
+/// 統計の履歴をFillTriangle()を使ってグラフとして描画します。
+void    DrawStatsOverlay(const DrawStatsHistory& history);
+
+
+#endif /* DrawStats_hpp */
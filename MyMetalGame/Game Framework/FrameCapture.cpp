@@ -0,0 +1,226 @@
+//
+//  FrameCapture.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "FrameCapture.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+
+/// バックグラウンドで処理するキャプチャ1つ分の情報
+struct FrameCaptureJob
+{
+    RGBA8Image          image;
+    FrameCaptureRequest request;
+};
+
+
+/// キャプチャの書き出しと比較を行うワーカースレッドです。最初にキャプチャが登録されたときに起動します。
+class FrameCaptureWorker
+{
+public:
+    FrameCaptureWorker()
+        : isRunning(false), isQuitting(false), isBusy(false), mismatchCount(0)
+    {
+        // Do nothing
+    }
+
+    ~FrameCaptureWorker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            isQuitting = true;
+        }
+        condition.notify_all();
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    void Enqueue(FrameCaptureJob&& job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(std::move(job));
+            if (!isRunning) {
+                thread = std::thread(&FrameCaptureWorker::Run, this);
+                isRunning = true;
+            }
+        }
+        condition.notify_all();
+    }
+
+    int Wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        idleCondition.wait(lock, [this] { return jobs.empty() && !isBusy; });
+        return mismatchCount;
+    }
+
+    int MismatchCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return mismatchCount;
+    }
+
+private:
+    void Run()
+    {
+        while (true) {
+            FrameCaptureJob job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this] { return !jobs.empty() || isQuitting; });
+                if (jobs.empty()) {
+                    return;
+                }
+                job = std::move(jobs.front());
+                jobs.pop_front();
+                isBusy = true;
+            }
+
+            bool isMatched = Process(job);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!isMatched) {
+                    mismatchCount++;
+                }
+                isBusy = false;
+            }
+            idleCondition.notify_all();
+        }
+    }
+
+    static bool Process(const FrameCaptureJob& job)
+    {
+        const FrameCaptureRequest& request = job.request;
+        if (!request.path.empty() && !WriteImageFile(job.image, request.path)) {
+            fprintf(stderr, "Failed to write the captured frame: %s\n", request.path.c_str());
+        }
+        if (request.goldenPath.empty()) {
+            return true;
+        }
+
+        RGBA8Image golden;
+        if (!ReadImageFile(request.goldenPath, golden)) {
+            fprintf(stderr, "Failed to read the golden image: %s\n", request.goldenPath.c_str());
+            return false;
+        }
+
+        RGBA8Image diff;
+        ImageCompareResult result = CompareImages(job.image, golden, request.tolerance, request.diffPath.empty()? nullptr: &diff);
+        if (result.IsMatched()) {
+            return true;
+        }
+
+        if (!result.isSizeMatched) {
+            fprintf(stderr, "Golden image mismatch: %s (size %dx%d, expected %dx%d)\n", request.goldenPath.c_str(),
+                    job.image.width, job.image.height, golden.width, golden.height);
+        } else {
+            fprintf(stderr, "Golden image mismatch: %s (%d pixels differ, max difference %d, tolerance %d)\n",
+                    request.goldenPath.c_str(), result.differentPixelCount, result.maxDifference, request.tolerance);
+        }
+        if (!request.diffPath.empty() && result.isSizeMatched) {
+            WriteImageFile(diff, request.diffPath);
+        }
+        return false;
+    }
+
+private:
+    std::mutex                  mutex;
+    std::condition_variable     condition;
+    std::condition_variable     idleCondition;
+    std::thread                 thread;
+    std::deque<FrameCaptureJob> jobs;
+    bool    isRunning;
+    bool    isQuitting;
+    bool    isBusy;
+    int     mismatchCount;
+};
+
+static FrameCaptureWorker& GetWorker()
+{
+    static FrameCaptureWorker worker;
+    return worker;
+}
+
+
+bool ImageCompareResult::IsMatched() const
+{
+    return (isSizeMatched && differentPixelCount == 0);
+}
+
+ImageCompareResult CompareImages(const RGBA8Image& actual, const RGBA8Image& expected, int tolerance, RGBA8Image *outDiff)
+{
+    ImageCompareResult ret;
+    ret.isSizeMatched = (actual.width == expected.width && actual.height == expected.height);
+    ret.differentPixelCount = 0;
+    ret.maxDifference = 0;
+    if (!ret.isSizeMatched) {
+        return ret;
+    }
+
+    if (outDiff) {
+        outDiff->Resize(expected.width, expected.height);
+    }
+    size_t pixelCount = (size_t)expected.width * expected.height;
+    for (size_t i = 0; i < pixelCount; i++) {
+        const uint8_t *a = actual.pixels.data() + i * 4;
+        const uint8_t *e = expected.pixels.data() + i * 4;
+        int difference = 0;
+        for (int c = 0; c < 4; c++) {
+            difference = std::max(difference, abs((int)a[c] - (int)e[c]));
+        }
+        ret.maxDifference = std::max(ret.maxDifference, difference);
+
+        bool isDifferent = (difference > tolerance);
+        if (isDifferent) {
+            ret.differentPixelCount++;
+        }
+        if (outDiff) {
+            uint8_t *d = outDiff->pixels.data() + i * 4;
+            if (isDifferent) {
+                d[0] = 0xff;
+                d[1] = 0;
+                d[2] = 0;
+            } else {
+                // 一致しているところは、位置がわかる程度に期待する画像を暗く表示する
+                uint8_t gray = (uint8_t)((e[0] * 77 + e[1] * 150 + e[2] * 29) >> 10);
+                d[0] = gray;
+                d[1] = gray;
+                d[2] = gray;
+            }
+            d[3] = 0xff;
+        }
+    }
+    return ret;
+}
+
+void EnqueueFrameCapture(const RGBA8Image& image, const FrameCaptureRequest& request)
+{
+    FrameCaptureJob job;
+    job.image = image;
+    job.request = request;
+    GetWorker().Enqueue(std::move(job));
+}
+
+bool WaitForFrameCaptures()
+{
+    return (GetWorker().Wait() == 0);
+}
+
+int GetGoldenMismatchCount()
+{
+    return GetWorker().MismatchCount();
+}
+
@@ -0,0 +1,75 @@
+//
+//  FrameCapture.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef FrameCapture_hpp
+#define FrameCapture_hpp
+
+#include "ImageFile.hpp"
+#include <string>
+
+
+/// 2つの画像を比較した結果です。
+struct ImageCompareResult
+{
+    /// 画像のサイズが一致したかどうか
+    bool    isSizeMatched;
+
+    /// 許容誤差を超えて異なっていたピクセルの数
+    int     differentPixelCount;
+
+    /// すべてのピクセル・チャンネルの中で最大の差
+    int     maxDifference;
+
+    /// 許容誤差の範囲で一致したかどうかを判定します。
+    bool    IsMatched() const;
+};
+
+
+/// フレームのキャプチャで行う処理の指定です。
+struct FrameCaptureRequest
+{
+    /// 画像の書き出し先のパス（空の場合は書き出さない）。拡張子が ".ppm" の場合はPPM、それ以外はPNGで書き出されます。
+    std::string     path;
+
+    /// 比較するゴールデンイメージのパス（空の場合は比較しない）
+    std::string     goldenPath;
+
+    /// 差分画像の書き出し先のパス（空の場合は書き出さない）。一致しなかった場合だけ書き出されます。
+    std::string     diffPath;
+
+    /// ピクセルの各チャンネルで許容する差（0〜255）
+    int             tolerance;
+};
+
+
+/// 2つの画像をピクセルごとに比較します。各チャンネルの差がtoleranceを超えたピクセルを異なるピクセルとして数えます。
+/// outDiffを指定すると、異なるピクセルを赤、それ以外を期待する画像の暗いグレーで塗った差分画像が作成されます。
+ImageCompareResult  CompareImages(const RGBA8Image& actual, const RGBA8Image& expected, int tolerance, RGBA8Image *outDiff);
+
+/// 現在のフレームの描画結果を、フレームの終わりに読み戻して画像ファイルに書き出します。
+/// 読み戻しのためにビューのframebufferOnlyをNOに切り替えるので、そのフレームのドローアブルがすでにフレームバッファ専用で作成されていた場合は、次のフレームでキャプチャされます。
+/// ヘッドレスのランナーには描画結果がないので、この関数とCaptureFrameAndCompare()は定義されていません。
+void    CaptureFrame(const std::string& path);
+
+/// 現在のフレームの描画結果を読み戻して、ゴールデンイメージと比較します。一致しなかった場合は、diffPathに差分画像が書き出されます。
+/// 比較はバックグラウンドで行われるので、結果はWaitForFrameCaptures()で受け取ってください。
+void    CaptureFrameAndCompare(const std::string& goldenPath, int tolerance, const std::string& diffPath);
+
+/// キャプチャした画像の書き出しとゴールデンイメージとの比較を、バックグラウンドのスレッドで行うように登録します。
+/// Metalのドローアブルからの読み戻しのほか、テスト用のハーネスが用意したCPU側のフレームバッファもこの関数に渡せます。
+void    EnqueueFrameCapture(const RGBA8Image& image, const FrameCaptureRequest& request);
+
+/// 登録済みのキャプチャの処理がすべて終わるまで待ちます。
+/// これまでのゴールデンイメージとの比較がすべて一致していればtrueを返します（読み込めなかったゴールデンイメージは不一致として扱います）。
+bool    WaitForFrameCaptures();
+
+/// これまでにゴールデンイメージと一致しなかったキャプチャの数を取得します。
+int     GetGoldenMismatchCount();
+
+
+#endif /* FrameCapture_hpp */
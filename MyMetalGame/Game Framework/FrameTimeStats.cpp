@@ -0,0 +1,194 @@
+//
+//  FrameTimeStats.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "FrameTimeStats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+
+// 32マイクロ秒未満は1マイクロ秒ごとのバケット、それ以上は2の冪ごとの区間を16等分したバケットにする
+static const int        kLinearBucketCount  = 32;
+static const int        kSubBucketCount     = 16;
+static const int        kSubBucketBits      = 4;
+static const uint32_t   kMaxMicroseconds    = (1U << 28) - 1;
+
+static const char * const   kChannelNames[FrameTimeChannelCount] = { "frame", "update", "encode", "commit" };
+
+static FrameTimeHistogram   sHistograms[FrameTimeChannelCount];
+static double               sFrameTimeBudget = 1.0 / 60;
+static int                  sLogInterval = 0;
+
+
+FrameTimeHistogram::FrameTimeHistogram()
+{
+    Clear();
+}
+
+void FrameTimeHistogram::Clear()
+{
+    memset(counts, 0, sizeof(counts));
+    head = 0;
+    count = 0;
+}
+
+int FrameTimeHistogram::BucketOf(double seconds)
+{
+    double microseconds = seconds * 1.0e6;
+    uint32_t value = (microseconds <= 0.0)? 0: (microseconds >= kMaxMicroseconds)? kMaxMicroseconds: (uint32_t)microseconds;
+    if (value < kLinearBucketCount) {
+        return (int)value;
+    }
+
+    // 最上位ビットの位置で区間を決め、その下の4ビットで区間内の位置を決める
+    int exponent = 31 - __builtin_clz(value);
+    int subBucket = (int)((value >> (exponent - kSubBucketBits)) & (kSubBucketCount - 1));
+    return kLinearBucketCount + (exponent - 5) * kSubBucketCount + subBucket;
+}
+
+double FrameTimeHistogram::BucketValue(int bucket)
+{
+    if (bucket < kLinearBucketCount) {
+        return (bucket + 0.5) * 1.0e-6;
+    }
+    int exponent = (bucket - kLinearBucketCount) / kSubBucketCount + 5;
+    int subBucket = (bucket - kLinearBucketCount) % kSubBucketCount;
+    double width = (double)(1U << (exponent - kSubBucketBits));
+    double lower = (kSubBucketCount + subBucket) * width;
+    return (lower + width * 0.5) * 1.0e-6;
+}
+
+void FrameTimeHistogram::Record(double seconds)
+{
+    // ウィンドウがいっぱいであれば、最も古い値をヒストグラムから取り除いてから上書きする
+    if (count == kWindowSize) {
+        counts[BucketOf(window[head])]--;
+    } else {
+        count++;
+    }
+    // 取り除くときと同じバケットに数えるように、単精度に丸めてウィンドウに格納した値からバケットを求める
+    // （倍精度の値のままでは、1, 2, 4マイクロ秒などのバケットの境界で隣のバケットに数えてしまう）
+    float value = (float)seconds;
+    window[head] = value;
+    counts[BucketOf(value)]++;
+    head = (head + 1) % kWindowSize;
+}
+
+int FrameTimeHistogram::Count() const
+{
+    return count;
+}
+
+double FrameTimeHistogram::Percentile(double percent) const
+{
+    if (count == 0) {
+        return 0.0;
+    }
+    uint32_t rank = (uint32_t)std::max(1.0, ceil(std::min(std::max(percent, 0.0), 100.0) / 100.0 * count));
+    uint32_t cumulative = 0;
+    for (int i = 0; i < kBucketCount; i++) {
+        cumulative += counts[i];
+        if (cumulative >= rank) {
+            return BucketValue(i);
+        }
+    }
+    return BucketValue(kBucketCount - 1);
+}
+
+FrameTimeSummary FrameTimeHistogram::Summarize(double hitchThreshold) const
+{
+    FrameTimeSummary ret;
+    ret.sampleCount = count;
+    ret.min = 0.0;
+    ret.max = 0.0;
+    ret.mean = 0.0;
+    ret.hitchCount = 0;
+    ret.p50 = Percentile(50.0);
+    ret.p95 = Percentile(95.0);
+    ret.p99 = Percentile(99.0);
+    if (count == 0) {
+        return ret;
+    }
+
+    // ウィンドウはkWindowSize個しかないので、最小値・最大値・平均値は問い合わせのたびに数え直す
+    ret.min = window[0];
+    ret.max = window[0];
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) {
+        double value = window[i];
+        ret.min = std::min(ret.min, value);
+        ret.max = std::max(ret.max, value);
+        sum += value;
+        if (value > hitchThreshold) {
+            ret.hitchCount++;
+        }
+    }
+    ret.mean = sum / count;
+    return ret;
+}
+
+
+void __RecordFrameTimes(double frameTime, double updateTime, double encodeTime, double commitTime)
+{
+    sHistograms[FrameTimeChannelFrame].Record(frameTime);
+    sHistograms[FrameTimeChannelUpdate].Record(updateTime);
+    sHistograms[FrameTimeChannelEncode].Record(encodeTime);
+    sHistograms[FrameTimeChannelCommit].Record(commitTime);
+}
+
+FrameTimeSummary GetFrameTimeSummary(FrameTimeChannel channel)
+{
+    return sHistograms[std::min(std::max((int)channel, 0), FrameTimeChannelCount - 1)].Summarize(sFrameTimeBudget * 2);
+}
+
+void ResetFrameTimeStats()
+{
+    for (int i = 0; i < FrameTimeChannelCount; i++) {
+        sHistograms[i].Clear();
+    }
+}
+
+void SetFrameTimeBudget(double seconds)
+{
+    sFrameTimeBudget = seconds;
+}
+
+double GetFrameTimeBudget()
+{
+    return sFrameTimeBudget;
+}
+
+void SetFrameTimeLogInterval(int frameCount)
+{
+    sLogInterval = std::max(frameCount, 0);
+}
+
+int GetFrameTimeLogInterval()
+{
+    return sLogInterval;
+}
+
+std::string FormatFrameTimeStats()
+{
+    std::string ret;
+    char buffer[256];
+    for (int i = 0; i < FrameTimeChannelCount; i++) {
+        FrameTimeSummary summary = GetFrameTimeSummary((FrameTimeChannel)i);
+        snprintf(buffer, sizeof(buffer), "%s%s p50=%.2f p95=%.2f p99=%.2f min=%.2f max=%.2f",
+                 (i > 0)? " | ": "", kChannelNames[i],
+                 summary.p50 * 1000, summary.p95 * 1000, summary.p99 * 1000, summary.min * 1000, summary.max * 1000);
+        ret += buffer;
+        if (i == FrameTimeChannelFrame) {
+            snprintf(buffer, sizeof(buffer), " hitches=%d/%d", summary.hitchCount, summary.sampleCount);
+            ret += buffer;
+        }
+    }
+    return ret;
+}
+
@@ -0,0 +1,136 @@
+//
+//  FrameTimeStats.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef FrameTimeStats_hpp
+#define FrameTimeStats_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+/// フレーム時間の統計を取る対象を表す列挙型
+enum FrameTimeChannel
+{
+    /// フレーム全体の時間（Time::unscaledDeltaTimeと同じ、前のフレームの開始からの実時間）
+    FrameTimeChannelFrame,
+
+    /// Update()の実行にかかったCPU時間（Update()内で行われたエンコードの時間は含みません）
+    FrameTimeChannelUpdate,
+
+    /// 描画コマンドのエンコードにかかったCPU時間
+    FrameTimeChannelEncode,
+
+    /// ドローアブルの表示の登録とコマンドバッファのコミットにかかったCPU時間
+    FrameTimeChannelCommit,
+
+    /// 対象の個数
+    FrameTimeChannelCount,
+};
+
+
+/// ある対象の、直近のフレームでの時間の統計です。時間はすべて秒単位です。
+struct FrameTimeSummary
+{
+    /// 集計したフレーム数
+    int     sampleCount;
+
+    /// 最小値
+    double  min;
+
+    /// 最大値
+    double  max;
+
+    /// 平均値
+    double  mean;
+
+    /// 50パーセンタイル（中央値）
+    double  p50;
+
+    /// 95パーセンタイル
+    double  p95;
+
+    /// 99パーセンタイル
+    double  p99;
+
+    /// 引っかかり（フレームの予算の2倍を超えたフレーム）の数
+    int     hitchCount;
+};
+
+
+/// 直近の一定数のフレームの時間の分布を、固定サイズのメモリで集計するクラスです。
+/// 値は2の冪ごとの区間を16等分したバケット（HDRヒストグラムと同じ形式）で数えるので、パーセンタイルの相対誤差は最大で約3%です。
+/// 記録のたびにメモリを確保することはなく、記録はO(1)で行えます。
+class FrameTimeHistogram
+{
+public:
+    /// 集計するフレーム数（ローリングウィンドウの大きさ）
+    static const int    kWindowSize = 600;
+
+    /// バケットの数（1マイクロ秒〜約268秒を表せます）
+    static const int    kBucketCount = 400;
+
+public:
+    FrameTimeHistogram();
+
+    /// 記録した値をすべて破棄します。
+    void    Clear();
+
+    /// 時間（秒）を記録します。kWindowSizeを超えた場合は、最も古い値が集計から外れます。
+    void    Record(double seconds);
+
+    /// 集計しているフレーム数を取得します。
+    int     Count() const;
+
+    /// 指定したパーセンタイル（0〜100）の値を取得します。値はバケットの中央の値になります。
+    double  Percentile(double percent) const;
+
+    /// 集計しているフレームの統計をまとめて取得します。最小値・最大値・平均値は記録された値そのものから求めます。
+    FrameTimeSummary    Summarize(double hitchThreshold) const;
+
+    /// 時間（秒）を格納するバケットの番号を取得します。
+    static int      BucketOf(double seconds);
+
+    /// バケットの中央の時間（秒）を取得します。
+    static double   BucketValue(int bucket);
+
+private:
+    uint32_t    counts[kBucketCount];
+    float       window[kWindowSize];
+    int         head;
+    int         count;
+
+};
+
+
+/// このフレームの各対象の時間を記録します。レンダラがフレームの終わりに呼び出します。
+void    __RecordFrameTimes(double frameTime, double updateTime, double encodeTime, double commitTime);
+
+/// 直近のフレーム（最大FrameTimeHistogram::kWindowSizeフレーム）での、指定した対象の時間の統計を取得します。
+FrameTimeSummary    GetFrameTimeSummary(FrameTimeChannel channel);
+
+/// 記録済みのフレーム時間の統計をすべて破棄します。
+void    ResetFrameTimeStats();
+
+/// 1フレームの予算（秒）を設定します。予算の2倍を超えたフレームは引っかかりとして数えられます。デフォルト値は1/60秒です。
+void    SetFrameTimeBudget(double seconds);
+
+/// 1フレームの予算（秒）を取得します。
+double  GetFrameTimeBudget();
+
+/// フレーム時間の統計をログに出力する間隔（フレーム数）を設定します。0を指定すると出力しません（デフォルト）。
+void    SetFrameTimeLogInterval(int frameCount);
+
+/// フレーム時間の統計をログに出力する間隔（フレーム数）を取得します。
+int     GetFrameTimeLogInterval();
+
+/// すべての対象の統計を、ログに出力するための1行の文字列にまとめます（時間はミリ秒単位）。
+std::string     FormatFrameTimeStats();
+
+
+#endif /* FrameTimeStats_hpp */
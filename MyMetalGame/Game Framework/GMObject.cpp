@@ -8,6 +8,7 @@
 
 #include "GMObject.hpp"
 #include "StringSupport.hpp"
+#include <cstring>
 
 
 static char sDebugStr[256];
@@ -18,7 +18,9 @@
 #include <map>
 #include <string>
 #include <vector>
+#if defined(__APPLE__)
 #include <os/log.h>
+#endif
 
 // Types, Math, System
 #include "Types.hpp"
@@ -28,9 +30,16 @@
 #include "DebugSupport.hpp"
 #include "StringSupport.hpp"
 #include "Time.hpp"
+#include "JobSystem.hpp"
+#include "Coroutine.hpp"
+#include "TimerService.hpp"
+#include "Tween.hpp"
 
 // Graphics
 #include "SimpleDraw.hpp"
+#include "DrawStats.hpp"
+#include "FrameCapture.hpp"
+#include "FrameTimeStats.hpp"
 
 
 using namespace std;
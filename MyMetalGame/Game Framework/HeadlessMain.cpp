@@ -0,0 +1,251 @@
+//
+//  HeadlessMain.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+// ウィンドウを開かずにゲームを決まったフレーム数だけ実行して、フレームごとのCPU時間と描画統計を出力するホストです。
+//
+//     headless [--frames N] [--dt SECONDS] [--seed N] [--warmup N] [--scene NAME] [--workers N] [--record FILE] [--replay FILE] [--quiet]
+//
+// 1フレームの時間はTime::captureDeltaTimeで固定し、乱数シードはStart()の前に設定するので、同じ引数で実行すれば毎回同じフレームが再現されます。
+// --replayを指定すると、アプリで -RecordInput を指定して記録したプレイの入力・経過時間・乱数シードで実行します。
+// --sceneを指定すると、Start()の前にゲーム側のSelectHeadlessScene()にその名前が渡されます（Tests/BenchmarkScenes.cpp のベンチマークなど）。
+// --workersを指定すると、Start()の前にその数のワーカースレッドでジョブシステムを開始するので、ParallelFor()を使う処理の並列化の効果を比べられます。
+// 計測結果の要約では、最初の--warmupフレームを除いた残りのフレームを集計します。
+
+#include "HeadlessRenderer.hpp"
+#include "DrawStats.hpp"
+#include "Random.hpp"
+#include "Time.hpp"
+#include "InputRecording.hpp"
+#include "JobSystem.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+void Start();
+
+/// ゲーム側でSelectHeadlessScene()を定義しなかった場合に使われる、シーンを持たないデフォルトの実装
+__attribute__((weak)) bool SelectHeadlessScene(const char *)
+{
+    return false;
+}
+
+
+/// ヘッドレスの実行の設定
+struct HeadlessOptions
+{
+    int         frameCount;
+    float       deltaTime;
+    unsigned    seed;
+    int         warmupFrameCount;
+    std::string sceneName;
+    int         workerCount;
+    std::string recordPath;
+    std::string replayPath;
+    bool        isQuiet;
+};
+
+static void PrintUsage(const char *programName)
+{
+    fprintf(stderr, "usage: %s [--frames N] [--dt SECONDS] [--seed N] [--warmup N] [--scene NAME] [--workers N] [--record FILE] [--replay FILE] [--quiet]\n", programName);
+    fprintf(stderr, "  --frames N      実行するフレーム数（デフォルト: 600。--replayでは記録されたフレーム数）\n");
+    fprintf(stderr, "  --dt SECONDS    1フレームの時間（デフォルト: 1/60）\n");
+    fprintf(stderr, "  --seed N        乱数シード（デフォルト: 1）\n");
+    fprintf(stderr, "  --warmup N      要約から除く最初のフレーム数（デフォルト: 10。フレーム数より少なくなるように切り詰められる）\n");
+    fprintf(stderr, "  --scene NAME    ゲームが用意しているシーンの名前（SelectHeadlessScene()に渡される）\n");
+    fprintf(stderr, "  --workers N     ジョブシステムのワーカースレッドの数（0はメインスレッドだけ。デフォルト: CPUのコア数 - 1）\n");
+    fprintf(stderr, "  --record FILE   入力と経過時間をファイルに記録する\n");
+    fprintf(stderr, "  --replay FILE   記録された入力と経過時間、乱数シードで実行する（--dtと--seedは無視される）\n");
+    fprintf(stderr, "  --quiet         フレームごとの行を出力せず、要約だけを出力する\n");
+}
+
+static bool ParseOptions(int argc, const char *argv[], HeadlessOptions& options)
+{
+    options.frameCount = 0;
+    options.deltaTime = 1.0f / 60;
+    options.seed = 1;
+    options.warmupFrameCount = 10;
+    options.workerCount = -1;
+    options.isQuiet = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc)? argv[i + 1]: nullptr;
+        if (strcmp(arg, "--quiet") == 0) {
+            options.isQuiet = true;
+            continue;
+        }
+        if (!value) {
+            return false;
+        }
+        if (strcmp(arg, "--frames") == 0) {
+            options.frameCount = atoi(value);
+        } else if (strcmp(arg, "--dt") == 0) {
+            options.deltaTime = (float)atof(value);
+        } else if (strcmp(arg, "--seed") == 0) {
+            options.seed = (unsigned)strtoul(value, nullptr, 10);
+        } else if (strcmp(arg, "--warmup") == 0) {
+            options.warmupFrameCount = atoi(value);
+        } else if (strcmp(arg, "--scene") == 0) {
+            options.sceneName = value;
+        } else if (strcmp(arg, "--workers") == 0) {
+            options.workerCount = atoi(value);
+            if (options.workerCount < 0) {
+                return false;
+            }
+        } else if (strcmp(arg, "--record") == 0) {
+            options.recordPath = value;
+        } else if (strcmp(arg, "--replay") == 0) {
+            options.replayPath = value;
+        } else {
+            return false;
+        }
+        i++;
+    }
+    return (options.frameCount >= 0 && options.deltaTime > 0.0f && options.warmupFrameCount >= 0);
+}
+
+/// ソート済みの値から、指定したパーセンタイルの値を取得する（最も近い順位の値）
+static double GetPercentile(const std::vector<double>& sortedValues, double percent)
+{
+    size_t rank = (size_t)(percent / 100.0 * (sortedValues.size() - 1) + 0.5);
+    return sortedValues[std::min(rank, sortedValues.size() - 1)];
+}
+
+static void PrintTimeSummary(const char *name, std::vector<double>& values)
+{
+    double sum = 0.0;
+    for (double value : values) {
+        sum += value;
+    }
+    std::sort(values.begin(), values.end());
+    printf("%-8s mean %8.3f  p50 %8.3f  p95 %8.3f  p99 %8.3f  max %8.3f  (ms)\n", name,
+           sum / values.size() * 1000.0, GetPercentile(values, 50) * 1000.0, GetPercentile(values, 95) * 1000.0,
+           GetPercentile(values, 99) * 1000.0, values.back() * 1000.0);
+}
+
+int main(int argc, const char *argv[])
+{
+    HeadlessOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    // Renderer.mmの -CaptureSeed と -CaptureDeltaTime と同じように、Start()の前に乱数と時間を固定する
+    Random::SetSeed(options.seed);
+    Time::captureDeltaTime = options.deltaTime;
+
+    // 再生する場合は、記録された乱数シードと経過時間で上書きされる。フレーム数を省略した場合は、記録されたフレームをすべて再生する。
+    if (!options.replayPath.empty()) {
+        int replayFrameCount = StartInputReplay(options.replayPath);
+        if (options.frameCount == 0) {
+            options.frameCount = replayFrameCount;
+        }
+    }
+    if (options.frameCount == 0) {
+        options.frameCount = 600;
+    }
+
+    // 要約に少なくとも1フレームは残るように、ウォームアップのフレーム数を実行するフレーム数より少なくする
+    if (options.warmupFrameCount >= options.frameCount) {
+        int warmupFrameCount = options.frameCount - 1;
+        fprintf(stderr, "%s: --warmup %d is not less than the frame count %d; using %d warmup frames\n",
+                argv[0], options.warmupFrameCount, options.frameCount, warmupFrameCount);
+        options.warmupFrameCount = warmupFrameCount;
+    }
+    if (!options.recordPath.empty()) {
+        StartInputRecording(options.recordPath);
+    }
+
+    if (!options.sceneName.empty() && !SelectHeadlessScene(options.sceneName.c_str())) {
+        fprintf(stderr, "%s: unknown scene \"%s\"\n", argv[0], options.sceneName.c_str());
+        return 1;
+    }
+
+    if (options.workerCount >= 0) {
+        InitJobSystem(options.workerCount);
+    }
+
+    InitHeadlessRenderer();
+    Start();
+
+    if (!options.isQuiet) {
+        printf("frame\tframe_ms\tupdate_ms\tencode_ms\ttriangles\tvertices\tculled\tdraws\tflushes\tswitches\tbytes\n");
+    }
+
+    std::vector<double> frameTimes;
+    std::vector<double> updateTimes;
+    std::vector<double> encodeTimes;
+    DrawStats total;
+    total.Reset();
+    double totalFrameTime = 0.0;
+    size_t peakVertexBufferBytes = 0;
+
+    for (int i = 0; i < options.frameCount; i++) {
+        double frameTime = RunHeadlessFrame();
+        const DrawStats& stats = GetLastDrawStats();
+
+        if (!options.isQuiet) {
+            printf("%d\t%.3f\t%.3f\t%.3f\t%u\t%u\t%u\t%u\t%u\t%u\t%zu\n", stats.frameCount,
+                   frameTime * 1000.0, stats.updateTime * 1000.0, stats.encodeTime * 1000.0,
+                   stats.triangleCount, stats.vertexCount, stats.culledTriangleCount,
+                   stats.drawCallCount, stats.flushCount, stats.pipelineSwitchCount, stats.bytesWritten);
+        }
+        if (i < options.warmupFrameCount) {
+            continue;
+        }
+
+        frameTimes.push_back(frameTime);
+        totalFrameTime += frameTime;
+        updateTimes.push_back(stats.updateTime);
+        encodeTimes.push_back(stats.encodeTime);
+        total.triangleCount += stats.triangleCount;
+        total.culledTriangleCount += stats.culledTriangleCount;
+        total.drawCallCount += stats.drawCallCount;
+        total.flushCount += stats.flushCount;
+        total.pipelineSwitchCount += stats.pipelineSwitchCount;
+        total.bytesWritten += stats.bytesWritten;
+        peakVertexBufferBytes = std::max(peakVertexBufferBytes, stats.peakVertexBufferBytes);
+    }
+
+    StopInputRecording();
+
+    // 要約は、フレームごとの行と区別できるように先頭に#を付けて出力する
+    int count = (int)frameTimes.size();
+    if (options.replayPath.empty()) {
+        printf("# %d frames (dt %.6f s, seed %u, %d warmup frames skipped)\n", count, options.deltaTime, options.seed,
+               options.frameCount - count);
+    } else {
+        printf("# %d frames (replay %s, %d warmup frames skipped)\n", count, options.replayPath.c_str(), options.frameCount - count);
+    }
+    if (options.workerCount >= 0) {
+        printf("# %d job worker threads\n", GetJobWorkerCount());
+    }
+    if (count == 0) {
+        return 0;
+    }
+    printf("# ");
+    PrintTimeSummary("frame", frameTimes);
+    printf("# ");
+    PrintTimeSummary("update", updateTimes);
+    printf("# ");
+    PrintTimeSummary("encode", encodeTimes);
+    printf("# per frame: triangles %.1f  culled %.1f  draws %.1f  flushes %.1f  switches %.1f  bytes %.0f\n",
+           (double)total.triangleCount / count, (double)total.culledTriangleCount / count, (double)total.drawCallCount / count,
+           (double)total.flushCount / count, (double)total.pipelineSwitchCount / count, (double)total.bytesWritten / count);
+    if (total.triangleCount > 0) {
+        printf("# throughput: %.0f triangles/s\n", (double)total.triangleCount / totalFrameTime);
+    }
+    printf("# peak vertex buffer usage: %zu / %zu bytes (%.1f%%)\n", peakVertexBufferBytes, GetLastDrawStats().vertexBufferCapacity,
+           100.0 * peakVertexBufferBytes / GetLastDrawStats().vertexBufferCapacity);
+    return 0;
+}
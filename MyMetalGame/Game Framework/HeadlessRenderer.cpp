@@ -0,0 +1,177 @@
+//
+//  HeadlessRenderer.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "HeadlessRenderer.hpp"
+#include "RenderBackend.hpp"
+#include "Settings.hpp"
+#include "StaticMesh2D.hpp"
+#include "ImageFile.hpp"
+#include <chrono>
+#include <vector>
+#include "DebugSupport.hpp"
+#include "StringSupport.hpp"
+
+
+// バッチの組み立てと描画統計はBatchRenderer.cppがRenderer.mmと共通の処理で行い、このファイルはGPUを使わないバックエンドを実装する。
+// エンコードされたパスやパイプラインの切り替えはGPUに送らずに捨てるので、描画結果のピクセルはない。
+
+// GPUに送る代わりに書き込むだけの頂点バッファとインデックスバッファ（大きさはRenderer.mmと同じ）
+static std::vector<char>        sVertexBuffer;
+static std::vector<uint16_t>    sIndexBuffer;
+
+// ビューの大きさ（Main.storyboardのビューと同じ）。クリップ矩形からシザー矩形を求めるときに使われる。
+static const float  kViewWidth = 800.0f;
+static const float  kViewHeight = 600.0f;
+
+
+bool __BackendEncodeClear(const Color&)
+{
+    return true;
+}
+
+bool __BackendBeginPass(const char *)
+{
+    return true;
+}
+
+void __BackendEndPass()
+{
+    // Do nothing
+}
+
+void __BackendGetViewSize(float& outWidth, float& outHeight)
+{
+    outWidth = kViewWidth;
+    outHeight = kViewHeight;
+}
+
+void __BackendSetScissorRect(int, int, int, int)
+{
+    // Do nothing
+}
+
+void __BackendSetPipeline(PipelineShader, BlendMode, PipelineVertexLayout)
+{
+    // Do nothing
+}
+
+void __BackendSetTexture(unsigned)
+{
+    // Do nothing
+}
+
+void __BackendWriteUniforms2D(int, const Matrix4x4&)
+{
+    // Do nothing
+}
+
+void __BackendDrawIndexedTriangles(size_t, size_t, uint32_t)
+{
+    // Do nothing
+}
+
+void __BackendDrawTriangles(size_t, uint32_t)
+{
+    // Do nothing
+}
+
+void __BackendDrawInstances(size_t, uint32_t, uint32_t, int)
+{
+    // Do nothing
+}
+
+void __BackendDrawStaticMesh(int, const Transform2D&, const Color&, uint32_t)
+{
+    // Do nothing
+}
+
+void __BackendUploadStaticMesh(int, StaticMesh2D&, bool)
+{
+    // 転送するバイト数は、BatchRenderer.cppが描画統計に数える
+}
+
+void __BackendReleaseStaticMesh(int)
+{
+    // Do nothing
+}
+
+void __BackendCreateRenderTarget(int, int, int)
+{
+    // Do nothing
+}
+
+void __BackendReleaseRenderTarget(int)
+{
+    // Do nothing
+}
+
+void __BackendSetRenderTarget(int)
+{
+    // Do nothing
+}
+
+void __BackendPrewarmPipelines(const std::vector<BlendMode>&)
+{
+    // Do nothing
+}
+
+void __BackendCreateAtlasPage(int, int)
+{
+    // Do nothing
+}
+
+void __BackendUploadAtlasRegion(const AtlasRegion&, const uint8_t *)
+{
+    // Do nothing
+}
+
+/// PNGとPPMに対応する（ファイルはカレントディレクトリから探す）
+bool __BackendDecodeImage(const std::string& name, std::vector<uint8_t>& outPixels, int& outWidth, int& outHeight)
+{
+    RGBA8Image image;
+    std::string path = GetFilepath(name);
+    if (path.length() == 0 || !ReadImageFile(path, image)) {
+        return false;
+    }
+    outPixels.swap(image.pixels);
+    outWidth = image.width;
+    outHeight = image.height;
+    return true;
+}
+
+/// ヘッドレスのビルドにはCaptureFrame()とCaptureFrameAndCompare()を含めないので、ここが呼ばれることはない
+void __BackendAddFrameCapture(const FrameCaptureRequest& request)
+{
+    AbortGame("ヘッドレスの実行では描画結果がないため、フレームをキャプチャできません。（%s）",
+              request.path.empty()? request.goldenPath.c_str(): request.path.c_str());
+}
+
+void __BackendSubmitFrame()
+{
+    // Do nothing
+}
+
+void __BackendEndFrame()
+{
+    // Do nothing
+}
+
+
+void InitHeadlessRenderer()
+{
+    sVertexBuffer.assign(sizeof(BatchVertex) * METAL_MAX_POLYGON_COUNT * 3, 0);
+    sIndexBuffer.assign(METAL_MAX_POLYGON_COUNT * 3, 0);
+    __InitBatchRenderer(sVertexBuffer.data(), sVertexBuffer.size(), sIndexBuffer.data(), sizeof(uint16_t) * sIndexBuffer.size());
+}
+
+double RunHeadlessFrame()
+{
+    auto startTime = std::chrono::steady_clock::now();
+    __RunFrame();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
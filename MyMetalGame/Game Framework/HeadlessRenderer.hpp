@@ -0,0 +1,33 @@
+//
+//  HeadlessRenderer.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef HeadlessRenderer_hpp
+#define HeadlessRenderer_hpp
+
+
+// ウィンドウもGPUも使わずに、Start()とUpdate()を実行するためのレンダラです。
+// バッチの組み立てと描画統計（DrawStats）はRenderer.mmと同じBatchRenderer.cppで行い、CPU側の頂点バッファに書き込みますが、GPUには何も送りません。
+// そのため、ゲームの処理とバッチ処理の性能をLinuxなどの環境で計測できます。描画結果のピクセルはないので、CaptureFrame()は使えません。
+// このファイルと HeadlessRenderer.cpp、HeadlessTextDraw.cpp、HeadlessMain.cpp はアプリのターゲットには含めず、
+// Renderer.mm、TextDraw.mm、main.m の代わりにリンクして使います（ビルドの方法は README.md を参照してください）。
+
+
+/// ヘッドレスのレンダラを初期化します。Start()を呼び出す前に1回だけ呼び出してください。
+void    InitHeadlessRenderer();
+
+/// 1フレーム分の処理を行います。入力と時間を更新し、FixedUpdate()とUpdate()を実行して、記録された描画をバッチにまとめます。
+/// パイプライン化した更新では、Renderer.mmと同じようにシミュレーションのスレッドで次のフレームの更新を並行して進めます。
+/// フレームの統計はGetLastDrawStats()で取得できます。戻り値は、このフレームの処理全体にかかったCPU時間（秒）です。
+double  RunHeadlessFrame();
+
+/// ヘッドレスのランナーの --scene で指定された名前を受け取り、Start()の前に、実行するシーンを選びます。
+/// ゲーム側で定義しなかった場合は、どの名前も受け付けないデフォルトの実装が使われます。知らない名前が指定された場合はfalseを返してください。
+bool    SelectHeadlessScene(const char *name);
+
+
+#endif /* HeadlessRenderer_hpp */
@@ -0,0 +1,123 @@
+//
+//  HeadlessTextDraw.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "SimpleDraw.hpp"
+#include "TextLayout.hpp"
+#include "DebugSupport.hpp"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+
+/// ヘッドレスの実行で使う、CoreTextの代わりに固定の寸法のグリフを返すGlyphSourceの実装。
+/// 文字はすべて箱の形にして（幅は全角の文字が1文字分、それ以外は半角分）、初めて使われたときにアトラスに詰め込む。
+/// 描画される四角形の数とアトラスの使い方はTextDraw.mmとほぼ同じになるので、文字の描画を含むバッチ処理の計測に使える。
+class HeadlessGlyphSource : public GlyphSource
+{
+public:
+    explicit HeadlessGlyphSource(float pixelSize)
+        : pixelSize(pixelSize)
+    {
+        lineHeight = ceilf(pixelSize * 1.2f);
+    }
+
+    const GlyphMetrics& GetGlyph(uint32_t codePoint) override
+    {
+        auto it = glyphs.find(codePoint);
+        if (it != glyphs.end()) {
+            return it->second;
+        }
+        GlyphMetrics& metrics = glyphs[codePoint];
+        Rasterize(codePoint, metrics);
+        return metrics;
+    }
+
+    float LineHeight() const override
+    {
+        return lineHeight;
+    }
+
+    float PixelSize() const
+    {
+        return pixelSize;
+    }
+
+private:
+    void Rasterize(uint32_t codePoint, GlyphMetrics& metrics)
+    {
+        bool isWide = (codePoint >= 0x1100);
+        metrics.image = AtlasImage();
+        metrics.offsetX = 0.0f;
+        metrics.offsetY = 0.0f;
+        metrics.advance = isWide? pixelSize: pixelSize / 2;
+
+        // 空白と制御文字は、画像のない文字にする
+        if (codePoint <= 0x20 || codePoint == 0x3000) {
+            return;
+        }
+
+        int width = std::max((int)ceilf(metrics.advance), 1) + 2;
+        int height = (int)ceilf(pixelSize) + 2;
+        std::vector<uint8_t> pixels((size_t)width * height * 4, 255);
+        metrics.image = CreateImage(pixels.data(), width, height);
+        metrics.offsetX = -1.0f;
+        metrics.offsetY = -ceilf(pixelSize * 0.2f) - 1.0f;
+    }
+
+    float       pixelSize;
+    float       lineHeight;
+    std::unordered_map<uint32_t, GlyphMetrics>  glyphs;
+
+};
+
+
+static std::vector<HeadlessGlyphSource *>   sFonts;
+static TextLayoutCache                      sTextLayoutCache;
+
+
+int LoadFont(const std::string& name, float pixelSize)
+{
+    // フォントファイルは読み込まず、名前に関係なく同じ寸法のフォントとして扱う
+    if (pixelSize <= 0.0f) {
+        AbortGame("フォント\"%s\"の大きさが不正です。（%f）", name.c_str(), pixelSize);
+    }
+    sFonts.push_back(new HeadlessGlyphSource(pixelSize));
+    return (int)sFonts.size() - 1;
+}
+
+static HeadlessGlyphSource *GetFont(int fontID)
+{
+    if (fontID < 0 || fontID >= (int)sFonts.size()) {
+        AbortGame("無効なフォントのIDが指定されました。（ID: %d）", fontID);
+    }
+    return sFonts[fontID];
+}
+
+void DrawText(int fontID, const std::string& text, const Vector2& position, float size, const Color& color)
+{
+    HeadlessGlyphSource *font = GetFont(fontID);
+    const TextLayout& layout = sTextLayoutCache.Get(text, fontID, *font);
+
+    float scale = size / font->PixelSize();
+    Game::Rect uvRect(0.0f, 0.0f, 1.0f, 1.0f);
+    SpriteVertex vertices[4];
+    for (const LaidOutGlyph& glyph : layout.glyphs) {
+        Game::Rect destRect(position.x + glyph.x * scale, position.y + glyph.y * scale, glyph.image.width * scale, glyph.image.height * scale);
+        MakeSpriteQuad(glyph.image, uvRect, destRect, color, vertices);
+        DrawSpriteQuad(glyph.image.textureID, vertices);
+    }
+}
+
+Vector2 MeasureText(int fontID, const std::string& text, float size)
+{
+    HeadlessGlyphSource *font = GetFont(fontID);
+    const TextLayout& layout = sTextLayoutCache.Get(text, fontID, *font);
+    float scale = size / font->PixelSize();
+    return Vector2(layout.width * scale, font->LineHeight() * layout.lineCount * scale);
+}
@@ -0,0 +1,662 @@
+//
+//  ImageFile.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "ImageFile.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+static const uint8_t    kPNGSignature[8] = { 0x89, 'P', 'N', 'G', 0x0d, 0x0a, 0x1a, 0x0a };
+static const size_t     kMaxStoredBlockSize = 0xffff;
+
+
+RGBA8Image::RGBA8Image()
+    : width(0), height(0)
+{
+    // Do nothing
+}
+
+void RGBA8Image::Resize(int width_, int height_)
+{
+    width = width_;
+    height = height_;
+    pixels.assign((size_t)width * height * 4, 0);
+}
+
+void RGBA8Image::CopyFromBGRA8(const uint8_t *bgra, int width_, int height_, size_t bytesPerRow)
+{
+    Resize(width_, height_);
+    for (int y = 0; y < height; y++) {
+        const uint8_t *src = bgra + bytesPerRow * y;
+        uint8_t *dst = pixels.data() + (size_t)width * 4 * y;
+        for (int x = 0; x < width; x++) {
+            dst[0] = src[2];
+            dst[1] = src[1];
+            dst[2] = src[0];
+            dst[3] = src[3];
+            src += 4;
+            dst += 4;
+        }
+    }
+}
+
+
+#pragma mark - チェックサム
+
+static uint32_t UpdateCRC32(uint32_t crc, const uint8_t *data, size_t size)
+{
+    static uint32_t table[256];
+    static bool isTableReady = false;
+    if (!isTableReady) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1)? (0xedb88320U ^ (c >> 1)): (c >> 1);
+            }
+            table[i] = c;
+        }
+        isTableReady = true;
+    }
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static uint32_t UpdateAdler32(uint32_t adler, const uint8_t *data, size_t size)
+{
+    uint32_t a = adler & 0xffff;
+    uint32_t b = adler >> 16;
+    while (size > 0) {
+        // 5552バイトまでは剰余を取らなくても32ビットに収まる
+        size_t n = (size < 5552)? size: 5552;
+        size -= n;
+        while (n-- > 0) {
+            a += *data++;
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+static void AppendUInt32BE(std::vector<uint8_t>& data, uint32_t value)
+{
+    data.push_back((uint8_t)(value >> 24));
+    data.push_back((uint8_t)(value >> 16));
+    data.push_back((uint8_t)(value >> 8));
+    data.push_back((uint8_t)value);
+}
+
+static uint32_t ReadUInt32BE(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+
+#pragma mark - inflate
+
+/// deflateのハフマン符号表（符号長ごとの個数と、符号の順に並べたシンボル）
+struct Huffman
+{
+    uint16_t    counts[16];
+    uint16_t    symbols[288];
+};
+
+/// zlibストリームを展開するための、ビット単位の読み込み状態
+struct InflateState
+{
+    const uint8_t   *data;
+    size_t          size;
+    size_t          pos;
+    uint32_t        bitBuffer;
+    int             bitCount;
+    bool            isError;
+    std::vector<uint8_t>    *out;
+
+    int Bits(int need)
+    {
+        uint32_t value = bitBuffer;
+        while (bitCount < need) {
+            if (pos >= size) {
+                isError = true;
+                return 0;
+            }
+            value |= (uint32_t)data[pos++] << bitCount;
+            bitCount += 8;
+        }
+        bitBuffer = value >> need;
+        bitCount -= need;
+        return (int)(value & ((1U << need) - 1));
+    }
+
+    int Decode(const Huffman& h)
+    {
+        // 符号長の短い順に、その長さの符号の範囲に入っているかを調べる（RFC 1951のpuffと同じ方式）
+        int code = 0;
+        int first = 0;
+        int index = 0;
+        for (int len = 1; len < 16; len++) {
+            code |= Bits(1);
+            if (isError) {
+                return -1;
+            }
+            int count = h.counts[len];
+            if (code - count < first) {
+                return h.symbols[index + (code - first)];
+            }
+            index += count;
+            first += count;
+            first <<= 1;
+            code <<= 1;
+        }
+        isError = true;
+        return -1;
+    }
+};
+
+static bool BuildHuffman(Huffman& h, const uint8_t *lengths, int n)
+{
+    memset(h.counts, 0, sizeof(h.counts));
+    for (int i = 0; i < n; i++) {
+        h.counts[lengths[i]]++;
+    }
+    if (h.counts[0] == n) {
+        return true;
+    }
+
+    int left = 1;
+    for (int len = 1; len < 16; len++) {
+        left <<= 1;
+        left -= h.counts[len];
+        if (left < 0) {
+            return false;
+        }
+    }
+
+    uint16_t offsets[16];
+    offsets[1] = 0;
+    for (int len = 1; len < 15; len++) {
+        offsets[len + 1] = offsets[len] + h.counts[len];
+    }
+    for (int i = 0; i < n; i++) {
+        if (lengths[i] != 0) {
+            h.symbols[offsets[lengths[i]]++] = (uint16_t)i;
+        }
+    }
+    return true;
+}
+
+static bool InflateCodes(InflateState& s, const Huffman& lengthCodes, const Huffman& distanceCodes)
+{
+    static const uint16_t kLengthBase[29] = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    static const uint16_t kLengthExtra[29] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    static const uint16_t kDistanceBase[30] = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+        4097, 6145, 8193, 12289, 16385, 24577 };
+    static const uint16_t kDistanceExtra[30] = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+    std::vector<uint8_t>& out = *s.out;
+    while (true) {
+        int symbol = s.Decode(lengthCodes);
+        if (symbol < 0) {
+            return false;
+        }
+        if (symbol < 256) {
+            out.push_back((uint8_t)symbol);
+        } else if (symbol == 256) {
+            return true;
+        } else {
+            symbol -= 257;
+            if (symbol >= 29) {
+                return false;
+            }
+            int length = kLengthBase[symbol] + s.Bits(kLengthExtra[symbol]);
+            int distanceSymbol = s.Decode(distanceCodes);
+            if (distanceSymbol < 0 || distanceSymbol >= 30) {
+                return false;
+            }
+            size_t distance = kDistanceBase[distanceSymbol] + s.Bits(kDistanceExtra[distanceSymbol]);
+            if (s.isError || distance > out.size()) {
+                return false;
+            }
+            size_t from = out.size() - distance;
+            for (int i = 0; i < length; i++) {
+                out.push_back(out[from + i]);
+            }
+        }
+    }
+}
+
+static bool InflateDynamic(InflateState& s)
+{
+    static const uint8_t kOrder[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+    int lengthCount = s.Bits(5) + 257;
+    int distanceCount = s.Bits(5) + 1;
+    int codeCount = s.Bits(4) + 4;
+    if (s.isError || lengthCount > 286 || distanceCount > 30) {
+        return false;
+    }
+
+    uint8_t lengths[320] = {};
+    for (int i = 0; i < codeCount; i++) {
+        lengths[kOrder[i]] = (uint8_t)s.Bits(3);
+    }
+    Huffman codeLengthCodes;
+    if (!BuildHuffman(codeLengthCodes, lengths, 19)) {
+        return false;
+    }
+
+    int index = 0;
+    while (index < lengthCount + distanceCount) {
+        int symbol = s.Decode(codeLengthCodes);
+        if (symbol < 0) {
+            return false;
+        }
+        if (symbol < 16) {
+            lengths[index++] = (uint8_t)symbol;
+            continue;
+        }
+        uint8_t value = 0;
+        int repeat;
+        if (symbol == 16) {
+            if (index == 0) {
+                return false;
+            }
+            value = lengths[index - 1];
+            repeat = 3 + s.Bits(2);
+        } else if (symbol == 17) {
+            repeat = 3 + s.Bits(3);
+        } else {
+            repeat = 11 + s.Bits(7);
+        }
+        if (index + repeat > lengthCount + distanceCount) {
+            return false;
+        }
+        while (repeat-- > 0) {
+            lengths[index++] = value;
+        }
+    }
+
+    Huffman lengthCodes;
+    Huffman distanceCodes;
+    if (!BuildHuffman(lengthCodes, lengths, lengthCount) || !BuildHuffman(distanceCodes, lengths + lengthCount, distanceCount)) {
+        return false;
+    }
+    return InflateCodes(s, lengthCodes, distanceCodes);
+}
+
+static bool InflateFixed(InflateState& s)
+{
+    static Huffman lengthCodes;
+    static Huffman distanceCodes;
+    static bool isReady = false;
+    if (!isReady) {
+        uint8_t lengths[288];
+        for (int i = 0; i < 144; i++) {
+            lengths[i] = 8;
+        }
+        for (int i = 144; i < 256; i++) {
+            lengths[i] = 9;
+        }
+        for (int i = 256; i < 280; i++) {
+            lengths[i] = 7;
+        }
+        for (int i = 280; i < 288; i++) {
+            lengths[i] = 8;
+        }
+        BuildHuffman(lengthCodes, lengths, 288);
+        for (int i = 0; i < 30; i++) {
+            lengths[i] = 5;
+        }
+        BuildHuffman(distanceCodes, lengths, 30);
+        isReady = true;
+    }
+    return InflateCodes(s, lengthCodes, distanceCodes);
+}
+
+static bool InflateStored(InflateState& s)
+{
+    // ブロックの先頭はバイト境界に揃っている
+    s.bitBuffer = 0;
+    s.bitCount = 0;
+    if (s.pos + 4 > s.size) {
+        return false;
+    }
+    size_t length = s.data[s.pos] | (s.data[s.pos + 1] << 8);
+    size_t complement = s.data[s.pos + 2] | (s.data[s.pos + 3] << 8);
+    s.pos += 4;
+    if (length != (~complement & 0xffff) || s.pos + length > s.size) {
+        return false;
+    }
+    s.out->insert(s.out->end(), s.data + s.pos, s.data + s.pos + length);
+    s.pos += length;
+    return true;
+}
+
+/// zlib形式（RFC 1950）のストリームを展開する。
+static bool InflateZlib(const uint8_t *data, size_t size, std::vector<uint8_t>& out)
+{
+    if (size < 6 || (data[0] & 0x0f) != 8 || ((data[0] << 8) | data[1]) % 31 != 0 || (data[1] & 0x20)) {
+        return false;
+    }
+
+    InflateState s;
+    s.data = data;
+    s.size = size - 4;
+    s.pos = 2;
+    s.bitBuffer = 0;
+    s.bitCount = 0;
+    s.isError = false;
+    s.out = &out;
+
+    bool isLast = false;
+    while (!isLast) {
+        isLast = (s.Bits(1) != 0);
+        int type = s.Bits(2);
+        bool isSucceeded = false;
+        if (s.isError) {
+            return false;
+        } else if (type == 0) {
+            isSucceeded = InflateStored(s);
+        } else if (type == 1) {
+            isSucceeded = InflateFixed(s);
+        } else if (type == 2) {
+            isSucceeded = InflateDynamic(s);
+        }
+        if (!isSucceeded || s.isError) {
+            return false;
+        }
+    }
+    return (UpdateAdler32(1, out.data(), out.size()) == ReadUInt32BE(data + size - 4));
+}
+
+
+#pragma mark - PNG
+
+static void AppendChunk(std::vector<uint8_t>& data, const char *type, const uint8_t *body, size_t size)
+{
+    AppendUInt32BE(data, (uint32_t)size);
+    size_t typePos = data.size();
+    data.insert(data.end(), type, type + 4);
+    data.insert(data.end(), body, body + size);
+    AppendUInt32BE(data, UpdateCRC32(0, data.data() + typePos, size + 4));
+}
+
+void EncodePNG(const RGBA8Image& image, std::vector<uint8_t>& outData)
+{
+    outData.assign(kPNGSignature, kPNGSignature + 8);
+
+    uint8_t header[13];
+    for (int i = 0; i < 4; i++) {
+        header[i] = (uint8_t)(image.width >> (24 - i * 8));
+        header[4 + i] = (uint8_t)(image.height >> (24 - i * 8));
+    }
+    header[8] = 8;      // ビット深度
+    header[9] = 6;      // RGBA
+    header[10] = 0;     // deflate
+    header[11] = 0;     // アダプティブフィルタ
+    header[12] = 0;     // インターレースなし
+    AppendChunk(outData, "IHDR", header, sizeof(header));
+
+    // 各行の先頭にフィルタなし（0）を付けた生データ
+    size_t rowSize = (size_t)image.width * 4;
+    std::vector<uint8_t> raw;
+    raw.reserve((rowSize + 1) * image.height);
+    for (int y = 0; y < image.height; y++) {
+        raw.push_back(0);
+        raw.insert(raw.end(), image.pixels.begin() + rowSize * y, image.pixels.begin() + rowSize * (y + 1));
+    }
+
+    // 圧縮にかかる時間を読み戻しのたびに払わないように、無圧縮のブロックで格納する
+    std::vector<uint8_t> zlib;
+    zlib.reserve(raw.size() + raw.size() / kMaxStoredBlockSize * 5 + 16);
+    zlib.push_back(0x78);
+    zlib.push_back(0x01);
+    size_t pos = 0;
+    do {
+        size_t length = std::min(raw.size() - pos, kMaxStoredBlockSize);
+        bool isLast = (pos + length == raw.size());
+        zlib.push_back(isLast? 1: 0);
+        zlib.push_back((uint8_t)length);
+        zlib.push_back((uint8_t)(length >> 8));
+        zlib.push_back((uint8_t)~length);
+        zlib.push_back((uint8_t)(~length >> 8));
+        zlib.insert(zlib.end(), raw.begin() + pos, raw.begin() + pos + length);
+        pos += length;
+    } while (pos < raw.size());
+    AppendUInt32BE(zlib, UpdateAdler32(1, raw.data(), raw.size()));
+    AppendChunk(outData, "IDAT", zlib.data(), zlib.size());
+
+    AppendChunk(outData, "IEND", nullptr, 0);
+}
+
+static int PaethPredictor(int a, int b, int c)
+{
+    int p = a + b - c;
+    int pa = abs(p - a);
+    int pb = abs(p - b);
+    int pc = abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return (pb <= pc)? b: c;
+}
+
+bool DecodePNG(const uint8_t *data, size_t size, RGBA8Image& outImage)
+{
+    if (size < 8 || memcmp(data, kPNGSignature, 8) != 0) {
+        return false;
+    }
+
+    int width = 0;
+    int height = 0;
+    int channelCount = 0;
+    std::vector<uint8_t> zlib;
+    size_t pos = 8;
+    while (pos + 12 <= size) {
+        size_t length = ReadUInt32BE(data + pos);
+        const uint8_t *type = data + pos + 4;
+        const uint8_t *body = data + pos + 8;
+        if (pos + 12 + length > size) {
+            return false;
+        }
+        if (memcmp(type, "IHDR", 4) == 0) {
+            if (length != 13) {
+                return false;
+            }
+            width = (int)ReadUInt32BE(body);
+            height = (int)ReadUInt32BE(body + 4);
+            int bitDepth = body[8];
+            int colorType = body[9];
+            if (bitDepth != 8 || body[12] != 0) {
+                return false;
+            }
+            channelCount = (colorType == 0)? 1: (colorType == 2)? 3: (colorType == 6)? 4: 0;
+            if (channelCount == 0 || width <= 0 || height <= 0) {
+                return false;
+            }
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            zlib.insert(zlib.end(), body, body + length);
+        } else if (memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        pos += 12 + length;
+    }
+    if (channelCount == 0) {
+        return false;
+    }
+
+    std::vector<uint8_t> raw;
+    if (!InflateZlib(zlib.data(), zlib.size(), raw)) {
+        return false;
+    }
+    size_t rowSize = (size_t)width * channelCount;
+    if (raw.size() < (rowSize + 1) * height) {
+        return false;
+    }
+
+    // フィルタを戻す（前の行はフィルタを戻したあとの値を参照する）
+    std::vector<uint8_t> prevRow(rowSize, 0);
+    std::vector<uint8_t> row(rowSize);
+    outImage.Resize(width, height);
+    for (int y = 0; y < height; y++) {
+        const uint8_t *src = raw.data() + (rowSize + 1) * y;
+        int filter = src[0];
+        src++;
+        for (size_t i = 0; i < rowSize; i++) {
+            int a = (i >= (size_t)channelCount)? row[i - channelCount]: 0;
+            int b = prevRow[i];
+            int c = (i >= (size_t)channelCount)? prevRow[i - channelCount]: 0;
+            int value = src[i];
+            if (filter == 1) {
+                value += a;
+            } else if (filter == 2) {
+                value += b;
+            } else if (filter == 3) {
+                value += (a + b) / 2;
+            } else if (filter == 4) {
+                value += PaethPredictor(a, b, c);
+            } else if (filter != 0) {
+                return false;
+            }
+            row[i] = (uint8_t)value;
+        }
+
+        uint8_t *dst = outImage.pixels.data() + (size_t)width * 4 * y;
+        for (int x = 0; x < width; x++) {
+            const uint8_t *p = row.data() + x * channelCount;
+            dst[x * 4 + 0] = p[0];
+            dst[x * 4 + 1] = (channelCount >= 3)? p[1]: p[0];
+            dst[x * 4 + 2] = (channelCount >= 3)? p[2]: p[0];
+            dst[x * 4 + 3] = (channelCount == 4)? p[3]: 0xff;
+        }
+        prevRow.swap(row);
+    }
+    return true;
+}
+
+
+#pragma mark - ファイルの読み書き
+
+static bool HasExtension(const std::string& path, const char *extension)
+{
+    size_t length = strlen(extension);
+    if (path.size() < length) {
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        char c = path[path.size() - length + i];
+        if (c >= 'A' && c <= 'Z') {
+            c += 'a' - 'A';
+        }
+        if (c != extension[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool ReadPPM(const std::vector<uint8_t>& data, RGBA8Image& outImage)
+{
+    // ヘッダは "P6" の後に、空白またはコメントで区切られた幅・高さ・最大値が続く
+    size_t pos = 2;
+    int values[3];
+    for (int i = 0; i < 3; i++) {
+        while (pos < data.size() && (isspace(data[pos]) || data[pos] == '#')) {
+            if (data[pos] == '#') {
+                while (pos < data.size() && data[pos] != '\n') {
+                    pos++;
+                }
+            } else {
+                pos++;
+            }
+        }
+        int value = 0;
+        bool hasDigit = false;
+        while (pos < data.size() && data[pos] >= '0' && data[pos] <= '9') {
+            value = value * 10 + (data[pos++] - '0');
+            hasDigit = true;
+        }
+        if (!hasDigit) {
+            return false;
+        }
+        values[i] = value;
+    }
+    pos++;
+
+    int width = values[0];
+    int height = values[1];
+    if (width <= 0 || height <= 0 || values[2] != 255 || pos + (size_t)width * height * 3 > data.size()) {
+        return false;
+    }
+    outImage.Resize(width, height);
+    const uint8_t *src = data.data() + pos;
+    for (size_t i = 0; i < (size_t)width * height; i++) {
+        outImage.pixels[i * 4 + 0] = src[i * 3 + 0];
+        outImage.pixels[i * 4 + 1] = src[i * 3 + 1];
+        outImage.pixels[i * 4 + 2] = src[i * 3 + 2];
+        outImage.pixels[i * 4 + 3] = 0xff;
+    }
+    return true;
+}
+
+bool WriteImageFile(const RGBA8Image& image, const std::string& path)
+{
+    std::vector<uint8_t> data;
+    if (HasExtension(path, ".ppm")) {
+        char header[64];
+        int headerSize = snprintf(header, sizeof(header), "P6\n%d %d\n255\n", image.width, image.height);
+        data.assign(header, header + headerSize);
+        data.reserve(headerSize + (size_t)image.width * image.height * 3);
+        for (size_t i = 0; i < (size_t)image.width * image.height; i++) {
+            data.insert(data.end(), image.pixels.begin() + i * 4, image.pixels.begin() + i * 4 + 3);
+        }
+    } else {
+        EncodePNG(image, data);
+    }
+
+    FILE *fp = fopen(path.c_str(), "wb");
+    if (!fp) {
+        return false;
+    }
+    bool ret = (fwrite(data.data(), 1, data.size(), fp) == data.size());
+    ret = (fclose(fp) == 0) && ret;
+    return ret;
+}
+
+bool ReadImageFile(const std::string& path, RGBA8Image& outImage)
+{
+    FILE *fp = fopen(path.c_str(), "rb");
+    if (!fp) {
+        return false;
+    }
+    std::vector<uint8_t> data;
+    uint8_t buffer[65536];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), fp)) > 0) {
+        data.insert(data.end(), buffer, buffer + n);
+    }
+    fclose(fp);
+
+    if (data.size() >= 2 && data[0] == 'P' && data[1] == '6') {
+        return ReadPPM(data, outImage);
+    }
+    return DecodePNG(data.data(), data.size(), outImage);
+}
+
@@ -0,0 +1,55 @@
+//
+//  ImageFile.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef ImageFile_hpp
+#define ImageFile_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+/// RGBA8（1ピクセル4バイト、左上から行の順）で格納された画像です。
+struct RGBA8Image
+{
+    /// 幅（ピクセル）
+    int     width;
+
+    /// 高さ（ピクセル）
+    int     height;
+
+    /// ピクセルデータ（width * height * 4 バイト）
+    std::vector<uint8_t>    pixels;
+
+    /// 幅・高さが0の空の画像を作成します。
+    RGBA8Image();
+
+    /// 指定したサイズの画像を、すべて0で確保します。
+    void    Resize(int width, int height);
+
+    /// BGRA8で格納されたピクセルデータを、RGBA8に並べ替えながらコピーします。bytesPerRowは元のデータの1行のバイト数です。
+    void    CopyFromBGRA8(const uint8_t *bgra, int width, int height, size_t bytesPerRow);
+};
+
+
+/// 画像をファイルに書き出します。拡張子が ".ppm" の場合はPPM（P6、アルファは捨てられます）、それ以外はPNGで書き出します。
+/// PNGは無圧縮のdeflateブロックで書き出すので、同じ画像からは常に同じバイト列のファイルが作成されます。
+bool    WriteImageFile(const RGBA8Image& image, const std::string& path);
+
+/// PNG（8ビットのグレースケール・RGB・RGBA、インターレースなし）またはPPM（P6、8ビット）のファイルを読み込みます。
+bool    ReadImageFile(const std::string& path, RGBA8Image& outImage);
+
+/// 画像をPNG形式のバイト列にエンコードします。
+void    EncodePNG(const RGBA8Image& image, std::vector<uint8_t>& outData);
+
+/// PNG形式のバイト列をデコードします。対応していない形式の場合はfalseを返します。
+bool    DecodePNG(const uint8_t *data, size_t size, RGBA8Image& outImage);
+
+
+#endif /* ImageFile_hpp */
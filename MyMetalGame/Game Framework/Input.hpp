@@ -204,7 +204,26 @@ struct KeyCode
 };
 
 
+/// あるフレームの始めの時点での、キーボードとマウスの入力状態です。
+struct InputSnapshot
+{
+    /// 押されているキーのマスク
+    KeyCodeType keyState;
+
+    /// マウスの左ボタンが押されているかどうか
+    bool        isMouseDown;
+
+    /// マウスの右ボタンが押されているかどうか
+    bool        isMouseDownRight;
+
+    /// マウスのカーソル位置（ウィンドウ座標）
+    Vector2     mousePosition;
+};
+
+
 /// キーボードとマウスの入力を管理するためのクラス
+/// イベントで変化した入力状態は、フレームの始めにまとめて取り込まれます。取り込みにはロックを使わないので、
+/// パイプライン化した更新では、メインスレッドでイベントを受け取りながら、シミュレーションのスレッドで入力を読み取ることができます。
 class Input : public GMObject
 {
     static KeyCodeType  sKeyState;
@@ -222,6 +241,8 @@ class Input : public GMObject
     static bool         sIsMouseDownTriggeredRight;
     static bool         sIsMouseUpTriggeredRight;
 
+    static Vector2      sMousePosition;
+
 public:
 
     /// 仮想軸の値を取得します。軸の名前には "Horizontal" または "Vertical" を指定します。
@@ -260,7 +281,7 @@ public:
     /// マウスボタンの状態を確認し、直前のフレームでボタンが離されたかどうかをリターンします。
     static bool     GetMouseButtonUp(int button);
     
-    /// マウスの現在のカーソル位置を取得します。
+    /// マウスのカーソル位置を取得します。値はフレームの始めに取り込まれたものです。
     static Vector2  MousePosition();
 
 
@@ -271,6 +292,17 @@ public:
     static void __ProcessMouseUp();
     static void __ProcessMouseDownRight();
     static void __ProcessMouseUpRight();
+
+    /// マウスのカーソル位置（ウィンドウ座標）を設定します。入力の再生で使います。
+    static void __ProcessMouseMove(const Vector2& position);
+
+    /// 直前の__UpdateTriggers()で取り込まれた、押されているキーのマスクを取得します。入力の記録で使います。
+    static KeyCodeType  __GetKeyState();
+
+    /// メインスレッドで、マウスのカーソル位置を含めた現在の入力状態を、次に__UpdateTriggers()で取り込まれるように公開します。
+    static void __PublishInput();
+
+    /// 公開された最新の入力状態を取り込んで、押された・離されたの判定を更新します。フレームごとに1つのスレッドから呼び出してください。
     static void __UpdateTriggers();
 };
 
@@ -6,9 +6,13 @@
 //  Copyright (c) 2010-2018 Satoshi Numata. All rights reserved.
 //
 
+#if defined(__OBJC__)
 #import "AppDelegate.hpp"
+#endif
 #include "Input.hpp"
 #include <algorithm>
+#include <atomic>
+#include <cfloat>
 #include <utility>
 #include "DebugSupport.hpp"
 
@@ -28,6 +32,33 @@ bool Input::sIsMouseDownOldRight = false;
 bool Input::sIsMouseDownTriggeredRight = false;
 bool Input::sIsMouseUpTriggeredRight = false;
 
+Vector2 Input::sMousePosition;
+
+
+// メインスレッドのイベントで変化する入力状態と、それをフレームの始めに受け渡すためのトリプルバッファ。
+// 書き込み側と読み取り側がそれぞれ専用のスロットを持ち、受け渡し用のスロットとの交換だけをアトミックに行う。
+static const int        kSnapshotDirtyBit = 4;      // 受け渡し用のスロットがまだ読まれていないことを表す
+
+static InputSnapshot    sLiveInput;
+static InputSnapshot    sSnapshotSlots[3];
+static int              sSnapshotBackIndex = 0;     // 書き込み側（メインスレッド）だけが使う
+static int              sSnapshotFrontIndex = 1;    // 読み取り側だけが使う
+static std::atomic<int> sSnapshotMiddleIndex(2);
+
+static void PublishSnapshot()
+{
+    sSnapshotSlots[sSnapshotBackIndex] = sLiveInput;
+    sSnapshotBackIndex = sSnapshotMiddleIndex.exchange(sSnapshotBackIndex | kSnapshotDirtyBit, std::memory_order_acq_rel) & 3;
+}
+
+static const InputSnapshot& TakeLatestSnapshot()
+{
+    if (sSnapshotMiddleIndex.load(std::memory_order_relaxed) & kSnapshotDirtyBit) {
+        sSnapshotFrontIndex = sSnapshotMiddleIndex.exchange(sSnapshotFrontIndex, std::memory_order_acq_rel) & 3;
+    }
+    return sSnapshotSlots[sSnapshotFrontIndex];
+}
+
 
 const KeyCodeType KeyCode::UpArrow     = (1ULL << 0);
 const KeyCodeType KeyCode::DownArrow   = (1ULL << 1);
@@ -224,47 +255,80 @@ bool Input::GetMouseButtonUp(int button)
 
 Vector2 Input::MousePosition()
 {
-    NSWindow* window = [AppDelegate sharedInstance].window;
-
-    NSPoint location = [NSEvent mouseLocation];
-    NSRect rect = NSMakeRect(location.x, location.y, 0.0f, 0.0f);
-    rect = [window convertRectFromScreen:rect];
-    location = rect.origin;
-    return Vector2(location.x, location.y);
+    return sMousePosition;
 }
 
 void Input::__ProcessKeyDown(KeyCodeType mask)
 {
-    sKeyState |= mask;
+    sLiveInput.keyState |= mask;
+    PublishSnapshot();
 }
 
 void Input::__ProcessKeyUp(KeyCodeType mask)
 {
-    sKeyState &= ~mask;
+    sLiveInput.keyState &= ~mask;
+    PublishSnapshot();
 }
 
 void Input::__ProcessMouseDown()
 {
-    sIsMouseDown = true;
+    sLiveInput.isMouseDown = true;
+    PublishSnapshot();
 }
 
 void Input::__ProcessMouseUp()
 {
-    sIsMouseDown = false;
+    sLiveInput.isMouseDown = false;
+    PublishSnapshot();
 }
 
 void Input::__ProcessMouseDownRight()
 {
-    sIsMouseDownRight = true;
+    sLiveInput.isMouseDownRight = true;
+    PublishSnapshot();
 }
 
 void Input::__ProcessMouseUpRight()
 {
-    sIsMouseDownRight = false;
+    sLiveInput.isMouseDownRight = false;
+    PublishSnapshot();
+}
+
+void Input::__ProcessMouseMove(const Vector2& position)
+{
+    sLiveInput.mousePosition = position;
+    PublishSnapshot();
+}
+
+KeyCodeType Input::__GetKeyState()
+{
+    return sKeyState;
+}
+
+void Input::__PublishInput()
+{
+#if defined(__OBJC__)
+    // ウィンドウとマウスの位置はメインスレッドでしか取得できないので、ここで取り込んでおく
+    NSWindow* window = [AppDelegate sharedInstance].window;
+    if (window) {
+        NSPoint location = [NSEvent mouseLocation];
+        NSRect rect = NSMakeRect(location.x, location.y, 0.0f, 0.0f);
+        rect = [window convertRectFromScreen:rect];
+        location = rect.origin;
+        sLiveInput.mousePosition = Vector2(location.x, location.y);
+    }
+#endif
+    PublishSnapshot();
 }
 
 void Input::__UpdateTriggers()
 {
+    const InputSnapshot& snapshot = TakeLatestSnapshot();
+    sKeyState = snapshot.keyState;
+    sIsMouseDown = snapshot.isMouseDown;
+    sIsMouseDownRight = snapshot.isMouseDownRight;
+    sMousePosition = snapshot.mousePosition;
+
     sKeyDownStateTriggered = sKeyState & ~sKeyStateOld;
     sKeyUpStateTriggered = ~sKeyState & sKeyStateOld;
 	sKeyStateOld = sKeyState;
@@ -0,0 +1,457 @@
+//
+//  InputRecording.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "InputRecording.hpp"
+#include "Input.hpp"
+#include "Time.hpp"
+#include "Random.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "DebugSupport.hpp"
+
+
+static const char       kInputRecordMagic[4] = { 'G', 'M', 'I', 'R' };
+static const uint8_t    kInputRecordVersion = 1;
+
+static const uint8_t    kInputRecordKeyState        = 0x01;
+static const uint8_t    kInputRecordMouseButtons    = 0x02;
+static const uint8_t    kInputRecordMousePosition   = 0x04;
+static const uint8_t    kInputRecordDeltaTime       = 0x08;
+static const uint8_t    kInputRecordIdleRun         = 0x80;
+
+static const uint8_t    kMouseButtonLeft    = 0x01;
+static const uint8_t    kMouseButtonRight   = 0x02;
+
+/// 符号化したフレームをこのバイト数までためてから、書き出しのスレッドに渡す
+static const size_t     kInputRecordChunkSize = 4096;
+
+
+/// 1フレーム分の入力と経過時間。マウスの位置は、差分を小さくするためにfloatのビット列のまま扱う。
+struct InputRecordFrame
+{
+    KeyCodeType keyState;
+    uint8_t     mouseButtons;
+    uint32_t    mouseXBits;
+    uint32_t    mouseYBits;
+    int64_t     deltaNanoseconds;
+};
+
+
+/// 符号化したフレームのまとまりを、バックグラウンドでファイルに書き出すワーカースレッドです。
+class InputRecordWriter
+{
+public:
+    InputRecordWriter()
+        : fp(nullptr), isQuitting(false)
+    {
+        // Do nothing
+    }
+
+    ~InputRecordWriter()
+    {
+        Close();
+    }
+
+    bool Open(const std::string& path)
+    {
+        fp = fopen(path.c_str(), "wb");
+        if (!fp) {
+            return false;
+        }
+        isQuitting = false;
+        thread = std::thread(&InputRecordWriter::Run, this);
+        return true;
+    }
+
+    void Enqueue(std::vector<uint8_t>&& chunk)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            chunks.push_back(std::move(chunk));
+        }
+        condition.notify_all();
+    }
+
+    /// 登録済みのまとまりをすべて書き出してから、ファイルを閉じる
+    void Close()
+    {
+        if (!thread.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            isQuitting = true;
+        }
+        condition.notify_all();
+        thread.join();
+        fclose(fp);
+        fp = nullptr;
+    }
+
+private:
+    void Run()
+    {
+        while (true) {
+            std::vector<uint8_t> chunk;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this] { return !chunks.empty() || isQuitting; });
+                if (chunks.empty()) {
+                    return;
+                }
+                chunk = std::move(chunks.front());
+                chunks.pop_front();
+            }
+
+            // 途中で強制終了されても、書き出し済みのフレームまでは再生できるように、まとまりごとにフラッシュする
+            if (fwrite(chunk.data(), 1, chunk.size(), fp) != chunk.size() || fflush(fp) != 0) {
+                fprintf(stderr, "Failed to write the input recording.\n");
+            }
+        }
+    }
+
+private:
+    FILE                    *fp;
+    std::mutex              mutex;
+    std::condition_variable condition;
+    std::thread             thread;
+    std::deque<std::vector<uint8_t>>    chunks;
+    bool    isQuitting;
+};
+
+static InputRecordWriter& GetWriter()
+{
+    static InputRecordWriter writer;
+    return writer;
+}
+
+
+// 記録の状態（フレームを記録するスレッドだけが使う）
+static bool                 sIsRecording = false;
+static bool                 sIsAtExitRegistered = false;
+static std::vector<uint8_t> sRecordBuffer;
+static InputRecordFrame     sLastRecordedFrame;
+static uint64_t             sIdleFrameCount = 0;
+
+// 再生の状態（入力を公開するメインスレッドだけが使う）
+static bool                         sIsReplaying = false;
+static std::vector<InputRecordFrame> sReplayFrames;
+static size_t                       sReplayFrameIndex = 0;
+static InputRecordFrame             sLastReplayedFrame;
+
+
+static void WriteVarint(std::vector<uint8_t>& buffer, uint64_t value)
+{
+    while (value >= 0x80) {
+        buffer.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back((uint8_t)value);
+}
+
+static uint64_t ZigZagEncode(int64_t value)
+{
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t ZigZagDecode(uint64_t value)
+{
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+/// 可変長整数を読み取る。データが途中で終わっていた場合はfalseを返す。
+static bool ReadVarint(const std::vector<uint8_t>& data, size_t& pos, uint64_t& outValue)
+{
+    outValue = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= data.size()) {
+            return false;
+        }
+        uint8_t byte = data[pos++];
+        outValue |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void ClearFrame(InputRecordFrame& frame)
+{
+    frame.keyState = 0;
+    frame.mouseButtons = 0;
+    frame.mouseXBits = 0;
+    frame.mouseYBits = 0;
+    frame.deltaNanoseconds = 0;
+}
+
+static uint32_t FloatToBits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float BitsToFloat(uint32_t bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/// 何も変化しなかったフレームの連続を書き込む
+static void FlushIdleFrames()
+{
+    if (sIdleFrameCount > 0) {
+        sRecordBuffer.push_back(kInputRecordIdleRun);
+        WriteVarint(sRecordBuffer, sIdleFrameCount);
+        sIdleFrameCount = 0;
+    }
+}
+
+/// たまったバイト列を書き出しのスレッドに渡す
+static void HandOffRecordBuffer()
+{
+    if (sRecordBuffer.empty()) {
+        return;
+    }
+    std::vector<uint8_t> chunk;
+    chunk.reserve(kInputRecordChunkSize + 64);
+    std::swap(chunk, sRecordBuffer);
+    GetWriter().Enqueue(std::move(chunk));
+}
+
+
+void StartInputRecording(const std::string& path)
+{
+    if (sIsRecording) {
+        AbortGame("入力の記録はすでに開始されています。");
+    }
+    if (!GetWriter().Open(path)) {
+        AbortGame("入力の記録ファイル\"%s\"を作成できませんでした。", path.c_str());
+    }
+
+    // 書き出しのスレッドが破棄される前に残りを書き出せるように、ワーカーを作成してから終了時の処理を登録する
+    if (!sIsAtExitRegistered) {
+        atexit(StopInputRecording);
+        sIsAtExitRegistered = true;
+    }
+
+    sRecordBuffer.clear();
+    sRecordBuffer.reserve(kInputRecordChunkSize + 64);
+    for (int i = 0; i < 4; i++) {
+        sRecordBuffer.push_back((uint8_t)kInputRecordMagic[i]);
+    }
+    sRecordBuffer.push_back(kInputRecordVersion);
+    unsigned seed = Random::GetSeed();
+    for (int i = 0; i < 4; i++) {
+        sRecordBuffer.push_back((uint8_t)(seed >> (i * 8)));
+    }
+    ClearFrame(sLastRecordedFrame);
+    sIdleFrameCount = 0;
+    sIsRecording = true;
+}
+
+void StopInputRecording()
+{
+    if (!sIsRecording) {
+        return;
+    }
+    sIsRecording = false;
+    FlushIdleFrames();
+    HandOffRecordBuffer();
+    GetWriter().Close();
+}
+
+int StartInputReplay(const std::string& path)
+{
+    FILE *fp = fopen(path.c_str(), "rb");
+    if (!fp) {
+        AbortGame("入力の記録ファイル\"%s\"を開けませんでした。", path.c_str());
+    }
+    std::vector<uint8_t> data;
+    uint8_t readBuffer[4096];
+    size_t readSize;
+    while ((readSize = fread(readBuffer, 1, sizeof(readBuffer), fp)) > 0) {
+        data.insert(data.end(), readBuffer, readBuffer + readSize);
+    }
+    fclose(fp);
+
+    if (data.size() < 9 || memcmp(data.data(), kInputRecordMagic, 4) != 0) {
+        AbortGame("入力の記録ファイル\"%s\"の形式が不正です。", path.c_str());
+    }
+    if (data[4] != kInputRecordVersion) {
+        AbortGame("入力の記録ファイル\"%s\"のバージョンに対応していません。（バージョン: %d）", path.c_str(), data[4]);
+    }
+    unsigned seed = 0;
+    for (int i = 0; i < 4; i++) {
+        seed |= (unsigned)data[5 + i] << (i * 8);
+    }
+
+    // 再生中にファイルを読まなくて済むように、すべてのフレームを最初に復元しておく
+    sReplayFrames.clear();
+    InputRecordFrame frame;
+    ClearFrame(frame);
+    size_t pos = 9;
+    bool isTruncated = false;
+    while (pos < data.size() && !isTruncated) {
+        uint8_t flags = data[pos++];
+        uint64_t value = 0;
+        if (flags & kInputRecordIdleRun) {
+            if (!ReadVarint(data, pos, value)) {
+                isTruncated = true;
+                break;
+            }
+            sReplayFrames.insert(sReplayFrames.end(), (size_t)value, frame);
+            continue;
+        }
+        InputRecordFrame next = frame;
+        if (flags & kInputRecordKeyState) {
+            isTruncated |= !ReadVarint(data, pos, value);
+            next.keyState ^= value;
+        }
+        if (flags & kInputRecordMouseButtons) {
+            isTruncated |= (pos >= data.size());
+            next.mouseButtons = isTruncated? 0: data[pos++];
+        }
+        if (flags & kInputRecordMousePosition) {
+            isTruncated |= !ReadVarint(data, pos, value);
+            next.mouseXBits = (uint32_t)(next.mouseXBits + ZigZagDecode(value));
+            isTruncated |= !ReadVarint(data, pos, value);
+            next.mouseYBits = (uint32_t)(next.mouseYBits + ZigZagDecode(value));
+        }
+        if (flags & kInputRecordDeltaTime) {
+            isTruncated |= !ReadVarint(data, pos, value);
+            next.deltaNanoseconds += ZigZagDecode(value);
+        }
+        if (!isTruncated) {
+            frame = next;
+            sReplayFrames.push_back(frame);
+        }
+    }
+    if (isTruncated) {
+        // 記録中に強制終了されたファイルでは最後のフレームが途中で切れていることがあるので、そのフレームだけを捨てる
+        fprintf(stderr, "The input recording is truncated; replaying the first %d frames: %s\n", (int)sReplayFrames.size(), path.c_str());
+    }
+
+    Random::SetSeed(seed);
+    ClearFrame(sLastReplayedFrame);
+    sReplayFrameIndex = 0;
+    sIsReplaying = !sReplayFrames.empty();
+    return (int)sReplayFrames.size();
+}
+
+bool IsReplayingInput()
+{
+    return sIsReplaying;
+}
+
+void __ApplyInputReplay()
+{
+    if (!sIsReplaying) {
+        return;
+    }
+
+    // 前のフレームで送り込んだ状態との差だけを、イベントと同じ経路で送り込む
+    const InputRecordFrame& frame = sReplayFrames[sReplayFrameIndex];
+    KeyCodeType pressedKeys = frame.keyState & ~sLastReplayedFrame.keyState;
+    KeyCodeType releasedKeys = ~frame.keyState & sLastReplayedFrame.keyState;
+    if (pressedKeys) {
+        Input::__ProcessKeyDown(pressedKeys);
+    }
+    if (releasedKeys) {
+        Input::__ProcessKeyUp(releasedKeys);
+    }
+    uint8_t changedButtons = frame.mouseButtons ^ sLastReplayedFrame.mouseButtons;
+    if (changedButtons & kMouseButtonLeft) {
+        if (frame.mouseButtons & kMouseButtonLeft) {
+            Input::__ProcessMouseDown();
+        } else {
+            Input::__ProcessMouseUp();
+        }
+    }
+    if (changedButtons & kMouseButtonRight) {
+        if (frame.mouseButtons & kMouseButtonRight) {
+            Input::__ProcessMouseDownRight();
+        } else {
+            Input::__ProcessMouseUpRight();
+        }
+    }
+
+    // マウスの位置は__PublishInput()で実際のカーソル位置に上書きされるので、毎フレーム送り込む
+    Input::__ProcessMouseMove(Vector2(BitsToFloat(frame.mouseXBits), BitsToFloat(frame.mouseYBits)));
+    Time::__SetReplayDeltaNanoseconds(frame.deltaNanoseconds);
+
+    sLastReplayedFrame = frame;
+    sReplayFrameIndex++;
+    if (sReplayFrameIndex >= sReplayFrames.size()) {
+        sIsReplaying = false;
+        fprintf(stderr, "Finished replaying %d input frames.\n", (int)sReplayFrames.size());
+    }
+}
+
+void __RecordInputFrame()
+{
+    if (!sIsRecording) {
+        return;
+    }
+
+    InputRecordFrame frame;
+    frame.keyState = Input::__GetKeyState();
+    frame.mouseButtons = (Input::GetMouseButton(0)? kMouseButtonLeft: 0) | (Input::GetMouseButton(1)? kMouseButtonRight: 0);
+    Vector2 mousePosition = Input::MousePosition();
+    frame.mouseXBits = FloatToBits(mousePosition.x);
+    frame.mouseYBits = FloatToBits(mousePosition.y);
+    frame.deltaNanoseconds = Time::__GetDeltaNanoseconds();
+
+    uint8_t flags = 0;
+    if (frame.keyState != sLastRecordedFrame.keyState) {
+        flags |= kInputRecordKeyState;
+    }
+    if (frame.mouseButtons != sLastRecordedFrame.mouseButtons) {
+        flags |= kInputRecordMouseButtons;
+    }
+    if (frame.mouseXBits != sLastRecordedFrame.mouseXBits || frame.mouseYBits != sLastRecordedFrame.mouseYBits) {
+        flags |= kInputRecordMousePosition;
+    }
+    if (frame.deltaNanoseconds != sLastRecordedFrame.deltaNanoseconds) {
+        flags |= kInputRecordDeltaTime;
+    }
+    if (flags == 0) {
+        sIdleFrameCount++;
+        return;
+    }
+
+    FlushIdleFrames();
+    sRecordBuffer.push_back(flags);
+    if (flags & kInputRecordKeyState) {
+        WriteVarint(sRecordBuffer, frame.keyState ^ sLastRecordedFrame.keyState);
+    }
+    if (flags & kInputRecordMouseButtons) {
+        sRecordBuffer.push_back(frame.mouseButtons);
+    }
+    if (flags & kInputRecordMousePosition) {
+        WriteVarint(sRecordBuffer, ZigZagEncode((int64_t)frame.mouseXBits - (int64_t)sLastRecordedFrame.mouseXBits));
+        WriteVarint(sRecordBuffer, ZigZagEncode((int64_t)frame.mouseYBits - (int64_t)sLastRecordedFrame.mouseYBits));
+    }
+    if (flags & kInputRecordDeltaTime) {
+        WriteVarint(sRecordBuffer, ZigZagEncode(frame.deltaNanoseconds - sLastRecordedFrame.deltaNanoseconds));
+    }
+    sLastRecordedFrame = frame;
+
+    if (sRecordBuffer.size() >= kInputRecordChunkSize) {
+        HandOffRecordBuffer();
+    }
+}
@@ -0,0 +1,52 @@
+//
+//  InputRecording.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef InputRecording_hpp
+#define InputRecording_hpp
+
+#include <string>
+
+
+// フレームごとの入力状態（キー、マウスボタン、マウスの位置）と経過時間、および乱数シードを記録して、あとで同じ順番で再生するための機能です。
+// 記録したプレイをヘッドレスのランナーで再生すれば、ビルドの間で同じ処理量のベンチマークを繰り返し実行できます。
+//
+// 記録のファイルは、前のフレームから変化した値だけを書き込むバイナリ形式です（リトルエンディアン）。
+//     ヘッダ: "GMIR"、バージョン（1バイト）、乱数シード（4バイト）
+//     フレーム: フラグ（1バイト）に続けて、フラグで示された値
+//         0x01 キーのマスク（前のフレームとのXORを可変長整数で）
+//         0x02 マウスボタン（1バイト。0x01が左、0x02が右）
+//         0x04 マウスの位置（x、yそれぞれ、floatのビット列の前のフレームとの差をジグザグ符号化した可変長整数で）
+//         0x08 経過時間（ナノ秒。前のフレームとの差をジグザグ符号化した可変長整数で）
+//         0x80 何も変化しなかったフレームの連続（フレーム数を可変長整数で）
+// 何も操作していない間は、連続したフレームがまとめて数バイトになります。
+
+
+/// 入力の記録を開始します。現在の乱数シードも記録されるので、Start()の前に呼び出してください。
+/// 記録はフレームごとにメモリ上で符号化され、ある程度たまるとバックグラウンドのスレッドでファイルに書き出されます。
+void    StartInputRecording(const std::string& path);
+
+/// 入力の記録を終了し、書き出しが終わるまで待ちます。呼び出さなかった場合は、プログラムの終了時に自動的に終了します。
+void    StopInputRecording();
+
+/// 記録された入力を読み込んで、再生を開始します。記録したときの乱数シードが設定されるので、Start()の前に呼び出してください。
+/// 再生中は、記録された入力がInput::__ProcessKeyDown()などで送り込まれ、経過時間も記録されたものになります。
+/// 戻り値は、記録されているフレーム数です。
+int     StartInputReplay(const std::string& path);
+
+/// 入力を再生中かどうかを取得します。記録されたフレームをすべて再生し終えるとfalseになります。
+bool    IsReplayingInput();
+
+/// 再生中であれば、次のフレームの入力と経過時間を送り込みます。
+/// 入力を公開するメインスレッドで、Input::__PublishInput()の後、Input::__UpdateTriggers()の前に呼び出してください。
+void    __ApplyInputReplay();
+
+/// 記録中であれば、このフレームの入力と経過時間を記録します。Input::__UpdateTriggers()とTime::__Update()の後に呼び出してください。
+void    __RecordInputFrame();
+
+
+#endif /* InputRecording_hpp */
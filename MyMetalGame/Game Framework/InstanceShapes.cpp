@@ -0,0 +1,175 @@
+//
+//  InstanceShapes.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "InstanceShapes.hpp"
+#include "Color.hpp"
+#include "Matrix4x4.hpp"
+#include "Vector2.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+// 円を近似する三角形の個数
+static const int    kCircleSegmentCount = 32;
+
+
+struct InstanceShapeTable
+{
+    std::vector<float>  vertices;
+    InstanceShapeInfo   infos[InstanceShapeCount];
+    uint32_t            maxVertexCount;
+
+    InstanceShapeTable()
+    {
+        // 正三角形
+        BeginShape(InstanceShapeTriangle);
+        for (int i = 0; i < 3; i++) {
+            float angle = (float)M_PI / 2 + (float)M_PI * 2 * i / 3;
+            AddVertex(cosf(angle), sinf(angle));
+        }
+        EndShape(InstanceShapeTriangle);
+
+        // 正方形
+        BeginShape(InstanceShapeQuad);
+        AddVertex(-1.0f, -1.0f);
+        AddVertex( 1.0f, -1.0f);
+        AddVertex( 1.0f,  1.0f);
+        AddVertex(-1.0f, -1.0f);
+        AddVertex( 1.0f,  1.0f);
+        AddVertex(-1.0f,  1.0f);
+        EndShape(InstanceShapeQuad);
+
+        // 円
+        BeginShape(InstanceShapeCircle);
+        for (int i = 0; i < kCircleSegmentCount; i++) {
+            float angle1 = (float)M_PI * 2 * i / kCircleSegmentCount;
+            float angle2 = (float)M_PI * 2 * (i + 1) / kCircleSegmentCount;
+            AddVertex(0.0f, 0.0f);
+            AddVertex(cosf(angle1), sinf(angle1));
+            AddVertex(cosf(angle2), sinf(angle2));
+        }
+        EndShape(InstanceShapeCircle);
+
+        maxVertexCount = 0;
+        for (int i = 0; i < InstanceShapeCount; i++) {
+            maxVertexCount = std::max(maxVertexCount, infos[i].vertexCount);
+        }
+    }
+
+    void BeginShape(InstanceShape shape)
+    {
+        infos[shape].firstVertex = (uint32_t)(vertices.size() / 2);
+    }
+
+    void EndShape(InstanceShape shape)
+    {
+        infos[shape].vertexCount = (uint32_t)(vertices.size() / 2) - infos[shape].firstVertex;
+    }
+
+    void AddVertex(float x, float y)
+    {
+        vertices.push_back(x);
+        vertices.push_back(y);
+    }
+};
+
+static const InstanceShapeTable& GetTable()
+{
+    static InstanceShapeTable table;
+    return table;
+}
+
+
+InstanceData InstanceData::Make(const Vector2& position, float rad, const Vector2& scale, const Color& color, InstanceShape shape)
+{
+    float c = cosf(rad);
+    float s = sinf(rad);
+
+    InstanceData ret;
+    ret.axisX[0] = c * scale.x;
+    ret.axisX[1] = s * scale.x;
+    ret.axisY[0] = -s * scale.y;
+    ret.axisY[1] = c * scale.y;
+    ret.translation[0] = position.x;
+    ret.translation[1] = position.y;
+    ret.color = color.ToRGBA8();
+    ret.shape = (uint32_t)shape;
+    return ret;
+}
+
+InstanceData InstanceData::Make(const Matrix4x4& matrix, const Color& color, InstanceShape shape)
+{
+    InstanceData ret;
+    ret.axisX[0] = matrix.m00;
+    ret.axisX[1] = matrix.m01;
+    ret.axisY[0] = matrix.m10;
+    ret.axisY[1] = matrix.m11;
+    ret.translation[0] = matrix.m30;
+    ret.translation[1] = matrix.m31;
+    ret.color = color.ToRGBA8();
+    ret.shape = (uint32_t)shape;
+    return ret;
+}
+
+
+const float* GetInstanceShapeVertices()
+{
+    return GetTable().vertices.data();
+}
+
+size_t GetInstanceShapeVertexCount()
+{
+    return GetTable().vertices.size() / 2;
+}
+
+const InstanceShapeInfo* GetInstanceShapeInfos()
+{
+    return GetTable().infos;
+}
+
+uint32_t GetInstanceShapeMaxVertexCount()
+{
+    return GetTable().maxVertexCount;
+}
+
+bool ExpandInstanceVertex(const InstanceData& instance, uint32_t vertexID, int shapeOverride, InstanceVertex& outVertex)
+{
+    const InstanceShapeTable& table = GetTable();
+    uint32_t shape = (shapeOverride >= 0)? (uint32_t)shapeOverride: instance.shape;
+    const InstanceShapeInfo& info = table.infos[std::min(shape, (uint32_t)InstanceShapeCount - 1)];
+
+    // 頂点シェーダ（vertexShaderInstanced）と同じ順番・同じ式で変換する
+    if (vertexID >= info.vertexCount) {
+        outVertex.x = 0.0f;
+        outVertex.y = 0.0f;
+        outVertex.color = 0;
+        return false;
+    }
+    float vx = table.vertices[(info.firstVertex + vertexID) * 2];
+    float vy = table.vertices[(info.firstVertex + vertexID) * 2 + 1];
+    outVertex.x = instance.axisX[0] * vx + instance.axisY[0] * vy + instance.translation[0];
+    outVertex.y = instance.axisX[1] * vx + instance.axisY[1] * vy + instance.translation[1];
+    outVertex.color = instance.color;
+    return true;
+}
+
+void ExpandInstances(const InstanceData *instances, size_t count, int shapeOverride, std::vector<InstanceVertex>& outVertices)
+{
+    uint32_t maxVertexCount = GetTable().maxVertexCount;
+
+    for (size_t i = 0; i < count; i++) {
+        for (uint32_t j = 0; j < maxVertexCount; j++) {
+            InstanceVertex vertex;
+            if (!ExpandInstanceVertex(instances[i], j, shapeOverride, vertex)) {
+                break;
+            }
+            outVertices.push_back(vertex);
+        }
+    }
+}
@@ -0,0 +1,113 @@
+//
+//  InstanceShapes.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef InstanceShapes_hpp
+#define InstanceShapes_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct Color;
+struct Matrix4x4;
+struct Vector2;
+
+
+/// インスタンス描画で使用できる図形を表す列挙型
+enum InstanceShape
+{
+    /// 中心が原点で、外接円の半径が1の正三角形
+    InstanceShapeTriangle,
+
+    /// 中心が原点で、一辺の長さが2の正方形
+    InstanceShapeQuad,
+
+    /// 中心が原点で、半径が1の円
+    InstanceShapeCircle,
+
+    /// 図形の種類の個数
+    InstanceShapeCount,
+};
+
+
+/// インスタンス描画で1つの図形ごとに指定する情報です。
+/// GPUにそのままコピーされるため、GMObjectは継承せず、Shaders.metal の InstanceData と同じ32バイトのレイアウトになっています。
+struct InstanceData
+{
+    /// 位置・回転（ラジアン）・拡大率を指定してインスタンス情報を作成します。
+    static InstanceData Make(const Vector2& position, float rad, const Vector2& scale, const Color& color, InstanceShape shape);
+
+    /// 変換行列を指定してインスタンス情報を作成します。行列のZ成分は無視されます。
+    static InstanceData Make(const Matrix4x4& matrix, const Color& color, InstanceShape shape);
+
+    /// 図形のX軸方向の単位ベクトルの変換先
+    float       axisX[2];
+
+    /// 図形のY軸方向の単位ベクトルの変換先
+    float       axisY[2];
+
+    /// 平行移動量
+    float       translation[2];
+
+    /// RGBA8にパックされた色
+    uint32_t    color;
+
+    /// 図形の種類（InstanceShape）
+    uint32_t    shape;
+};
+
+
+/// GPUで参照される図形ごとの頂点範囲です。Shaders.metal の InstanceShapeInfo と同じレイアウトです。
+struct InstanceShapeInfo
+{
+    /// 図形の頂点テーブル内での開始位置
+    uint32_t    firstVertex;
+
+    /// 図形の頂点数（3の倍数）
+    uint32_t    vertexCount;
+};
+
+
+/// インスタンス描画を展開した結果の頂点です。
+struct InstanceVertex
+{
+    /// X座標
+    float       x;
+
+    /// Y座標
+    float       y;
+
+    /// RGBA8にパックされた色
+    uint32_t    color;
+};
+
+
+/// すべての図形の頂点（x, yの組）を連結したテーブルを取得します。
+const float*                GetInstanceShapeVertices();
+
+/// 頂点テーブル内の頂点数を取得します。
+size_t                      GetInstanceShapeVertexCount();
+
+/// 図形ごとの頂点範囲のテーブル（InstanceShapeCount個）を取得します。
+const InstanceShapeInfo*    GetInstanceShapeInfos();
+
+/// すべての図形の中で最大の頂点数を取得します。
+uint32_t                    GetInstanceShapeMaxVertexCount();
+
+/// インスタンス描画の頂点シェーダ（vertexShaderInstanced）と同じ計算で、1つのインスタンスのvertexID番目の頂点を求めます。
+/// GPUでは、図形の種類が混在していても、すべてのインスタンスをGetInstanceShapeMaxVertexCount()個の頂点で描画します。
+/// 図形の頂点数を超えたvertexIDは面積ゼロの三角形になるので、原点に置いた透明の頂点を格納してfalseを返します。
+bool    ExpandInstanceVertex(const InstanceData& instance, uint32_t vertexID, int shapeOverride, InstanceVertex& outVertex);
+
+/// インスタンス描画の頂点シェーダと同じ計算をCPU上で行い、三角形の頂点列に展開します。
+/// 面積ゼロの三角形になる余りの頂点は含めません。
+/// shapeOverrideに0以上の値を指定すると、各インスタンスの図形の種類の代わりにその図形が使われます。
+void    ExpandInstances(const InstanceData *instances, size_t count, int shapeOverride, std::vector<InstanceVertex>& outVertices);
+
+
+#endif /* InstanceShapes_hpp */
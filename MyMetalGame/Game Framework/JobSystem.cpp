@@ -0,0 +1,472 @@
+//
+//  JobSystem.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "JobSystem.hpp"
+#include "DebugSupport.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+static const int    kQueueCapacity = 4096;          // 2の冪にすること
+static const int    kMaxThreadContextCount = 64;    // ワーカースレッドと、ジョブを投入するそれ以外のスレッドの合計
+static const int    kSpinCountBeforeSleep = 64;
+
+
+/// キューに積まれる1つのジョブ
+struct Job
+{
+    JobFunction         function;
+    void                *data;
+    size_t              begin;
+    size_t              end;
+    JobCounter          *counter;
+    const JobCounter    *dependency;
+};
+
+
+/// キューの1つのスロット。ジョブを値のまま格納する。
+/// 盗みに来たスレッドは、topのCASより前に内容を読み取る。その間に持ち主が同じスロットを書き換えるのは、
+/// 別のスレッドがそのスロットのジョブを取り出した後だけなので、読み取った内容が壊れていてもCASが失敗して捨てられる。
+/// 読み取りと書き換えが重なってもデータ競争にならないように、各フィールドはrelaxedのアトミック変数にしている。
+struct JobSlot
+{
+    std::atomic<JobFunction>        function;
+    std::atomic<void *>             data;
+    std::atomic<size_t>             begin;
+    std::atomic<size_t>             end;
+    std::atomic<JobCounter *>       counter;
+    std::atomic<const JobCounter *> dependency;
+
+    void Store(const Job& job)
+    {
+        function.store(job.function, std::memory_order_relaxed);
+        data.store(job.data, std::memory_order_relaxed);
+        begin.store(job.begin, std::memory_order_relaxed);
+        end.store(job.end, std::memory_order_relaxed);
+        counter.store(job.counter, std::memory_order_relaxed);
+        dependency.store(job.dependency, std::memory_order_relaxed);
+    }
+
+    void Load(Job& job) const
+    {
+        job.function = function.load(std::memory_order_relaxed);
+        job.data = data.load(std::memory_order_relaxed);
+        job.begin = begin.load(std::memory_order_relaxed);
+        job.end = end.load(std::memory_order_relaxed);
+        job.counter = counter.load(std::memory_order_relaxed);
+        job.dependency = dependency.load(std::memory_order_relaxed);
+    }
+};
+
+
+/// Chase-Levの両端キューです。持ち主のスレッドだけが末尾にジョブを積み、末尾から取り出します（LIFO）。
+/// 他のスレッドは先頭からジョブを盗みます（FIFO）。最後の1つを取り合う場合だけ、topのCASで決着をつけます。
+/// ジョブはスロットに値のまま格納するので、スロットが再利用されるのはキューの占有が解放されたときだけです。
+class WorkStealingQueue
+{
+public:
+    WorkStealingQueue()
+        : top(0), bottom(0)
+    {
+        // Do nothing
+    }
+
+    /// 持ち主のスレッドから、末尾にジョブを積む。いっぱいの場合はfalseを返す。
+    bool Push(const Job& job)
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        if (b - t >= kQueueCapacity) {
+            return false;
+        }
+        slots[b & (kQueueCapacity - 1)].Store(job);
+        bottom.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// 持ち主のスレッドから、末尾のジョブを取り出す。空の場合はfalseを返す。
+    bool Pop(Job& outJob)
+    {
+        // bottomを先に減らしてから、盗みに来たスレッドのtopを読む（この2つの順序が入れ替わらないようにseq_cstにする）
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_seq_cst);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        slots[b & (kQueueCapacity - 1)].Load(outJob);
+        if (t == b) {
+            // 最後の1つは盗みに来たスレッドと取り合いになる
+            bool isWon = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return isWon;
+        }
+        return true;
+    }
+
+    /// 他のスレッドから、先頭のジョブを盗む。空か、他のスレッドとの取り合いに負けた場合はfalseを返す。
+    bool Steal(Job& outJob)
+    {
+        int64_t t = top.load(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_seq_cst);
+        if (t >= b) {
+            return false;
+        }
+        // CASに勝つまでは、このスロットは持ち主に書き換えられないので、先に内容を読み取っておく
+        slots[t & (kQueueCapacity - 1)].Load(outJob);
+        return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+private:
+    // topとbottomは別のスレッドから頻繁に書き換えられるので、別のキャッシュラインに置く
+    std::atomic<int64_t>    top;
+    char                    padding[64];
+    std::atomic<int64_t>    bottom;
+    JobSlot                 slots[kQueueCapacity];
+};
+
+
+/// ジョブを投入・実行するスレッドごとの情報。スレッドが終了すると、別のスレッドで再利用される。
+struct JobThreadContext
+{
+    WorkStealingQueue   queue;
+    uint32_t            randomState;                // 盗む相手を選ぶための乱数
+    std::atomic<bool>   isInUse;
+};
+
+static std::atomic<JobThreadContext *>  sThreadContexts[kMaxThreadContextCount];
+static std::atomic<int>                 sThreadContextCount(0);
+
+static std::mutex                   sSystemMutex;
+static std::vector<std::thread>     sWorkers;
+static std::atomic<int>             sWorkerCount(0);
+static std::atomic<bool>            sIsStarted(false);
+static std::atomic<bool>            sIsQuitting(false);
+
+static std::mutex                   sSleepMutex;
+static std::condition_variable      sWakeCondition;
+static std::atomic<int>             sSleepingCount(0);
+
+
+static void ExecuteJob(const Job& job);
+
+
+static JobThreadContext *AcquireThreadContext()
+{
+    // 終了したスレッドの情報があれば再利用する
+    int count = sThreadContextCount.load(std::memory_order_acquire);
+    for (int i = 0; i < count; i++) {
+        JobThreadContext *context = sThreadContexts[i].load(std::memory_order_acquire);
+        bool isInUse = false;
+        if (context && context->isInUse.compare_exchange_strong(isInUse, true)) {
+            return context;
+        }
+    }
+
+    int index = sThreadContextCount.fetch_add(1);
+    if (index >= kMaxThreadContextCount) {
+        AbortGame("ジョブを投入・実行するスレッドの数が上限（%d）を超えました。", kMaxThreadContextCount);
+    }
+    JobThreadContext *context = new JobThreadContext();
+    context->randomState = 0x9e3779b9U * (uint32_t)(index + 1);
+    context->isInUse.store(true);
+    sThreadContexts[index].store(context, std::memory_order_release);
+    return context;
+}
+
+/// スレッドの終了時に、スレッドごとの情報を他のスレッドが使えるように返す
+struct JobThreadContextHolder
+{
+    JobThreadContext    *context;
+
+    JobThreadContextHolder()
+        : context(nullptr)
+    {
+        // Do nothing
+    }
+
+    ~JobThreadContextHolder()
+    {
+        if (context) {
+            context->isInUse.store(false);
+        }
+    }
+};
+
+static thread_local JobThreadContextHolder  tContextHolder;
+
+static JobThreadContext *GetThreadContext()
+{
+    if (!tContextHolder.context) {
+        tContextHolder.context = AcquireThreadContext();
+    }
+    return tContextHolder.context;
+}
+
+/// 自分以外のスレッドのキューから、乱数で選んだ相手を起点に順番にジョブを盗む
+static bool StealJob(JobThreadContext *context, Job& outJob)
+{
+    int count = sThreadContextCount.load(std::memory_order_acquire);
+    count = std::min(count, kMaxThreadContextCount);
+    if (count <= 1) {
+        return false;
+    }
+
+    uint32_t x = context->randomState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    context->randomState = x;
+
+    int start = (int)(x % (uint32_t)count);
+    for (int i = 0; i < count; i++) {
+        JobThreadContext *victim = sThreadContexts[(start + i) % count].load(std::memory_order_acquire);
+        if (!victim || victim == context) {
+            continue;
+        }
+        if (victim->queue.Steal(outJob)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// 自分のキューか他のスレッドのキューからジョブを1つ取り出して実行する。実行するジョブがなければfalseを返す。
+static bool TryRunOneJob(JobThreadContext *context)
+{
+    Job job;
+    if (!context->queue.Pop(job) && !StealJob(context, job)) {
+        return false;
+    }
+    ExecuteJob(job);
+    return true;
+}
+
+static void ExecuteJob(const Job& job)
+{
+    if (job.dependency && !job.dependency->IsDone()) {
+        WaitForCounter(*job.dependency);
+    }
+    job.function(job.data, job.begin, job.end);
+    if (job.counter) {
+        job.counter->__Done();
+    }
+}
+
+static void WakeWorker()
+{
+    if (sSleepingCount.load(std::memory_order_relaxed) > 0) {
+        sWakeCondition.notify_one();
+    }
+}
+
+static void WorkerMain()
+{
+    JobThreadContext *context = GetThreadContext();
+    int spinCount = 0;
+    while (!sIsQuitting.load(std::memory_order_acquire)) {
+        if (TryRunOneJob(context)) {
+            spinCount = 0;
+            continue;
+        }
+
+        // しばらく仕事がなければ眠る（起こし損ねても1ミリ秒で起きるので、ジョブが取り残されることはない）
+        if (++spinCount < kSpinCountBeforeSleep) {
+            std::this_thread::yield();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sSleepMutex);
+        sSleepingCount++;
+        sWakeCondition.wait_for(lock, std::chrono::milliseconds(1));
+        sSleepingCount--;
+        spinCount = 0;
+    }
+
+    // 自分のキューに残っているジョブは、終了する前に片付けておく
+    Job job;
+    while (context->queue.Pop(job)) {
+        ExecuteJob(job);
+    }
+}
+
+static void StopWorkers()
+{
+    sIsQuitting.store(true, std::memory_order_release);
+    sWakeCondition.notify_all();
+    for (std::thread& worker : sWorkers) {
+        // ワーカースレッドの中からexit()された場合は、自分自身をjoinできないので切り離す
+        if (worker.get_id() == std::this_thread::get_id()) {
+            worker.detach();
+        } else if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    sWorkers.clear();
+    sWorkerCount.store(0);
+    sIsQuitting.store(false, std::memory_order_release);
+}
+
+/// プログラムの終了時に、ワーカースレッドを終了させる
+struct JobSystemTerminator
+{
+    ~JobSystemTerminator()
+    {
+        ShutdownJobSystem();
+    }
+};
+
+static JobSystemTerminator  sTerminator;
+
+static void EnsureStarted()
+{
+    if (!sIsStarted.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(sSystemMutex);
+        if (!sIsStarted.load(std::memory_order_relaxed)) {
+            int count = std::max((int)std::thread::hardware_concurrency() - 1, 0);
+            for (int i = 0; i < count; i++) {
+                sWorkers.push_back(std::thread(WorkerMain));
+            }
+            sWorkerCount.store(count);
+            sIsStarted.store(true, std::memory_order_release);
+        }
+    }
+}
+
+
+JobCounter::JobCounter()
+    : pendingCount(0)
+{
+    // Do nothing
+}
+
+bool JobCounter::IsDone() const
+{
+    return (pendingCount.load(std::memory_order_acquire) == 0);
+}
+
+int JobCounter::PendingCount() const
+{
+    return pendingCount.load(std::memory_order_acquire);
+}
+
+void JobCounter::__Add(int count)
+{
+    pendingCount.fetch_add(count, std::memory_order_relaxed);
+}
+
+void JobCounter::__Done()
+{
+    pendingCount.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+
+void InitJobSystem(int workerCount)
+{
+    std::lock_guard<std::mutex> lock(sSystemMutex);
+    if (sIsStarted.load(std::memory_order_relaxed)) {
+        StopWorkers();
+    }
+    if (workerCount < 0) {
+        workerCount = std::max((int)std::thread::hardware_concurrency() - 1, 0);
+    }
+    for (int i = 0; i < workerCount; i++) {
+        sWorkers.push_back(std::thread(WorkerMain));
+    }
+    sWorkerCount.store(workerCount);
+    sIsStarted.store(true, std::memory_order_release);
+}
+
+void ShutdownJobSystem()
+{
+    std::lock_guard<std::mutex> lock(sSystemMutex);
+    if (sIsStarted.load(std::memory_order_relaxed)) {
+        StopWorkers();
+        sIsStarted.store(false, std::memory_order_release);
+    }
+}
+
+int GetJobWorkerCount()
+{
+    EnsureStarted();
+    return sWorkerCount.load();
+}
+
+void RunJob(JobFunction function, void *data, size_t begin, size_t end, JobCounter *counter, const JobCounter *dependency)
+{
+    EnsureStarted();
+    JobThreadContext *context = GetThreadContext();
+    if (counter) {
+        counter->__Add(1);
+    }
+
+    Job job = { function, data, begin, end, counter, dependency };
+
+    // キューがいっぱいなら、積まずにこの場で実行する
+    if (!context->queue.Push(job)) {
+        ExecuteJob(job);
+        return;
+    }
+    WakeWorker();
+}
+
+void WaitForCounter(const JobCounter& counter)
+{
+    JobThreadContext *context = GetThreadContext();
+    while (!counter.IsDone()) {
+        if (!TryRunOneJob(context)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+
+/// ParallelForRange()で分割中の範囲に共通する情報
+struct ParallelForData
+{
+    JobFunction function;
+    void        *data;
+    size_t      grain;
+    JobCounter  *counter;
+};
+
+/// 範囲がgrainより大きいうちは後半をジョブとして投入し、前半を自分で処理する
+static void SplitParallelForRange(void *data, size_t begin, size_t end)
+{
+    ParallelForData *forData = (ParallelForData *)data;
+    while (end - begin > forData->grain) {
+        size_t middle = begin + (end - begin) / 2;
+        RunJob(SplitParallelForRange, data, middle, end, forData->counter);
+        end = middle;
+    }
+    forData->function(forData->data, begin, end);
+}
+
+void ParallelForRange(size_t begin, size_t end, size_t grain, JobFunction function, void *data)
+{
+    if (begin >= end) {
+        return;
+    }
+    grain = std::max(grain, (size_t)1);
+    if (end - begin <= grain) {
+        function(data, begin, end);
+        return;
+    }
+
+    JobCounter counter;
+    ParallelForData forData = { function, data, grain, &counter };
+    RunJob(SplitParallelForRange, &forData, begin, end, &counter);
+    WaitForCounter(counter);
+}
+
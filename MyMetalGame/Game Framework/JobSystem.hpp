@@ -0,0 +1,85 @@
+//
+//  JobSystem.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef JobSystem_hpp
+#define JobSystem_hpp
+
+#include <atomic>
+#include <cstddef>
+
+
+/// 投入したジョブの完了を待つためのカウンタです。ジョブを投入するたびに増え、ジョブが完了するたびに減ります。
+/// カウンタはジョブがすべて完了するまで破棄しないでください。
+class JobCounter
+{
+public:
+    JobCounter();
+
+    /// このカウンタで数えているジョブがすべて完了しているかどうかを判定します。
+    bool    IsDone() const;
+
+    /// 完了していないジョブの数を取得します。
+    int     PendingCount() const;
+
+public:
+    void    __Add(int count);
+    void    __Done();
+
+private:
+    std::atomic<int>    pendingCount;
+
+};
+
+
+/// ジョブとして実行する関数の型です。dataにはRunJob()に渡したポインタ、beginとendには実行する範囲が渡されます。
+typedef void (*JobFunction)(void *data, size_t begin, size_t end);
+
+
+/// ワーカースレッドの数を指定して、ジョブシステムを開始します。workerCountに負の値を指定すると、CPUのコア数から1を引いた数になります。
+/// 0を指定するとワーカースレッドは作成されず、ジョブは完了を待っているスレッドだけで実行されます（並列化の効果を比べるときの基準になります）。
+/// 呼び出さなかった場合は、最初にジョブを投入したときにデフォルトの数で開始されます。すでに開始していた場合は、いったん終了してから開始し直します。
+void    InitJobSystem(int workerCount = -1);
+
+/// 実行中のジョブの完了を待ってから、ワーカースレッドをすべて終了します。
+void    ShutdownJobSystem();
+
+/// ワーカースレッドの数を取得します。ジョブはワーカースレッドに加えて、完了を待っているスレッドでも実行されます。
+int     GetJobWorkerCount();
+
+/// 範囲[begin, end)を処理するジョブを、現在のスレッドのキューに投入します。ジョブは空いているスレッドに盗まれて並列に実行されます。
+/// counterを指定すると、ジョブの完了時にカウンタが減ります。dependencyを指定すると、そのカウンタが0になるまでジョブの実行が延期されます。
+/// 1つのスレッドから同時に投入しておけるジョブは4096個までです。キューがいっぱいの場合は、その場で実行されます。
+void    RunJob(JobFunction function, void *data, size_t begin, size_t end, JobCounter *counter, const JobCounter *dependency = nullptr);
+
+/// カウンタが0になるまで待ちます。待っている間は、このスレッドもキューにあるジョブを実行して処理を手伝います。
+void    WaitForCounter(const JobCounter& counter);
+
+/// 範囲[begin, end)を、grain個以下の区間になるまで再帰的に分割しながら、fn(begin, end)を並列に呼び出します。すべての区間の処理が終わるまで戻りません。
+void    ParallelForRange(size_t begin, size_t end, size_t grain, JobFunction function, void *data);
+
+
+/// 範囲[begin, end)の各インデックスについてfn(index)を並列に呼び出します。すべての呼び出しが終わるまで戻りません。
+/// grainには1つのジョブで処理するインデックスの数の目安を指定します（1回の処理が軽い場合は大きめにしてください）。
+template <typename Func>
+void ParallelFor(size_t begin, size_t end, size_t grain, const Func& fn)
+{
+    struct Invoker
+    {
+        static void Run(void *data, size_t rangeBegin, size_t rangeEnd)
+        {
+            const Func& f = *(const Func *)data;
+            for (size_t i = rangeBegin; i < rangeEnd; i++) {
+                f(i);
+            }
+        }
+    };
+    ParallelForRange(begin, end, grain, &Invoker::Run, (void *)&fn);
+}
+
+
+#endif /* JobSystem_hpp */
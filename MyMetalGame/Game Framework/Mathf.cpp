@@ -12,7 +12,9 @@
 #include <cfloat>
 #include <climits>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 //#include "Debug.hpp"
 
 
@@ -136,6 +138,47 @@ float Mathf::Exp(float x)
     return expf(x);
 }
 
+unsigned short Mathf::FloatToHalf(float val)
+{
+    uint32_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t absBits = bits & 0x7fffffff;
+
+    // 無限大とNaN
+    if (absBits >= 0x7f800000) {
+        return (unsigned short)(sign | 0x7c00 | ((absBits > 0x7f800000)? 0x200: 0));
+    }
+    // 半精度で表現できない大きさ（65520以上）は無限大になる
+    if (absBits >= 0x477ff000) {
+        return (unsigned short)(sign | 0x7c00);
+    }
+    // 半精度では非正規化数になる小さな値
+    if (absBits < 0x38800000) {
+        if (absBits < 0x33000000) {
+            return (unsigned short)sign;
+        }
+        uint32_t mantissa = (absBits & 0x7fffff) | 0x800000;
+        uint32_t shift = 126 - (absBits >> 23);
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1))) {
+            half++;
+        }
+        return (unsigned short)(sign | half);
+    }
+
+    // 指数のバイアスを127から15に付け替えて、仮数部を最近接偶数丸めで13ビット落とす
+    uint32_t half = (absBits - 0x38000000) >> 13;
+    uint32_t rest = absBits & 0x1fff;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) {
+        half++;
+    }
+    return (unsigned short)(sign | half);
+}
+
 float Mathf::Floor(float f)
 {
     return floorf(f);
@@ -146,6 +189,29 @@ int Mathf::FloorToInt(float f)
     return (int)floorf(f);
 }
 
+float Mathf::HalfToFloat(unsigned short val)
+{
+    uint32_t sign = (uint32_t)(val & 0x8000) << 16;
+    uint32_t exponent = (val >> 10) & 0x1f;
+    uint32_t mantissa = val & 0x3ff;
+
+    if (exponent == 0) {
+        // ゼロと非正規化数（仮数部 × 2^-24）
+        float ret = (float)mantissa * (1.0f / 16777216.0f);
+        return (sign != 0)? -ret: ret;
+    }
+
+    uint32_t bits;
+    if (exponent == 31) {
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+    float ret;
+    memcpy(&ret, &bits, sizeof(ret));
+    return ret;
+}
+
 bool Mathf::IsPowerOfTwo(int value)
 {
     if (value < 0) {
@@ -111,6 +111,9 @@ struct Mathf : public GMObject
     /// （Unityとの互換性のために用意していますが、C言語/C++では expf() (#include <cmath>) を使うのが一般的なので、使用は推奨されません。）
     [[deprecated]] static float    Exp(float x);
 
+    /// 32ビットの浮動小数点数を、最も近い16ビットの半精度浮動小数点数のビット表現に変換します。
+    static unsigned short   FloatToHalf(float val);
+
     /// f以下の最大の整数を返します。
     /// （Unityとの互換性のために用意していますが、C言語/C++では floorf() (#include <cmath>) を使うのが一般的なので、使用は推奨されません。）
     __attribute__((deprecated("floorf() (#include <cmath>) is recommended to use instead of Mathf::Floor().")))
@@ -121,6 +124,9 @@ struct Mathf : public GMObject
     __attribute__((deprecated("floorf() (#include <cmath>) is recommended to use instead of Mathf::FloorToInt().")))
     static int      FloorToInt(float f);
 
+    /// 16ビットの半精度浮動小数点数のビット表現を、32ビットの浮動小数点数に変換します。
+    static float    HalfToFloat(unsigned short val);
+
     /// [v1, v2]の範囲内で補間された値valueを生成するような線形パラメータtを計算します。
     static float    InverseLerp(float v1, float v2, float value);
 
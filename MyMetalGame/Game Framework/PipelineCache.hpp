@@ -0,0 +1,39 @@
+//
+//  PipelineCache.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef PipelineCache_hpp
+#define PipelineCache_hpp
+
+#import <Metal/Metal.h>
+#include "PipelineKey.hpp"
+#include <vector>
+
+
+/// パイプラインキャッシュを初期化します。前回の実行で保存したバイナリアーカイブとキーのリストがあれば読み込み、
+/// そのキーのパイプラインを作成しておきます（アーカイブに含まれるものはシェーダのコンパイルが省略されます）。
+void    InitPipelineCache(id<MTLDevice> device, id<MTLLibrary> library);
+
+/// キーに対応するパイプラインステートを取得します。まだ作成されていなければ、その場で作成してキャッシュします。
+id<MTLRenderPipelineState>  GetPipelineState(const PipelineKey& key);
+
+/// 指定されたキーのパイプラインステートを、描画で必要になる前に作成しておきます。
+void    PrewarmPipelineStates(const std::vector<PipelineKey>& keys);
+
+/// キャッシュされているパイプラインステートの個数を取得します。
+size_t  GetPipelineStateCount();
+
+/// 新しく作成したパイプラインがあれば、バイナリアーカイブとキーのリストをファイルに書き出します。毎フレームの終わりに呼び出されます。
+/// 書き出しはバックグラウンドのキューで行われ、パイプラインの作成が続いている間は、最後の作成から2秒経つまで待ってまとめて1回だけ行われます。
+/// アーカイブはmacOS 11以降でのみ使用され、それより前のOSではキーのリストだけが保存されます。
+void    SavePipelineCache();
+
+/// まだ書き出していない変更をすぐに書き出し、書き出しが終わるまで待ちます。終了時に自動的に呼び出されます。
+void    FlushPipelineCache();
+
+
+#endif /* PipelineCache_hpp */
@@ -0,0 +1,438 @@
+//
+//  PipelineCache.mm
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import "PipelineCache.hpp"
+#import "AAPLShaderTypes.h"
+#include "Sprite.hpp"
+#include "StaticMesh2D.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+
+static id<MTLDevice> _Nullable      sDevice;
+static id<MTLLibrary> _Nullable     sLibrary;
+static id<MTLFunction> _Nullable    sVertexFunctions[PipelineShaderCount];
+static id<MTLFunction> _Nullable    sFragmentFunctions[PipelineShaderCount];
+
+static std::unordered_map<uint64_t, id<MTLRenderPipelineState>, PipelineKeyHash>  sPipelineStates;
+static std::vector<uint64_t>        sPipelineKeys;              // 作成した順のキー（ファイルに保存するリスト）
+static uint64_t                     sLastPackedKey = ~0ULL;
+static id<MTLRenderPipelineState>   sLastPipelineState;
+
+static id _Nullable     sBinaryArchive;         // id<MTLBinaryArchive>（macOS 11以降）
+static std::mutex       sBinaryArchiveMutex;    // アーカイブへの追加（描画のスレッド）と書き出し（保存用のキュー）を排他する
+static bool             sIsCacheDirty = false;
+static std::chrono::steady_clock::time_point    sLastCreationTime;
+static dispatch_queue_t _Nullable   sSaveQueue;
+static bool             sIsAtExitRegistered = false;
+
+static const uint32_t   kPipelineKeysFileMagic = 'PLK1';
+
+// 新しいパイプラインの作成が続いている間は保存しない（最後の作成からこの時間が経ってから、まとめて1回保存する）
+static const double     kSaveDelaySeconds = 2.0;
+
+static NSString * const kVertexFunctionNames[PipelineShaderCount] = {
+    @"vertexShader2", @"vertexShaderInstanced", @"vertexShaderSprite", @"vertexShaderStaticMesh",
+};
+static NSString * const kFragmentFunctionNames[PipelineShaderCount] = {
+    @"fragmentShader2", @"fragmentShader2", @"fragmentShaderSprite", @"fragmentShader2",
+};
+static NSString * const kPipelineLabels[PipelineShaderCount] = {
+    @"MyPipeline2", @"MyPipelineInstanced", @"MyPipelineSprite", @"MyPipelineStaticMesh",
+};
+
+
+static NSURL *GetPipelineCacheDirectoryURL()
+{
+    NSURL *baseURL = [[NSFileManager defaultManager] URLForDirectory:NSApplicationSupportDirectory
+                                                            inDomain:NSUserDomainMask
+                                                   appropriateForURL:nil
+                                                              create:YES
+                                                               error:nil];
+    if (!baseURL) {
+        return nil;
+    }
+    NSString *bundleID = [[NSBundle mainBundle] bundleIdentifier];
+    NSURL *ret = [baseURL URLByAppendingPathComponent:(bundleID? bundleID: @"MyMetalGame") isDirectory:YES];
+    [[NSFileManager defaultManager] createDirectoryAtURL:ret withIntermediateDirectories:YES attributes:nil error:nil];
+    return ret;
+}
+
+static NSURL *GetPipelineArchiveURL()
+{
+    return [GetPipelineCacheDirectoryURL() URLByAppendingPathComponent:@"PipelineArchive.metallib"];
+}
+
+static NSURL *GetPipelineKeysURL()
+{
+    return [GetPipelineCacheDirectoryURL() URLByAppendingPathComponent:@"PipelineKeys.bin"];
+}
+
+static bool HasDepth(MTLPixelFormat format)
+{
+    return (format == MTLPixelFormatDepth16Unorm || format == MTLPixelFormatDepth32Float ||
+            format == MTLPixelFormatDepth24Unorm_Stencil8 || format == MTLPixelFormatDepth32Float_Stencil8);
+}
+
+static bool HasStencil(MTLPixelFormat format)
+{
+    return (format == MTLPixelFormatStencil8 || format == MTLPixelFormatDepth24Unorm_Stencil8 ||
+            format == MTLPixelFormatDepth32Float_Stencil8 || format == MTLPixelFormatX32_Stencil8 ||
+            format == MTLPixelFormatX24_Stencil8);
+}
+
+static MTLVertexDescriptor *CreateVertexDescriptor(PipelineVertexLayout vertexLayout)
+{
+    if (vertexLayout == PipelineVertexLayoutNone) {
+        // インスタンス情報と図形の頂点テーブルは頂点シェーダの中で直接読むので、頂点ディスクリプタは使わない
+        return nil;
+    }
+
+    MTLVertexDescriptor *ret = [[MTLVertexDescriptor alloc] init];
+
+    if (vertexLayout == PipelineVertexLayoutCompact) {
+        // 半精度の位置とRGBA8の色は、頂点フェッチの段階でfloat2/float4に展開される
+        ret.attributes[0].format = MTLVertexFormatHalf2;
+        ret.attributes[0].offset = 0;
+        ret.attributes[0].bufferIndex = 0;
+
+        ret.attributes[1].format = MTLVertexFormatUChar4Normalized;
+        ret.attributes[1].offset = 2 * 2;
+        ret.attributes[1].bufferIndex = 0;
+
+        ret.layouts[0].stride = sizeof(AAPLVertexCompact);
+    } else if (vertexLayout == PipelineVertexLayoutSprite) {
+        ret.attributes[0].format = MTLVertexFormatFloat2;
+        ret.attributes[0].offset = 0;
+        ret.attributes[0].bufferIndex = 0;
+
+        ret.attributes[1].format = MTLVertexFormatFloat2;
+        ret.attributes[1].offset = 2 * 4;
+        ret.attributes[1].bufferIndex = 0;
+
+        ret.attributes[2].format = MTLVertexFormatUChar4Normalized;
+        ret.attributes[2].offset = 4 * 4;
+        ret.attributes[2].bufferIndex = 0;
+
+        ret.layouts[0].stride = sizeof(SpriteVertex);
+    } else {
+        // AAPLVertexとStaticMeshVertexは同じレイアウト
+        ret.attributes[0].format = MTLVertexFormatFloat2;
+        ret.attributes[0].offset = 0;
+        ret.attributes[0].bufferIndex = 0;
+
+        ret.attributes[1].format = MTLVertexFormatFloat4;
+        ret.attributes[1].offset = 2 * 4;
+        ret.attributes[1].bufferIndex = 0;
+
+        ret.layouts[0].stride = sizeof(StaticMeshVertex);
+    }
+    ret.layouts[0].stepRate = 1;
+    ret.layouts[0].stepFunction = MTLVertexStepFunctionPerVertex;
+
+    return ret;
+}
+
+static void SetupBlending(MTLRenderPipelineColorAttachmentDescriptor *attachment, BlendMode blendMode)
+{
+    if (blendMode == BlendModeNone) {
+    } else if (blendMode == BlendModeCopy) {
+        // コピー合成
+        attachment.blendingEnabled = YES;
+        attachment.sourceRGBBlendFactor = MTLBlendFactorOne;
+        attachment.destinationRGBBlendFactor = MTLBlendFactorZero;
+        attachment.rgbBlendOperation = MTLBlendOperationAdd;
+        attachment.sourceAlphaBlendFactor = MTLBlendFactorOne;
+        attachment.destinationAlphaBlendFactor = MTLBlendFactorZero;
+        attachment.alphaBlendOperation = MTLBlendOperationAdd;
+    } else if (blendMode == BlendModeClear) {
+        // クリア合成
+        attachment.blendingEnabled = YES;
+        attachment.sourceRGBBlendFactor = MTLBlendFactorZero;
+        attachment.destinationRGBBlendFactor = MTLBlendFactorZero;
+        attachment.rgbBlendOperation = MTLBlendOperationAdd;
+        attachment.sourceAlphaBlendFactor = MTLBlendFactorZero;
+        attachment.destinationAlphaBlendFactor = MTLBlendFactorZero;
+        attachment.alphaBlendOperation = MTLBlendOperationAdd;
+    } else if (blendMode == BlendModeXOR) {
+        // XOR合成
+        attachment.blendingEnabled = YES;
+        attachment.sourceRGBBlendFactor = MTLBlendFactorOneMinusDestinationColor;
+        attachment.destinationRGBBlendFactor = MTLBlendFactorOneMinusSourceColor;
+        attachment.rgbBlendOperation = MTLBlendOperationAdd;
+        attachment.sourceAlphaBlendFactor = MTLBlendFactorOneMinusDestinationAlpha;
+        attachment.destinationAlphaBlendFactor = MTLBlendFactorOneMinusSourceAlpha;
+        attachment.alphaBlendOperation = MTLBlendOperationAdd;
+    } else if (blendMode == BlendModeInvert) {
+        // 反転合成
+        attachment.blendingEnabled = YES;
+        attachment.sourceRGBBlendFactor = MTLBlendFactorOneMinusDestinationColor;
+        attachment.destinationRGBBlendFactor = MTLBlendFactorZero;
+        attachment.rgbBlendOperation = MTLBlendOperationAdd;
+        attachment.sourceAlphaBlendFactor = MTLBlendFactorOneMinusDestinationAlpha;
+        attachment.destinationAlphaBlendFactor = MTLBlendFactorZero;
+        attachment.alphaBlendOperation = MTLBlendOperationAdd;
+    } else if (blendMode == BlendModeMultiply) {
+        // 乗算合成
+        attachment.blendingEnabled = YES;
+        attachment.sourceRGBBlendFactor = MTLBlendFactorZero;
+        attachment.destinationRGBBlendFactor = MTLBlendFactorSourceColor;
+        attachment.rgbBlendOperation = MTLBlendOperationAdd;
+        attachment.sourceAlphaBlendFactor = MTLBlendFactorZero;
+        attachment.destinationAlphaBlendFactor = MTLBlendFactorSourceAlpha;
+        attachment.alphaBlendOperation = MTLBlendOperationAdd;
+    } else if (blendMode == BlendModeAdd) {
+        // 加算合成（覆い焼き（リニア））
+        attachment.blendingEnabled = YES;
+        attachment.sourceRGBBlendFactor = MTLBlendFactorSourceAlpha;
+        attachment.destinationRGBBlendFactor = MTLBlendFactorOne;
+        attachment.rgbBlendOperation = MTLBlendOperationAdd;
+        attachment.sourceAlphaBlendFactor = MTLBlendFactorSourceAlpha;
+        attachment.destinationAlphaBlendFactor = MTLBlendFactorOne;
+        attachment.alphaBlendOperation = MTLBlendOperationAdd;
+    } else if (blendMode == BlendModeScreen) {
+        // スクリーン合成
+        attachment.blendingEnabled = YES;
+        attachment.sourceRGBBlendFactor = MTLBlendFactorOneMinusDestinationColor;
+        attachment.destinationRGBBlendFactor = MTLBlendFactorOne;
+        attachment.rgbBlendOperation = MTLBlendOperationAdd;
+        attachment.sourceAlphaBlendFactor = MTLBlendFactorOneMinusDestinationAlpha;
+        attachment.destinationAlphaBlendFactor = MTLBlendFactorOne;
+        attachment.alphaBlendOperation = MTLBlendOperationAdd;
+    } else {
+        // アルファ合成
+        attachment.blendingEnabled = YES;
+        attachment.sourceRGBBlendFactor = MTLBlendFactorSourceAlpha;
+        attachment.destinationRGBBlendFactor = MTLBlendFactorOneMinusSourceAlpha;
+        attachment.rgbBlendOperation = MTLBlendOperationAdd;
+        attachment.sourceAlphaBlendFactor = MTLBlendFactorSourceAlpha;
+        attachment.destinationAlphaBlendFactor = MTLBlendFactorOneMinusSourceAlpha;
+        attachment.alphaBlendOperation = MTLBlendOperationAdd;
+    }
+}
+
+static id<MTLRenderPipelineState> CreatePipelineState(const PipelineKey& key)
+{
+    if (key.shader >= PipelineShaderCount) {
+        return nil;
+    }
+    if (!sVertexFunctions[key.shader]) {
+        sVertexFunctions[key.shader] = [sLibrary newFunctionWithName:kVertexFunctionNames[key.shader]];
+        sFragmentFunctions[key.shader] = [sLibrary newFunctionWithName:kFragmentFunctionNames[key.shader]];
+    }
+
+    MTLPixelFormat depthFormat = (MTLPixelFormat)key.depthFormat;
+
+    MTLRenderPipelineDescriptor *desc = [[MTLRenderPipelineDescriptor alloc] init];
+    desc.label = kPipelineLabels[key.shader];
+    desc.sampleCount = key.sampleCount;
+    desc.vertexFunction = sVertexFunctions[key.shader];
+    desc.fragmentFunction = sFragmentFunctions[key.shader];
+    desc.vertexDescriptor = CreateVertexDescriptor(key.vertexLayout);
+    desc.colorAttachments[0].pixelFormat = (MTLPixelFormat)key.colorFormat;
+    desc.depthAttachmentPixelFormat = HasDepth(depthFormat)? depthFormat: MTLPixelFormatInvalid;
+    desc.stencilAttachmentPixelFormat = HasStencil(depthFormat)? depthFormat: MTLPixelFormatInvalid;
+
+    SetupBlending(desc.colorAttachments[0], key.blendMode);
+
+    if (@available(macOS 11.0, *)) {
+        if (sBinaryArchive) {
+            desc.binaryArchives = @[sBinaryArchive];
+        }
+    }
+
+    NSError *error = NULL;
+    id<MTLRenderPipelineState> ret = [sDevice newRenderPipelineStateWithDescriptor:desc error:&error];
+    if (!ret) {
+        NSLog(@"Failed to created pipeline state for key 0x%012llx: Error=\"%@\"", key.Pack(), error);
+        return nil;
+    }
+
+    // アーカイブに追加しておくと、次回の起動時にはシェーダのコンパイルが省略される
+    if (@available(macOS 11.0, *)) {
+        if (sBinaryArchive) {
+            std::lock_guard<std::mutex> lock(sBinaryArchiveMutex);
+            if ([(id<MTLBinaryArchive>)sBinaryArchive addRenderPipelineFunctionsWithDescriptor:desc error:&error]) {
+                sIsCacheDirty = true;
+            } else {
+                NSLog(@"Failed to add pipeline functions to the binary archive: Error=\"%@\"", error);
+            }
+        }
+    }
+    return ret;
+}
+
+static void LoadPipelineKeys(std::vector<PipelineKey>& outKeys)
+{
+    NSData *data = [NSData dataWithContentsOfURL:GetPipelineKeysURL()];
+    if (!data || data.length < sizeof(uint32_t) * 2) {
+        return;
+    }
+    const uint32_t *header = (const uint32_t *)data.bytes;
+    if (header[0] != kPipelineKeysFileMagic) {
+        return;
+    }
+    size_t count = std::min((size_t)header[1], (data.length - sizeof(uint32_t) * 2) / sizeof(uint64_t));
+    const uint8_t *p = (const uint8_t *)data.bytes + sizeof(uint32_t) * 2;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t packed;
+        memcpy(&packed, p + i * sizeof(uint64_t), sizeof(uint64_t));
+        PipelineKey key = PipelineKey::Unpack(packed);
+        if (key.shader < PipelineShaderCount && key.vertexLayout < PipelineVertexLayoutCount) {
+            outKeys.push_back(key);
+        }
+    }
+}
+
+/// キーのリストとバイナリアーカイブをファイルに書き出す（保存用のキューで呼ばれる）
+static void WritePipelineCacheFiles(const std::vector<uint64_t>& packedKeys)
+{
+    NSMutableData *data = [NSMutableData dataWithCapacity:sizeof(uint32_t) * 2 + sizeof(uint64_t) * packedKeys.size()];
+    uint32_t header[2] = { kPipelineKeysFileMagic, (uint32_t)packedKeys.size() };
+    [data appendBytes:header length:sizeof(header)];
+    [data appendBytes:packedKeys.data() length:sizeof(uint64_t) * packedKeys.size()];
+    NSURL *keysURL = GetPipelineKeysURL();
+    if (keysURL) {
+        [data writeToURL:keysURL atomically:YES];
+    }
+
+    if (@available(macOS 11.0, *)) {
+        NSURL *archiveURL = GetPipelineArchiveURL();
+        if (sBinaryArchive && archiveURL) {
+            std::lock_guard<std::mutex> lock(sBinaryArchiveMutex);
+            NSError *error = NULL;
+            if (![(id<MTLBinaryArchive>)sBinaryArchive serializeToURL:archiveURL error:&error]) {
+                NSLog(@"Failed to save the pipeline archive: Error=\"%@\"", error);
+            }
+        }
+    }
+}
+
+/// 変更があれば、その時点のキーのリストを保存用のキューに渡して書き出す
+static void ScheduleSave()
+{
+    if (!sIsCacheDirty) {
+        return;
+    }
+    sIsCacheDirty = false;
+
+    std::vector<uint64_t> packedKeys = sPipelineKeys;
+    if (!sSaveQueue) {
+        WritePipelineCacheFiles(packedKeys);
+        return;
+    }
+    dispatch_async(sSaveQueue, ^{
+        WritePipelineCacheFiles(packedKeys);
+    });
+}
+
+
+void InitPipelineCache(id<MTLDevice> device, id<MTLLibrary> library)
+{
+    sDevice = device;
+    sLibrary = library;
+    sPipelineStates.clear();
+    sPipelineKeys.clear();
+    sLastPackedKey = ~0ULL;
+    sLastPipelineState = nil;
+
+    if (@available(macOS 11.0, *)) {
+        NSURL *archiveURL = GetPipelineArchiveURL();
+        MTLBinaryArchiveDescriptor *archiveDesc = [[MTLBinaryArchiveDescriptor alloc] init];
+        if (archiveURL && [[NSFileManager defaultManager] fileExistsAtPath:archiveURL.path]) {
+            archiveDesc.url = archiveURL;
+        }
+        NSError *error = NULL;
+        sBinaryArchive = [device newBinaryArchiveWithDescriptor:archiveDesc error:&error];
+        if (!sBinaryArchive && archiveDesc.url) {
+            // OSやGPUドライバの更新で読み込めなくなったアーカイブは捨てて、空のアーカイブから作り直す
+            NSLog(@"Failed to load the pipeline archive: Error=\"%@\"", error);
+            archiveDesc.url = nil;
+            sBinaryArchive = [device newBinaryArchiveWithDescriptor:archiveDesc error:&error];
+        }
+    }
+
+    std::vector<PipelineKey> keys;
+    LoadPipelineKeys(keys);
+    PrewarmPipelineStates(keys);
+    sIsCacheDirty = false;
+
+    // 書き出しは描画のスレッドを止めないように保存用のキューで行い、終了時には残りを書き出してから終わる
+    if (!sSaveQueue) {
+        sSaveQueue = dispatch_queue_create("MyMetalGame.PipelineCache", dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0));
+    }
+    if (!sIsAtExitRegistered) {
+        atexit(FlushPipelineCache);
+        sIsAtExitRegistered = true;
+    }
+}
+
+id<MTLRenderPipelineState> GetPipelineState(const PipelineKey& key)
+{
+    // 同じ状態での描画が続くことが多いので、直前のキーはハッシュテーブルを引かずに返す
+    uint64_t packed = key.Pack();
+    if (packed == sLastPackedKey) {
+        return sLastPipelineState;
+    }
+
+    id<MTLRenderPipelineState> ret;
+    auto it = sPipelineStates.find(packed);
+    if (it != sPipelineStates.end()) {
+        ret = it->second;
+    } else {
+        ret = CreatePipelineState(key);
+        if (!ret) {
+            return nil;
+        }
+        sPipelineStates[packed] = ret;
+        sPipelineKeys.push_back(packed);
+        sIsCacheDirty = true;
+        sLastCreationTime = std::chrono::steady_clock::now();
+    }
+
+    sLastPackedKey = packed;
+    sLastPipelineState = ret;
+    return ret;
+}
+
+void PrewarmPipelineStates(const std::vector<PipelineKey>& keys)
+{
+    for (const PipelineKey& key : keys) {
+        GetPipelineState(key);
+    }
+}
+
+size_t GetPipelineStateCount()
+{
+    return sPipelineStates.size();
+}
+
+void SavePipelineCache()
+{
+    if (!sIsCacheDirty) {
+        return;
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - sLastCreationTime).count();
+    if (elapsed < kSaveDelaySeconds) {
+        return;
+    }
+    ScheduleSave();
+}
+
+void FlushPipelineCache()
+{
+    ScheduleSave();
+    if (sSaveQueue) {
+        dispatch_sync(sSaveQueue, ^{});
+    }
+}
+
@@ -0,0 +1,79 @@
+//
+//  PipelineKey.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "PipelineKey.hpp"
+
+
+static const int    kBlendModeShift     = 4;
+static const int    kVertexLayoutShift  = 8;
+static const int    kSampleCountShift   = 12;
+static const int    kDepthFormatShift   = 16;
+static const int    kColorFormatShift   = 32;
+
+
+PipelineKey PipelineKey::Make(PipelineShader shader, BlendMode blendMode, PipelineVertexLayout vertexLayout,
+                              unsigned colorFormat, unsigned depthFormat, unsigned sampleCount)
+{
+    if (blendMode == BlendModeNone || blendMode > BlendModeXOR) {
+        blendMode = BlendModeAlpha;
+    }
+
+    PipelineKey ret;
+    ret.shader = shader;
+    ret.blendMode = blendMode;
+    ret.vertexLayout = vertexLayout;
+    ret.colorFormat = colorFormat & 0xffff;
+    ret.depthFormat = depthFormat & 0xffff;
+    ret.sampleCount = (sampleCount > 0)? (sampleCount & 0xf): 1;
+    return ret;
+}
+
+PipelineKey PipelineKey::Unpack(uint64_t packed)
+{
+    PipelineKey ret;
+    ret.shader = (PipelineShader)(packed & 0xf);
+    ret.blendMode = (BlendMode)((packed >> kBlendModeShift) & 0xf);
+    ret.vertexLayout = (PipelineVertexLayout)((packed >> kVertexLayoutShift) & 0xf);
+    ret.sampleCount = (unsigned)((packed >> kSampleCountShift) & 0xf);
+    ret.depthFormat = (unsigned)((packed >> kDepthFormatShift) & 0xffff);
+    ret.colorFormat = (unsigned)((packed >> kColorFormatShift) & 0xffff);
+    return ret;
+}
+
+uint64_t PipelineKey::Pack() const
+{
+    return ((uint64_t)(shader & 0xf)) |
+           ((uint64_t)(blendMode & 0xf) << kBlendModeShift) |
+           ((uint64_t)(vertexLayout & 0xf) << kVertexLayoutShift) |
+           ((uint64_t)(sampleCount & 0xf) << kSampleCountShift) |
+           ((uint64_t)(depthFormat & 0xffff) << kDepthFormatShift) |
+           ((uint64_t)(colorFormat & 0xffff) << kColorFormatShift);
+}
+
+bool PipelineKey::operator==(const PipelineKey& key) const
+{
+    return (Pack() == key.Pack());
+}
+
+bool PipelineKey::operator!=(const PipelineKey& key) const
+{
+    return (Pack() != key.Pack());
+}
+
+size_t PipelineKeyHash::operator()(uint64_t packed) const
+{
+    // splitmix64の最終段と同じ混ぜ方で、下位のビットにも上位のフィールドの違いが行き渡るようにする
+    uint64_t x = packed;
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return (size_t)x;
+}
+
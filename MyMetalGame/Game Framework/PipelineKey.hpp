@@ -0,0 +1,102 @@
+//
+//  PipelineKey.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef PipelineKey_hpp
+#define PipelineKey_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include "BlendMode.hpp"
+
+
+/// パイプラインで使用する頂点シェーダとフラグメントシェーダの組を表す列挙型
+enum PipelineShader
+{
+    /// 図形描画（vertexShader2 / fragmentShader2）
+    PipelineShaderSimpleDraw,
+
+    /// インスタンス描画（vertexShaderInstanced / fragmentShader2）
+    PipelineShaderInstanced,
+
+    /// スプライト描画（vertexShaderSprite / fragmentShaderSprite）
+    PipelineShaderSprite,
+
+    /// 静的メッシュ描画（vertexShaderStaticMesh / fragmentShader2）
+    PipelineShaderStaticMesh,
+
+    /// シェーダの組の個数
+    PipelineShaderCount,
+};
+
+
+/// パイプラインの頂点ディスクリプタのレイアウトを表す列挙型
+enum PipelineVertexLayout
+{
+    /// 頂点ディスクリプタを使わない（シェーダの中でバッファを直接読む）
+    PipelineVertexLayoutNone,
+
+    /// 位置float×2、色float×4（AAPLVertex、StaticMeshVertex）
+    PipelineVertexLayoutStandard,
+
+    /// 位置half×2、色RGBA8（AAPLVertexCompact）
+    PipelineVertexLayoutCompact,
+
+    /// 位置float×2、テクスチャ座標float×2、色RGBA8（SpriteVertex）
+    PipelineVertexLayoutSprite,
+
+    /// レイアウトの個数
+    PipelineVertexLayoutCount,
+};
+
+
+/// パイプラインステートを一意に識別するためのキーです。
+/// Metalには依存していないため、ピクセルフォーマットはMTLPixelFormatの値をそのまま整数で保持します。
+struct PipelineKey
+{
+    /// 各フィールドを指定してキーを作成します。
+    /// ブレンドモードは、BlendModeNoneと範囲外の値がBlendModeAlphaに正規化されます。
+    static PipelineKey  Make(PipelineShader shader, BlendMode blendMode, PipelineVertexLayout vertexLayout,
+                             unsigned colorFormat, unsigned depthFormat, unsigned sampleCount);
+
+    /// 64ビットの整数に詰めたキーから、各フィールドを取り出します。
+    static PipelineKey  Unpack(uint64_t packed);
+
+    /// シェーダの組
+    PipelineShader          shader;
+
+    /// ブレンドモード
+    BlendMode               blendMode;
+
+    /// 頂点レイアウト
+    PipelineVertexLayout    vertexLayout;
+
+    /// カラーアタッチメントのピクセルフォーマット（MTLPixelFormat）
+    unsigned                colorFormat;
+
+    /// 深度・ステンシルアタッチメントのピクセルフォーマット（MTLPixelFormat）
+    unsigned                depthFormat;
+
+    /// サンプル数
+    unsigned                sampleCount;
+
+    /// キーを64ビットの整数に詰めます（上位から 予約16 / カラー16 / 深度16 / サンプル数4 / 頂点レイアウト4 / ブレンドモード4 / シェーダ4）。
+    uint64_t    Pack() const;
+
+    bool    operator==(const PipelineKey& key) const;
+    bool    operator!=(const PipelineKey& key) const;
+};
+
+
+/// Pack()したキーを、ハッシュテーブルの中でばらつくように混ぜ合わせるハッシュ関数です。
+struct PipelineKeyHash
+{
+    size_t  operator()(uint64_t packed) const;
+};
+
+
+#endif /* PipelineKey_hpp */
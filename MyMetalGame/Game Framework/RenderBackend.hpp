@@ -0,0 +1,150 @@
+//
+//  RenderBackend.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef RenderBackend_hpp
+#define RenderBackend_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "BlendMode.hpp"
+#include "Color.hpp"
+#include "Matrix4x4.hpp"
+#include "PipelineKey.hpp"
+#include "TextureAtlas.hpp"
+#include "TransformStack.hpp"
+#include "FrameCapture.hpp"
+
+class StaticMesh2D;
+
+
+// SimpleDrawの描画関数が組み立てたバッチを、実際の描画先に送るバックエンドとのインタフェースです。
+// バッチの組み立て、遅延描画の並べ替え、クリップ矩形、レンダーターゲットとアトラスと静的メッシュの管理、描画統計、フレームの進行は
+// BatchRenderer.cpp が受け持ち、バックエンドはエンコードと提出だけを行います。
+// バックエンドは、Metalで描画する Renderer.mm と、GPUを使わずにLinuxなどで実行する HeadlessRenderer.cpp の2つで、
+// どちらか一方を BatchRenderer.cpp と一緒にリンクします。__Backendで始まる関数は、リンクするバックエンドが実装します。
+
+
+typedef float BatchFloat2 __attribute__((vector_size(8)));                         // simd_float2と同じ2要素のベクタ
+typedef float BatchPackedFloat4 __attribute__((vector_size(16), aligned(4)));      // simd_packed_float4と同じ4要素のベクタ
+
+/// 図形描画の頂点です。AAPLShaderTypes.hのAAPLVertexと同じ24バイトのレイアウトです（AAPLShaderTypes.hはsimdに依存するので、同じ形のベクタで定義します）。
+struct BatchVertex
+{
+    BatchFloat2         position;
+    BatchPackedFloat4   color;
+};
+
+/// VertexFormatCompactの頂点です。AAPLVertexCompactと同じ8バイトのレイアウトです。
+struct BatchVertexCompact
+{
+    uint16_t    position[2];
+    uint32_t    color;
+};
+
+static_assert(sizeof(BatchVertex) == 24, "BatchVertex must have the same size as AAPLVertex");
+static_assert(sizeof(BatchVertexCompact) == 8, "BatchVertexCompact must have the same size as AAPLVertexCompact");
+
+
+/// これ以降のテクスチャIDはレンダーターゲットを表します（それより前は、アトラスのページ番号 + 1です）。
+const unsigned  kRenderTargetTextureIDBase = 0x400;
+
+/// アトラスのページ数の上限です。ページのテクスチャIDは1からこの数までで、レンダーターゲットのIDとは重なりません。
+const unsigned  kMaxAtlasPageCount = kRenderTargetTextureIDBase - 1;
+
+static_assert(kMaxAtlasPageCount < kRenderTargetTextureIDBase, "Atlas page texture IDs must not overlap render target texture IDs");
+
+
+/// バッチを書き込む頂点バッファとインデックスバッファを指定して、描画の状態を初期化します。Start()を呼び出す前に1回だけ呼び出してください。
+/// バッファはバックエンドが確保し、頂点はフレームごとに先頭から、256バイト境界に揃えて書き込まれます。
+void    __InitBatchRenderer(char *vertexBuffer, size_t vertexBufferSize, uint16_t *indexBuffer, size_t indexBufferSize);
+
+/// 1フレーム分の処理を行います。入力と時間を更新してFixedUpdate()とUpdate()を実行し、記録された描画をエンコードして提出します。
+/// パイプライン化した更新では、シミュレーションのスレッドで次のフレームの更新を進めながら、前のフレームで記録された描画をエンコードします。
+void    __RunFrame();
+
+/// フレームのキャプチャを登録します。パイプライン化した更新では記録中のフレームと一緒に渡され、そのフレームをエンコードするときに登録されます。
+void    __RequestFrameCapture(const FrameCaptureRequest& request);
+
+
+/// 描画先をクリアするだけのパスをエンコードします。パスをエンコードできなかった場合（ドローアブルがない場合など）はfalseを返します。
+bool    __BackendEncodeClear(const Color& color);
+
+/// それまでの描画内容に重ねて描画するパスを始めます。パスを始められなかった場合はfalseを返します。
+/// パスの中では、現在のカメラの射影（__BackendWriteUniforms2D()で最後に書き込んだもの）が使われます。
+bool    __BackendBeginPass(const char *label);
+
+/// __BackendBeginPass()で始めたパスを終了します。
+void    __BackendEndPass();
+
+/// ビュー（レンダーターゲットに描画していないときの描画先）のピクセル単位の大きさを取得します。
+void    __BackendGetViewSize(float& outWidth, float& outHeight);
+
+/// パスの中で、シザー矩形を設定します（ピクセル単位で、左上が原点）。
+void    __BackendSetScissorRect(int x, int y, int width, int height);
+
+/// パスの中で、パイプラインを切り替えます。
+void    __BackendSetPipeline(PipelineShader shader, BlendMode blendMode, PipelineVertexLayout vertexLayout);
+
+/// パスの中で、スプライト描画に使うテクスチャを設定します。
+void    __BackendSetTexture(unsigned textureID);
+
+/// カメラの射影を、このフレームのslot番目の領域に書き込み、以降のパスで使うようにします。
+void    __BackendWriteUniforms2D(int slot, const Matrix4x4& viewProjection);
+
+/// 頂点バッファのvertexOffsetバイト目からの頂点を、インデックスバッファのindexOffsetバイト目からの16ビットのインデックスで描画します。
+void    __BackendDrawIndexedTriangles(size_t vertexOffset, size_t indexOffset, uint32_t indexCount);
+
+/// 頂点バッファのvertexOffsetバイト目からの頂点を、順番に三角形として描画します。
+void    __BackendDrawTriangles(size_t vertexOffset, uint32_t vertexCount);
+
+/// 頂点バッファのdataOffsetバイト目からのInstanceDataで、インスタンス描画を行います。shapeOverrideが0以上なら、すべてのインスタンスをその図形で描画します。
+void    __BackendDrawInstances(size_t dataOffset, uint32_t vertexCount, uint32_t instanceCount, int shapeOverride);
+
+/// 転送済みの静的メッシュを、変換と色を掛け合わせて描画します。
+void    __BackendDrawStaticMesh(int meshID, const Transform2D& transform, const Color& tint, uint32_t indexCount);
+
+/// 静的メッシュの頂点とインデックスを転送します。isFullUploadがfalseの場合は、書き換えられた頂点の範囲（DirtyRanges()）だけを転送します。
+void    __BackendUploadStaticMesh(int meshID, StaticMesh2D& mesh, bool isFullUpload);
+
+/// 静的メッシュのバッファを解放します。
+void    __BackendReleaseStaticMesh(int meshID);
+
+/// レンダーターゲットのテクスチャを作成します。
+void    __BackendCreateRenderTarget(int targetID, int width, int height);
+
+/// レンダーターゲットのテクスチャを解放します。
+void    __BackendReleaseRenderTarget(int targetID);
+
+/// 以降のパスの描画先を、レンダーターゲットに切り替えます。targetIDに-1を指定すると、ビューに戻します。
+void    __BackendSetRenderTarget(int targetID);
+
+/// ブレンドモードごとのパイプラインを、現在の描画先のフォーマットで先に作成しておきます。
+void    __BackendPrewarmPipelines(const std::vector<BlendMode>& blendModes);
+
+/// アトラスのpage番目のページのテクスチャ（size×sizeピクセル、透明で初期化）を作成します。
+void    __BackendCreateAtlasPage(int page, int size);
+
+/// アトラスの配置済みの領域に、RGBA8のピクセル列を書き込みます。
+void    __BackendUploadAtlasRegion(const AtlasRegion& region, const uint8_t *pixels);
+
+/// 画像ファイルを読み込み、アルファを乗算していないRGBA8のピクセル列（上の行から順）に展開します。
+bool    __BackendDecodeImage(const std::string& name, std::vector<uint8_t>& outPixels, int& outWidth, int& outHeight);
+
+/// このフレームの描画結果を、提出するときにキャプチャするように登録します。
+void    __BackendAddFrameCapture(const FrameCaptureRequest& request);
+
+/// 1つ以上のパスをエンコードしたフレームを提出します（登録されたキャプチャ、表示の登録、コマンドバッファのコミット）。
+void    __BackendSubmitFrame();
+
+/// フレームの処理の最後に呼び出されます（新しく作成したパイプラインのキャッシュへの保存など）。
+void    __BackendEndFrame();
+
+
+#endif /* RenderBackend_hpp */
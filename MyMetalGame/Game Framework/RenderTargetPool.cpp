@@ -0,0 +1,142 @@
+//
+//  RenderTargetPool.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "RenderTargetPool.hpp"
+
+
+RenderTargetPool::RenderTargetPool(size_t bytesPerPixel)
+    : bytesPerPixel(bytesPerPixel), inUseBytes(0), pooledBytes(0)
+{
+    // Do nothing
+}
+
+int RenderTargetPool::Acquire(int width, int height, bool& outNeedsTexture)
+{
+    // 同じ大きさのテクスチャを持つ解放済みのターゲットを優先して再利用し、なければテクスチャのない空きを使う
+    int freeSlot = -1;
+    for (size_t i = 0; i < slots.size(); i++) {
+        RenderTargetSlot& slot = slots[i];
+        if (slot.isInUse) {
+            continue;
+        }
+        if (slot.byteSize > 0 && slot.width == width && slot.height == height) {
+            slot.isInUse = true;
+            slot.isContentValid = false;
+            slot.lastRenderedFrame = -1;
+            pooledBytes -= slot.byteSize;
+            inUseBytes += slot.byteSize;
+            outNeedsTexture = false;
+            return (int)i;
+        }
+        if (slot.byteSize == 0 && freeSlot < 0) {
+            freeSlot = (int)i;
+        }
+    }
+
+    if (freeSlot < 0) {
+        freeSlot = (int)slots.size();
+        slots.push_back(RenderTargetSlot());
+    }
+    RenderTargetSlot& slot = slots[freeSlot];
+    slot.width = width;
+    slot.height = height;
+    slot.byteSize = (size_t)width * height * bytesPerPixel;
+    slot.isInUse = true;
+    slot.isContentValid = false;
+    slot.lastRenderedFrame = -1;
+    inUseBytes += slot.byteSize;
+    outNeedsTexture = true;
+    return freeSlot;
+}
+
+bool RenderTargetPool::Release(int targetID)
+{
+    if (!IsInUse(targetID)) {
+        return false;
+    }
+    RenderTargetSlot& slot = slots[targetID];
+    slot.isInUse = false;
+    slot.isContentValid = false;
+    inUseBytes -= slot.byteSize;
+    pooledBytes += slot.byteSize;
+    return true;
+}
+
+void RenderTargetPool::Invalidate(int targetID)
+{
+    if (IsValidID(targetID)) {
+        slots[targetID].isContentValid = false;
+    }
+}
+
+void RenderTargetPool::InvalidateAll()
+{
+    for (RenderTargetSlot& slot : slots) {
+        slot.isContentValid = false;
+    }
+}
+
+void RenderTargetPool::MarkRendered(int targetID, int frame)
+{
+    if (IsInUse(targetID)) {
+        slots[targetID].isContentValid = true;
+        slots[targetID].lastRenderedFrame = frame;
+    }
+}
+
+bool RenderTargetPool::IsInUse(int targetID) const
+{
+    return (IsValidID(targetID) && slots[targetID].isInUse);
+}
+
+bool RenderTargetPool::IsContentValid(int targetID) const
+{
+    return (IsInUse(targetID) && slots[targetID].isContentValid);
+}
+
+const RenderTargetSlot& RenderTargetPool::GetSlot(int targetID) const
+{
+    return slots[targetID];
+}
+
+size_t RenderTargetPool::SlotCount() const
+{
+    return slots.size();
+}
+
+size_t RenderTargetPool::InUseBytes() const
+{
+    return inUseBytes;
+}
+
+size_t RenderTargetPool::PooledBytes() const
+{
+    return pooledBytes;
+}
+
+std::vector<int> RenderTargetPool::Trim()
+{
+    std::vector<int> ret;
+    for (size_t i = 0; i < slots.size(); i++) {
+        RenderTargetSlot& slot = slots[i];
+        if (!slot.isInUse && slot.byteSize > 0) {
+            pooledBytes -= slot.byteSize;
+            slot.byteSize = 0;
+            slot.width = 0;
+            slot.height = 0;
+            ret.push_back((int)i);
+        }
+    }
+    return ret;
+}
+
+bool RenderTargetPool::IsValidID(int targetID) const
+{
+    return (targetID >= 0 && targetID < (int)slots.size());
+}
+
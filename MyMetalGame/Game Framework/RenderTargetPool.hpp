@@ -0,0 +1,97 @@
+//
+//  RenderTargetPool.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef RenderTargetPool_hpp
+#define RenderTargetPool_hpp
+
+#include <cstddef>
+#include <vector>
+
+
+/// レンダーターゲット1つ分の管理情報です。
+struct RenderTargetSlot
+{
+    /// 幅（ピクセル）
+    int     width;
+
+    /// 高さ（ピクセル）
+    int     height;
+
+    /// GPUのメモリ上で使用しているバイト数（0はテクスチャが確保されていないことを表します）
+    size_t  byteSize;
+
+    /// 使用中かどうか（falseの場合は、解放されて再利用を待っている状態です）
+    bool    isInUse;
+
+    /// 描画済みの内容がそのまま使えるかどうか
+    bool    isContentValid;
+
+    /// 最後に内容を描画したフレーム（まだ描画していない場合は-1）
+    int     lastRenderedFrame;
+};
+
+
+/// レンダーターゲットの確保・再利用・無効化・メモリ使用量を管理するクラスです。
+/// GPUのリソースは持たず、どのターゲットのテクスチャを作成・破棄するべきかを判断するだけなので、CPUだけで動作を確認できます。
+class RenderTargetPool
+{
+public:
+    /// コンストラクタ。1ピクセルあたりのバイト数（カラーと深度・ステンシルの合計）を指定します。
+    explicit RenderTargetPool(size_t bytesPerPixel);
+
+    /// 指定した大きさのレンダーターゲットを確保して、そのIDを返します。
+    /// 解放済みで同じ大きさのテクスチャを持つものがあれば、それを再利用します。
+    /// テクスチャを新しく作成する必要がある場合は、outNeedsTextureにtrueが設定されます。
+    int     Acquire(int width, int height, bool& outNeedsTexture);
+
+    /// レンダーターゲットを解放します。テクスチャは、同じ大きさのターゲットで再利用できるように残されます。
+    /// 使用中でないIDが指定された場合はfalseを返します。
+    bool    Release(int targetID);
+
+    /// 描画済みの内容を無効にします。次に使う前に描画し直す必要があることを表します。
+    void    Invalidate(int targetID);
+
+    /// すべてのターゲットの内容を無効にします。
+    void    InvalidateAll();
+
+    /// 内容を描画したことを記録します。
+    void    MarkRendered(int targetID, int frame);
+
+    /// 使用中のIDかどうかを判定します。
+    bool    IsInUse(int targetID) const;
+
+    /// 描画済みの内容がそのまま使えるかどうかを判定します。
+    bool    IsContentValid(int targetID) const;
+
+    /// ターゲットの管理情報を取得します。
+    const RenderTargetSlot&     GetSlot(int targetID) const;
+
+    /// 管理しているターゲットの数（解放済みのものを含む）を取得します。
+    size_t  SlotCount() const;
+
+    /// 使用中のターゲットが使用しているバイト数を取得します。
+    size_t  InUseBytes() const;
+
+    /// 解放済みで再利用を待っているテクスチャが使用しているバイト数を取得します。
+    size_t  PooledBytes() const;
+
+    /// 解放済みのターゲットのテクスチャを手放し、テクスチャを破棄するべきターゲットのIDのリストを返します。
+    std::vector<int>    Trim();
+
+private:
+    bool    IsValidID(int targetID) const;
+
+    std::vector<RenderTargetSlot>   slots;
+    size_t  bytesPerPixel;
+    size_t  inUseBytes;
+    size_t  pooledBytes;
+
+};
+
+
+#endif /* RenderTargetPool_hpp */
@@ -11,175 +11,511 @@
 #import "GameViewController.hpp"
 #import "Renderer.hpp"
 #import "ShaderTypes.hpp"
-#include "Input.hpp"
+#include "Types.hpp"
+#include "SimpleDraw.hpp"
 #include "Time.hpp"
 #include "Settings.hpp"
 #import "AAPLShaderTypes.h"
-#include "BlendMode.hpp"
-#include <os/log.h>
+#include "RenderBackend.hpp"
+#include "DrawCommandList.hpp"
+#include "InstanceShapes.hpp"
+#include "Mathf.hpp"
+#include "StaticMesh2D.hpp"
+#include "PipelineCache.hpp"
+#include "FrameCapture.hpp"
+#include "Random.hpp"
+#include "InputRecording.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <vector>
 #include "DebugSupport.hpp"
-#include "StringSupport.hpp"
 
 
+// バッチの組み立て、描画統計、フレームの進行はBatchRenderer.cppがヘッドレスのレンダラと共通の処理で行い、
+// このファイルはMetalのエンコーダとバッファでそれを描画するバックエンドを実装する。
+
+static id<MTLCommandQueue> _Nullable    sCommandQueue;
 static id<MTLCommandBuffer> _Nullable   sCommandBuffer;
 static MTKView* _Nullable               sMetalView;
 static id<MTLBuffer> _Nullable          sMetalVertexBuffer;
+static id<MTLBuffer> _Nullable          sMetalIndexBuffer;
+static id<MTLRenderCommandEncoder> _Nullable    sRenderEncoder;     // __BackendBeginPass()で始めたパスのエンコーダ
+
+static std::vector<FrameCaptureRequest> sPendingFrameCaptures;
+
+static id<MTLBuffer> _Nullable          sMetalShapeVertexBuffer;
+static id<MTLBuffer> _Nullable          sMetalShapeInfoBuffer;
+
+static id<MTLTexture>                   sAtlasPageTextures[kMaxAtlasPageCount];     // テクスチャID - 1 のページのテクスチャ
+
+static std::vector<id<MTLTexture>>      sRenderTargetTextures;
+static std::vector<id<MTLTexture>>      sRenderTargetDepthTextures;
+static MTLRenderPassDescriptor          *sRenderTargetPassDescriptor;
+static int                              sCurrentRenderTarget = -1;
+
+static std::vector<id<MTLBuffer>>       sStaticMeshVertexBuffers;
+static std::vector<id<MTLBuffer>>       sStaticMeshIndexBuffers;
 
-static id<MTLRenderPipelineState>  sPipelineState_SimpleDraw_Alpha;
-static id<MTLRenderPipelineState>  sPipelineState_SimpleDraw_Screen;
-static id<MTLRenderPipelineState>  sPipelineState_SimpleDraw_Add;
-static id<MTLRenderPipelineState>  sPipelineState_SimpleDraw_Multiply;
-static id<MTLRenderPipelineState>  sPipelineState_SimpleDraw_Invert;
-static id<MTLRenderPipelineState>  sPipelineState_SimpleDraw_XOR;
-static id<MTLRenderPipelineState>  sPipelineState_SimpleDraw_Copy;
-static id<MTLRenderPipelineState>  sPipelineState_SimpleDraw_Clear;
-
-static NSUInteger   sPassCount;
-static BlendMode    sBlendMode;
-static NSUInteger   sBatchedPolygonCount;
-static NSUInteger   sVertexBufferOffset;
-static AAPLVertex   *sVertexBufferPointer;
-static AAPLVertex   *sVertexBufferPointerStart;
-static AAPLVertex   *sVertexBufferPointerEdge;
-static size_t       sVertexBufferSize;
+static id<MTLBuffer> _Nullable  sUniformBuffer;
+static NSUInteger       sUniforms2DBaseOffset;
+static NSUInteger       sUniforms2DOffset;
 
 static const NSUInteger kMaxBuffersInFlight = 3;
 static const size_t kAlignedUniformsSize = (sizeof(Uniforms) & ~0xFF) + 0x100;
+static const size_t kAlignedUniforms2DSize = (sizeof(Uniforms2D) & ~0xFF) + 0x100;
+static const int    kMaxCameraChangeCount = 16;     // 1フレームの中でカメラを切り替えられる回数（BatchRenderer.cppと同じ）
+static const size_t kAlignedFrameUniformsSize = kAlignedUniformsSize + kAlignedUniforms2DSize * kMaxCameraChangeCount;
+
+static_assert(sizeof(BatchVertex) == sizeof(AAPLVertex) && offsetof(BatchVertex, color) == offsetof(AAPLVertex, color),
+              "BatchVertex must have the same layout as AAPLVertex");
+static_assert(sizeof(BatchVertexCompact) == sizeof(AAPLVertexCompact) && offsetof(BatchVertexCompact, color) == offsetof(AAPLVertexCompact, color),
+              "BatchVertexCompact must have the same layout as AAPLVertexCompact");
 
 
 void Start();
-void Update();
-void FlushVertexRendering();
 
 
-void InitRenderingState()
+/// 現在の描画先のパスの設定を取得する（レンダーターゲットに描画中であればそのターゲットのもの）
+static MTLRenderPassDescriptor *GetCurrentRenderPassDescriptor()
 {
-    sBlendMode = BlendModeAlpha;
-    sBatchedPolygonCount = 0;
-    sVertexBufferOffset = 0;
-    sVertexBufferPointer = (AAPLVertex *)sMetalVertexBuffer.contents;
-    sVertexBufferPointerStart = sVertexBufferPointer;
-    sVertexBufferPointerEdge = (AAPLVertex *)((char *)sVertexBufferPointer + sVertexBufferSize);
-    sPassCount = 0;
+    if (sCurrentRenderTarget >= 0) {
+        return sRenderTargetPassDescriptor;
+    }
+    return sMetalView.currentRenderPassDescriptor;
 }
 
-void Clear(const Color& color)
+/// それまでの描画内容に重ねて描画するためのパスの設定を取得する
+static MTLRenderPassDescriptor *GetRenderPassDescriptorForDrawing()
 {
-    // 未処理の頂点バッファが溜まっていれば破棄する
-    if (sBatchedPolygonCount > 0) {
-        sBatchedPolygonCount = 0;
-        sVertexBufferPointer = sVertexBufferPointerStart;
+    MTLRenderPassDescriptor *renderPassDescriptor = GetCurrentRenderPassDescriptor();
+    if (renderPassDescriptor) {
+        // レンダーターゲットは前のパスの内容を引き継ぐ必要があるので、カラーを読み込む
+        renderPassDescriptor.colorAttachments[0].loadAction = (sCurrentRenderTarget >= 0)? MTLLoadActionLoad: MTLLoadActionDontCare;
+        renderPassDescriptor.depthAttachment.loadAction = MTLLoadActionDontCare;
+        renderPassDescriptor.stencilAttachment.loadAction = MTLLoadActionDontCare;
     }
+    return renderPassDescriptor;
+}
 
-    MTLRenderPassDescriptor *renderPassDescriptor = sMetalView.currentRenderPassDescriptor;
+/// テクスチャIDに対応するテクスチャを取得する（アトラスのページか、レンダーターゲット）。IDはBatchRenderer.cppで検証済み。
+static id<MTLTexture> GetTextureForID(unsigned textureID)
+{
+    if (textureID >= kRenderTargetTextureIDBase) {
+        return sRenderTargetTextures[textureID - kRenderTargetTextureIDBase];
+    }
+    return sAtlasPageTextures[textureID - 1];
+}
 
-    if (renderPassDescriptor) {
-        renderPassDescriptor.colorAttachments[0].loadAction = MTLLoadActionClear;
-        renderPassDescriptor.colorAttachments[0].clearColor = MTLClearColorMake(color.r, color.g, color.b, color.a);
-        renderPassDescriptor.depthAttachment.loadAction = MTLLoadActionClear;
-        renderPassDescriptor.depthAttachment.clearDepth = 1.0f;
-        renderPassDescriptor.stencilAttachment.loadAction = MTLLoadActionClear;
-        renderPassDescriptor.stencilAttachment.clearStencil = 0;
+/// 現在描画しているパス（レンダーターゲットまたはビュー）のフォーマットで、パイプラインのキーを作成する。
+static PipelineKey MakePipelineKey(PipelineShader shader, BlendMode blendMode, PipelineVertexLayout vertexLayout)
+{
+    if (sCurrentRenderTarget >= 0) {
+        id<MTLTexture> colorTexture = sRenderTargetTextures[sCurrentRenderTarget];
+        id<MTLTexture> depthTexture = sRenderTargetDepthTextures[sCurrentRenderTarget];
+        return PipelineKey::Make(shader, blendMode, vertexLayout, (unsigned)colorTexture.pixelFormat,
+                                 (unsigned)depthTexture.pixelFormat, (unsigned)colorTexture.sampleCount);
+    }
+    return PipelineKey::Make(shader, blendMode, vertexLayout, (unsigned)sMetalView.colorPixelFormat,
+                             (unsigned)sMetalView.depthStencilPixelFormat, (unsigned)sMetalView.sampleCount);
+}
 
-        id <MTLRenderCommandEncoder> renderEncoder = [sCommandBuffer renderCommandEncoderWithDescriptor:renderPassDescriptor];
-        [renderEncoder endEncoding];
+bool __BackendEncodeClear(const Color& color)
+{
+    MTLRenderPassDescriptor *renderPassDescriptor = GetCurrentRenderPassDescriptor();
+    if (!renderPassDescriptor) {
+        return false;
+    }
+
+    renderPassDescriptor.colorAttachments[0].loadAction = MTLLoadActionClear;
+    renderPassDescriptor.colorAttachments[0].clearColor = MTLClearColorMake(color.r, color.g, color.b, color.a);
+    renderPassDescriptor.depthAttachment.loadAction = MTLLoadActionClear;
+    renderPassDescriptor.depthAttachment.clearDepth = 1.0f;
+    renderPassDescriptor.stencilAttachment.loadAction = MTLLoadActionClear;
+    renderPassDescriptor.stencilAttachment.clearStencil = 0;
+
+    id <MTLRenderCommandEncoder> renderEncoder = [sCommandBuffer renderCommandEncoderWithDescriptor:renderPassDescriptor];
+    [renderEncoder endEncoding];
+    return true;
+}
 
-        sPassCount++;
+bool __BackendBeginPass(const char *label)
+{
+    MTLRenderPassDescriptor *renderPassDescriptor = GetRenderPassDescriptorForDrawing();
+    if (!renderPassDescriptor) {
+        return false;
     }
+    sRenderEncoder = [sCommandBuffer renderCommandEncoderWithDescriptor:renderPassDescriptor];
+    sRenderEncoder.label = [NSString stringWithUTF8String:label];
+    [sRenderEncoder setVertexBuffer:sUniformBuffer offset:sUniforms2DOffset atIndex:BufferIndexUniforms2D];
+    return true;
+}
+
+void __BackendEndPass()
+{
+    [sRenderEncoder endEncoding];
+    sRenderEncoder = nil;
+}
+
+void __BackendGetViewSize(float& outWidth, float& outHeight)
+{
+    // ビューのパスの描画先は、ドローアブルの大きさのテクスチャになる
+    CGSize size = sMetalView.drawableSize;
+    outWidth = (float)size.width;
+    outHeight = (float)size.height;
+}
+
+void __BackendSetScissorRect(int x, int y, int width, int height)
+{
+    MTLScissorRect scissorRect = { (NSUInteger)x, (NSUInteger)y, (NSUInteger)width, (NSUInteger)height };
+    [sRenderEncoder setScissorRect:scissorRect];
+}
+
+void __BackendSetPipeline(PipelineShader shader, BlendMode blendMode, PipelineVertexLayout vertexLayout)
+{
+    [sRenderEncoder setRenderPipelineState:GetPipelineState(MakePipelineKey(shader, blendMode, vertexLayout))];
+}
+
+void __BackendSetTexture(unsigned textureID)
+{
+    [sRenderEncoder setFragmentTexture:GetTextureForID(textureID) atIndex:0];
 }
 
-void SetBlendMode(BlendMode blendMode)
+void __BackendWriteUniforms2D(int slot, const Matrix4x4& viewProjection)
 {
-    // 頂点バッファが溜まっていれば吐き出す
-    if (sBatchedPolygonCount > 0) {
-        FlushVertexRendering();
+    // 最初のフレームより前（Start()の中など）は、ユニフォームバッファの領域がまだ割り当てられていない
+    if (!sUniformBuffer) {
+        return;
     }
-    sBlendMode = blendMode;
+    sUniforms2DOffset = sUniforms2DBaseOffset + kAlignedUniforms2DSize * slot;
+
+    Uniforms2D *uniforms = (Uniforms2D *)((char *)sUniformBuffer.contents + sUniforms2DOffset);
+    uniforms->viewProjectionMatrix = *(matrix_float4x4 *)viewProjection.mat;
+}
+
+void __BackendDrawIndexedTriangles(size_t vertexOffset, size_t indexOffset, uint32_t indexCount)
+{
+    [sRenderEncoder setVertexBuffer:sMetalVertexBuffer offset:vertexOffset atIndex:0];
+    [sRenderEncoder drawIndexedPrimitives:MTLPrimitiveTypeTriangle
+                               indexCount:indexCount
+                                indexType:MTLIndexTypeUInt16
+                              indexBuffer:sMetalIndexBuffer
+                        indexBufferOffset:indexOffset];
 }
 
-void FillTriangle(const Vector2& p1, const Vector2& p2, const Vector2& p3, const Color& c1, const Color& c2, const Color& c3)
+void __BackendDrawTriangles(size_t vertexOffset, uint32_t vertexCount)
 {
-    // ポリゴンの数が設定された最大個数を超えていないことをチェックする
-    if (sVertexBufferPointer + 3 > sVertexBufferPointerEdge) {
-        AbortGame("頂点バッファのメモリ領域を超えてポリゴン情報を格納しようとしました。（最大ポリゴン数は約 %u）", METAL_MAX_POLYGON_COUNT);
+    [sRenderEncoder setVertexBuffer:sMetalVertexBuffer offset:vertexOffset atIndex:0];
+    [sRenderEncoder drawPrimitives:MTLPrimitiveTypeTriangle vertexStart:0 vertexCount:vertexCount];
+}
+
+void __BackendDrawInstances(size_t dataOffset, uint32_t vertexCount, uint32_t instanceCount, int shapeOverride)
+{
+    [sRenderEncoder setVertexBuffer:sMetalVertexBuffer offset:dataOffset atIndex:0];
+    [sRenderEncoder setVertexBuffer:sMetalShapeVertexBuffer offset:0 atIndex:1];
+    [sRenderEncoder setVertexBuffer:sMetalShapeInfoBuffer offset:0 atIndex:2];
+    [sRenderEncoder setVertexBytes:&shapeOverride length:sizeof(shapeOverride) atIndex:3];
+    [sRenderEncoder drawPrimitives:MTLPrimitiveTypeTriangle vertexStart:0 vertexCount:vertexCount instanceCount:instanceCount];
+}
+
+void __BackendDrawStaticMesh(int meshID, const Transform2D& transform, const Color& tint, uint32_t indexCount)
+{
+    StaticMeshUniforms uniforms;
+    uniforms.axisX = simd_make_float2(transform.m00, transform.m01);
+    uniforms.axisY = simd_make_float2(transform.m10, transform.m11);
+    uniforms.translation = simd_make_float2(transform.tx, transform.ty);
+    uniforms.tint = simd_make_float4(tint.r, tint.g, tint.b, tint.a);
+
+    [sRenderEncoder setVertexBuffer:sStaticMeshVertexBuffers[meshID] offset:0 atIndex:0];
+    [sRenderEncoder setVertexBytes:&uniforms length:sizeof(uniforms) atIndex:1];
+    [sRenderEncoder drawIndexedPrimitives:MTLPrimitiveTypeTriangle
+                               indexCount:indexCount
+                                indexType:MTLIndexTypeUInt32
+                              indexBuffer:sStaticMeshIndexBuffers[meshID]
+                        indexBufferOffset:0];
+}
+
+/// ステージング用のバッファにコピーしたデータを、専用のコマンドバッファでプライベートのバッファに転送する。
+/// 同じキューに先にコミットされるので、このフレームの描画より前に（前のフレームの描画より後に）転送が完了する。
+void __BackendUploadStaticMesh(int meshID, StaticMesh2D& mesh, bool isFullUpload)
+{
+    id<MTLDevice> device = sMetalView.device;
+    const std::vector<StaticMeshVertex>& vertices = mesh.Vertices();
+    const std::vector<uint32_t>& indices = mesh.Indices();
+
+    if ((size_t)meshID >= sStaticMeshVertexBuffers.size()) {
+        sStaticMeshVertexBuffers.resize(meshID + 1);
+        sStaticMeshIndexBuffers.resize(meshID + 1);
     }
 
-    // 頂点バッファにデータを書き込む
-    sVertexBufferPointer->position.x = p1.x;
-    sVertexBufferPointer->position.y = p1.y;
-    sVertexBufferPointer->color.r = c1.r;
-    sVertexBufferPointer->color.g = c1.g;
-    sVertexBufferPointer->color.b = c1.b;
-    sVertexBufferPointer->color.a = c1.a;
-    sVertexBufferPointer++;
-
-    sVertexBufferPointer->position.x = p2.x;
-    sVertexBufferPointer->position.y = p2.y;
-    sVertexBufferPointer->color.r = c2.r;
-    sVertexBufferPointer->color.g = c2.g;
-    sVertexBufferPointer->color.b = c2.b;
-    sVertexBufferPointer->color.a = c2.a;
-    sVertexBufferPointer++;
-
-    sVertexBufferPointer->position.x = p3.x;
-    sVertexBufferPointer->position.y = p3.y;
-    sVertexBufferPointer->color.r = c3.r;
-    sVertexBufferPointer->color.g = c3.g;
-    sVertexBufferPointer->color.b = c3.b;
-    sVertexBufferPointer->color.a = c3.a;
-    sVertexBufferPointer++;
-
-    sBatchedPolygonCount++;
-}
-
-
-id<MTLRenderPipelineState> GetPipelineStateForSimpleDrawing()
-{
-    if (sBlendMode == BlendModeNone) {
-        return sPipelineState_SimpleDraw_Alpha;
-    } else if (sBlendMode == BlendModeScreen) {
-        return sPipelineState_SimpleDraw_Screen;
-    } else if (sBlendMode == BlendModeAdd) {
-        return sPipelineState_SimpleDraw_Add;
-    } else if (sBlendMode == BlendModeMultiply) {
-        return sPipelineState_SimpleDraw_Multiply;
-    } else if (sBlendMode == BlendModeInvert) {
-        return sPipelineState_SimpleDraw_Invert;
-    } else if (sBlendMode == BlendModeXOR) {
-        return sPipelineState_SimpleDraw_XOR;
-    } else if (sBlendMode == BlendModeCopy) {
-        return sPipelineState_SimpleDraw_Copy;
-    } else if (sBlendMode == BlendModeClear) {
-        return sPipelineState_SimpleDraw_Clear;
+    id<MTLCommandBuffer> commandBuffer = [sCommandQueue commandBuffer];
+    commandBuffer.label = @"StaticMeshUpload";
+    id<MTLBlitCommandEncoder> blitEncoder = [commandBuffer blitCommandEncoder];
+
+    if (isFullUpload) {
+        // 初回（または記録し直して大きさが変わった場合）は、頂点とインデックスの全体を転送する
+        size_t vertexBytes = sizeof(StaticMeshVertex) * vertices.size();
+        size_t indexBytes = sizeof(uint32_t) * indices.size();
+        id<MTLBuffer> vertexBuffer = [device newBufferWithLength:vertexBytes options:MTLResourceStorageModePrivate];
+        id<MTLBuffer> indexBuffer = [device newBufferWithLength:indexBytes options:MTLResourceStorageModePrivate];
+        vertexBuffer.label = [NSString stringWithFormat:@"StaticMeshVertices%d", meshID];
+        indexBuffer.label = [NSString stringWithFormat:@"StaticMeshIndices%d", meshID];
+        sStaticMeshVertexBuffers[meshID] = vertexBuffer;
+        sStaticMeshIndexBuffers[meshID] = indexBuffer;
+
+        id<MTLBuffer> stagingBuffer = [device newBufferWithLength:vertexBytes + indexBytes options:MTLResourceStorageModeShared];
+        memcpy(stagingBuffer.contents, vertices.data(), vertexBytes);
+        memcpy((char *)stagingBuffer.contents + vertexBytes, indices.data(), indexBytes);
+        [blitEncoder copyFromBuffer:stagingBuffer sourceOffset:0 toBuffer:vertexBuffer destinationOffset:0 size:vertexBytes];
+        [blitEncoder copyFromBuffer:stagingBuffer sourceOffset:vertexBytes toBuffer:indexBuffer destinationOffset:0 size:indexBytes];
     } else {
-        return sPipelineState_SimpleDraw_Alpha;
+        // 書き換えられた頂点の範囲だけを転送する（インデックスは記録し直さない限り変わらない）
+        const std::vector<StaticMeshRange>& ranges = mesh.DirtyRanges();
+        size_t stagingBytes = 0;
+        for (const StaticMeshRange& range : ranges) {
+            stagingBytes += sizeof(StaticMeshVertex) * range.count;
+        }
+        id<MTLBuffer> stagingBuffer = [device newBufferWithLength:stagingBytes options:MTLResourceStorageModeShared];
+        size_t offset = 0;
+        for (const StaticMeshRange& range : ranges) {
+            size_t bytes = sizeof(StaticMeshVertex) * range.count;
+            memcpy((char *)stagingBuffer.contents + offset, &vertices[range.first], bytes);
+            [blitEncoder copyFromBuffer:stagingBuffer
+                           sourceOffset:offset
+                               toBuffer:sStaticMeshVertexBuffers[meshID]
+                      destinationOffset:sizeof(StaticMeshVertex) * range.first
+                                   size:bytes];
+            offset += bytes;
+        }
     }
+
+    [blitEncoder endEncoding];
+    [commandBuffer commit];
 }
 
-void FlushVertexRendering()
+void __BackendReleaseStaticMesh(int meshID)
 {
-    MTLRenderPassDescriptor *renderPassDescriptor = sMetalView.currentRenderPassDescriptor;
+    if ((size_t)meshID < sStaticMeshVertexBuffers.size()) {
+        sStaticMeshVertexBuffers[meshID] = nil;
+        sStaticMeshIndexBuffers[meshID] = nil;
+    }
+}
 
-    if (renderPassDescriptor) {
-        renderPassDescriptor.colorAttachments[0].loadAction = MTLLoadActionDontCare;
-        renderPassDescriptor.depthAttachment.loadAction = MTLLoadActionDontCare;
-        renderPassDescriptor.stencilAttachment.loadAction = MTLLoadActionDontCare;
+void __BackendCreateRenderTarget(int targetID, int width, int height)
+{
+    // 画面と同じフォーマットにして、SimpleDrawのパイプラインをそのまま使えるようにする
+    id<MTLDevice> device = sMetalView.device;
+    MTLTextureDescriptor *colorDesc = [MTLTextureDescriptor texture2DDescriptorWithPixelFormat:sMetalView.colorPixelFormat
+                                                                                         width:width
+                                                                                        height:height
+                                                                                     mipmapped:NO];
+    colorDesc.usage = MTLTextureUsageRenderTarget | MTLTextureUsageShaderRead;
+    colorDesc.storageMode = MTLStorageModePrivate;
+    MTLTextureDescriptor *depthDesc = [MTLTextureDescriptor texture2DDescriptorWithPixelFormat:sMetalView.depthStencilPixelFormat
+                                                                                         width:width
+                                                                                        height:height
+                                                                                     mipmapped:NO];
+    depthDesc.usage = MTLTextureUsageRenderTarget;
+    depthDesc.storageMode = MTLStorageModePrivate;
+
+    if ((size_t)targetID >= sRenderTargetTextures.size()) {
+        sRenderTargetTextures.resize(targetID + 1);
+        sRenderTargetDepthTextures.resize(targetID + 1);
+    }
+    sRenderTargetTextures[targetID] = [device newTextureWithDescriptor:colorDesc];
+    sRenderTargetTextures[targetID].label = [NSString stringWithFormat:@"RenderTarget%d", targetID];
+    sRenderTargetDepthTextures[targetID] = [device newTextureWithDescriptor:depthDesc];
+}
 
-        id<MTLRenderCommandEncoder> renderEncoder = [sCommandBuffer renderCommandEncoderWithDescriptor:renderPassDescriptor];
-        renderEncoder.label = @"MyRenderEncoder";
+void __BackendReleaseRenderTarget(int targetID)
+{
+    sRenderTargetTextures[targetID] = nil;
+    sRenderTargetDepthTextures[targetID] = nil;
+}
 
-        [renderEncoder setRenderPipelineState:GetPipelineStateForSimpleDrawing()];
-        [renderEncoder setVertexBuffer:sMetalVertexBuffer offset:sVertexBufferOffset atIndex:0];
-        [renderEncoder drawPrimitives:MTLPrimitiveTypeTriangle vertexStart:0 vertexCount:sBatchedPolygonCount*3];
-        [renderEncoder endEncoding];
+void __BackendSetRenderTarget(int targetID)
+{
+    sCurrentRenderTarget = targetID;
+    if (targetID < 0) {
+        return;
+    }
+
+    if (!sRenderTargetPassDescriptor) {
+        sRenderTargetPassDescriptor = [MTLRenderPassDescriptor renderPassDescriptor];
+    }
+    sRenderTargetPassDescriptor.colorAttachments[0].texture = sRenderTargetTextures[targetID];
+    sRenderTargetPassDescriptor.colorAttachments[0].storeAction = MTLStoreActionStore;
+    sRenderTargetPassDescriptor.depthAttachment.texture = sRenderTargetDepthTextures[targetID];
+    sRenderTargetPassDescriptor.depthAttachment.storeAction = MTLStoreActionDontCare;
+    sRenderTargetPassDescriptor.stencilAttachment.texture = sRenderTargetDepthTextures[targetID];
+    sRenderTargetPassDescriptor.stencilAttachment.storeAction = MTLStoreActionDontCare;
+}
+
+void __BackendPrewarmPipelines(const std::vector<BlendMode>& blendModes)
+{
+    std::vector<PipelineKey> keys;
+    for (BlendMode blendMode : blendModes) {
+        keys.push_back(MakePipelineKey(PipelineShaderSimpleDraw, blendMode, PipelineVertexLayoutStandard));
+        keys.push_back(MakePipelineKey(PipelineShaderSprite, blendMode, PipelineVertexLayoutSprite));
+    }
+    PrewarmPipelineStates(keys);
+}
 
-        sVertexBufferOffset += sizeof(AAPLVertex) * sBatchedPolygonCount * 3;
-        sVertexBufferOffset = ((sVertexBufferOffset - 1) & ~0xff) + 0x100;
-        sVertexBufferPointer = (AAPLVertex *)((char *)sMetalVertexBuffer.contents + sVertexBufferOffset);
-        sVertexBufferPointerStart = sVertexBufferPointer;
+/// ページの中身は透明で初期化する
+void __BackendCreateAtlasPage(int page, int size)
+{
+    MTLTextureDescriptor *desc = [MTLTextureDescriptor texture2DDescriptorWithPixelFormat:MTLPixelFormatRGBA8Unorm
+                                                                                    width:size
+                                                                                   height:size
+                                                                                mipmapped:NO];
+    desc.usage = MTLTextureUsageShaderRead;
+    desc.storageMode = MTLStorageModeManaged;
+    id<MTLTexture> texture = [sMetalView.device newTextureWithDescriptor:desc];
+    texture.label = [NSString stringWithFormat:@"AtlasPage%d", page];
+
+    std::vector<uint8_t> zeros((size_t)size * 4, 0);
+    for (int y = 0; y < size; y++) {
+        [texture replaceRegion:MTLRegionMake2D(0, y, size, 1) mipmapLevel:0 withBytes:zeros.data() bytesPerRow:size * 4];
+    }
+    sAtlasPageTextures[page] = texture;
+}
+
+void __BackendUploadAtlasRegion(const AtlasRegion& region, const uint8_t *pixels)
+{
+    [sAtlasPageTextures[region.page] replaceRegion:MTLRegionMake2D(region.x, region.y, region.width, region.height)
+                                       mipmapLevel:0
+                                         withBytes:pixels
+                                       bytesPerRow:region.width * 4];
+}
 
-        sBatchedPolygonCount = 0;
+bool __BackendDecodeImage(const std::string& name, std::vector<uint8_t>& outPixels, int& outWidth, int& outHeight)
+{
+    NSString *nameStr = [NSString stringWithUTF8String:name.c_str()];
+    NSImage *image = [NSImage imageNamed:nameStr];
+    if (!image) {
+        NSString *path = [[NSBundle mainBundle] pathForResource:nameStr ofType:nil];
+        if (path) {
+            image = [[NSImage alloc] initWithContentsOfFile:path];
+        }
+    }
+    if (!image) {
+        return false;
     }
+    CGImageRef cgImage = [image CGImageForProposedRect:NULL context:nil hints:nil];
+    if (!cgImage) {
+        return false;
+    }
+
+    outWidth = (int)CGImageGetWidth(cgImage);
+    outHeight = (int)CGImageGetHeight(cgImage);
+    outPixels.assign((size_t)outWidth * outHeight * 4, 0);
+
+    // CGBitmapContextはアルファ乗算済みの形式しか扱えないので、描画したあとで元に戻す
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+    CGContextRef context = CGBitmapContextCreate(outPixels.data(), outWidth, outHeight, 8, outWidth * 4, colorSpace,
+                                                 kCGImageAlphaPremultipliedLast | kCGBitmapByteOrder32Big);
+    CGColorSpaceRelease(colorSpace);
+    if (!context) {
+        return false;
+    }
+    CGContextDrawImage(context, CGRectMake(0, 0, outWidth, outHeight), cgImage);
+    CGContextRelease(context);
+
+    for (size_t i = 0; i < outPixels.size(); i += 4) {
+        uint8_t a = outPixels[i + 3];
+        if (a > 0 && a < 255) {
+            for (int j = 0; j < 3; j++) {
+                outPixels[i + j] = (uint8_t)std::min(255, (outPixels[i + j] * 255 + a / 2) / a);
+            }
+        }
+    }
+    return true;
+}
+
+
+void CaptureFrame(const std::string& path)
+{
+    FrameCaptureRequest request;
+    request.path = path;
+    request.tolerance = 0;
+    __RequestFrameCapture(request);
+}
+
+void CaptureFrameAndCompare(const std::string& goldenPath, int tolerance, const std::string& diffPath)
+{
+    FrameCaptureRequest request;
+    request.goldenPath = goldenPath;
+    request.diffPath = diffPath;
+    request.tolerance = tolerance;
+    __RequestFrameCapture(request);
+}
+
+void __BackendAddFrameCapture(const FrameCaptureRequest& request)
+{
+    // ドローアブルのテクスチャから読み戻せるように、フレームバッファ専用の設定を外しておく
+    if (sMetalView.framebufferOnly) {
+        sMetalView.framebufferOnly = NO;
+    }
+    sPendingFrameCaptures.push_back(request);
+}
+
+/// 最終的なフレームの内容を共有メモリのバッファにコピーするブリットをエンコードし、GPUの処理が終わったらRGBA8に変換して、
+/// 書き出しと比較をバックグラウンドのスレッドに渡す。
+static void EncodeFrameCapture(id<MTLCommandBuffer> commandBuffer, id<MTLTexture> texture)
+{
+    if (!texture || texture.framebufferOnly) {
+        // このフレームのドローアブルは読み戻せないので、次のフレームに持ち越す
+        return;
+    }
+
+    NSUInteger width = texture.width;
+    NSUInteger height = texture.height;
+    NSUInteger bytesPerRow = width * 4;
+    id<MTLBuffer> buffer = [sMetalView.device newBufferWithLength:bytesPerRow * height options:MTLResourceStorageModeShared];
+    buffer.label = @"FrameCaptureBuffer";
+
+    id<MTLBlitCommandEncoder> blitEncoder = [commandBuffer blitCommandEncoder];
+    blitEncoder.label = @"MyFrameCaptureEncoder";
+    [blitEncoder copyFromTexture:texture
+                     sourceSlice:0
+                     sourceLevel:0
+                    sourceOrigin:MTLOriginMake(0, 0, 0)
+                      sourceSize:MTLSizeMake(width, height, 1)
+                        toBuffer:buffer
+               destinationOffset:0
+          destinationBytesPerRow:bytesPerRow
+        destinationBytesPerImage:bytesPerRow * height];
+    [blitEncoder endEncoding];
+
+    bool isBGRA = (texture.pixelFormat == MTLPixelFormatBGRA8Unorm || texture.pixelFormat == MTLPixelFormatBGRA8Unorm_sRGB);
+    std::vector<FrameCaptureRequest> requests;
+    requests.swap(sPendingFrameCaptures);
+    [commandBuffer addCompletedHandler:^(id<MTLCommandBuffer> completedBuffer) {
+        RGBA8Image image;
+        if (isBGRA) {
+            image.CopyFromBGRA8((const uint8_t *)buffer.contents, (int)width, (int)height, bytesPerRow);
+        } else {
+            image.Resize((int)width, (int)height);
+            memcpy(image.pixels.data(), buffer.contents, bytesPerRow * height);
+        }
+        for (const FrameCaptureRequest& request : requests) {
+            EnqueueFrameCapture(image, request);
+        }
+    }];
+}
+
+void __BackendSubmitFrame()
+{
+    if (sPendingFrameCaptures.size() > 0) {
+        EncodeFrameCapture(sCommandBuffer, sMetalView.currentDrawable.texture);
+    }
+    [sCommandBuffer presentDrawable:sMetalView.currentDrawable];
+    [sCommandBuffer commit];
+}
+
+void __BackendEndFrame()
+{
+    // 新しく作成したパイプラインがあれば、次回の起動のために保存しておく（作成が落ち着いてから、バックグラウンドで書き出される）
+    SavePipelineCache();
 }
 
 
@@ -195,7 +531,6 @@ void FlushVertexRendering()
     id<MTLDepthStencilState>    _depthState;
     id<MTLTexture>              _colorMap;
     MTLVertexDescriptor         *_mtlVertexDescriptor;
-    MTLVertexDescriptor         *_mtlVertexDescriptor2;
 
     uint32_t    _uniformBufferOffset;
     uint8_t     _uniformBufferIndex;
@@ -217,6 +552,27 @@ void FlushVertexRendering()
     if (self) {
         _device = view.device;
         _inFlightSemaphore = dispatch_semaphore_create(kMaxBuffersInFlight);
+
+        // 起動引数で -CaptureSeed <シード> と -CaptureDeltaTime <秒> を指定すると、Start()の前に乱数シードと1フレームの時間を固定する。
+        // テスト用のハーネスからこの2つを指定して起動すれば、キャプチャしたフレームを毎回同じバイト列で再現できる。
+        NSUserDefaults *defaults = [NSUserDefaults standardUserDefaults];
+        if ([defaults objectForKey:@"CaptureSeed"]) {
+            Random::SetSeed((unsigned)[defaults integerForKey:@"CaptureSeed"]);
+        }
+        if ([defaults objectForKey:@"CaptureDeltaTime"]) {
+            Time::captureDeltaTime = [defaults floatForKey:@"CaptureDeltaTime"];
+        }
+
+        // -RecordInput <パス> でプレイ中の入力と経過時間を記録し、-ReplayInput <パス> で記録した入力を再生する。
+        // 再生では記録したときの乱数シードが設定されるので、-CaptureSeedより優先される。
+        NSString *replayInputPath = [defaults stringForKey:@"ReplayInput"];
+        if (replayInputPath) {
+            StartInputReplay(replayInputPath.UTF8String);
+        }
+        NSString *recordInputPath = [defaults stringForKey:@"RecordInput"];
+        if (recordInputPath) {
+            StartInputRecording(recordInputPath.UTF8String);
+        }
         [self _loadMetalWithView:view];
         [self _loadAssets];
     }
@@ -265,117 +621,6 @@ void FlushVertexRendering()
     return ret;
 }
 
-- (id<MTLRenderPipelineState>)createSimpleDrawingPipelineWithLibrary:(id<MTLLibrary>)metalLib view:(nonnull MTKView *)view blendMode:(BlendMode)blendMode
-{
-    _mtlVertexDescriptor2 = [[MTLVertexDescriptor alloc] init];
-
-    _mtlVertexDescriptor2.attributes[0].format = MTLVertexFormatFloat2;
-    _mtlVertexDescriptor2.attributes[0].offset = 0;
-    _mtlVertexDescriptor2.attributes[0].bufferIndex = 0;
-
-    _mtlVertexDescriptor2.attributes[1].format = MTLVertexFormatFloat4;
-    _mtlVertexDescriptor2.attributes[1].offset = 2 * 4;
-    _mtlVertexDescriptor2.attributes[1].bufferIndex = 0;
-
-    _mtlVertexDescriptor2.layouts[0].stride = (2 + 4) * 4;
-    _mtlVertexDescriptor2.layouts[0].stepRate = 1;
-    _mtlVertexDescriptor2.layouts[0].stepFunction = MTLVertexStepFunctionPerVertex;
-
-    id<MTLFunction> vfunc = [metalLib newFunctionWithName:@"vertexShader2"];
-    id<MTLFunction> ffunc = [metalLib newFunctionWithName:@"fragmentShader2"];
-
-    MTLRenderPipelineDescriptor *desc = [[MTLRenderPipelineDescriptor alloc] init];
-    desc.label = @"MyPipeline2";
-    desc.vertexFunction = vfunc;
-    desc.fragmentFunction = ffunc;
-    desc.vertexDescriptor = _mtlVertexDescriptor2;
-    desc.colorAttachments[0].pixelFormat = view.colorPixelFormat;
-    desc.depthAttachmentPixelFormat = view.depthStencilPixelFormat;
-    desc.stencilAttachmentPixelFormat = view.depthStencilPixelFormat;
-
-    if (blendMode == BlendModeNone) {
-    } else if (blendMode == BlendModeCopy) {
-        // コピー合成
-        desc.colorAttachments[0].blendingEnabled = YES;
-        desc.colorAttachments[0].sourceRGBBlendFactor = MTLBlendFactorOne;
-        desc.colorAttachments[0].destinationRGBBlendFactor = MTLBlendFactorZero;
-        desc.colorAttachments[0].rgbBlendOperation = MTLBlendOperationAdd;
-        desc.colorAttachments[0].sourceAlphaBlendFactor = MTLBlendFactorOne;
-        desc.colorAttachments[0].destinationAlphaBlendFactor = MTLBlendFactorZero;
-        desc.colorAttachments[0].alphaBlendOperation = MTLBlendOperationAdd;
-    } else if (blendMode == BlendModeClear) {
-        // クリア合成
-        desc.colorAttachments[0].blendingEnabled = YES;
-        desc.colorAttachments[0].sourceRGBBlendFactor = MTLBlendFactorZero;
-        desc.colorAttachments[0].destinationRGBBlendFactor = MTLBlendFactorZero;
-        desc.colorAttachments[0].rgbBlendOperation = MTLBlendOperationAdd;
-        desc.colorAttachments[0].sourceAlphaBlendFactor = MTLBlendFactorZero;
-        desc.colorAttachments[0].destinationAlphaBlendFactor = MTLBlendFactorZero;
-        desc.colorAttachments[0].alphaBlendOperation = MTLBlendOperationAdd;
-    } else if (blendMode == BlendModeXOR) {
-        // XOR合成
-        desc.colorAttachments[0].blendingEnabled = YES;
-        desc.colorAttachments[0].sourceRGBBlendFactor = MTLBlendFactorOneMinusDestinationColor;
-        desc.colorAttachments[0].destinationRGBBlendFactor = MTLBlendFactorOneMinusSourceColor;
-        desc.colorAttachments[0].rgbBlendOperation = MTLBlendOperationAdd;
-        desc.colorAttachments[0].sourceAlphaBlendFactor = MTLBlendFactorOneMinusDestinationAlpha;
-        desc.colorAttachments[0].destinationAlphaBlendFactor = MTLBlendFactorOneMinusSourceAlpha;
-        desc.colorAttachments[0].alphaBlendOperation = MTLBlendOperationAdd;
-    } else if (blendMode == BlendModeInvert) {
-        // 反転合成
-        desc.colorAttachments[0].blendingEnabled = YES;
-        desc.colorAttachments[0].sourceRGBBlendFactor = MTLBlendFactorOneMinusDestinationColor;
-        desc.colorAttachments[0].destinationRGBBlendFactor = MTLBlendFactorZero;
-        desc.colorAttachments[0].rgbBlendOperation = MTLBlendOperationAdd;
-        desc.colorAttachments[0].sourceAlphaBlendFactor = MTLBlendFactorOneMinusDestinationAlpha;
-        desc.colorAttachments[0].destinationAlphaBlendFactor = MTLBlendFactorZero;
-        desc.colorAttachments[0].alphaBlendOperation = MTLBlendOperationAdd;
-    } else if (blendMode == BlendModeMultiply) {
-        // 乗算合成
-        desc.colorAttachments[0].blendingEnabled = YES;
-        desc.colorAttachments[0].sourceRGBBlendFactor = MTLBlendFactorZero;
-        desc.colorAttachments[0].destinationRGBBlendFactor = MTLBlendFactorSourceColor;
-        desc.colorAttachments[0].rgbBlendOperation = MTLBlendOperationAdd;
-        desc.colorAttachments[0].sourceAlphaBlendFactor = MTLBlendFactorZero;
-        desc.colorAttachments[0].destinationAlphaBlendFactor = MTLBlendFactorSourceAlpha;
-        desc.colorAttachments[0].alphaBlendOperation = MTLBlendOperationAdd;
-    } else if (blendMode == BlendModeAdd) {
-        // 加算合成（覆い焼き（リニア））
-        desc.colorAttachments[0].blendingEnabled = YES;
-        desc.colorAttachments[0].sourceRGBBlendFactor = MTLBlendFactorSourceAlpha;
-        desc.colorAttachments[0].destinationRGBBlendFactor = MTLBlendFactorOne;
-        desc.colorAttachments[0].rgbBlendOperation = MTLBlendOperationAdd;
-        desc.colorAttachments[0].sourceAlphaBlendFactor = MTLBlendFactorSourceAlpha;
-        desc.colorAttachments[0].destinationAlphaBlendFactor = MTLBlendFactorOne;
-        desc.colorAttachments[0].alphaBlendOperation = MTLBlendOperationAdd;
-    } else if (blendMode == BlendModeScreen) {
-        // スクリーン合成
-        desc.colorAttachments[0].blendingEnabled = YES;
-        desc.colorAttachments[0].sourceRGBBlendFactor = MTLBlendFactorOneMinusDestinationColor;
-        desc.colorAttachments[0].destinationRGBBlendFactor = MTLBlendFactorOne;
-        desc.colorAttachments[0].rgbBlendOperation = MTLBlendOperationAdd;
-        desc.colorAttachments[0].sourceAlphaBlendFactor = MTLBlendFactorOneMinusDestinationAlpha;
-        desc.colorAttachments[0].destinationAlphaBlendFactor = MTLBlendFactorOne;
-        desc.colorAttachments[0].alphaBlendOperation = MTLBlendOperationAdd;
-    } else {
-        // アルファ合成
-        desc.colorAttachments[0].blendingEnabled = YES;
-        desc.colorAttachments[0].sourceRGBBlendFactor = MTLBlendFactorSourceAlpha;
-        desc.colorAttachments[0].destinationRGBBlendFactor = MTLBlendFactorOneMinusSourceAlpha;
-        desc.colorAttachments[0].rgbBlendOperation = MTLBlendOperationAdd;
-        desc.colorAttachments[0].sourceAlphaBlendFactor = MTLBlendFactorSourceAlpha;
-        desc.colorAttachments[0].destinationAlphaBlendFactor = MTLBlendFactorOneMinusSourceAlpha;
-        desc.colorAttachments[0].alphaBlendOperation = MTLBlendOperationAdd;
-    }
-
-    NSError *error = NULL;
-    id<MTLRenderPipelineState> ret = [_device newRenderPipelineStateWithDescriptor:desc error:&error];
-    if (!ret) {
-        NSLog(@"Failed to created pipeline state for simple drawing: Error=\"%@\"", error);
-    }
-    return ret;
-}
-
 - (void)_loadMetalWithView:(nonnull MTKView *)view
 {
     sMetalView = view;
@@ -385,31 +630,46 @@ void FlushVertexRendering()
     //view.colorPixelFormat = MTLPixelFormatBGRA8Unorm_sRGB;
     view.sampleCount = 1;
 
-    os_log(OS_LOG_DEFAULT, "size: %lu", sizeof(AAPLVertex));
-
     // 頂点データのバッファを用意する
-    sVertexBufferSize = sizeof(AAPLVertex) * METAL_MAX_POLYGON_COUNT * 3;
-    sMetalVertexBuffer = [_device newBufferWithLength:sVertexBufferSize options:MTLResourceStorageModeShared];
+    size_t vertexBufferSize = sizeof(AAPLVertex) * METAL_MAX_POLYGON_COUNT * 3;
+    // CPUからは書き込むだけなので、キャッシュを汚さないライトコンバインドのメモリを使う
+    sMetalVertexBuffer = [_device newBufferWithLength:vertexBufferSize options:MTLResourceStorageModeShared | MTLResourceCPUCacheModeWriteCombined];
     sMetalVertexBuffer.label = @"MetalVertexBuffer";
 
+    // 即時描画のバッチで使う16ビットのインデックスのバッファを用意する
+    size_t indexBufferSize = sizeof(uint16_t) * METAL_MAX_POLYGON_COUNT * 3;
+    sMetalIndexBuffer = [_device newBufferWithLength:indexBufferSize options:MTLResourceStorageModeShared | MTLResourceCPUCacheModeWriteCombined];
+    sMetalIndexBuffer.label = @"MetalIndexBuffer";
+
+    // バッチはこの2つのバッファに直接書き込まれる
+    __InitBatchRenderer((char *)sMetalVertexBuffer.contents, vertexBufferSize, (uint16_t *)sMetalIndexBuffer.contents, indexBufferSize);
+
     // シェーダを使ったパイプラインの用意
     id<MTLLibrary> metalLib = [_device newDefaultLibrary];
     _pipelineState = [self createTextureDrawingPipelineWithLibrary:metalLib view:view];
-    sPipelineState_SimpleDraw_Alpha = [self createSimpleDrawingPipelineWithLibrary:metalLib view:view blendMode:BlendModeAlpha];
-    sPipelineState_SimpleDraw_Screen = [self createSimpleDrawingPipelineWithLibrary:metalLib view:view blendMode:BlendModeScreen];
-    sPipelineState_SimpleDraw_Add = [self createSimpleDrawingPipelineWithLibrary:metalLib view:view blendMode:BlendModeAdd];
-    sPipelineState_SimpleDraw_Multiply = [self createSimpleDrawingPipelineWithLibrary:metalLib view:view blendMode:BlendModeMultiply];
-    sPipelineState_SimpleDraw_Invert = [self createSimpleDrawingPipelineWithLibrary:metalLib view:view blendMode:BlendModeInvert];
-    sPipelineState_SimpleDraw_XOR = [self createSimpleDrawingPipelineWithLibrary:metalLib view:view blendMode:BlendModeXOR];
-    sPipelineState_SimpleDraw_Copy = [self createSimpleDrawingPipelineWithLibrary:metalLib view:view blendMode:BlendModeCopy];
-    sPipelineState_SimpleDraw_Clear = [self createSimpleDrawingPipelineWithLibrary:metalLib view:view blendMode:BlendModeClear];
+
+    // 2D描画のパイプラインは、描画で初めて使われた組み合わせだけを作成する。
+    // ほぼ確実に使われるアルファ合成の図形描画とスプライト描画だけは、最初のフレームが遅れないように先に作っておく。
+    InitPipelineCache(_device, metalLib);
+    PrewarmBlendModes(std::vector<BlendMode>(1, BlendModeAlpha));
+
+    // インスタンス描画用の図形の頂点テーブルを用意する
+    sMetalShapeVertexBuffer = [_device newBufferWithBytes:GetInstanceShapeVertices()
+                                                   length:sizeof(float) * 2 * GetInstanceShapeVertexCount()
+                                                  options:MTLResourceStorageModeShared];
+    sMetalShapeVertexBuffer.label = @"MetalShapeVertexBuffer";
+    sMetalShapeInfoBuffer = [_device newBufferWithBytes:GetInstanceShapeInfos()
+                                                 length:sizeof(InstanceShapeInfo) * InstanceShapeCount
+                                                options:MTLResourceStorageModeShared];
+    sMetalShapeInfoBuffer.label = @"MetalShapeInfoBuffer";
 
     MTLDepthStencilDescriptor *depthStateDesc = [[MTLDepthStencilDescriptor alloc] init];
     depthStateDesc.depthCompareFunction = MTLCompareFunctionLess;
     depthStateDesc.depthWriteEnabled = YES;
     _depthState = [_device newDepthStencilStateWithDescriptor:depthStateDesc];
 
-    NSUInteger uniformBufferSize = kAlignedUniformsSize * kMaxBuffersInFlight;
+    // フレームごとの領域には、3D描画用のユニフォームに続けて、カメラを切り替えるたびに使う2D描画用のユニフォームを並べる
+    NSUInteger uniformBufferSize = kAlignedFrameUniformsSize * kMaxBuffersInFlight;
 
     _dynamicUniformBuffer = [_device newBufferWithLength:uniformBufferSize
                                                  options:MTLResourceStorageModeShared];
@@ -417,6 +677,7 @@ void FlushVertexRendering()
     _dynamicUniformBuffer.label = @"UniformBuffer";
 
     _commandQueue = [_device newCommandQueue];
+    sCommandQueue = _commandQueue;
 }
 
 - (void)_loadAssets
@@ -468,8 +729,11 @@ void FlushVertexRendering()
 - (void)_updateDynamicBufferState
 {
     _uniformBufferIndex = (_uniformBufferIndex + 1) % kMaxBuffersInFlight;
-    _uniformBufferOffset = kAlignedUniformsSize * _uniformBufferIndex;
+    _uniformBufferOffset = kAlignedFrameUniformsSize * _uniformBufferIndex;
     _uniformBufferAddress = ((uint8_t *)_dynamicUniformBuffer.contents) + _uniformBufferOffset;
+
+    sUniformBuffer = _dynamicUniformBuffer;
+    sUniforms2DBaseOffset = _uniformBufferOffset + kAlignedUniformsSize;
 }
 
 - (void)_updateGameState
@@ -553,26 +817,7 @@ void FlushVertexRendering()
     [self _updateDynamicBufferState];
     [self _updateGameState];
 
-    Input::__UpdateTriggers();
-    Time::__Update();
-
-    InitRenderingState();
-    Update();
-
-    // バッチ処理のデータがあれば吐き出す
-    if (sBatchedPolygonCount > 0) {
-        FlushVertexRendering();
-    }
-
-    //[self drawBoxWithView:view commandBuffer:commandBuffer];
-    //passCount++;
-
-    if (sPassCount > 0) {
-        [commandBuffer presentDrawable:view.currentDrawable];
-        [commandBuffer commit];
-    }
-
-    Time::frameCount++;
+    __RunFrame();
 
     //os_log(OS_LOG_DEFAULT, "\\------/");
 }
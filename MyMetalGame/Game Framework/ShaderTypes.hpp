@@ -22,7 +22,8 @@ typedef NS_ENUM(NSInteger, BufferIndex)
 {
     BufferIndexMeshPositions = 0,
     BufferIndexMeshGenerics  = 1,
-    BufferIndexUniforms      = 2
+    BufferIndexUniforms      = 2,
+    BufferIndexUniforms2D    = 4
 };
 
 typedef NS_ENUM(NSInteger, VertexAttribute)
@@ -42,5 +43,18 @@ typedef struct
     matrix_float4x4 modelViewMatrix;
 } Uniforms;
 
+typedef struct
+{
+    matrix_float4x4 viewProjectionMatrix;
+} Uniforms2D;
+
+typedef struct
+{
+    vector_float2   axisX;
+    vector_float2   axisY;
+    vector_float2   translation;
+    vector_float4   tint;
+} StaticMeshUniforms;
+
 #endif /* ShaderTypes_hpp */
 
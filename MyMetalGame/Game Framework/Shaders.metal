@@ -66,13 +66,12 @@ struct ColorInOut
     float4 color;
 };
 
-vertex ColorInOut vertexShader2(ColorIn in [[stage_in]])
+vertex ColorInOut vertexShader2(ColorIn in [[stage_in]],
+                                constant Uniforms2D &uniforms [[buffer(BufferIndexUniforms2D)]])
 {
     ColorInOut out;
 
-    out.position.xy = in.position;
-    out.position.z = 0.0;
-    out.position.w = 1.0;
+    out.position = uniforms.viewProjectionMatrix * float4(in.position, 0.0, 1.0);
     out.color = in.color;
 
     return out;
@@ -83,3 +82,107 @@ fragment float4 fragmentShader2(ColorInOut in [[stage_in]])
     return in.color;
 }
 
+
+
+//// Shader 3 (インスタンス描画)
+
+// InstanceShapes.hpp の InstanceData と同じレイアウト（32バイト）
+struct InstanceData
+{
+    packed_float2   axisX;
+    packed_float2   axisY;
+    packed_float2   translation;
+    uint            color;
+    uint            shape;
+};
+
+// InstanceShapes.hpp の InstanceShapeInfo と同じレイアウト
+struct InstanceShapeInfo
+{
+    uint    firstVertex;
+    uint    vertexCount;
+};
+
+vertex ColorInOut vertexShaderInstanced(uint vertexID [[vertex_id]],
+                                        uint instanceID [[instance_id]],
+                                        const device InstanceData *instances [[buffer(0)]],
+                                        const device packed_float2 *shapeVertices [[buffer(1)]],
+                                        constant InstanceShapeInfo *shapeInfos [[buffer(2)]],
+                                        constant int &shapeOverride [[buffer(3)]],
+                                        constant Uniforms2D &uniforms [[buffer(BufferIndexUniforms2D)]])
+{
+    InstanceData instance = instances[instanceID];
+    uint shape = (shapeOverride >= 0)? uint(shapeOverride): instance.shape;
+    InstanceShapeInfo info = shapeInfos[min(shape, 2u)];    // InstanceShapeCount - 1 に制限する
+
+    ColorInOut out;
+
+    // 図形ごとに頂点数が異なるので、余った頂点は面積ゼロの三角形にする
+    if (vertexID >= info.vertexCount) {
+        out.position = float4(0.0, 0.0, 0.0, 1.0);
+        out.color = float4(0.0);
+        return out;
+    }
+
+    float2 v = shapeVertices[info.firstVertex + vertexID];
+    float2 position = float2(instance.axisX) * v.x + float2(instance.axisY) * v.y + float2(instance.translation);
+    out.position = uniforms.viewProjectionMatrix * float4(position, 0.0, 1.0);
+    out.color = unpack_unorm4x8_to_float(instance.color);
+
+    return out;
+}
+
+
+//// Shader 4（スプライト描画）
+
+struct SpriteIn
+{
+    float2   position    [[attribute(0)]];
+    float2   texCoord    [[attribute(1)]];
+    float4   color       [[attribute(2)]];
+};
+
+struct SpriteInOut
+{
+    float4 position [[position]];
+    float2 texCoord;
+    float4 color;
+};
+
+vertex SpriteInOut vertexShaderSprite(SpriteIn in [[stage_in]],
+                                     constant Uniforms2D &uniforms [[buffer(BufferIndexUniforms2D)]])
+{
+    SpriteInOut out;
+
+    out.position = uniforms.viewProjectionMatrix * float4(in.position, 0.0, 1.0);
+    out.texCoord = in.texCoord;
+    out.color = in.color;
+
+    return out;
+}
+
+fragment float4 fragmentShaderSprite(SpriteInOut in [[stage_in]],
+                                     texture2d<float> atlas [[ texture(0) ]])
+{
+    constexpr sampler atlasSampler(mag_filter::linear,
+                                   min_filter::linear,
+                                   address::clamp_to_edge);
+    return atlas.sample(atlasSampler, in.texCoord) * in.color;
+}
+
+
+//// Shader 5（静的メッシュ描画）
+
+vertex ColorInOut vertexShaderStaticMesh(ColorIn in [[stage_in]],
+                                         constant StaticMeshUniforms &mesh [[buffer(1)]],
+                                         constant Uniforms2D &uniforms [[buffer(BufferIndexUniforms2D)]])
+{
+    ColorInOut out;
+
+    // 記録したときの頂点は変更せず、描画するたびに変換と色を掛け合わせる
+    float2 position = mesh.axisX * in.position.x + mesh.axisY * in.position.y + mesh.translation;
+    out.position = uniforms.viewProjectionMatrix * float4(position, 0.0, 1.0);
+    out.color = in.color * mesh.tint;
+
+    return out;
+}
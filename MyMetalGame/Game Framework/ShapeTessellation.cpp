@@ -0,0 +1,309 @@
+//
+//  ShapeTessellation.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "ShapeTessellation.hpp"
+#include "Rect.hpp"
+#include "DebugSupport.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+// 段階ごとの円の分割数
+static const int    kCircleSegmentCounts[kCircleLODCount] = { 8, 16, 32, 64, 128 };
+
+// 円周と多角形の辺の間の許容誤差（クリップ座標で約1ピクセル）
+static const float  kCircleTolerance = 0.001f;
+
+// 留め継ぎの長さの上限（太さの半分に対する倍率）
+static const float  kMiterLimit = 4.0f;
+
+
+void ShapeMesh::Clear()
+{
+    positions.clear();
+    indices.clear();
+}
+
+uint16_t ShapeMesh::AddVertex(const Vector2& pos)
+{
+    // 16ビットのインデックスで参照できない頂点を追加すると、インデックスが桁あふれして別の頂点を指してしまう
+    if (positions.size() > 0xffff) {
+        AbortGame("1つの図形の頂点数が、16ビットのインデックスで参照できる数（%d個）を超えました。", 0x10000);
+    }
+    positions.push_back(pos);
+    return (uint16_t)(positions.size() - 1);
+}
+
+void ShapeMesh::AddTriangle(uint16_t i1, uint16_t i2, uint16_t i3)
+{
+    indices.push_back(i1);
+    indices.push_back(i2);
+    indices.push_back(i3);
+}
+
+
+struct UnitCircleTable
+{
+    std::vector<Vector2>    points[kCircleLODCount];
+
+    UnitCircleTable()
+    {
+        for (int lod = 0; lod < kCircleLODCount; lod++) {
+            int segmentCount = kCircleSegmentCounts[lod];
+            points[lod].reserve(segmentCount);
+            for (int i = 0; i < segmentCount; i++) {
+                double angle = M_PI * 2 * i / segmentCount;
+                points[lod].push_back(Vector2((float)cos(angle), (float)sin(angle)));
+            }
+        }
+    }
+};
+
+static const UnitCircleTable& GetUnitCircleTable()
+{
+    static UnitCircleTable table;
+    return table;
+}
+
+
+int SelectCircleLOD(float radius)
+{
+    radius = fabsf(radius);
+    if (radius <= kCircleTolerance) {
+        return 0;
+    }
+
+    // 弦と円弧の最大の距離 r(1 - cos(θ/2)) が許容誤差以下になる分割数を求める
+    float neededCount = (float)M_PI / acosf(1.0f - kCircleTolerance / radius);
+    for (int lod = 0; lod < kCircleLODCount; lod++) {
+        if (kCircleSegmentCounts[lod] >= neededCount) {
+            return lod;
+        }
+    }
+    return kCircleLODCount - 1;
+}
+
+int GetCircleSegmentCount(int lod)
+{
+    return kCircleSegmentCounts[std::min(std::max(lod, 0), kCircleLODCount - 1)];
+}
+
+const std::vector<Vector2>& GetUnitCirclePoints(int lod)
+{
+    return GetUnitCircleTable().points[std::min(std::max(lod, 0), kCircleLODCount - 1)];
+}
+
+
+void TessellateRect(const Game::Rect& rect, ShapeMesh& mesh)
+{
+    uint16_t i1 = mesh.AddVertex(Vector2(rect.x, rect.y));
+    uint16_t i2 = mesh.AddVertex(Vector2(rect.x + rect.width, rect.y));
+    uint16_t i3 = mesh.AddVertex(Vector2(rect.x + rect.width, rect.y + rect.height));
+    uint16_t i4 = mesh.AddVertex(Vector2(rect.x, rect.y + rect.height));
+    mesh.AddTriangle(i1, i2, i3);
+    mesh.AddTriangle(i1, i3, i4);
+}
+
+void TessellateEllipse(const Vector2& center, float radiusX, float radiusY, ShapeMesh& mesh)
+{
+    const std::vector<Vector2>& circle = GetUnitCirclePoints(SelectCircleLOD(std::max(fabsf(radiusX), fabsf(radiusY))));
+    uint16_t centerIndex = mesh.AddVertex(center);
+    uint16_t firstIndex = (uint16_t)mesh.positions.size();
+    for (const Vector2& p : circle) {
+        mesh.AddVertex(Vector2(center.x + p.x * radiusX, center.y + p.y * radiusY));
+    }
+
+    uint16_t count = (uint16_t)circle.size();
+    for (uint16_t i = 0; i < count; i++) {
+        mesh.AddTriangle(centerIndex, firstIndex + i, firstIndex + (i + 1) % count);
+    }
+}
+
+void TessellateRoundedRect(const Game::Rect& rect, float radius, ShapeMesh& mesh)
+{
+    float xMin = std::min(rect.x, rect.x + rect.width);
+    float yMin = std::min(rect.y, rect.y + rect.height);
+    float xMax = std::max(rect.x, rect.x + rect.width);
+    float yMax = std::max(rect.y, rect.y + rect.height);
+    radius = std::min(fabsf(radius), std::min(xMax - xMin, yMax - yMin) / 2);
+    if (radius <= 0.0f) {
+        TessellateRect(rect, mesh);
+        return;
+    }
+
+    // 右下・右上・左上・左下の順に、各角の90度の円弧を単位円から取り出して並べる
+    const std::vector<Vector2>& circle = GetUnitCirclePoints(SelectCircleLOD(radius));
+    int quarterCount = (int)circle.size() / 4;
+    Vector2 corners[4] = {
+        Vector2(xMax - radius, yMin + radius),
+        Vector2(xMax - radius, yMax - radius),
+        Vector2(xMin + radius, yMax - radius),
+        Vector2(xMin + radius, yMin + radius),
+    };
+
+    uint16_t centerIndex = mesh.AddVertex(Vector2((xMin + xMax) / 2, (yMin + yMax) / 2));
+    uint16_t firstIndex = (uint16_t)mesh.positions.size();
+    for (int corner = 0; corner < 4; corner++) {
+        int startPoint = ((corner + 3) % 4) * quarterCount;
+        for (int i = 0; i <= quarterCount; i++) {
+            const Vector2& p = circle[(startPoint + i) % circle.size()];
+            mesh.AddVertex(Vector2(corners[corner].x + p.x * radius, corners[corner].y + p.y * radius));
+        }
+    }
+
+    uint16_t count = (uint16_t)(mesh.positions.size() - firstIndex);
+    for (uint16_t i = 0; i < count; i++) {
+        mesh.AddTriangle(centerIndex, firstIndex + i, firstIndex + (i + 1) % count);
+    }
+}
+
+
+static inline float Cross(const Vector2& o, const Vector2& a, const Vector2& b)
+{
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+static bool IsPointInTriangle(const Vector2& p, const Vector2& a, const Vector2& b, const Vector2& c)
+{
+    // 反時計回りの三角形に対して、辺上の点も内側として扱う
+    return (Cross(a, b, p) >= 0.0f && Cross(b, c, p) >= 0.0f && Cross(c, a, p) >= 0.0f);
+}
+
+void TessellatePolygon(const Vector2 *points, size_t count, ShapeMesh& mesh)
+{
+    if (count < 3) {
+        return;
+    }
+
+    uint16_t firstIndex = (uint16_t)mesh.positions.size();
+    float area = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        mesh.AddVertex(points[i]);
+        const Vector2& p1 = points[i];
+        const Vector2& p2 = points[(i + 1) % count];
+        area += p1.x * p2.y - p2.x * p1.y;
+    }
+
+    // 反時計回りになるように頂点の並びを作る
+    std::vector<uint16_t> remaining(count);
+    for (size_t i = 0; i < count; i++) {
+        remaining[i] = (uint16_t)((area >= 0.0f)? i: count - 1 - i);
+    }
+
+    // 凸な頂点のうち、他の頂点を内側に含まないもの（耳）を1つずつ切り取っていく
+    size_t failCount = 0;
+    size_t i = 0;
+    while (remaining.size() > 3) {
+        size_t n = remaining.size();
+        uint16_t prev = remaining[(i + n - 1) % n];
+        uint16_t cur = remaining[i % n];
+        uint16_t next = remaining[(i + 1) % n];
+        const Vector2& a = points[prev];
+        const Vector2& b = points[cur];
+        const Vector2& c = points[next];
+
+        bool isEar = (Cross(a, b, c) > 0.0f);
+        for (size_t j = 0; isEar && j < n; j++) {
+            uint16_t other = remaining[j];
+            if (other == prev || other == cur || other == next) {
+                continue;
+            }
+            if (IsPointInTriangle(points[other], a, b, c)) {
+                isEar = false;
+            }
+        }
+
+        if (isEar) {
+            mesh.AddTriangle(firstIndex + prev, firstIndex + cur, firstIndex + next);
+            remaining.erase(remaining.begin() + i % n);
+            failCount = 0;
+        } else {
+            i++;
+            failCount++;
+
+            // 自己交差や縮退で耳が見つからなくなったら、残りは扇状に分割する
+            if (failCount > n) {
+                for (size_t k = 1; k + 1 < n; k++) {
+                    mesh.AddTriangle(firstIndex + remaining[0], firstIndex + remaining[k], firstIndex + remaining[k + 1]);
+                }
+                return;
+            }
+        }
+    }
+    mesh.AddTriangle(firstIndex + remaining[0], firstIndex + remaining[1], firstIndex + remaining[2]);
+}
+
+void TessellatePolyline(const Vector2 *points, size_t count, float thickness, bool isClosed, ShapeMesh& mesh)
+{
+    // 連続する同じ座標の点は取り除く
+    std::vector<Vector2> line;
+    line.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        if (line.empty() || line.back() != points[i]) {
+            line.push_back(points[i]);
+        }
+    }
+    if (isClosed && line.size() > 2 && line.front() == line.back()) {
+        line.pop_back();
+    }
+    size_t n = line.size();
+    if (n < 2) {
+        return;
+    }
+    if (n == 2) {
+        isClosed = false;
+    }
+
+    float halfThickness = fabsf(thickness) / 2;
+    size_t segmentCount = isClosed? n: n - 1;
+
+    // 線分ごとの左向きの法線
+    std::vector<Vector2> normals(segmentCount);
+    for (size_t i = 0; i < segmentCount; i++) {
+        Vector2 dir = line[(i + 1) % n] - line[i];
+        float length = sqrtf(dir.x * dir.x + dir.y * dir.y);
+        normals[i] = Vector2(-dir.y / length, dir.x / length);
+    }
+
+    // 各点の左右に1つずつ頂点を置き、隣り合う線分で共有する
+    uint16_t firstIndex = (uint16_t)mesh.positions.size();
+    for (size_t i = 0; i < n; i++) {
+        Vector2 offset;
+        if (!isClosed && i == 0) {
+            offset = normals[0] * halfThickness;
+        } else if (!isClosed && i == n - 1) {
+            offset = normals[n - 2] * halfThickness;
+        } else {
+            const Vector2& n1 = normals[(i + segmentCount - 1) % segmentCount];
+            const Vector2& n2 = normals[i % segmentCount];
+            Vector2 miter = n1 + n2;
+            float miterLength = sqrtf(miter.x * miter.x + miter.y * miter.y);
+            if (miterLength < 1e-6f) {
+                // 折り返している場合は手前の線分の法線をそのまま使う
+                offset = n1 * halfThickness;
+            } else {
+                miter = miter / miterLength;
+                float scale = halfThickness / std::max(miter.x * n1.x + miter.y * n1.y, 1.0f / kMiterLimit);
+                offset = miter * scale;
+            }
+        }
+        mesh.AddVertex(line[i] + offset);
+        mesh.AddVertex(line[i] - offset);
+    }
+
+    for (size_t i = 0; i < segmentCount; i++) {
+        uint16_t left1 = (uint16_t)(firstIndex + i * 2);
+        uint16_t right1 = left1 + 1;
+        uint16_t left2 = (uint16_t)(firstIndex + ((i + 1) % n) * 2);
+        uint16_t right2 = left2 + 1;
+        mesh.AddTriangle(right1, right2, left2);
+        mesh.AddTriangle(right1, left2, left1);
+    }
+}
+
@@ -0,0 +1,69 @@
+//
+//  ShapeTessellation.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef ShapeTessellation_hpp
+#define ShapeTessellation_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Vector2.hpp"
+
+namespace Game { struct Rect; }
+
+
+/// 図形を三角形に分割した結果です。頂点は共有され、16ビットのインデックスで3つずつ三角形を表します。
+struct ShapeMesh
+{
+    /// 頂点の位置
+    std::vector<Vector2>    positions;
+
+    /// 三角形を構成する頂点のインデックス
+    std::vector<uint16_t>   indices;
+
+    /// 頂点とインデックスをすべて破棄します（確保済みのメモリは再利用されます）。
+    void        Clear();
+
+    /// 頂点を追加し、そのインデックスを返します。頂点数が65536個を超える場合はエラーになります。
+    uint16_t    AddVertex(const Vector2& pos);
+
+    /// 三角形を追加します。
+    void        AddTriangle(uint16_t i1, uint16_t i2, uint16_t i3);
+};
+
+
+/// 円の分割数の段階（LOD）の数
+static const int    kCircleLODCount = 5;
+
+/// 半径に応じて、見た目の誤差が許容範囲に収まる最小の円の分割数の段階を選択します。
+int     SelectCircleLOD(float radius);
+
+/// 指定した段階の円の分割数を取得します。分割数は常に4の倍数です。
+int     GetCircleSegmentCount(int lod);
+
+/// 指定した段階の単位円上の点（角度0から反時計回り、分割数と同じ個数）を取得します。計算結果はキャッシュされます。
+/// 分割数が4の倍数なので、4分の1ずつ取り出すと90度の円弧としても使えます。
+const std::vector<Vector2>&     GetUnitCirclePoints(int lod);
+
+/// 矩形を4頂点・2つの三角形に分割します。
+void    TessellateRect(const Game::Rect& rect, ShapeMesh& mesh);
+
+/// 楕円を中心から扇状に分割します。分割数は大きいほうの半径から選択されます。
+void    TessellateEllipse(const Vector2& center, float radiusX, float radiusY, ShapeMesh& mesh);
+
+/// 角を丸めた矩形を分割します。半径は短いほうの辺の半分までに制限されます。
+void    TessellateRoundedRect(const Game::Rect& rect, float radius, ShapeMesh& mesh);
+
+/// 自己交差のない多角形を、耳切り法で三角形に分割します。頂点の順番は時計回りでも反時計回りでも構いません。
+void    TessellatePolygon(const Vector2 *points, size_t count, ShapeMesh& mesh);
+
+/// 折れ線を指定した太さの帯に分割します。折れ目は留め継ぎ（長くなりすぎる場合は太さの一定倍まで）でつなぎます。
+void    TessellatePolyline(const Vector2 *points, size_t count, float thickness, bool isClosed, ShapeMesh& mesh);
+
+
+#endif /* ShapeTessellation_hpp */
@@ -9,18 +9,238 @@
 #ifndef SimpleDraw_hpp
 #define SimpleDraw_hpp
 
+#include "Camera2D.hpp"
 #include "Color.hpp"
+#include "Matrix4x4.hpp"
+#include "Rect.hpp"
 #include "Vector2.hpp"
 #include "BlendMode.hpp"
+#include "BatchMode.hpp"
+#include "InstanceShapes.hpp"
+#include "VertexFormat.hpp"
+#include "Sprite.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
 
 
 void    Clear(const Color& color);
 
 void    SetBlendMode(BlendMode blendMode);
 
+/// 指定したブレンドモードの図形描画・スプライト描画のパイプラインを、描画で必要になる前に作成しておきます。
+/// パイプラインは初めて使われたときに作成されるので、シーンの切り替え時などに呼び出しておくと、描画中のコンパイルによる引っかかりを避けられます。
+void    PrewarmBlendModes(const std::vector<BlendMode>& blendModes);
+
+/// 描画コマンドの処理方法を設定します。BatchModeDeferredを指定すると、描画コマンドはフレームの終わりに描画状態ごとに並べ替えられ、まとめて描画されます。
+void    SetBatchMode(BatchMode batchMode);
+
+/// 更新と描画のパイプライン化を設定します。有効にすると、次のフレームから、FixedUpdate()とUpdate()はシミュレーション用のスレッドで実行され、
+/// メインスレッドはその間に、1つ前のフレームで記録された描画内容をエンコードします。表示は1フレーム遅れますが、CPUで重いシーンのフレームレートが改善します。
+/// パイプライン化している間は、描画コマンドはBatchModeDeferredで記録されるので、記録だけで済む描画（図形・スプライト・テキスト）と、
+/// 最初の描画より前のClear()・SetCamera()だけが使えます。クリップ矩形、レンダーターゲット、静的メッシュ、インスタンス描画を使うとゲームが終了します。
+/// 無効に戻すと、パイプライン化する前の描画モード（SetBatchMode()）に戻ります。
+void    SetPipelinedUpdateEnabled(bool isEnabled);
+
+/// 更新と描画のパイプライン化が設定されているかどうかを取得します。
+bool    IsPipelinedUpdateEnabled();
+
+/// 以降の描画のレイヤを設定します。レイヤの大きいものほど後に（手前に）描画されます。値は-32768〜32767に制限され、フレームの始めに0に戻ります。
+/// レイヤと深度はBatchModeDeferredのときに描画順序に反映され、BatchModeImmediateでは呼び出し順に描画されます。
+void    SetLayer(int layer);
+
+/// 現在のレイヤを取得します。
+int     GetLayer();
+
+/// 以降の描画の、同じレイヤの中での深度を設定します。深度の大きいものほど先に（奥に）描画されます。値は0.0〜1.0に制限され、フレームの始めに0.0に戻ります。
+/// 同じレイヤ・同じ深度の描画は呼び出し順に描画されます。
+void    SetDepth(float depth);
+
+/// 現在の深度を取得します。
+float   GetDepth();
+
+/// 図形描画で使用する頂点フォーマットを設定します。VertexFormatCompactを指定すると、頂点あたりのデータ量が1/3になります。
+void    SetVertexFormat(VertexFormat vertexFormat);
+
+/// 現在の変換をスタックに積みます。変換はフレームの始めに単位行列に戻ります。
+void    PushMatrix();
+
+/// PushMatrix()で積んだ変換を取り出して、現在の変換に戻します。
+void    PopMatrix();
+
+/// 現在の変換を単位行列に戻します。スタックに積まれた変換はそのまま残ります。
+void    ResetMatrix();
+
+/// 平行移動を現在の変換に掛け合わせます。以降に描画する図形の座標は、移動した座標系で解釈されます。
+void    Translate(float x, float y);
+void    Translate(const Vector2& pos);
+
+/// 原点を中心とした回転（ラジアン）を現在の変換に掛け合わせます。
+void    Rotate(float rad);
+
+/// 拡大・縮小を現在の変換に掛け合わせます。
+void    Scale(float scale);
+void    Scale(float x, float y);
+
+/// 任意の変換行列を現在の変換に掛け合わせます。行列のZ成分は無視されます。
+void    MultiplyMatrix(const Matrix4x4& matrix);
+
+/// 現在の変換を取得します。
+Matrix4x4   GetMatrix();
+
+/// クリップ矩形をスタックに積みます。以降の描画は、この矩形と、それまでに積まれたクリップ矩形の内側だけに制限されます。
+/// 矩形は現在の変換を適用した座標で解釈され、回転している場合はそれを囲む矩形になります。完全に外側にある三角形は、頂点を書き込む前に捨てられます。
+void    PushClipRect(const Game::Rect& rect);
+
+/// PushClipRect()で積んだクリップ矩形を取り出します。
+void    PopClipRect();
+
+/// 描画に使用するカメラを設定します。以降の描画の座標は、クリップ座標ではなくカメラから見たワールド座標で解釈されます。
+/// カメラの設定はフレームをまたいで維持されます。
+void    SetCamera(const Camera2D& camera);
+
+/// カメラの設定を解除して、座標をクリップ座標（-1.0〜1.0）で解釈する状態に戻します。
+void    ResetCamera();
+
 void    FillTriangle(const Vector2 pos[3], const Color& color);
 void    FillTriangle(const Vector2 pos[3], const Color color[3]);
 void    FillTriangle(const Vector2& p1, const Vector2& p2, const Vector2& p3, const Color& color);
 void    FillTriangle(const Vector2& p1, const Vector2& p2, const Vector2& p3, const Color& c1, const Color& c2, const Color& c3);
 
+/// 3頂点ずつを1つの三角形として、複数の三角形をまとめて描画します。colorsには頂点ごとの色を指定します。
+void    FillTriangles(const Vector2 *positions, const Color *colors, size_t vertexCount);
+void    FillTriangles(const std::vector<Vector2>& positions, const std::vector<Color>& colors);
+
+/// インデックスで参照する頂点を3つずつ1つの三角形として、複数の三角形をまとめて描画します。
+/// std::vectorを渡す場合、positionsとcolorsの要素数以上のインデックスが含まれているとエラーになります。
+void    FillTriangles(const Vector2 *positions, const Color *colors, const uint16_t *indices, size_t indexCount);
+void    FillTriangles(const std::vector<Vector2>& positions, const std::vector<Color>& colors, const std::vector<uint16_t>& indices);
+
+/// 頂点を共有する複数の三角形を、1色でまとめて描画します。vertexCount以上のインデックスが含まれている場合はエラーになります。
+void    FillTriangles(const Vector2 *positions, size_t vertexCount, const uint16_t *indices, size_t indexCount, const Color& color);
+
+/// 矩形を塗りつぶします。
+void    FillRect(const Game::Rect& rect, const Color& color);
+
+/// 角を丸めた矩形を塗りつぶします。
+void    FillRoundedRect(const Game::Rect& rect, float radius, const Color& color);
+
+/// 円を塗りつぶします。分割数は半径に応じて自動的に選択されます。
+void    FillCircle(const Vector2& center, float radius, const Color& color);
+
+/// 楕円を塗りつぶします。分割数は大きいほうの半径に応じて自動的に選択されます。
+void    FillEllipse(const Vector2& center, float radiusX, float radiusY, const Color& color);
+
+/// 自己交差のない多角形を塗りつぶします。凹んだ多角形も描画できます。頂点が65536個を超える場合はエラーになります。
+void    FillPolygon(const Vector2 *points, size_t count, const Color& color);
+void    FillPolygon(const std::vector<Vector2>& points, const Color& color);
+
+/// 指定した太さの線分を描画します。
+void    DrawLine(const Vector2& p1, const Vector2& p2, float thickness, const Color& color);
+
+/// 指定した太さの折れ線を描画します。isClosedにtrueを指定すると、最後の点と最初の点もつなぎます。
+/// 1つの点につき2つの頂点を使うので、点が32768個を超える場合はエラーになります。
+void    DrawPolyline(const Vector2 *points, size_t count, float thickness, const Color& color, bool isClosed = false);
+void    DrawPolyline(const std::vector<Vector2>& points, float thickness, const Color& color, bool isClosed = false);
+
+/// 画像ファイルを読み込んで、アトラスのページに詰め込みます。
+AtlasImage  LoadImage(const std::string& name);
+
+/// 複数の画像ファイルをまとめて読み込みます。大きさ順に並べてから詰め込むので、1つずつ読み込むよりもページの隙間が少なくなります。
+std::vector<AtlasImage>     LoadImages(const std::vector<std::string>& names);
+
+/// RGBA8（アルファは乗算しない、上の行から順）のピクセル列から画像を作成し、アトラスのページに詰め込みます。
+AtlasImage  CreateImage(const uint8_t *pixels, int width, int height);
+
+/// 画像を描画先の矩形に合わせて描画します。uvRectには画像内の描画する範囲を正規化座標（原点は左上）で指定します。
+/// 同じページの画像は、描画状態が変わらない限り1回の描画呼び出しにまとめられます。
+void    DrawImage(const AtlasImage& image, const Game::Rect& destRect, const Color& tint = Color::white);
+void    DrawImage(const AtlasImage& image, const Game::Rect& destRect, const Game::Rect& uvRect, const Color& tint = Color::white);
+
+/// 中心が原点で1x1の四角形に画像を貼り付け、位置・回転（ラジアン）・拡大率で変換して描画します。
+void    DrawSprite(const AtlasImage& image, const Vector2& position, float rad, const Vector2& scale, const Color& tint = Color::white);
+
+/// 中心が原点で1x1の四角形に画像を貼り付け、変換行列で変換して描画します。行列のZ成分は無視されます。
+void    DrawSprite(const AtlasImage& image, const Matrix4x4& transform, const Color& tint = Color::white);
+void    DrawSprite(const AtlasImage& image, const Game::Rect& uvRect, const Matrix4x4& transform, const Color& tint = Color::white);
+
+/// 作成済みのスプライトの4頂点（左下・右下・右上・左上の順）を、指定したページのテクスチャで描画します。
+void    DrawSpriteQuad(unsigned textureID, const SpriteVertex vertices[4]);
+
+/// フォントを読み込み、フォントのIDを返します。nameには、システムのフォント名か、バンドルに含めたTTF/OTFファイルの名前を指定します。
+/// グリフはpixelSizeの大きさで必要になったときに1回だけラスタライズされ、画像と同じアトラスのページに詰め込まれます。
+int     LoadFont(const std::string& name, float pixelSize);
+
+/// 文字列を描画します。positionは1行目のベースラインの左端で、sizeはフォントの大きさ（描画座標での1emの高さ）です。
+/// レイアウトの結果は（文字列, フォント）ごとにキャッシュされ、同じ文字列を描画し続ける限り再レイアウトは行われません。
+void    DrawText(int fontID, const std::string& text, const Vector2& position, float size, const Color& color);
+
+/// 文字列を描画したときの大きさ（最も長い行の幅と、行の高さ×行数）を描画座標で取得します。
+Vector2 MeasureText(int fontID, const std::string& text, float size);
+
+/// 指定した大きさ（ピクセル）のレンダーターゲットを作成し、そのIDを返します。解放済みで同じ大きさのものがあれば、そのテクスチャが再利用されます。
+int     CreateRenderTarget(int width, int height);
+
+/// レンダーターゲットを解放します。テクスチャは同じ大きさのターゲットを作成するときのために残されます。
+void    ReleaseRenderTarget(int targetID);
+
+/// 解放済みのレンダーターゲットに残されているテクスチャを破棄します。
+void    TrimRenderTargets();
+
+/// 以降の描画の描画先を、レンダーターゲットに切り替えます。描画先を切り替えた直後は内容が不定なので、最初にClear()を呼び出してください。
+/// ターゲット全体がクリップ座標の-1.0〜1.0に対応します（カメラと変換はそのまま適用されます）。
+void    BeginRenderTarget(int targetID);
+
+/// 描画先を画面に戻します。ターゲットの内容は、InvalidateRenderTarget()が呼ばれるまで有効なものとして扱われます。
+void    EndRenderTarget();
+
+/// レンダーターゲットの内容を無効にします。
+void    InvalidateRenderTarget(int targetID);
+
+/// レンダーターゲットの内容が描画済みで、描画し直さずに使えるかどうかを判定します。
+bool    IsRenderTargetValid(int targetID);
+
+/// レンダーターゲットを画像として取得します。DrawImage()やDrawSprite()でそのまま描画できます。
+AtlasImage  GetRenderTargetImage(int targetID);
+
+/// レンダーターゲットを描画先の矩形に合わせて描画します。
+void    DrawRenderTarget(int targetID, const Game::Rect& destRect, const Color& tint = Color::white);
+
+/// レンダーターゲットのテクスチャが使用しているメモリのバイト数（解放済みで再利用を待っているものを含む）を取得します。
+size_t  GetRenderTargetMemoryUsage();
+
+/// 静的メッシュの記録を開始します。EndStaticMesh()までに呼び出したFillTriangle()や図形の描画は、画面には描画されずにメッシュに記録されます。
+/// 記録される座標には、その時点の変換が適用されます。スプライトとインスタンス描画は記録できません。
+void    BeginStaticMesh();
+
+/// 記録済みの静的メッシュの内容を破棄して、記録し直します。
+void    BeginStaticMesh(int meshID);
+
+/// 静的メッシュの記録を終了し、GPUのメモリに転送して、メッシュのIDを返します。
+int     EndStaticMesh();
+
+/// 静的メッシュを、現在の変換を適用して描画します。頂点はGPUのメモリに置かれたままで、1回の描画コマンドで描画されます。
+void    DrawStaticMesh(int meshID, const Color& tint = Color::white);
+
+/// 静的メッシュを、指定した変換と現在の変換を適用して描画します。
+void    DrawStaticMesh(int meshID, const Matrix4x4& transform, const Color& tint = Color::white);
+
+/// 静的メッシュの頂点を書き換えます。positionsかcolorsにnullptrを指定すると、その要素は変更されません。
+/// 書き換えた範囲だけが、次に描画するときにGPUのメモリに転送されます。
+void    UpdateStaticMesh(int meshID, uint32_t firstVertex, const Vector2 *positions, const Color *colors, size_t count);
+
+/// 静的メッシュの頂点数を取得します。頂点は記録した順に並んでいます。
+uint32_t    GetStaticMeshVertexCount(int meshID);
+
+/// 静的メッシュを解放します。
+void    ReleaseStaticMesh(int meshID);
+
+/// 同じ形の図形をインスタンス描画でまとめて描画します。各インスタンスの図形の種類は無視され、shapeで指定した図形が使われます。
+void    DrawInstances(InstanceShape shape, const InstanceData *instances, size_t count);
+void    DrawInstances(InstanceShape shape, const std::vector<InstanceData>& instances);
+
+/// 各インスタンスに指定された図形の種類を使って、インスタンス描画でまとめて描画します。
+void    DrawInstances(const InstanceData *instances, size_t count);
+void    DrawInstances(const std::vector<InstanceData>& instances);
+
 #endif /* SimpleDraw_hpp */
@@ -7,7 +7,10 @@
 //
 
 #include "SimpleDraw.hpp"
-#include "Renderer.hpp"
+#include "ShapeTessellation.hpp"
+#include <algorithm>
+#include <cmath>
+#include "DebugSupport.hpp"
 
 
 void FillTriangle(const Vector2 pos[3], const Color& color)
@@ -25,3 +28,139 @@ void FillTriangle(const Vector2& p1, const Vector2& p2, const Vector2& p3, const
     FillTriangle(p1, p2, p3, color, color, color);
 }
 
+void FillTriangles(const std::vector<Vector2>& positions, const std::vector<Color>& colors)
+{
+    FillTriangles(positions.data(), colors.data(), std::min(positions.size(), colors.size()));
+}
+
+void FillTriangles(const std::vector<Vector2>& positions, const std::vector<Color>& colors, const std::vector<uint16_t>& indices)
+{
+    size_t vertexCount = std::min(positions.size(), colors.size());
+    for (uint16_t index : indices) {
+        if (index >= vertexCount) {
+            AbortGame("頂点数（%lu）以上のインデックス（%u）が指定されました。", (unsigned long)vertexCount, (unsigned)index);
+        }
+    }
+    FillTriangles(positions.data(), colors.data(), indices.data(), indices.size());
+}
+
+// 図形の分割結果を受け取るための作業領域（確保したメモリはフレームをまたいで再利用する）
+static ShapeMesh    sShapeMesh;
+
+static void FillShapeMesh(const ShapeMesh& mesh, const Color& color)
+{
+    FillTriangles(mesh.positions.data(), mesh.positions.size(), mesh.indices.data(), mesh.indices.size(), color);
+}
+
+void FillRect(const Game::Rect& rect, const Color& color)
+{
+    sShapeMesh.Clear();
+    TessellateRect(rect, sShapeMesh);
+    FillShapeMesh(sShapeMesh, color);
+}
+
+void FillRoundedRect(const Game::Rect& rect, float radius, const Color& color)
+{
+    sShapeMesh.Clear();
+    TessellateRoundedRect(rect, radius, sShapeMesh);
+    FillShapeMesh(sShapeMesh, color);
+}
+
+void FillCircle(const Vector2& center, float radius, const Color& color)
+{
+    FillEllipse(center, radius, radius, color);
+}
+
+void FillEllipse(const Vector2& center, float radiusX, float radiusY, const Color& color)
+{
+    sShapeMesh.Clear();
+    TessellateEllipse(center, radiusX, radiusY, sShapeMesh);
+    FillShapeMesh(sShapeMesh, color);
+}
+
+void FillPolygon(const Vector2 *points, size_t count, const Color& color)
+{
+    sShapeMesh.Clear();
+    TessellatePolygon(points, count, sShapeMesh);
+    FillShapeMesh(sShapeMesh, color);
+}
+
+void FillPolygon(const std::vector<Vector2>& points, const Color& color)
+{
+    FillPolygon(points.data(), points.size(), color);
+}
+
+void DrawLine(const Vector2& p1, const Vector2& p2, float thickness, const Color& color)
+{
+    Vector2 points[2] = { p1, p2 };
+    DrawPolyline(points, 2, thickness, color);
+}
+
+void DrawPolyline(const Vector2 *points, size_t count, float thickness, const Color& color, bool isClosed)
+{
+    sShapeMesh.Clear();
+    TessellatePolyline(points, count, thickness, isClosed, sShapeMesh);
+    FillShapeMesh(sShapeMesh, color);
+}
+
+void DrawPolyline(const std::vector<Vector2>& points, float thickness, const Color& color, bool isClosed)
+{
+    DrawPolyline(points.data(), points.size(), thickness, color, isClosed);
+}
+
+void DrawImage(const AtlasImage& image, const Game::Rect& destRect, const Color& tint)
+{
+    DrawImage(image, destRect, Game::Rect(0.0f, 0.0f, 1.0f, 1.0f), tint);
+}
+
+void DrawImage(const AtlasImage& image, const Game::Rect& destRect, const Game::Rect& uvRect, const Color& tint)
+{
+    SpriteVertex vertices[4];
+    MakeSpriteQuad(image, uvRect, destRect, tint, vertices);
+    DrawSpriteQuad(image.textureID, vertices);
+}
+
+void DrawRenderTarget(int targetID, const Game::Rect& destRect, const Color& tint)
+{
+    DrawImage(GetRenderTargetImage(targetID), destRect, tint);
+}
+
+void DrawSprite(const AtlasImage& image, const Vector2& position, float rad, const Vector2& scale, const Color& tint)
+{
+    float c = cosf(rad);
+    float s = sinf(rad);
+
+    Matrix4x4 transform;
+    transform.m00 = c * scale.x;
+    transform.m01 = s * scale.x;
+    transform.m10 = -s * scale.y;
+    transform.m11 = c * scale.y;
+    transform.m22 = 1.0f;
+    transform.m30 = position.x;
+    transform.m31 = position.y;
+    transform.m33 = 1.0f;
+    DrawSprite(image, transform, tint);
+}
+
+void DrawSprite(const AtlasImage& image, const Matrix4x4& transform, const Color& tint)
+{
+    DrawSprite(image, Game::Rect(0.0f, 0.0f, 1.0f, 1.0f), transform, tint);
+}
+
+void DrawSprite(const AtlasImage& image, const Game::Rect& uvRect, const Matrix4x4& transform, const Color& tint)
+{
+    SpriteVertex vertices[4];
+    MakeSpriteQuad(image, uvRect, transform, tint, vertices);
+    DrawSpriteQuad(image.textureID, vertices);
+}
+
+void DrawInstances(InstanceShape shape, const std::vector<InstanceData>& instances)
+{
+    DrawInstances(shape, instances.data(), instances.size());
+}
+
+void DrawInstances(const std::vector<InstanceData>& instances)
+{
+    DrawInstances(instances.data(), instances.size());
+}
+
@@ -0,0 +1,89 @@
+//
+//  SimulationThread.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "SimulationThread.hpp"
+
+
+SimulationThread::SimulationThread(void (*frameFunc_)())
+    : frameFunc(frameFunc_), isRunning(false), isQuitting(false), isBusy(false)
+{
+    // Do nothing
+}
+
+SimulationThread::~SimulationThread()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCondition.wait(lock, [this] { return !isBusy || IsCurrentThread(); });
+        isQuitting = true;
+    }
+    kickCondition.notify_all();
+    if (!thread.joinable()) {
+        return;
+    }
+
+    // シミュレーションの中からexit()された場合は、自分自身をjoinできないので切り離す
+    if (IsCurrentThread()) {
+        thread.detach();
+    } else {
+        thread.join();
+    }
+}
+
+void SimulationThread::Kick()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCondition.wait(lock, [this] { return !isBusy; });
+        isBusy = true;
+        if (!isRunning) {
+            thread = std::thread(&SimulationThread::Run, this);
+            isRunning = true;
+        }
+    }
+    kickCondition.notify_all();
+}
+
+void SimulationThread::Wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this] { return !isBusy; });
+}
+
+bool SimulationThread::IsBusy()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return isBusy;
+}
+
+bool SimulationThread::IsCurrentThread() const
+{
+    return (std::this_thread::get_id() == thread.get_id());
+}
+
+void SimulationThread::Run()
+{
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            kickCondition.wait(lock, [this] { return isBusy || isQuitting; });
+            if (isQuitting) {
+                return;
+            }
+        }
+
+        frameFunc();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            isBusy = false;
+        }
+        doneCondition.notify_all();
+    }
+}
+
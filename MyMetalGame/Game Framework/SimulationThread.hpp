@@ -0,0 +1,58 @@
+//
+//  SimulationThread.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef SimulationThread_hpp
+#define SimulationThread_hpp
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+
+/// 1フレーム分のシミュレーションを、呼び出し元とは別のスレッドで実行するためのクラスです。
+/// Kick()で1回分の処理を始め、Wait()でその完了を待ちます。Kick()からWait()までの間に、呼び出し元は別の処理（前のフレームのエンコードなど）を並行して行えます。
+/// Wait()から戻った時点で、シミュレーションのスレッドが書き込んだ内容はすべて呼び出し元から見えるようになっています。
+class SimulationThread
+{
+public:
+    /// 1フレーム分の処理として実行する関数を指定して作成します。スレッドは最初のKick()で起動します。
+    explicit SimulationThread(void (*frameFunc)());
+
+    /// 実行中の処理が終わるのを待ってから、スレッドを終了します。
+    ~SimulationThread();
+
+    /// 1フレーム分の処理を開始します。前の処理が終わっていない場合は、終わるまで待ってから開始します。
+    void    Kick();
+
+    /// 開始した処理が終わるまで待ちます。処理を開始していない場合はすぐに戻ります。
+    void    Wait();
+
+    /// 開始した処理がまだ終わっていないかどうかを判定します。
+    bool    IsBusy();
+
+    /// 現在のスレッドがシミュレーションのスレッドかどうかを判定します。
+    bool    IsCurrentThread() const;
+
+private:
+    void    Run();
+
+private:
+    void    (*frameFunc)();
+
+    std::mutex                  mutex;
+    std::condition_variable     kickCondition;
+    std::condition_variable     doneCondition;
+    std::thread                 thread;
+    bool    isRunning;
+    bool    isQuitting;
+    bool    isBusy;
+
+};
+
+
+#endif /* SimulationThread_hpp */
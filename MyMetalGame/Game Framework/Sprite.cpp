@@ -0,0 +1,76 @@
+//
+//  Sprite.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "Sprite.hpp"
+#include "Color.hpp"
+#include "Matrix4x4.hpp"
+#include "Rect.hpp"
+
+
+bool AtlasImage::IsValid() const
+{
+    return (textureID != 0);
+}
+
+
+/// 画像内の正規化座標の矩形を、アトラス内のテクスチャ座標に変換する
+static void MapUVRect(const AtlasImage& image, const Game::Rect& uvRect, float& outU0, float& outV0, float& outU1, float& outV1)
+{
+    float du = image.u1 - image.u0;
+    float dv = image.v1 - image.v0;
+    outU0 = image.u0 + du * uvRect.x;
+    outV0 = image.v0 + dv * uvRect.y;
+    outU1 = image.u0 + du * (uvRect.x + uvRect.width);
+    outV1 = image.v0 + dv * (uvRect.y + uvRect.height);
+}
+
+static inline void SetSpriteVertex(SpriteVertex& vertex, float x, float y, float u, float v, uint32_t color)
+{
+    vertex.x = x;
+    vertex.y = y;
+    vertex.u = u;
+    vertex.v = v;
+    vertex.color = color;
+}
+
+void MakeSpriteQuad(const AtlasImage& image, const Game::Rect& uvRect, const Matrix4x4& transform, const Color& tint, SpriteVertex outVertices[4])
+{
+    float u0, v0, u1, v1;
+    MapUVRect(image, uvRect, u0, v0, u1, v1);
+    uint32_t color = tint.ToRGBA8();
+
+    // 行ベクトルの行列なので、(x, y)は x*行0 + y*行1 + 行3 に変換される
+    static const float kCorners[4][2] = { { -0.5f, -0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f }, { -0.5f, 0.5f } };
+    float us[4] = { u0, u1, u1, u0 };
+    float vs[4] = { v1, v1, v0, v0 };
+    for (int i = 0; i < 4; i++) {
+        float cx = kCorners[i][0];
+        float cy = kCorners[i][1];
+        float x = cx * transform.m00 + cy * transform.m10 + transform.m30;
+        float y = cx * transform.m01 + cy * transform.m11 + transform.m31;
+        SetSpriteVertex(outVertices[i], x, y, us[i], vs[i], color);
+    }
+}
+
+void MakeSpriteQuad(const AtlasImage& image, const Game::Rect& uvRect, const Game::Rect& destRect, const Color& tint, SpriteVertex outVertices[4])
+{
+    float u0, v0, u1, v1;
+    MapUVRect(image, uvRect, u0, v0, u1, v1);
+    uint32_t color = tint.ToRGBA8();
+
+    // 描画先はY軸が上向きなので、矩形の下端に画像の下端（v1）を合わせる
+    float x0 = destRect.x;
+    float y0 = destRect.y;
+    float x1 = destRect.x + destRect.width;
+    float y1 = destRect.y + destRect.height;
+    SetSpriteVertex(outVertices[0], x0, y0, u0, v1, color);
+    SetSpriteVertex(outVertices[1], x1, y0, u1, v1, color);
+    SetSpriteVertex(outVertices[2], x1, y1, u1, v0, color);
+    SetSpriteVertex(outVertices[3], x0, y1, u0, v0, color);
+}
+
@@ -0,0 +1,77 @@
+//
+//  Sprite.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef Sprite_hpp
+#define Sprite_hpp
+
+#include <cstdint>
+
+struct Color;
+struct Matrix4x4;
+namespace Game { struct Rect; }
+
+
+/// アトラスに詰め込まれた1枚の画像を表す構造体です。LoadImage()で作成します。
+struct AtlasImage
+{
+    /// 画像が置かれたアトラスのページのテクスチャID（1から始まる。0は無効な画像）
+    unsigned    textureID;
+
+    /// アトラス内での左端のテクスチャ座標
+    float       u0;
+
+    /// アトラス内での上端のテクスチャ座標
+    float       v0;
+
+    /// アトラス内での右端のテクスチャ座標
+    float       u1;
+
+    /// アトラス内での下端のテクスチャ座標
+    float       v1;
+
+    /// 画像の幅（ピクセル）
+    int         width;
+
+    /// 画像の高さ（ピクセル）
+    int         height;
+
+    /// 有効な画像かどうかを判定します。
+    bool    IsValid() const;
+};
+
+
+/// スプライト描画で頂点バッファに書き込む頂点です。
+/// GPUにそのままコピーされるため、GMObjectは継承せず、Shaders.metal の SpriteIn と同じ20バイトのレイアウトになっています。
+struct SpriteVertex
+{
+    /// X座標
+    float       x;
+
+    /// Y座標
+    float       y;
+
+    /// テクスチャ座標のU成分
+    float       u;
+
+    /// テクスチャ座標のV成分
+    float       v;
+
+    /// RGBA8にパックされた色（テクスチャの色に乗算されます）
+    uint32_t    color;
+};
+
+
+/// 画像の一部（uvRectは画像内の正規化座標で、原点は左上）を、変換行列で変換した1x1の四角形（中心が原点）に貼り付けるための4頂点を作成します。
+/// 頂点は左下・右下・右上・左上の順に格納されます。
+void    MakeSpriteQuad(const AtlasImage& image, const Game::Rect& uvRect, const Matrix4x4& transform, const Color& tint, SpriteVertex outVertices[4]);
+
+/// 画像の一部を、描画先の矩形destRectに貼り付けるための4頂点を作成します。頂点は左下・右下・右上・左上の順に格納されます。
+void    MakeSpriteQuad(const AtlasImage& image, const Game::Rect& uvRect, const Game::Rect& destRect, const Color& tint, SpriteVertex outVertices[4]);
+
+
+#endif /* Sprite_hpp */
@@ -0,0 +1,201 @@
+//
+//  StaticMesh2D.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "StaticMesh2D.hpp"
+#include "Color.hpp"
+#include "TransformStack.hpp"
+#include "Vector2.hpp"
+#include <algorithm>
+
+
+StaticMesh2D::StaticMesh2D()
+{
+    Clear();
+}
+
+void StaticMesh2D::Clear()
+{
+    vertices.clear();
+    indices.clear();
+    dirtyRanges.clear();
+    isDirtyRangesMerged = true;
+    minX = minY = maxX = maxY = 0.0f;
+}
+
+void StaticMesh2D::AddVertex(float x, float y, const Color& color)
+{
+    UpdateBounds(x, y);
+
+    StaticMeshVertex vertex;
+    vertex.x = x;
+    vertex.y = y;
+    vertex.r = color.r;
+    vertex.g = color.g;
+    vertex.b = color.b;
+    vertex.a = color.a;
+    vertices.push_back(vertex);
+}
+
+void StaticMesh2D::UpdateBounds(float x, float y)
+{
+    if (vertices.empty()) {
+        minX = maxX = x;
+        minY = maxY = y;
+        return;
+    }
+    minX = std::min(minX, x);
+    minY = std::min(minY, y);
+    maxX = std::max(maxX, x);
+    maxY = std::max(maxY, y);
+}
+
+void StaticMesh2D::AddTriangle(const Vector2& p1, const Vector2& p2, const Vector2& p3, const Color& c1, const Color& c2, const Color& c3)
+{
+    uint32_t baseVertex = (uint32_t)vertices.size();
+    AddVertex(p1.x, p1.y, c1);
+    AddVertex(p2.x, p2.y, c2);
+    AddVertex(p3.x, p3.y, c3);
+    indices.push_back(baseVertex);
+    indices.push_back(baseVertex + 1);
+    indices.push_back(baseVertex + 2);
+}
+
+void StaticMesh2D::AddTriangles(const Vector2 *positions, const Color *colors, size_t colorStep, size_t vertexCount,
+                                const uint16_t *srcIndices, size_t indexCount, const Transform2D& transform)
+{
+    uint32_t baseVertex = (uint32_t)vertices.size();
+    vertices.reserve(vertices.size() + vertexCount);
+    for (size_t i = 0; i < vertexCount; i++) {
+        const Vector2& pos = positions[i];
+        AddVertex(pos.x * transform.m00 + pos.y * transform.m10 + transform.tx,
+                  pos.x * transform.m01 + pos.y * transform.m11 + transform.ty,
+                  colors[i * colorStep]);
+    }
+
+    if (srcIndices) {
+        indexCount -= indexCount % 3;
+        indices.reserve(indices.size() + indexCount);
+        for (size_t i = 0; i < indexCount; i++) {
+            indices.push_back(baseVertex + srcIndices[i]);
+        }
+    } else {
+        size_t count = vertexCount - vertexCount % 3;
+        indices.reserve(indices.size() + count);
+        for (size_t i = 0; i < count; i++) {
+            indices.push_back(baseVertex + (uint32_t)i);
+        }
+    }
+}
+
+bool StaticMesh2D::UpdateVertices(uint32_t firstVertex, const Vector2 *positions, const Color *colors, size_t count)
+{
+    if (count == 0) {
+        return true;
+    }
+    if ((size_t)firstVertex + count > vertices.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        StaticMeshVertex& vertex = vertices[firstVertex + i];
+        if (positions) {
+            vertex.x = positions[i].x;
+            vertex.y = positions[i].y;
+            minX = std::min(minX, vertex.x);
+            minY = std::min(minY, vertex.y);
+            maxX = std::max(maxX, vertex.x);
+            maxY = std::max(maxY, vertex.y);
+        }
+        if (colors) {
+            vertex.r = colors[i].r;
+            vertex.g = colors[i].g;
+            vertex.b = colors[i].b;
+            vertex.a = colors[i].a;
+        }
+    }
+
+    // 結合は取得するときにまとめて行う（書き換えのたびに並べ替えないようにする）
+    StaticMeshRange range;
+    range.first = firstVertex;
+    range.count = (uint32_t)count;
+    dirtyRanges.push_back(range);
+    isDirtyRangesMerged = (dirtyRanges.size() == 1);
+    return true;
+}
+
+uint32_t StaticMesh2D::VertexCount() const
+{
+    return (uint32_t)vertices.size();
+}
+
+uint32_t StaticMesh2D::IndexCount() const
+{
+    return (uint32_t)indices.size();
+}
+
+const std::vector<StaticMeshVertex>& StaticMesh2D::Vertices() const
+{
+    return vertices;
+}
+
+const std::vector<uint32_t>& StaticMesh2D::Indices() const
+{
+    return indices;
+}
+
+bool StaticMesh2D::GetBounds(float& outMinX, float& outMinY, float& outMaxX, float& outMaxY) const
+{
+    if (vertices.empty()) {
+        return false;
+    }
+    // 頂点を書き換えて縮んだ分は反映しないので、実際より大きい矩形になることがある
+    outMinX = minX;
+    outMinY = minY;
+    outMaxX = maxX;
+    outMaxY = maxY;
+    return true;
+}
+
+bool StaticMesh2D::IsDirty() const
+{
+    return !dirtyRanges.empty();
+}
+
+const std::vector<StaticMeshRange>& StaticMesh2D::DirtyRanges()
+{
+    if (isDirtyRangesMerged) {
+        return dirtyRanges;
+    }
+
+    std::sort(dirtyRanges.begin(), dirtyRanges.end(), [](const StaticMeshRange& a, const StaticMeshRange& b) {
+        return a.first < b.first;
+    });
+    size_t count = 0;
+    for (size_t i = 0; i < dirtyRanges.size(); i++) {
+        const StaticMeshRange& range = dirtyRanges[i];
+        if (count > 0) {
+            StaticMeshRange& last = dirtyRanges[count - 1];
+            uint32_t lastEnd = last.first + last.count;
+            if (range.first <= lastEnd) {
+                last.count = std::max(lastEnd, range.first + range.count) - last.first;
+                continue;
+            }
+        }
+        dirtyRanges[count++] = range;
+    }
+    dirtyRanges.resize(count);
+    isDirtyRangesMerged = true;
+    return dirtyRanges;
+}
+
+void StaticMesh2D::ClearDirtyRanges()
+{
+    dirtyRanges.clear();
+    isDirtyRangesMerged = true;
+}
+
@@ -0,0 +1,106 @@
+//
+//  StaticMesh2D.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef StaticMesh2D_hpp
+#define StaticMesh2D_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct Color;
+struct Transform2D;
+struct Vector2;
+
+
+/// 静的メッシュの頂点です。AAPLVertex（VertexFormatStandard）と同じ24バイトのレイアウトで、そのままGPUにコピーされます。
+struct StaticMeshVertex
+{
+    float   x;
+    float   y;
+    float   r;
+    float   g;
+    float   b;
+    float   a;
+};
+
+
+/// 頂点配列内の範囲です。
+struct StaticMeshRange
+{
+    /// 開始位置
+    uint32_t    first;
+
+    /// 個数
+    uint32_t    count;
+};
+
+
+/// 一度だけ記録して、毎フレーム描画し直さずに使い回す2次元のメッシュのCPU側のデータです。
+/// 頂点の一部を書き換えると、その範囲が次のアップロードで転送する範囲として記録されます。Metalには依存していないため、CPUだけで動作を確認できます。
+class StaticMesh2D
+{
+public:
+    StaticMesh2D();
+
+    /// すべての頂点とインデックスを破棄します。
+    void    Clear();
+
+    /// 三角形を1つ追加します。
+    void    AddTriangle(const Vector2& p1, const Vector2& p2, const Vector2& p3, const Color& c1, const Color& c2, const Color& c3);
+
+    /// 頂点を共有する三角形をまとめて追加します。位置にはtransformが適用されます。
+    /// indicesにnullptrを指定すると、頂点を3つずつ1つの三角形とします。colorStepに0を指定すると、すべての頂点にcolors[0]を使います。
+    void    AddTriangles(const Vector2 *positions, const Color *colors, size_t colorStep, size_t vertexCount,
+                         const uint16_t *indices, size_t indexCount, const Transform2D& transform);
+
+    /// 記録済みの頂点を書き換えます。positionsかcolorsにnullptrを指定すると、その要素は変更しません。
+    /// 書き換えた範囲は転送が必要な範囲として記録されます。範囲が頂点数を超える場合はfalseを返し、何も行いません。
+    bool    UpdateVertices(uint32_t firstVertex, const Vector2 *positions, const Color *colors, size_t count);
+
+    /// 頂点数を取得します。
+    uint32_t    VertexCount() const;
+
+    /// インデックス数を取得します。
+    uint32_t    IndexCount() const;
+
+    /// 頂点配列を取得します。
+    const std::vector<StaticMeshVertex>&    Vertices() const;
+
+    /// インデックス配列を取得します。
+    const std::vector<uint32_t>&            Indices() const;
+
+    /// すべての頂点を囲む矩形を取得します。頂点がない場合はfalseを返します。
+    bool    GetBounds(float& minX, float& minY, float& maxX, float& maxY) const;
+
+    /// 転送が必要な頂点の範囲があるかどうかを判定します。
+    bool    IsDirty() const;
+
+    /// 転送が必要な頂点の範囲を、重なっているものと隣接しているものを結合して、開始位置の順に取得します。
+    const std::vector<StaticMeshRange>&     DirtyRanges();
+
+    /// 転送が必要な範囲の記録を破棄します。
+    void    ClearDirtyRanges();
+
+private:
+    void    AddVertex(float x, float y, const Color& color);
+    void    UpdateBounds(float x, float y);
+
+    std::vector<StaticMeshVertex>   vertices;
+    std::vector<uint32_t>           indices;
+    std::vector<StaticMeshRange>    dirtyRanges;
+    bool    isDirtyRangesMerged;
+    float   minX;
+    float   minY;
+    float   maxX;
+    float   maxY;
+
+};
+
+
+#endif /* StaticMesh2D_hpp */
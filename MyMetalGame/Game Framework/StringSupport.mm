@@ -7,11 +7,17 @@
 //
 
 #include "StringSupport.hpp"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <strings.h>
 
+#if defined(__OBJC__)
 #import <Foundation/Foundation.h>
+#endif
 
 
 std::string FormatString(const char* format, ...)
@@ -24,6 +30,8 @@ std::string FormatString(const char* format, ...)
     return buffer;
 }
 
+#if defined(__OBJC__)
+
 std::string GetLastPathComponent(const std::string& pathstr)
 {
     NSString *str = [[NSString alloc] initWithCString:pathstr.c_str() encoding:NSUTF8StringEncoding];
@@ -48,6 +56,33 @@ std::string GetFilepath(const std::string& filename)
     return std::string([path cStringUsingEncoding:NSUTF8StringEncoding]);
 }
 
+#else
+
+// ヘッドレスの実行（C++としてコンパイルした場合）では、バンドルの代わりにカレントディレクトリからファイルを探す
+
+std::string GetLastPathComponent(const std::string& pathstr)
+{
+    std::string::size_type end = pathstr.find_last_not_of('/');
+    if (end == std::string::npos) {
+        return pathstr.empty()? "": "/";
+    }
+    std::string::size_type start = pathstr.find_last_of('/', end);
+    start = (start == std::string::npos)? 0: start + 1;
+    return pathstr.substr(start, end - start + 1);
+}
+
+std::string GetFilepath(const std::string& filename)
+{
+    FILE *fp = fopen(filename.c_str(), "rb");
+    if (!fp) {
+        return "";
+    }
+    fclose(fp);
+    return filename;
+}
+
+#endif
+
 std::vector<std::string> Split(const std::string& str, const std::string& separator)
 {
     std::vector<std::string> ret;
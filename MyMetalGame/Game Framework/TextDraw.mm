@@ -0,0 +1,201 @@
+//
+//  TextDraw.mm
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#import <CoreText/CoreText.h>
+#include "SimpleDraw.hpp"
+#include "TextLayout.hpp"
+#include "DebugSupport.hpp"
+#include "StringSupport.hpp"
+#include <cmath>
+#include <unordered_map>
+
+
+/// CoreTextでグリフをラスタライズし、アトラスに詰め込むGlyphSourceの実装
+class CoreTextGlyphSource : public GlyphSource
+{
+public:
+    CoreTextGlyphSource(CTFontRef font, float pixelSize)
+        : font(font), pixelSize(pixelSize)
+    {
+        lineHeight = ceilf((float)(CTFontGetAscent(font) + CTFontGetDescent(font) + CTFontGetLeading(font)));
+    }
+
+    ~CoreTextGlyphSource()
+    {
+        CFRelease(font);
+    }
+
+    const GlyphMetrics& GetGlyph(uint32_t codePoint) override
+    {
+        auto it = glyphs.find(codePoint);
+        if (it != glyphs.end()) {
+            return it->second;
+        }
+        GlyphMetrics& metrics = glyphs[codePoint];
+        Rasterize(codePoint, metrics);
+        return metrics;
+    }
+
+    float LineHeight() const override
+    {
+        return lineHeight;
+    }
+
+    float PixelSize() const
+    {
+        return pixelSize;
+    }
+
+private:
+    void Rasterize(uint32_t codePoint, GlyphMetrics& metrics)
+    {
+        metrics.image = AtlasImage();
+        metrics.offsetX = 0.0f;
+        metrics.offsetY = 0.0f;
+        metrics.advance = 0.0f;
+
+        // 基本多言語面の外の文字はサロゲートペアにする
+        UniChar chars[2];
+        CFIndex charCount = 1;
+        if (codePoint >= 0x10000) {
+            uint32_t c = codePoint - 0x10000;
+            chars[0] = (UniChar)(0xd800 + (c >> 10));
+            chars[1] = (UniChar)(0xdc00 + (c & 0x3ff));
+            charCount = 2;
+        } else {
+            chars[0] = (UniChar)codePoint;
+        }
+        CGGlyph glyphIDs[2] = { 0, 0 };
+        if (!CTFontGetGlyphsForCharacters(font, chars, glyphIDs, charCount)) {
+            // フォントにない文字は、半角分の空白として扱う
+            metrics.advance = pixelSize / 2;
+            return;
+        }
+
+        CGSize advance;
+        CTFontGetAdvancesForGlyphs(font, kCTFontOrientationHorizontal, glyphIDs, &advance, 1);
+        metrics.advance = (float)advance.width;
+
+        CGRect bounds = CTFontGetBoundingRectsForGlyphs(font, kCTFontOrientationHorizontal, glyphIDs, NULL, 1);
+        if (CGRectIsEmpty(bounds)) {
+            return;
+        }
+
+        // 線形補間でにじむ分として、周囲に1ピクセルの余白を付けてラスタライズする
+        int x0 = (int)floor(bounds.origin.x) - 1;
+        int y0 = (int)floor(bounds.origin.y) - 1;
+        int width = (int)ceil(CGRectGetMaxX(bounds)) + 1 - x0;
+        int height = (int)ceil(CGRectGetMaxY(bounds)) + 1 - y0;
+
+        std::vector<uint8_t> coverage((size_t)width * height, 0);
+        CGContextRef context = CGBitmapContextCreate(coverage.data(), width, height, 8, width, NULL, (CGBitmapInfo)kCGImageAlphaOnly);
+        if (!context) {
+            return;
+        }
+        CGContextSetShouldAntialias(context, true);
+        CGPoint position = CGPointMake(-x0, -y0);
+        CTFontDrawGlyphs(font, glyphIDs, &position, 1, context);
+        CGContextRelease(context);
+
+        // 白の文字として、被覆率をアルファに入れる（色は描画時に乗算される）
+        std::vector<uint8_t> pixels((size_t)width * height * 4);
+        for (size_t i = 0; i < coverage.size(); i++) {
+            pixels[i * 4] = 255;
+            pixels[i * 4 + 1] = 255;
+            pixels[i * 4 + 2] = 255;
+            pixels[i * 4 + 3] = coverage[i];
+        }
+
+        metrics.image = CreateImage(pixels.data(), width, height);
+        metrics.offsetX = (float)x0;
+        metrics.offsetY = (float)y0;
+    }
+
+    CTFontRef   font;
+    float       pixelSize;
+    float       lineHeight;
+    std::unordered_map<uint32_t, GlyphMetrics>  glyphs;
+
+};
+
+
+static std::vector<CoreTextGlyphSource *>   sFonts;
+static TextLayoutCache                      sTextLayoutCache;
+
+
+static CTFontRef CreateFont(const std::string& name, float pixelSize)
+{
+    // バンドルに含めたフォントファイル
+    if (EndsWith(name, ".ttf", true) || EndsWith(name, ".otf", true)) {
+        std::string path = GetFilepath(name);
+        if (path.length() == 0) {
+            return NULL;
+        }
+        CGDataProviderRef provider = CGDataProviderCreateWithFilename(path.c_str());
+        if (!provider) {
+            return NULL;
+        }
+        CGFontRef cgFont = CGFontCreateWithDataProvider(provider);
+        CGDataProviderRelease(provider);
+        if (!cgFont) {
+            return NULL;
+        }
+        CTFontRef font = CTFontCreateWithGraphicsFont(cgFont, pixelSize, NULL, NULL);
+        CGFontRelease(cgFont);
+        return font;
+    }
+
+    // システムのフォント
+    CFStringRef nameStr = CFStringCreateWithCString(kCFAllocatorDefault, name.c_str(), kCFStringEncodingUTF8);
+    CTFontRef font = CTFontCreateWithName(nameStr, pixelSize, NULL);
+    CFRelease(nameStr);
+    return font;
+}
+
+int LoadFont(const std::string& name, float pixelSize)
+{
+    CTFontRef font = CreateFont(name, pixelSize);
+    if (!font) {
+        AbortGame("フォント\"%s\"の読み込みに失敗しました。", name.c_str());
+    }
+    sFonts.push_back(new CoreTextGlyphSource(font, pixelSize));
+    return (int)sFonts.size() - 1;
+}
+
+static CoreTextGlyphSource *GetFont(int fontID)
+{
+    if (fontID < 0 || fontID >= (int)sFonts.size()) {
+        AbortGame("無効なフォントのIDが指定されました。（ID: %d）", fontID);
+    }
+    return sFonts[fontID];
+}
+
+void DrawText(int fontID, const std::string& text, const Vector2& position, float size, const Color& color)
+{
+    CoreTextGlyphSource *font = GetFont(fontID);
+    const TextLayout& layout = sTextLayoutCache.Get(text, fontID, *font);
+
+    // レイアウトはピクセル単位なので、描画するときに大きさを合わせる
+    float scale = size / font->PixelSize();
+    Game::Rect uvRect(0.0f, 0.0f, 1.0f, 1.0f);
+    SpriteVertex vertices[4];
+    for (const LaidOutGlyph& glyph : layout.glyphs) {
+        Game::Rect destRect(position.x + glyph.x * scale, position.y + glyph.y * scale, glyph.image.width * scale, glyph.image.height * scale);
+        MakeSpriteQuad(glyph.image, uvRect, destRect, color, vertices);
+        DrawSpriteQuad(glyph.image.textureID, vertices);
+    }
+}
+
+Vector2 MeasureText(int fontID, const std::string& text, float size)
+{
+    CoreTextGlyphSource *font = GetFont(fontID);
+    const TextLayout& layout = sTextLayoutCache.Get(text, fontID, *font);
+    float scale = size / font->PixelSize();
+    return Vector2(layout.width * scale, font->LineHeight() * layout.lineCount * scale);
+}
+
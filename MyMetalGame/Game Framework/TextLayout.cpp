@@ -0,0 +1,164 @@
+//
+//  TextLayout.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "TextLayout.hpp"
+#include <algorithm>
+#include <functional>
+
+
+static const uint32_t   kReplacementCharacter = 0xfffd;
+
+
+void DecodeUTF8(const std::string& str, std::vector<uint32_t>& outCodePoints)
+{
+    outCodePoints.clear();
+    size_t length = str.length();
+    size_t i = 0;
+    while (i < length) {
+        uint8_t c = (uint8_t)str[i];
+        int extraCount;
+        uint32_t codePoint;
+        if (c < 0x80) {
+            outCodePoints.push_back(c);
+            i++;
+            continue;
+        } else if ((c & 0xe0) == 0xc0) {
+            extraCount = 1;
+            codePoint = c & 0x1f;
+        } else if ((c & 0xf0) == 0xe0) {
+            extraCount = 2;
+            codePoint = c & 0x0f;
+        } else if ((c & 0xf8) == 0xf0) {
+            extraCount = 3;
+            codePoint = c & 0x07;
+        } else {
+            outCodePoints.push_back(kReplacementCharacter);
+            i++;
+            continue;
+        }
+
+        // 続くバイトが足りない・形式が違う場合は、先頭の1バイトだけを不正な文字として読み飛ばす
+        bool isValid = (i + extraCount < length);
+        for (int j = 1; isValid && j <= extraCount; j++) {
+            uint8_t next = (uint8_t)str[i + j];
+            if ((next & 0xc0) != 0x80) {
+                isValid = false;
+            } else {
+                codePoint = (codePoint << 6) | (next & 0x3f);
+            }
+        }
+        if (!isValid) {
+            outCodePoints.push_back(kReplacementCharacter);
+            i++;
+            continue;
+        }
+        outCodePoints.push_back(codePoint);
+        i += extraCount + 1;
+    }
+}
+
+void LayoutText(const std::string& text, GlyphSource& source, TextLayout& outLayout)
+{
+    outLayout.glyphs.clear();
+    outLayout.width = 0.0f;
+    outLayout.lineCount = 1;
+
+    std::vector<uint32_t> codePoints;
+    DecodeUTF8(text, codePoints);
+
+    float lineHeight = source.LineHeight();
+    float penX = 0.0f;
+    float penY = 0.0f;
+    for (uint32_t codePoint : codePoints) {
+        if (codePoint == '\n') {
+            outLayout.width = std::max(outLayout.width, penX);
+            penX = 0.0f;
+            penY -= lineHeight;
+            outLayout.lineCount++;
+            continue;
+        }
+
+        const GlyphMetrics& glyph = source.GetGlyph(codePoint);
+        if (glyph.image.IsValid()) {
+            LaidOutGlyph laidOut;
+            laidOut.image = glyph.image;
+            laidOut.x = penX + glyph.offsetX;
+            laidOut.y = penY + glyph.offsetY;
+            outLayout.glyphs.push_back(laidOut);
+        }
+        penX += glyph.advance;
+    }
+    outLayout.width = std::max(outLayout.width, penX);
+}
+
+
+TextLayoutCache::TextLayoutCache(size_t capacity)
+    : capacity(std::max(capacity, (size_t)1)), hitCount(0), missCount(0)
+{
+}
+
+bool TextLayoutCache::LayoutKey::operator==(const LayoutKey& key) const
+{
+    return (fontID == key.fontID && text == key.text);
+}
+
+size_t TextLayoutCache::LayoutKeyHash::operator()(const LayoutKey& key) const
+{
+    size_t hash = std::hash<std::string_view>()(key.text);
+    return hash ^ ((size_t)(uint32_t)key.fontID * 0x9e3779b97f4a7c15ULL);
+}
+
+const TextLayout& TextLayoutCache::Get(const std::string& text, int fontID, GlyphSource& source)
+{
+    // 毎フレーム同じ文字列を描画することが多いので、キャッシュにあった場合はキーの文字列を作らずに引数の文字列のまま検索する
+    LayoutKey key = { fontID, text };
+    auto it = entryMap.find(key);
+    if (it != entryMap.end()) {
+        hitCount++;
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->layout;
+    }
+
+    missCount++;
+    if (entries.size() >= capacity) {
+        const Entry& oldest = entries.back();
+        entryMap.erase(LayoutKey { oldest.fontID, oldest.text });
+        entries.pop_back();
+    }
+    entries.push_front(Entry());
+    Entry& entry = entries.front();
+    entry.fontID = fontID;
+    entry.text = text;
+    LayoutText(text, source, entry.layout);
+
+    // テーブルのキーは、引数ではなくキャッシュが持っている文字列を参照する
+    entryMap[LayoutKey { fontID, entry.text }] = entries.begin();
+    return entry.layout;
+}
+
+void TextLayoutCache::Clear()
+{
+    entries.clear();
+    entryMap.clear();
+}
+
+size_t TextLayoutCache::Count() const
+{
+    return entries.size();
+}
+
+size_t TextLayoutCache::HitCount() const
+{
+    return hitCount;
+}
+
+size_t TextLayoutCache::MissCount() const
+{
+    return missCount;
+}
+
@@ -0,0 +1,144 @@
+//
+//  TextLayout.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef TextLayout_hpp
+#define TextLayout_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Sprite.hpp"
+
+
+/// 1つのグリフの寸法とアトラス内の画像です。座標はピクセル単位で、Y軸は上向き、原点はベースライン上のペンの位置です。
+struct GlyphMetrics
+{
+    /// アトラスに置かれたグリフの画像（空白などの描画しない文字では無効な画像）
+    AtlasImage  image;
+
+    /// ペンの位置から画像の左端までの距離
+    float       offsetX;
+
+    /// ベースラインから画像の下端までの距離
+    float       offsetY;
+
+    /// 次の文字までペンを進める距離
+    float       advance;
+};
+
+
+/// レイアウトに使うグリフの情報を提供するインタフェースです。
+/// フォントのラスタライズはMetalやCoreTextに依存するので、レイアウトの処理からはこのインタフェースだけを参照します。
+class GlyphSource
+{
+public:
+    virtual ~GlyphSource() {}
+
+    /// 文字コード（Unicodeのコードポイント）に対応するグリフを取得します。必要であればその場でラスタライズされます。
+    virtual const GlyphMetrics&     GetGlyph(uint32_t codePoint) = 0;
+
+    /// 行の高さ（ピクセル）を取得します。
+    virtual float   LineHeight() const = 0;
+};
+
+
+/// レイアウト済みの1文字です。
+struct LaidOutGlyph
+{
+    /// グリフの画像
+    AtlasImage  image;
+
+    /// 画像の左端のX座標
+    float       x;
+
+    /// 画像の下端のY座標
+    float       y;
+};
+
+
+/// 文字列をレイアウトした結果です。座標はピクセル単位で、1行目のベースラインの左端が原点です。
+struct TextLayout
+{
+    /// 描画するグリフの並び（空白など画像のない文字は含まれません）
+    std::vector<LaidOutGlyph>   glyphs;
+
+    /// 最も長い行の幅
+    float   width;
+
+    /// 行数
+    int     lineCount;
+};
+
+
+/// UTF-8の文字列をUnicodeのコードポイントの並びに変換します。不正なバイト列はU+FFFDに置き換えられます。
+void    DecodeUTF8(const std::string& str, std::vector<uint32_t>& outCodePoints);
+
+/// 文字列をレイアウトします。改行文字で行を分けます。
+void    LayoutText(const std::string& text, GlyphSource& source, TextLayout& outLayout);
+
+
+/// (文字列, フォント) をキーにしてレイアウトの結果を保持するキャッシュです。
+/// フォントのIDにはサイズも含まれるので、同じ文字列を同じフォントとサイズで描画する限り、再レイアウトは行われません。
+/// 保持する数が上限を超えると、最も長く使われていないものから破棄されます。
+class TextLayoutCache
+{
+public:
+    TextLayoutCache(size_t capacity = 1024);
+
+    /// レイアウトの結果を取得します。キャッシュになければレイアウトして追加します。
+    /// 返される参照は、次にGet()またはClear()を呼ぶまで有効です。
+    const TextLayout&   Get(const std::string& text, int fontID, GlyphSource& source);
+
+    /// キャッシュをすべて破棄します。
+    void    Clear();
+
+    /// キャッシュに保持しているレイアウトの数を取得します。
+    size_t  Count() const;
+
+    /// キャッシュにあった回数を取得します。
+    size_t  HitCount() const;
+
+    /// キャッシュになくレイアウトした回数を取得します。
+    size_t  MissCount() const;
+
+private:
+    struct Entry
+    {
+        int             fontID;
+        std::string     text;
+        TextLayout      layout;
+    };
+
+    /// フォントのIDと文字列の組。テーブルのキーはEntryの文字列を参照し、検索のときは引数の文字列を参照するので、キャッシュにあればメモリを確保しない。
+    struct LayoutKey
+    {
+        int                 fontID;
+        std::string_view    text;
+
+        bool    operator==(const LayoutKey& key) const;
+    };
+
+    struct LayoutKeyHash
+    {
+        size_t  operator()(const LayoutKey& key) const;
+    };
+
+    size_t              capacity;
+    size_t              hitCount;
+    size_t              missCount;
+    std::list<Entry>    entries;    // 先頭が最近使われたもの（リストの要素は移動しないので、文字列への参照はEntryが破棄されるまで有効）
+    std::unordered_map<LayoutKey, std::list<Entry>::iterator, LayoutKeyHash>   entryMap;
+
+};
+
+
+#endif /* TextLayout_hpp */
@@ -0,0 +1,201 @@
+//
+//  TextureAtlas.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "TextureAtlas.hpp"
+#include <algorithm>
+#include <climits>
+
+
+SkylinePacker::SkylinePacker(int width, int height)
+    : width(width), height(height)
+{
+    Clear();
+}
+
+void SkylinePacker::Clear()
+{
+    usedArea = 0;
+    skyline.clear();
+    skyline.push_back({ 0, 0, width });
+}
+
+int SkylinePacker::Fit(size_t index, int width, int height) const
+{
+    int x = skyline[index].x;
+    if (x + width > this->width) {
+        return -1;
+    }
+
+    // 幅の分だけ右の線分を見ていき、その中で最も高い位置に置く
+    int y = 0;
+    int remainingWidth = width;
+    while (remainingWidth > 0) {
+        if (index >= skyline.size()) {
+            return -1;
+        }
+        y = std::max(y, skyline[index].y);
+        if (y + height > this->height) {
+            return -1;
+        }
+        remainingWidth -= skyline[index].width;
+        index++;
+    }
+    return y;
+}
+
+bool SkylinePacker::Insert(int width, int height, int& outX, int& outY)
+{
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+
+    // 置いたあとの上端が最も低くなる位置を選ぶ（同じ高さなら、より狭い線分の上を選ぶ）
+    int bestBottom = INT_MAX;
+    int bestWidth = INT_MAX;
+    size_t bestIndex = 0;
+    int bestY = -1;
+    for (size_t i = 0; i < skyline.size(); i++) {
+        int y = Fit(i, width, height);
+        if (y < 0) {
+            continue;
+        }
+        if (y + height < bestBottom || (y + height == bestBottom && skyline[i].width < bestWidth)) {
+            bestBottom = y + height;
+            bestWidth = skyline[i].width;
+            bestIndex = i;
+            bestY = y;
+        }
+    }
+    if (bestY < 0) {
+        return false;
+    }
+
+    // 新しい線分を挿入し、その下に隠れる線分を削ったり取り除いたりする
+    Node node = { skyline[bestIndex].x, bestY + height, width };
+    skyline.insert(skyline.begin() + bestIndex, node);
+
+    for (size_t i = bestIndex + 1; i < skyline.size(); i++) {
+        int nodeRight = node.x + node.width;
+        if (skyline[i].x >= nodeRight) {
+            break;
+        }
+        int shrink = nodeRight - skyline[i].x;
+        skyline[i].x += shrink;
+        skyline[i].width -= shrink;
+        if (skyline[i].width > 0) {
+            break;
+        }
+        skyline.erase(skyline.begin() + i);
+        i--;
+    }
+
+    // 同じ高さで隣り合う線分をまとめる
+    for (size_t i = 0; i + 1 < skyline.size(); i++) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+            i--;
+        }
+    }
+
+    usedArea += (long)width * height;
+    outX = node.x;
+    outY = bestY;
+    return true;
+}
+
+long SkylinePacker::UsedArea() const
+{
+    return usedArea;
+}
+
+
+TextureAtlasPacker::TextureAtlasPacker(int pageWidth, int pageHeight, int padding)
+    : pageWidth(pageWidth), pageHeight(pageHeight), padding(padding)
+{
+}
+
+void TextureAtlasPacker::Clear()
+{
+    pages.clear();
+}
+
+bool TextureAtlasPacker::Pack(int width, int height, AtlasRegion& outRegion)
+{
+    outRegion.page = -1;
+    outRegion.x = 0;
+    outRegion.y = 0;
+    outRegion.width = width;
+    outRegion.height = height;
+
+    // 右と下に余白を付けた大きさで配置する（ページの端では余白ははみ出してもよい）
+    int paddedWidth = std::min(width + padding, pageWidth);
+    int paddedHeight = std::min(height + padding, pageHeight);
+    if (width <= 0 || height <= 0 || width > pageWidth || height > pageHeight) {
+        return false;
+    }
+
+    for (size_t i = 0; i < pages.size(); i++) {
+        if (pages[i].Insert(paddedWidth, paddedHeight, outRegion.x, outRegion.y)) {
+            outRegion.page = (int)i;
+            return true;
+        }
+    }
+
+    pages.push_back(SkylinePacker(pageWidth, pageHeight));
+    pages.back().Insert(paddedWidth, paddedHeight, outRegion.x, outRegion.y);
+    outRegion.page = (int)pages.size() - 1;
+    return true;
+}
+
+bool TextureAtlasPacker::PackAll(const std::vector<AtlasRegion>& sizes, std::vector<AtlasRegion>& outRegions)
+{
+    std::vector<size_t> order(sizes.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&sizes](size_t a, size_t b) {
+        if (sizes[a].height != sizes[b].height) {
+            return sizes[a].height > sizes[b].height;
+        }
+        return sizes[a].width > sizes[b].width;
+    });
+
+    bool ret = true;
+    outRegions.resize(sizes.size());
+    for (size_t i : order) {
+        if (!Pack(sizes[i].width, sizes[i].height, outRegions[i])) {
+            ret = false;
+        }
+    }
+    return ret;
+}
+
+int TextureAtlasPacker::PageCount() const
+{
+    return (int)pages.size();
+}
+
+int TextureAtlasPacker::PageWidth() const
+{
+    return pageWidth;
+}
+
+int TextureAtlasPacker::PageHeight() const
+{
+    return pageHeight;
+}
+
+float TextureAtlasPacker::PageOccupancy(int page) const
+{
+    if (page < 0 || page >= (int)pages.size()) {
+        return 0.0f;
+    }
+    return (float)pages[page].UsedArea() / ((long)pageWidth * pageHeight);
+}
+
@@ -0,0 +1,110 @@
+//
+//  TextureAtlas.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef TextureAtlas_hpp
+#define TextureAtlas_hpp
+
+#include <cstddef>
+#include <vector>
+
+
+/// アトラス内で1つの画像に割り当てられた領域です（ピクセル単位、原点は左上）。
+struct AtlasRegion
+{
+    /// 配置されたページの番号
+    int     page;
+
+    /// ページ内でのX座標
+    int     x;
+
+    /// ページ内でのY座標
+    int     y;
+
+    /// 幅
+    int     width;
+
+    /// 高さ
+    int     height;
+};
+
+
+/// 1枚のページに対して、スカイライン法（Bottom-Left）で矩形を詰め込むクラスです。
+/// 配置済みの領域の上端を左から順に線分のリストとして保持し、最も低く置ける位置に矩形を置いていきます。
+class SkylinePacker
+{
+public:
+    SkylinePacker(int width, int height);
+
+    /// 配置済みの矩形をすべて破棄します。
+    void    Clear();
+
+    /// 指定したサイズの矩形を配置します。配置できなかった場合はfalseを返します。
+    bool    Insert(int width, int height, int& outX, int& outY);
+
+    /// 配置済みの矩形の面積の合計を取得します。
+    long    UsedArea() const;
+
+private:
+    struct Node
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    /// index番目の線分から始まる幅widthの領域に置く場合のY座標を求める。置けない場合は-1を返す。
+    int     Fit(size_t index, int width, int height) const;
+
+    int                 width;
+    int                 height;
+    long                usedArea;
+    std::vector<Node>   skyline;
+
+};
+
+
+/// 複数のページを使って、画像の矩形をアトラスに詰め込むクラスです。
+/// 既存のページに入らない場合は新しいページを追加します。Metalには依存していないため、CPUだけで動作を確認できます。
+class TextureAtlasPacker
+{
+public:
+    /// ページのサイズと、画像同士の間に空ける余白（ピクセル）を指定して作成します。
+    TextureAtlasPacker(int pageWidth, int pageHeight, int padding);
+
+    /// すべてのページを破棄します。
+    void    Clear();
+
+    /// 指定したサイズの画像を配置します。ページよりも大きい画像は配置できず、falseを返します。
+    bool    Pack(int width, int height, AtlasRegion& outRegion);
+
+    /// 複数の画像をまとめて配置します。高さの大きい順に並べ替えてから配置するので、1つずつ配置するよりも隙間が少なくなります。
+    /// 結果は渡した順番のままoutRegionsに格納されます。配置できない画像があった場合はfalseを返します（その画像のページは-1になります）。
+    bool    PackAll(const std::vector<AtlasRegion>& sizes, std::vector<AtlasRegion>& outRegions);
+
+    /// 現在のページ数を取得します。
+    int     PageCount() const;
+
+    /// ページの幅を取得します。
+    int     PageWidth() const;
+
+    /// ページの高さを取得します。
+    int     PageHeight() const;
+
+    /// 指定したページの使用率（0.0〜1.0）を取得します。
+    float   PageOccupancy(int page) const;
+
+private:
+    int                         pageWidth;
+    int                         pageHeight;
+    int                         padding;
+    std::vector<SkylinePacker>  pages;
+
+};
+
+
+#endif /* TextureAtlas_hpp */
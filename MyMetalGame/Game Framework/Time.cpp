@@ -7,42 +7,128 @@
 //
 
 #include "Time.hpp"
-#include <sys/time.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#if defined(__APPLE__)
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#endif
 
 
-static double   sStartTime = -1.0;
-static double   sCurrentTime = -1.0;
+static int64_t  sStartNanoseconds = -1;
+static int64_t  sCurrentNanoseconds = -1;
+static int64_t  sUnscaledNanoseconds = 0;       // unscaledTimeの元になる、ナノ秒単位の積算値
+static double   sFixedTimeAccumulator = 0.0;
+static int64_t  sReplayElapsedNanoseconds = -1; // 入力の再生で指定された、次のフレームの経過時間（負の値は指定なし）
+static int64_t  sLastElapsedNanoseconds = 0;
 
 
-static double GetCurrentTime()
+/// 単調増加する時計の現在値をナノ秒単位で取得する。システムの時刻が変更されても巻き戻らない。
+static int64_t GetMonotonicNanoseconds()
 {
-    static timeval tv;
-    gettimeofday(&tv, NULL);
-    return (double)tv.tv_sec + (double)tv.tv_usec / 1000000.0;
+#if defined(__APPLE__)
+    // mach_absolute_time()の単位はCPUによって異なるので、タイムベースでナノ秒に換算する
+    static mach_timebase_info_data_t timebase = [] {
+        mach_timebase_info_data_t info;
+        mach_timebase_info(&info);
+        return info;
+    }();
+    uint64_t ticks = mach_absolute_time();
+    if (timebase.numer == timebase.denom) {
+        return (int64_t)ticks;
+    }
+    // 掛け算でのオーバーフローを避けるために、商と余りに分けて換算する
+    uint64_t high = (ticks / timebase.denom) * timebase.numer;
+    uint64_t low = (ticks % timebase.denom) * timebase.numer / timebase.denom;
+    return (int64_t)(high + low);
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#endif
 }
 
 
 int Time::frameCount = 0;
-float Time::time = 0.0f;
+double Time::time = 0.0;
 float Time::deltaTime = 0.0f;
 float Time::timeScale = 1.0f;
 float Time::unscaledDeltaTime = 0.0f;
-float Time::unscaledTime = 0.0f;
+double Time::unscaledTime = 0.0;
+double Time::realtimeSinceStartup = 0.0;
+float Time::captureDeltaTime = 0.0f;
+float Time::fixedDeltaTime = 1.0f / 60;
+int Time::maxFixedStepsPerFrame = 8;
+float Time::interpolationAlpha = 0.0f;
 
 
 void Time::__Update()
 {
-    if (sStartTime < 0.0) {
-        sStartTime = GetCurrentTime();
-        sCurrentTime = sStartTime;
+    int64_t now = GetMonotonicNanoseconds();
+    if (sStartNanoseconds < 0) {
+        sStartNanoseconds = now;
+        sCurrentNanoseconds = now;
+    }
+    int64_t elapsedNanoseconds = now - sCurrentNanoseconds;
+    sCurrentNanoseconds = now;
+    realtimeSinceStartup = (now - sStartNanoseconds) * 1.0e-9;
+
+    if (captureDeltaTime > 0.0f) {
+        elapsedNanoseconds = (int64_t)llround(captureDeltaTime * 1.0e9);
+    }
+    if (sReplayElapsedNanoseconds >= 0) {
+        elapsedNanoseconds = sReplayElapsedNanoseconds;
+        sReplayElapsedNanoseconds = -1;
+    }
+    sLastElapsedNanoseconds = elapsedNanoseconds;
+    sUnscaledNanoseconds += elapsedNanoseconds;
+
+    double unscaledDelta = elapsedNanoseconds * 1.0e-9;
+    double scaledDelta = unscaledDelta * timeScale;
+    unscaledDeltaTime = (float)unscaledDelta;
+    deltaTime = (float)scaledDelta;
+
+    // timeScaleは途中で変わることがあるので、スケールした時間は倍精度の差分で積算する
+    time += scaledDelta;
+    unscaledTime = sUnscaledNanoseconds * 1.0e-9;
+}
+
+void Time::__SetReplayDeltaNanoseconds(long long nanoseconds)
+{
+    sReplayElapsedNanoseconds = std::max((int64_t)nanoseconds, (int64_t)0);
+}
+
+long long Time::__GetDeltaNanoseconds()
+{
+    return sLastElapsedNanoseconds;
+}
+
+void Time::__RunFixedUpdate(void (*fixedUpdate)())
+{
+    if (fixedDeltaTime <= 0.0f) {
+        interpolationAlpha = 0.0f;
+        return;
+    }
+
+    // 処理が追いつかずに積み立てが増え続けないように、1フレームで処理できる分を超えた時間は捨てる
+    double step = fixedDeltaTime;
+    sFixedTimeAccumulator += deltaTime;
+    double maxAccumulation = step * std::max(maxFixedStepsPerFrame, 1);
+    if (sFixedTimeAccumulator > maxAccumulation) {
+        sFixedTimeAccumulator = maxAccumulation;
+    }
+
+    int stepCount = (int)(sFixedTimeAccumulator / step);
+    sFixedTimeAccumulator -= stepCount * step;
+    interpolationAlpha = (float)std::min(sFixedTimeAccumulator / step, 1.0);
+
+    float frameDeltaTime = deltaTime;
+    deltaTime = fixedDeltaTime;
+    for (int i = 0; i < stepCount; i++) {
+        fixedUpdate();
     }
-    double prevTime = sCurrentTime;
-    sCurrentTime = GetCurrentTime();
-
-    unscaledDeltaTime = (float)(sCurrentTime - prevTime);
-    deltaTime = unscaledDeltaTime * timeScale;
-    
-    time += deltaTime;
-    unscaledTime += unscaledDeltaTime;
+    deltaTime = frameDeltaTime;
 }
 
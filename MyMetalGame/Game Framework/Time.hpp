@@ -16,10 +16,12 @@ struct Time
     /// ゲーム開始から直前のフレームまでに経過したフレーム数
     static int      frameCount;
 
-    /// ゲーム開始から現在のフレームの実行開始までに経過した時間
-    static float    time;
+    /// ゲーム開始から現在のフレームの実行開始までに経過した時間。
+    /// 倍精度で積算しているので、30日間（約260万秒）動かし続けても分解能は1マイクロ秒より十分細かいままです。
+    /// フレームごとの差分を足していくため丸め誤差は少しずつ蓄積しますが、60fpsで30日間動かしても1ミリ秒未満です（Tests/TimeTest.cpp）。
+    static double   time;
 
-    /// 直前のフレームの処理にかかった時間
+    /// 直前のフレームの処理にかかった時間。ナノ秒単位の時計の差から求めるので、ゲーム開始からの経過時間に関係なく精度は一定です。
     static float    deltaTime;
 
     /// 時間の経過をスケールさせます。デフォルト値は1.0です。
@@ -28,10 +30,41 @@ struct Time
     /// timeScaleの値によってスケールしない、直前のフレームの処理にかかった時間です。
     static float    unscaledDeltaTime;
 
-    /// timeScaleの値によってスケールしない、ゲーム開始から現在のフレームの実行開始までに経過した時間
-    static float    unscaledTime;
+    /// timeScaleの値によってスケールしない、ゲーム開始から現在のフレームの実行開始までに経過した時間。
+    /// ナノ秒単位の整数で積算した値から求めるので、どれだけ長く動かしても誤差は蓄積しません。
+    static double   unscaledTime;
+
+    /// ゲーム開始から現在のフレームの実行開始までに、実際に経過した時間です。
+    /// timeScaleとcaptureDeltaTimeの影響を受けず、単調増加する時計（システムの時刻の変更の影響を受けない時計）から求められます。
+    static double   realtimeSinceStartup;
+
+    /// 0より大きい値を設定すると、実際の経過時間に関係なく、毎フレームこの値だけ時間が進むようになります。デフォルト値は0.0です。
+    /// 固定した乱数シードと組み合わせると、フレームのキャプチャで毎回同じ画像を再現できます。
+    static float    captureDeltaTime;
+
+    /// FixedUpdate()を呼び出す間隔です。デフォルト値は1/60秒です。
+    /// FixedUpdate()の中では、deltaTimeもこの値になります。
+    static float    fixedDeltaTime;
+
+    /// 1フレームの中でFixedUpdate()を呼び出す最大の回数です。デフォルト値は8です。
+    /// 処理落ちでこれを超える時間が経過した場合、超えた分の時間は捨てられます（シミュレーションがそのぶん遅れます）。
+    static int      maxFixedStepsPerFrame;
+
+    /// 最後のFixedUpdate()から、次のFixedUpdate()までの時間のうち、現在のフレームまでに経過した割合（0.0以上1.0未満）です。
+    /// 直前の2回のFixedUpdate()の状態をこの値で補間して描画すると、表示のリフレッシュレートに関係なく滑らかに動きます。
+    static float    interpolationAlpha;
 
     static void     __Update();
+
+    /// 入力の再生で使います。次の__Update()で経過する時間を、実際の経過時間やcaptureDeltaTimeの代わりにナノ秒単位で指定します。
+    /// 指定は1回の__Update()だけで有効です。
+    static void     __SetReplayDeltaNanoseconds(long long nanoseconds);
+
+    /// 直前の__Update()で経過した時間（timeScaleでスケールする前）を、ナノ秒単位で取得します。
+    static long long    __GetDeltaNanoseconds();
+
+    /// このフレームで経過した時間を固定間隔の時間に積み立てて、実行すべき回数だけfixedUpdateを呼び出します。
+    static void     __RunFixedUpdate(void (*fixedUpdate)());
 };
 
 
@@ -0,0 +1,403 @@
+//
+//  TimerService.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "TimerService.hpp"
+#include "Time.hpp"
+#include "DebugSupport.hpp"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+
+static const int        kWheelBits = 8;
+static const int        kWheelSize = 1 << kWheelBits;
+static const uint64_t   kWheelMask = kWheelSize - 1;
+static const int        kLevelCount = 4;            // 1ミリ秒×256^4で約49日先までをホイールで扱い、それより先はオーバーフローのリストに入れる
+static const int        kOverflowLevel = kLevelCount;
+static const uint64_t   kNanosecondsPerTick = 1000000;
+static const double     kTicksPerSecond = 1000.0;
+static const int        kNodesPerChunk = 1024;
+
+
+/// 登録されたタイマー。コールバックの実行中に他のタイマーが登録されても動かないように、チャンク単位で確保する。
+struct TimerNode
+{
+    std::function<void()>   function;
+    uint64_t    dueTick;            // ホイール上の期限（dueNanosecondsを切り上げたティック）
+    uint64_t    dueNanoseconds;     // 丸める前の期限。周期の端数をティックに丸めずに持ち越すため
+    uint64_t    intervalNanoseconds;    // 0なら1回だけのタイマー
+    uint32_t    generation;
+    int         prev;
+    int         next;
+    int         level;
+    int         slot;
+    TimerClock  clock;
+    bool        isInUse;
+    bool        isFiring;
+    bool        isCancelled;
+};
+
+/// タイマーの双方向リスト（ノードの番号でつなぐ）
+struct TimerList
+{
+    int     head;
+    int     tail;
+};
+
+/// 1つの時計に対応する階層化されたタイミングホイール。
+/// レベルLのスロットには、現在のティックと上位のビットが一致し、(8×L)ビット目からの8ビットだけが異なるタイマーが入る。
+/// 現在のティックが256の倍数を越えるたびに、上のレベルの該当スロットを1つ下のレベルに振り分け直す。
+struct TimingWheel
+{
+    TimerList   slots[kLevelCount][kWheelSize];
+    TimerList   overflow;
+    uint64_t    occupiedSlots[kWheelSize / 64];     // レベル0の空でないスロットのビットマップ
+    uint64_t    currentTick;                        // 処理が済んだティック
+    uint64_t    targetTick;                         // 今回のフレームで進める先のティック
+};
+
+static std::vector<std::unique_ptr<TimerNode[]>>    sNodeChunks;
+static int          sNodeCount = 0;
+static int          sFreeNodeIndex = -1;
+static int          sActiveTimerCount = 0;
+static TimingWheel  sWheels[TimerClockCount];
+static bool         sIsWheelInitialized = false;
+
+
+static TimerNode& GetNode(int index)
+{
+    return sNodeChunks[index / kNodesPerChunk][index % kNodesPerChunk];
+}
+
+static void InitWheels()
+{
+    for (int clock = 0; clock < TimerClockCount; clock++) {
+        TimingWheel& wheel = sWheels[clock];
+        for (int level = 0; level < kLevelCount; level++) {
+            for (int slot = 0; slot < kWheelSize; slot++) {
+                wheel.slots[level][slot].head = -1;
+                wheel.slots[level][slot].tail = -1;
+            }
+        }
+        wheel.overflow.head = -1;
+        wheel.overflow.tail = -1;
+        std::fill(wheel.occupiedSlots, wheel.occupiedSlots + kWheelSize / 64, 0);
+        wheel.currentTick = 0;
+        wheel.targetTick = 0;
+    }
+    sIsWheelInitialized = true;
+}
+
+static double GetClockTime(TimerClock clock)
+{
+    return (clock == TimerClockScaled)? Time::time: Time::unscaledTime;
+}
+
+static TimerList& GetList(TimingWheel& wheel, int level, int slot)
+{
+    return (level == kOverflowLevel)? wheel.overflow: wheel.slots[level][slot];
+}
+
+static void AppendNode(TimingWheel& wheel, int index)
+{
+    TimerNode& node = GetNode(index);
+    TimerList& list = GetList(wheel, node.level, node.slot);
+    node.prev = list.tail;
+    node.next = -1;
+    if (list.tail >= 0) {
+        GetNode(list.tail).next = index;
+    } else {
+        list.head = index;
+    }
+    list.tail = index;
+
+    if (node.level == 0) {
+        wheel.occupiedSlots[node.slot / 64] |= (1ULL << (node.slot % 64));
+    }
+}
+
+static void UnlinkNode(TimingWheel& wheel, int index)
+{
+    TimerNode& node = GetNode(index);
+    TimerList& list = GetList(wheel, node.level, node.slot);
+    if (node.prev >= 0) {
+        GetNode(node.prev).next = node.next;
+    } else {
+        list.head = node.next;
+    }
+    if (node.next >= 0) {
+        GetNode(node.next).prev = node.prev;
+    } else {
+        list.tail = node.prev;
+    }
+    node.prev = -1;
+    node.next = -1;
+
+    if (node.level == 0 && list.head < 0) {
+        wheel.occupiedSlots[node.slot / 64] &= ~(1ULL << (node.slot % 64));
+    }
+}
+
+/// 期限と現在のティックの上位ビットを比べて、タイマーを入れるレベルとスロットを決める
+static void InsertNode(TimingWheel& wheel, int index)
+{
+    TimerNode& node = GetNode(index);
+    uint64_t due = node.dueTick;
+    uint64_t current = wheel.currentTick;
+    node.level = kOverflowLevel;
+    node.slot = 0;
+    for (int level = 0; level < kLevelCount; level++) {
+        int shift = kWheelBits * (level + 1);
+        if ((due >> shift) == (current >> shift)) {
+            node.level = level;
+            node.slot = (int)((due >> (kWheelBits * level)) & kWheelMask);
+            break;
+        }
+    }
+    AppendNode(wheel, index);
+}
+
+/// 上のレベルのスロットに入っているタイマーを、現在のティックを基準に入れ直す
+static void CascadeList(TimingWheel& wheel, TimerList& list)
+{
+    int index = list.head;
+    list.head = -1;
+    list.tail = -1;
+    while (index >= 0) {
+        int next = GetNode(index).next;
+        InsertNode(wheel, index);
+        index = next;
+    }
+}
+
+static int AllocateNode()
+{
+    if (sFreeNodeIndex >= 0) {
+        int index = sFreeNodeIndex;
+        sFreeNodeIndex = GetNode(index).next;
+        return index;
+    }
+    if (sNodeCount % kNodesPerChunk == 0) {
+        // チャンクはその場で構築して、一時的なunique_ptrの移動と破棄を挟まないようにする
+        sNodeChunks.emplace_back(new TimerNode[kNodesPerChunk]);
+    }
+    int index = sNodeCount++;
+    TimerNode& node = GetNode(index);
+    node.generation = 0;
+    node.isInUse = false;
+    return index;
+}
+
+static void ReleaseNode(int index)
+{
+    TimerNode& node = GetNode(index);
+    node.function = nullptr;
+    node.generation++;
+    node.isInUse = false;
+    node.isFiring = false;
+    node.isCancelled = false;
+    node.next = sFreeNodeIndex;
+    sFreeNodeIndex = index;
+}
+
+/// ナノ秒単位の時間を、それより前にならないティックに切り上げる
+static uint64_t CeilTick(uint64_t nanoseconds)
+{
+    return (nanoseconds + kNanosecondsPerTick - 1) / kNanosecondsPerTick;
+}
+
+static TimerHandle AddTimer(float seconds, uint64_t intervalNanoseconds, std::function<void()> fn, TimerClock clock)
+{
+    if (!sIsWheelInitialized) {
+        InitWheels();
+    }
+    TimingWheel& wheel = sWheels[clock];
+
+    // 期限は切り上げて、指定した時間より早く発火しないようにする。ただし、処理中のフレームで発火させることはしない。
+    double dueTime = GetClockTime(clock) + std::max(seconds, 0.0f);
+    uint64_t dueNanoseconds = (uint64_t)std::ceil(std::max(dueTime, 0.0) * 1.0e9);
+
+    int index = AllocateNode();
+    TimerNode& node = GetNode(index);
+    node.function = std::move(fn);
+    node.dueNanoseconds = dueNanoseconds;
+    node.dueTick = std::max(CeilTick(dueNanoseconds), wheel.targetTick + 1);
+    node.intervalNanoseconds = intervalNanoseconds;
+    node.clock = clock;
+    node.isInUse = true;
+    node.isFiring = false;
+    node.isCancelled = false;
+    InsertNode(wheel, index);
+    sActiveTimerCount++;
+
+    TimerHandle handle;
+    handle.index = index;
+    handle.generation = node.generation;
+    return handle;
+}
+
+TimerHandle After(float seconds, std::function<void()> fn, TimerClock clock)
+{
+    return AddTimer(seconds, 0, std::move(fn), clock);
+}
+
+TimerHandle Every(float seconds, std::function<void()> fn, TimerClock clock)
+{
+    // 周期が0以下（またはNaN）では、1回だけのタイマーとも毎フレームのタイマーとも区別できないので受け付けない
+    if (!(seconds > 0.0f)) {
+        AbortGame("Every()の周期には正の秒数を指定してください。（%f）", seconds);
+    }
+    uint64_t intervalNanoseconds = std::max((uint64_t)std::llround((double)seconds * 1.0e9), (uint64_t)1);
+    return AddTimer(seconds, intervalNanoseconds, std::move(fn), clock);
+}
+
+void CancelTimer(const TimerHandle& handle)
+{
+    if (!IsTimerActive(handle)) {
+        return;
+    }
+
+    // 実行中のコールバックは破棄できないので、戻ってきたところで解放する
+    TimerNode& node = GetNode(handle.index);
+    sActiveTimerCount--;
+    if (node.isFiring) {
+        node.isCancelled = true;
+        return;
+    }
+    UnlinkNode(sWheels[node.clock], handle.index);
+    ReleaseNode(handle.index);
+}
+
+void CancelAllTimers()
+{
+    for (int i = 0; i < sNodeCount; i++) {
+        const TimerNode& node = GetNode(i);
+        if (node.isInUse && !node.isCancelled) {
+            TimerHandle handle;
+            handle.index = i;
+            handle.generation = node.generation;
+            CancelTimer(handle);
+        }
+    }
+}
+
+bool IsTimerActive(const TimerHandle& handle)
+{
+    if (handle.index < 0 || handle.index >= sNodeCount) {
+        return false;
+    }
+    const TimerNode& node = GetNode(handle.index);
+    return (node.isInUse && node.generation == handle.generation && !node.isCancelled);
+}
+
+int GetActiveTimerCount()
+{
+    return sActiveTimerCount;
+}
+
+/// レベル0で、指定したスロット以降にある最初の空でないスロットを探す。見つからなければ-1を返す。
+static int FindOccupiedSlot(const TimingWheel& wheel, int startSlot)
+{
+    for (int word = startSlot / 64; word < kWheelSize / 64; word++) {
+        uint64_t bits = wheel.occupiedSlots[word];
+        if (word == startSlot / 64) {
+            bits &= ~0ULL << (startSlot % 64);
+        }
+        if (bits) {
+            return word * 64 + __builtin_ctzll(bits);
+        }
+    }
+    return -1;
+}
+
+/// レベル0のスロットに入っているタイマーを、先に登録されたものから順に発火させる
+static void FireSlot(TimingWheel& wheel, int slot)
+{
+    TimerList& list = wheel.slots[0][slot];
+    while (list.head >= 0) {
+        int index = list.head;
+        UnlinkNode(wheel, index);
+
+        TimerNode& node = GetNode(index);
+        node.isFiring = true;
+        node.function();
+        node.isFiring = false;
+
+        if (node.isCancelled) {
+            ReleaseNode(index);
+        } else if (node.intervalNanoseconds == 0) {
+            sActiveTimerCount--;
+            ReleaseNode(index);
+        } else {
+            // 周期は登録した時点を基準にナノ秒単位で保ち（ティックに丸めた端数は次の周期に持ち越す）、
+            // このフレームで進める先までに過ぎた周期は飛ばす
+            uint64_t interval = node.intervalNanoseconds;
+            uint64_t due = node.dueNanoseconds + interval;
+            uint64_t targetNanoseconds = wheel.targetTick * kNanosecondsPerTick;
+            if (due <= targetNanoseconds) {
+                due += ((targetNanoseconds - due) / interval + 1) * interval;
+            }
+            node.dueNanoseconds = due;
+            node.dueTick = CeilTick(due);
+            InsertNode(wheel, index);
+        }
+    }
+}
+
+/// 現在のティックをtargetTickまで進めながら、期限を迎えたタイマーを発火させる。
+/// レベル0では空でないスロットだけを訪れるので、かかる時間は発火したタイマーと越えた256ティックの境界の数にだけ比例する。
+static void AdvanceWheel(TimingWheel& wheel, uint64_t targetTick)
+{
+    if (targetTick <= wheel.currentTick) {
+        return;
+    }
+    wheel.targetTick = targetTick;
+
+    while (wheel.currentTick < targetTick) {
+        uint64_t blockBase = wheel.currentTick & ~kWheelMask;
+        uint64_t blockLast = blockBase + kWheelMask;
+        uint64_t stopTick = std::min(targetTick, blockLast);
+
+        int slot;
+        while ((slot = FindOccupiedSlot(wheel, (int)(wheel.currentTick & kWheelMask) + 1)) >= 0 && blockBase + slot <= stopTick) {
+            wheel.currentTick = blockBase + slot;
+            FireSlot(wheel, slot);
+        }
+        wheel.currentTick = stopTick;
+        if (stopTick == targetTick) {
+            break;
+        }
+
+        // 次のブロックに入るので、上のレベルから期限の近づいたタイマーを下ろしてくる（上のレベルから順に）
+        uint64_t tick = blockLast + 1;
+        wheel.currentTick = tick;
+        if ((tick & 0xffffffffULL) == 0) {
+            CascadeList(wheel, wheel.overflow);
+        }
+        for (int level = kLevelCount - 1; level >= 1; level--) {
+            if ((tick & ((1ULL << (kWheelBits * level)) - 1)) == 0) {
+                int cascadeSlot = (int)((tick >> (kWheelBits * level)) & kWheelMask);
+                CascadeList(wheel, wheel.slots[level][cascadeSlot]);
+            }
+        }
+        FireSlot(wheel, 0);
+    }
+}
+
+void __UpdateTimers()
+{
+    if (!sIsWheelInitialized) {
+        return;
+    }
+    for (int clock = 0; clock < TimerClockCount; clock++) {
+        double clockTime = GetClockTime((TimerClock)clock);
+        AdvanceWheel(sWheels[clock], (uint64_t)std::floor(clockTime * kTicksPerSecond));
+    }
+}
+
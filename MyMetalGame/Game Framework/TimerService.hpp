@@ -0,0 +1,70 @@
+//
+//  TimerService.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef TimerService_hpp
+#define TimerService_hpp
+
+#include <cstdint>
+#include <functional>
+
+
+/// タイマーの経過時間を測る時計を表す列挙型
+enum TimerClock
+{
+    /// Time::timeScaleでスケールした時間（Time::time）で測ります。
+    TimerClockScaled,
+
+    /// Time::timeScaleの影響を受けない時間（Time::unscaledTime）で測ります。
+    TimerClockUnscaled,
+
+    TimerClockCount,
+};
+
+
+/// After()やEvery()で登録したタイマーを識別するためのハンドルです。タイマーが終了するか取り消されると無効になります。
+struct TimerHandle
+{
+    int         index;
+    uint32_t    generation;
+
+    TimerHandle()
+        : index(-1), generation(0)
+    {
+        // Do nothing
+    }
+};
+
+
+/// 指定した秒数が経過した後に、1回だけfnを呼び出すタイマーを登録します。
+/// タイマーは1ミリ秒単位の階層化されたタイミングホイールで管理されるので、登録と取り消しは登録済みのタイマーの数に関係なく一定の時間で済み、
+/// フレームごとのコストも実際に発火したタイマーの数にだけ比例します。fnはUpdate()の直後に、Update()を実行するスレッドで呼び出されます。
+TimerHandle     After(float seconds, std::function<void()> fn, TimerClock clock = TimerClockScaled);
+
+/// 指定した秒数ごとにfnを呼び出すタイマーを登録します。取り消すまで呼び出し続けます。secondsに0以下を指定するとエラーになります。
+/// 呼び出しの周期は最初に登録した時点を基準にナノ秒単位で保たれるので、1/60秒のような1ミリ秒で割り切れない周期でもずれは蓄積しません。
+/// 1フレームの間に何周期分も経過した場合でも、呼び出しはフレームごとに1回です。
+TimerHandle     Every(float seconds, std::function<void()> fn, TimerClock clock = TimerClockScaled);
+
+/// タイマーを取り消します。すでに終了したタイマーのハンドルを渡した場合は何もしません。
+void    CancelTimer(const TimerHandle& handle);
+
+/// 登録されているタイマーをすべて取り消します。
+void    CancelAllTimers();
+
+/// タイマーがまだ終了も取り消しもされていないかどうかを判定します。
+bool    IsTimerActive(const TimerHandle& handle);
+
+/// 終了も取り消しもされていないタイマーの数を取得します。
+int     GetActiveTimerCount();
+
+/// 現在の時間までに期限を迎えたタイマーを発火させます。フレームごとにUpdate()の直後に呼び出されます。
+void    __UpdateTimers();
+
+
+#endif /* TimerService_hpp */
+
@@ -0,0 +1,170 @@
+//
+//  TransformStack.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "TransformStack.hpp"
+#include "Matrix4x4.hpp"
+#include "Vector2.hpp"
+#include <cmath>
+
+
+Transform2D Transform2D::Identity()
+{
+    Transform2D ret;
+    ret.m00 = 1.0f;
+    ret.m01 = 0.0f;
+    ret.m10 = 0.0f;
+    ret.m11 = 1.0f;
+    ret.tx = 0.0f;
+    ret.ty = 0.0f;
+    return ret;
+}
+
+Transform2D Transform2D::FromMatrix(const Matrix4x4& matrix)
+{
+    Transform2D ret;
+    ret.m00 = matrix.m00;
+    ret.m01 = matrix.m01;
+    ret.m10 = matrix.m10;
+    ret.m11 = matrix.m11;
+    ret.tx = matrix.m30;
+    ret.ty = matrix.m31;
+    return ret;
+}
+
+Transform2D Transform2D::Then(const Transform2D& t) const
+{
+    Transform2D ret;
+    ret.m00 = m00 * t.m00 + m01 * t.m10;
+    ret.m01 = m00 * t.m01 + m01 * t.m11;
+    ret.m10 = m10 * t.m00 + m11 * t.m10;
+    ret.m11 = m10 * t.m01 + m11 * t.m11;
+    ret.tx = tx * t.m00 + ty * t.m10 + t.tx;
+    ret.ty = tx * t.m01 + ty * t.m11 + t.ty;
+    return ret;
+}
+
+Vector2 Transform2D::Apply(const Vector2& pos) const
+{
+    return Vector2(pos.x * m00 + pos.y * m10 + tx, pos.x * m01 + pos.y * m11 + ty);
+}
+
+Matrix4x4 Transform2D::ToMatrix() const
+{
+    return Matrix4x4(m00, m01, 0.0f, 0.0f,
+                     m10, m11, 0.0f, 0.0f,
+                     0.0f, 0.0f, 1.0f, 0.0f,
+                     tx, ty, 0.0f, 1.0f);
+}
+
+
+TransformStack::TransformStack()
+{
+    Reset();
+}
+
+void TransformStack::Reset()
+{
+    stack.clear();
+    current = Transform2D::Identity();
+    isIdentity = true;
+}
+
+void TransformStack::Push()
+{
+    stack.push_back(current);
+}
+
+bool TransformStack::Pop()
+{
+    if (stack.empty()) {
+        return false;
+    }
+    current = stack.back();
+    stack.pop_back();
+    UpdateIdentityFlag();
+    return true;
+}
+
+void TransformStack::Translate(float x, float y)
+{
+    // 行列を作らずに、平行移動の成分だけを更新する
+    current.tx += x * current.m00 + y * current.m10;
+    current.ty += x * current.m01 + y * current.m11;
+    UpdateIdentityFlag();
+}
+
+void TransformStack::Rotate(float rad)
+{
+    float c = cosf(rad);
+    float s = sinf(rad);
+    Transform2D rotation = { c, s, -s, c, 0.0f, 0.0f };
+    current = rotation.Then(current);
+    UpdateIdentityFlag();
+}
+
+void TransformStack::Scale(float x, float y)
+{
+    current.m00 *= x;
+    current.m01 *= x;
+    current.m10 *= y;
+    current.m11 *= y;
+    UpdateIdentityFlag();
+}
+
+void TransformStack::Multiply(const Transform2D& transform)
+{
+    current = transform.Then(current);
+    UpdateIdentityFlag();
+}
+
+void TransformStack::Load(const Transform2D& transform)
+{
+    current = transform;
+    UpdateIdentityFlag();
+}
+
+const Transform2D& TransformStack::Current() const
+{
+    return current;
+}
+
+bool TransformStack::IsIdentity() const
+{
+    return isIdentity;
+}
+
+size_t TransformStack::Depth() const
+{
+    return stack.size();
+}
+
+void TransformStack::TransformPoints(const Vector2 *src, Vector2 *dst, size_t count) const
+{
+    if (isIdentity) {
+        if (src != dst) {
+            for (size_t i = 0; i < count; i++) {
+                dst[i] = src[i];
+            }
+        }
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        float x = src[i].x;
+        float y = src[i].y;
+        dst[i].x = x * current.m00 + y * current.m10 + current.tx;
+        dst[i].y = x * current.m01 + y * current.m11 + current.ty;
+    }
+}
+
+void TransformStack::UpdateIdentityFlag()
+{
+    // PushMatrix()/PopMatrix()で囲んだ変換を打ち消した場合にも、変換を省略できるようにする
+    isIdentity = (current.m00 == 1.0f && current.m01 == 0.0f && current.m10 == 0.0f && current.m11 == 1.0f &&
+                  current.tx == 0.0f && current.ty == 0.0f);
+}
+
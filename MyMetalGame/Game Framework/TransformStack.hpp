@@ -0,0 +1,100 @@
+//
+//  TransformStack.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef TransformStack_hpp
+#define TransformStack_hpp
+
+#include <cstddef>
+#include <vector>
+
+struct Matrix4x4;
+struct Vector2;
+
+
+/// 2次元のアフィン変換（2x3行列）を表す構造体です。
+/// Matrix4x4と同じく行ベクトルに右から掛ける形式で、点(x, y)は (x * m00 + y * m10 + tx, x * m01 + y * m11 + ty) に変換されます。
+struct Transform2D
+{
+    /// 単位行列を作成します。
+    static Transform2D  Identity();
+
+    /// 4x4行列のX・Y成分からアフィン変換を作成します。Z成分と射影の成分は無視されます。
+    static Transform2D  FromMatrix(const Matrix4x4& matrix);
+
+    /// このアフィン変換の後にtransformを適用する変換を作成します。
+    Transform2D Then(const Transform2D& transform) const;
+
+    /// 点を変換します。
+    Vector2     Apply(const Vector2& pos) const;
+
+    /// 同じ内容の4x4行列を作成します。
+    Matrix4x4   ToMatrix() const;
+
+    float   m00;
+    float   m01;
+    float   m10;
+    float   m11;
+    float   tx;
+    float   ty;
+};
+
+
+/// PushMatrix()/PopMatrix()で使用する、2次元のアフィン変換のスタックです。
+/// Translate()などの変換は、それ以降に描画される図形のローカル座標に対して適用されます（先に描画する図形に近い側から掛け合わされます）。
+class TransformStack
+{
+public:
+    TransformStack();
+
+    /// スタックを空にして、現在の変換を単位行列に戻します。
+    void    Reset();
+
+    /// 現在の変換をスタックに積みます。
+    void    Push();
+
+    /// スタックに積まれた変換を取り出して現在の変換に戻します。スタックが空の場合はfalseを返し、何も行いません。
+    bool    Pop();
+
+    /// 平行移動を掛け合わせます。
+    void    Translate(float x, float y);
+
+    /// 原点を中心とした回転（ラジアン）を掛け合わせます。
+    void    Rotate(float rad);
+
+    /// 拡大・縮小を掛け合わせます。
+    void    Scale(float x, float y);
+
+    /// 任意のアフィン変換を掛け合わせます。
+    void    Multiply(const Transform2D& transform);
+
+    /// 現在の変換を置き換えます。
+    void    Load(const Transform2D& transform);
+
+    /// 現在の変換を取得します。
+    const Transform2D&  Current() const;
+
+    /// 現在の変換が単位行列かどうかを判定します。頂点の変換を省略できるかどうかの判断に使います。
+    bool    IsIdentity() const;
+
+    /// スタックに積まれている変換の数を取得します。
+    size_t  Depth() const;
+
+    /// 点の列を現在の変換で変換します。srcとdstは同じ配列でも構いません。
+    void    TransformPoints(const Vector2 *src, Vector2 *dst, size_t count) const;
+
+private:
+    void    UpdateIdentityFlag();
+
+    Transform2D                 current;
+    std::vector<Transform2D>    stack;
+    bool                        isIdentity;
+
+};
+
+
+#endif /* TransformStack_hpp */
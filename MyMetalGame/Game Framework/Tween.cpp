@@ -0,0 +1,817 @@
+//
+//  Tween.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#include "Tween.hpp"
+#include "DebugSupport.hpp"
+#include "Time.hpp"
+#include <algorithm>
+#include <cmath>
+
+
+static const int    kMaxComponentCount = 4;
+static const int    kPoolCount = (int)TweenValueTypeCount * (int)TweenEaseCount * (int)TimerClockCount;
+static const float  kMinDuration = 1.0e-6f;
+
+
+static int GetComponentCount(TweenValueType valueType)
+{
+    switch (valueType) {
+        case TweenValueFloat:       return 1;
+        case TweenValueVector2:     return 2;
+        case TweenValueVector3:     return 3;
+        case TweenValueColor:       return 4;
+        case TweenValueQuaternion:  return 4;
+        default:                    return 0;
+    }
+}
+
+
+#pragma mark - トゥイーンの設定
+
+Tween::Tween(TweenValueType valueType_, float *target_, const float *to_, float duration_, TweenEase ease_)
+    : valueType(valueType_), target(target_), hasFrom(false), duration(duration_), delay(0.0f), ease(ease_), clock(TimerClockScaled)
+{
+    for (int i = 0; i < kMaxComponentCount; i++) {
+        from[i] = 0.0f;
+        to[i] = (i < GetComponentCount(valueType))? to_[i]: 0.0f;
+    }
+}
+
+Tween Tween::To(float *target, float to, float duration, TweenEase ease)
+{
+    return Tween(TweenValueFloat, target, &to, duration, ease);
+}
+
+Tween Tween::To(Vector2 *target, const Vector2& to, float duration, TweenEase ease)
+{
+    return Tween(TweenValueVector2, &target->x, &to.x, duration, ease);
+}
+
+Tween Tween::To(Vector3 *target, const Vector3& to, float duration, TweenEase ease)
+{
+    return Tween(TweenValueVector3, &target->x, &to.x, duration, ease);
+}
+
+Tween Tween::To(Color *target, const Color& to, float duration, TweenEase ease)
+{
+    return Tween(TweenValueColor, &target->r, &to.r, duration, ease);
+}
+
+Tween Tween::To(Quaternion *target, const Quaternion& to, float duration, TweenEase ease)
+{
+    return Tween(TweenValueQuaternion, &target->x, &to.x, duration, ease);
+}
+
+Tween Tween::Interval(float seconds)
+{
+    return Tween(TweenValueNone, nullptr, nullptr, seconds, TweenEaseLinear);
+}
+
+void Tween::SetFrom(TweenValueType valueType_, const float *value)
+{
+    if (valueType_ != valueType) {
+        AbortGame("Tween::From()に、To()で指定した変数と異なる型の値が指定されました。");
+    }
+    for (int i = 0; i < GetComponentCount(valueType); i++) {
+        from[i] = value[i];
+    }
+    hasFrom = true;
+}
+
+Tween& Tween::From(float value)
+{
+    SetFrom(TweenValueFloat, &value);
+    return *this;
+}
+
+Tween& Tween::From(const Vector2& value)
+{
+    SetFrom(TweenValueVector2, &value.x);
+    return *this;
+}
+
+Tween& Tween::From(const Vector3& value)
+{
+    SetFrom(TweenValueVector3, &value.x);
+    return *this;
+}
+
+Tween& Tween::From(const Color& value)
+{
+    SetFrom(TweenValueColor, &value.r);
+    return *this;
+}
+
+Tween& Tween::From(const Quaternion& value)
+{
+    SetFrom(TweenValueQuaternion, &value.x);
+    return *this;
+}
+
+Tween& Tween::Delay(float seconds)
+{
+    delay = std::max(seconds, 0.0f);
+    return *this;
+}
+
+Tween& Tween::OnComplete(std::function<void()> fn)
+{
+    onComplete = std::move(fn);
+    return *this;
+}
+
+Tween& Tween::Clock(TimerClock clock_)
+{
+    clock = clock_;
+    return *this;
+}
+
+float Tween::TotalDuration() const
+{
+    return delay + std::max(duration, 0.0f);
+}
+
+
+#pragma mark - トゥイーンのグループ
+
+TweenGroup::TweenGroup(bool isSequence_)
+    : isSequence(isSequence_), duration(0.0f)
+{
+    // Do nothing
+}
+
+TweenGroup TweenGroup::Sequence()
+{
+    return TweenGroup(true);
+}
+
+TweenGroup TweenGroup::Parallel()
+{
+    return TweenGroup(false);
+}
+
+float TweenGroup::AddOffset(float length)
+{
+    if (isSequence) {
+        float offset = duration;
+        duration += length;
+        return offset;
+    }
+    duration = std::max(duration, length);
+    return 0.0f;
+}
+
+void TweenGroup::AddEntry(float offset, const Tween& tween)
+{
+    Entry entry = { offset, tween };
+
+    // 同じ変数を先に変化させ終えるトゥイーンがあれば、その最終的な値から始める。
+    // こうしておくと、フレームの区切りに関係なく、前のトゥイーンの最終的な値から確実に続けられる。
+    if (!entry.tween.hasFrom && entry.tween.target) {
+        float startTime = entry.offset + entry.tween.delay;
+        const Entry *previous = nullptr;
+        for (const Entry& other : entries) {
+            float endTime = other.offset + other.tween.TotalDuration();
+            if (other.tween.target == entry.tween.target && other.tween.valueType == entry.tween.valueType && endTime <= startTime) {
+                if (!previous || endTime >= previous->offset + previous->tween.TotalDuration()) {
+                    previous = &other;
+                }
+            }
+        }
+        if (previous) {
+            entry.tween.SetFrom(previous->tween.valueType, previous->tween.to);
+        }
+    }
+    entries.push_back(entry);
+}
+
+TweenGroup& TweenGroup::Add(const Tween& tween)
+{
+    AddEntry(AddOffset(tween.TotalDuration()), tween);
+    return *this;
+}
+
+TweenGroup& TweenGroup::Add(const TweenGroup& group)
+{
+    // 入れ子のグループは、中のトゥイーンの時刻をずらして平らに並べる
+    float offset = AddOffset(group.duration);
+    for (const Entry& entry : group.entries) {
+        AddEntry(offset + entry.offset, entry.tween);
+    }
+    return *this;
+}
+
+float TweenGroup::Duration() const
+{
+    return duration;
+}
+
+
+#pragma mark - トゥイーンの管理
+
+/// 開始したトゥイーンやグループの情報。ハンドルはこのスロットを指し、終了したスロットは世代を進めて再利用する。
+struct TweenSlot
+{
+    std::function<void()>       onComplete;
+    std::vector<TweenHandle>    members;            // グループのときだけ使う
+    TweenValueType  valueType;
+    TweenEase       ease;
+    TimerClock      clock;
+    float           *target;
+    float           from[kMaxComponentCount];
+    float           to[kMaxComponentCount];
+    bool            hasFrom;
+    float           duration;
+    int             poolIndex;                      // 開始を待っている間は-1
+    int             denseIndex;
+    int             groupIndex;
+    uint32_t        groupGeneration;
+    int             remainingCount;                 // グループのときだけ使う
+    uint32_t        generation;
+    int             nextFreeIndex;
+    bool            isInUse;
+    bool            isGroup;
+};
+
+/// 値の型と曲線と時計が同じトゥイーンを、要素ごとの配列（SoA）にまとめたプール。
+/// フレームごとの処理は、配列を先頭から順に処理する単純なループだけで済む（コンパイラがベクトル化できる）。
+struct TweenPool
+{
+    TweenValueType      valueType;
+    TweenEase           ease;
+    TimerClock          clock;
+    int                 componentCount;
+    std::vector<float>  elapsed;
+    std::vector<float>  inverseDuration;
+    std::vector<float>  weights;
+    std::vector<float>  start[kMaxComponentCount];
+    std::vector<float>  delta[kMaxComponentCount];
+    std::vector<float *>    targets;
+    std::vector<int>        slotIndices;
+};
+
+/// 開始時刻を待っているトゥイーン（開始時刻が最も早いものが先頭に来るヒープで管理する）
+struct PendingTween
+{
+    double      startTime;
+    uint64_t    order;                  // 開始時刻が同じものは、追加した順に開始する
+    int         slotIndex;
+    uint32_t    generation;
+};
+
+static std::vector<TweenSlot>       sSlots;
+static int                          sFreeSlotIndex = -1;
+static TweenPool                    sPools[kPoolCount];
+static bool                         sIsPoolInitialized = false;
+static std::vector<PendingTween>    sPendingTweens[TimerClockCount];
+static std::vector<TweenHandle>     sFinishedTweens;
+static uint64_t                     sPendingOrder = 0;
+
+
+static double GetClockTime(TimerClock clock)
+{
+    return (clock == TimerClockScaled)? Time::time: Time::unscaledTime;
+}
+
+static float GetClockDeltaTime(TimerClock clock)
+{
+    return (clock == TimerClockScaled)? Time::deltaTime: Time::unscaledDeltaTime;
+}
+
+static bool IsLaterStart(const PendingTween& a, const PendingTween& b)
+{
+    if (a.startTime != b.startTime) {
+        return (a.startTime > b.startTime);
+    }
+    return (a.order > b.order);
+}
+
+static void InitPools()
+{
+    for (int type = 0; type < TweenValueTypeCount; type++) {
+        for (int ease = 0; ease < TweenEaseCount; ease++) {
+            for (int clock = 0; clock < TimerClockCount; clock++) {
+                TweenPool& pool = sPools[(type * TweenEaseCount + ease) * TimerClockCount + clock];
+                pool.valueType = (TweenValueType)type;
+                pool.ease = (TweenEase)ease;
+                pool.clock = (TimerClock)clock;
+                pool.componentCount = GetComponentCount((TweenValueType)type);
+            }
+        }
+    }
+    sIsPoolInitialized = true;
+}
+
+static bool IsSlotAlive(int index, uint32_t generation)
+{
+    return (index >= 0 && index < (int)sSlots.size() && sSlots[index].isInUse && sSlots[index].generation == generation);
+}
+
+static int AllocateSlot()
+{
+    int index = sFreeSlotIndex;
+    if (index >= 0) {
+        sFreeSlotIndex = sSlots[index].nextFreeIndex;
+    } else {
+        index = (int)sSlots.size();
+        sSlots.push_back(TweenSlot());
+        sSlots[index].generation = 0;
+    }
+    TweenSlot& slot = sSlots[index];
+    slot.poolIndex = -1;
+    slot.denseIndex = -1;
+    slot.groupIndex = -1;
+    slot.groupGeneration = 0;
+    slot.remainingCount = 0;
+    slot.isInUse = true;
+    slot.isGroup = false;
+    return index;
+}
+
+static void ReleaseSlot(int index)
+{
+    TweenSlot& slot = sSlots[index];
+    slot.onComplete = nullptr;
+    slot.members.clear();
+    slot.generation++;
+    slot.isInUse = false;
+    slot.nextFreeIndex = sFreeSlotIndex;
+    sFreeSlotIndex = index;
+}
+
+/// 線形のパラメータtを、曲線に沿った補間の重みに変換する（Mathfの各関数と同じ式）
+template <TweenEase Ease>
+static inline float EaseWeight(float t)
+{
+    switch (Ease) {
+        case TweenEaseIn:
+            return t * t;
+        case TweenEaseOut:
+            return t * (2.0f - t);
+        case TweenEaseInOut:
+            return (t <= 0.5f)? 2.0f * t * t: 1.0f - 2.0f * (1.0f - t) * (1.0f - t);
+        case TweenEaseSmoothStep:
+            return t * t * (3.0f - 2.0f * t);
+        default:
+            return t;
+    }
+}
+
+static float EvaluateEase(TweenEase ease, float t)
+{
+    switch (ease) {
+        case TweenEaseIn:           return EaseWeight<TweenEaseIn>(t);
+        case TweenEaseOut:          return EaseWeight<TweenEaseOut>(t);
+        case TweenEaseInOut:        return EaseWeight<TweenEaseInOut>(t);
+        case TweenEaseSmoothStep:   return EaseWeight<TweenEaseSmoothStep>(t);
+        default:                    return EaseWeight<TweenEaseLinear>(t);
+    }
+}
+
+static void WriteValue(TweenValueType valueType, float *target, const float *start, const float *delta, float weight)
+{
+    int count = GetComponentCount(valueType);
+    float value[kMaxComponentCount];
+    for (int i = 0; i < count; i++) {
+        value[i] = start[i] + delta[i] * weight;
+    }
+    if (valueType == TweenValueQuaternion) {
+        float length = sqrtf(value[0] * value[0] + value[1] * value[1] + value[2] * value[2] + value[3] * value[3]);
+        float scale = (length > 0.0f)? 1.0f / length: 0.0f;
+        for (int i = 0; i < count; i++) {
+            value[i] *= scale;
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        target[i] = value[i];
+    }
+}
+
+static void AddToPool(int slotIndex, const float *start, const float *delta, float elapsed)
+{
+    TweenSlot& slot = sSlots[slotIndex];
+    int poolIndex = ((int)slot.valueType * (int)TweenEaseCount + (int)slot.ease) * (int)TimerClockCount + (int)slot.clock;
+    TweenPool& pool = sPools[poolIndex];
+    slot.poolIndex = poolIndex;
+    slot.denseIndex = (int)pool.slotIndices.size();
+
+    pool.elapsed.push_back(elapsed);
+    pool.inverseDuration.push_back(1.0f / std::max(slot.duration, kMinDuration));
+    pool.weights.push_back(0.0f);
+    for (int i = 0; i < pool.componentCount; i++) {
+        pool.start[i].push_back(start[i]);
+        pool.delta[i].push_back(delta[i]);
+    }
+    pool.targets.push_back(slot.target);
+    pool.slotIndices.push_back(slotIndex);
+}
+
+/// プールから取り除く。配列に隙間を作らないように、最後の要素を空いた位置に移す。
+static void RemoveFromPool(int slotIndex)
+{
+    TweenSlot& slot = sSlots[slotIndex];
+    TweenPool& pool = sPools[slot.poolIndex];
+    int index = slot.denseIndex;
+    int last = (int)pool.slotIndices.size() - 1;
+    if (index != last) {
+        pool.elapsed[index] = pool.elapsed[last];
+        pool.inverseDuration[index] = pool.inverseDuration[last];
+        for (int i = 0; i < pool.componentCount; i++) {
+            pool.start[i][index] = pool.start[i][last];
+            pool.delta[i][index] = pool.delta[i][last];
+        }
+        pool.targets[index] = pool.targets[last];
+        pool.slotIndices[index] = pool.slotIndices[last];
+        sSlots[pool.slotIndices[index]].denseIndex = index;
+    }
+    pool.elapsed.pop_back();
+    pool.inverseDuration.pop_back();
+    pool.weights.pop_back();
+    for (int i = 0; i < pool.componentCount; i++) {
+        pool.start[i].pop_back();
+        pool.delta[i].pop_back();
+    }
+    pool.targets.pop_back();
+    pool.slotIndices.pop_back();
+    slot.poolIndex = -1;
+    slot.denseIndex = -1;
+}
+
+/// 経過時間を進めて、補間の重みを求める。曲線ごとに別のループにして、ループの中に分岐を残さないようにする（コンパイラがベクトル化できる）。
+template <TweenEase Ease>
+static void AdvanceWeights(TweenPool& pool, size_t count, float deltaTime)
+{
+    float *elapsed = pool.elapsed.data();
+    const float *inverseDuration = pool.inverseDuration.data();
+    float *weights = pool.weights.data();
+    for (size_t i = 0; i < count; i++) {
+        float e = elapsed[i] + deltaTime;
+        elapsed[i] = e;
+        weights[i] = EaseWeight<Ease>(std::min(std::max(e * inverseDuration[i], 0.0f), 1.0f));
+    }
+}
+
+/// 補間した値を書き込み先に書き込む。書き込み先はばらばらなので、キャッシュラインに触れるのが1回で済むように、1つの書き込み先の要素はまとめて書き込む。
+template <int ComponentCount>
+static void ScatterValues(const TweenPool& pool, size_t count)
+{
+    float *const *targets = pool.targets.data();
+    const float *weights = pool.weights.data();
+    const float *start[ComponentCount];
+    const float *delta[ComponentCount];
+    for (int c = 0; c < ComponentCount; c++) {
+        start[c] = pool.start[c].data();
+        delta[c] = pool.delta[c].data();
+    }
+    for (size_t i = 0; i < count; i++) {
+        float *target = targets[i];
+        float weight = weights[i];
+        for (int c = 0; c < ComponentCount; c++) {
+            target[c] = start[c][i] + delta[c][i] * weight;
+        }
+    }
+}
+
+/// クォータニオンは、補間した値を正規化してから書き込む
+static void ScatterQuaternions(const TweenPool& pool, size_t count)
+{
+    float *const *targets = pool.targets.data();
+    const float *weights = pool.weights.data();
+    for (size_t i = 0; i < count; i++) {
+        float weight = weights[i];
+        float x = pool.start[0][i] + pool.delta[0][i] * weight;
+        float y = pool.start[1][i] + pool.delta[1][i] * weight;
+        float z = pool.start[2][i] + pool.delta[2][i] * weight;
+        float w = pool.start[3][i] + pool.delta[3][i] * weight;
+        float length = sqrtf(x * x + y * y + z * z + w * w);
+        float scale = (length > 0.0f)? 1.0f / length: 0.0f;
+        float *target = targets[i];
+        target[0] = x * scale;
+        target[1] = y * scale;
+        target[2] = z * scale;
+        target[3] = w * scale;
+    }
+}
+
+/// プールのトゥイーンをすべて進めて、補間した値を書き込む
+static void AdvancePool(TweenPool& pool, float deltaTime)
+{
+    size_t count = pool.slotIndices.size();
+    switch (pool.ease) {
+        case TweenEaseIn:           AdvanceWeights<TweenEaseIn>(pool, count, deltaTime); break;
+        case TweenEaseOut:          AdvanceWeights<TweenEaseOut>(pool, count, deltaTime); break;
+        case TweenEaseInOut:        AdvanceWeights<TweenEaseInOut>(pool, count, deltaTime); break;
+        case TweenEaseSmoothStep:   AdvanceWeights<TweenEaseSmoothStep>(pool, count, deltaTime); break;
+        default:                    AdvanceWeights<TweenEaseLinear>(pool, count, deltaTime); break;
+    }
+
+    if (pool.valueType == TweenValueQuaternion) {
+        ScatterQuaternions(pool, count);
+        return;
+    }
+    switch (pool.componentCount) {
+        case 1: ScatterValues<1>(pool, count); break;
+        case 2: ScatterValues<2>(pool, count); break;
+        case 3: ScatterValues<3>(pool, count); break;
+        case 4: ScatterValues<4>(pool, count); break;
+        default: break;
+    }
+}
+
+/// 最終的な値を書き込む（開始時の値に差分を足し戻すと丸め誤差が出るので、終点の値をそのまま使う）
+static void WriteFinalValue(const TweenSlot& slot)
+{
+    if (slot.valueType != TweenValueNone) {
+        float zero[kMaxComponentCount] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        WriteValue(slot.valueType, slot.target, slot.to, zero, 0.0f);
+    }
+}
+
+/// 開始時刻を迎えたトゥイーンをプールに入れ、そのフレームの値を書き込む。
+/// 長さが0のものや、開始した時点で既に最後まで進んでいるものは、最終的な値を書き込んでtrueを返す。
+static bool ActivateTween(int slotIndex, float elapsed)
+{
+    TweenSlot& slot = sSlots[slotIndex];
+    int count = GetComponentCount(slot.valueType);
+    float start[kMaxComponentCount];
+    float delta[kMaxComponentCount];
+    for (int i = 0; i < count; i++) {
+        start[i] = slot.hasFrom? slot.from[i]: slot.target[i];
+    }
+
+    // クォータニオンは、同じ回転を表す2つの値のうち、近い方に向かって補間する
+    float sign = 1.0f;
+    if (slot.valueType == TweenValueQuaternion) {
+        float dot = start[0] * slot.to[0] + start[1] * slot.to[1] + start[2] * slot.to[2] + start[3] * slot.to[3];
+        if (dot < 0.0f) {
+            sign = -1.0f;
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        delta[i] = slot.to[i] * sign - start[i];
+    }
+
+    AddToPool(slotIndex, start, delta, elapsed);
+    if (slot.duration <= 0.0f || elapsed >= slot.duration) {
+        WriteFinalValue(slot);
+        return true;
+    }
+    if (count > 0) {
+        float t = std::min(std::max(elapsed / std::max(slot.duration, kMinDuration), 0.0f), 1.0f);
+        WriteValue(slot.valueType, slot.target, start, delta, EvaluateEase(slot.ease, t));
+    }
+    return false;
+}
+
+static TweenHandle AddTween(const Tween& tween, double startTime, int groupIndex, uint32_t groupGeneration)
+{
+    if (!sIsPoolInitialized) {
+        InitPools();
+    }
+
+    int index = AllocateSlot();
+    TweenSlot& slot = sSlots[index];
+    slot.onComplete = tween.onComplete;
+    slot.valueType = tween.valueType;
+    slot.ease = tween.ease;
+    slot.clock = tween.clock;
+    slot.target = tween.target;
+    for (int i = 0; i < kMaxComponentCount; i++) {
+        slot.from[i] = tween.from[i];
+        slot.to[i] = tween.to[i];
+    }
+    slot.hasFrom = tween.hasFrom;
+    slot.duration = std::max(tween.duration, 0.0f);
+    slot.groupIndex = groupIndex;
+    slot.groupGeneration = groupGeneration;
+
+    // 開始を待つトゥイーンはヒープに入れておき、__UpdateTweens()で開始時刻を迎えたときにプールに移す
+    PendingTween pending = { startTime, sPendingOrder++, index, slot.generation };
+    std::vector<PendingTween>& heap = sPendingTweens[tween.clock];
+    heap.push_back(pending);
+    std::push_heap(heap.begin(), heap.end(), IsLaterStart);
+
+    TweenHandle handle;
+    handle.index = index;
+    handle.generation = slot.generation;
+    return handle;
+}
+
+/// グループに属するトゥイーンが1つ終わったことを知らせ、すべて終わっていればグループを終了する
+static void NotifyGroupMemberFinished(int groupIndex, uint32_t groupGeneration)
+{
+    if (!IsSlotAlive(groupIndex, groupGeneration)) {
+        return;
+    }
+    if (--sSlots[groupIndex].remainingCount > 0) {
+        return;
+    }
+    std::function<void()> onComplete = std::move(sSlots[groupIndex].onComplete);
+    ReleaseSlot(groupIndex);
+    if (onComplete) {
+        onComplete();
+    }
+}
+
+/// トゥイーンを終了して、完了時の関数を呼び出す
+static void FinishTween(int slotIndex)
+{
+    if (sSlots[slotIndex].poolIndex >= 0) {
+        RemoveFromPool(slotIndex);
+    }
+    std::function<void()> onComplete = std::move(sSlots[slotIndex].onComplete);
+    int groupIndex = sSlots[slotIndex].groupIndex;
+    uint32_t groupGeneration = sSlots[slotIndex].groupGeneration;
+    ReleaseSlot(slotIndex);
+
+    // 完了時の関数の中で新しいトゥイーンが開始されることがあるので、スロットを解放してから呼び出す
+    if (onComplete) {
+        onComplete();
+    }
+    NotifyGroupMemberFinished(groupIndex, groupGeneration);
+}
+
+TweenHandle StartTween(const Tween& tween)
+{
+    return AddTween(tween, GetClockTime(tween.clock) + tween.delay, -1, 0);
+}
+
+TweenHandle StartTweenGroup(const TweenGroup& group, std::function<void()> onComplete)
+{
+    int groupIndex = AllocateSlot();
+    uint32_t groupGeneration = sSlots[groupIndex].generation;
+    sSlots[groupIndex].isGroup = true;
+    sSlots[groupIndex].onComplete = std::move(onComplete);
+    sSlots[groupIndex].remainingCount = (int)group.entries.size();
+
+    TweenHandle handle;
+    handle.index = groupIndex;
+    handle.generation = groupGeneration;
+    if (group.entries.empty()) {
+        // 空のグループはすぐに完了する
+        sSlots[groupIndex].remainingCount = 1;
+        NotifyGroupMemberFinished(groupIndex, groupGeneration);
+        return handle;
+    }
+
+    // 各トゥイーンの開始時刻は、グループを開始した時刻から決めておく
+    double now[TimerClockCount];
+    for (int clock = 0; clock < TimerClockCount; clock++) {
+        now[clock] = GetClockTime((TimerClock)clock);
+    }
+    std::vector<TweenHandle> members;
+    members.reserve(group.entries.size());
+    for (const TweenGroup::Entry& entry : group.entries) {
+        const Tween& tween = entry.tween;
+        members.push_back(AddTween(tween, now[tween.clock] + entry.offset + tween.delay, groupIndex, groupGeneration));
+    }
+    sSlots[groupIndex].members = std::move(members);
+    return handle;
+}
+
+void CancelTween(const TweenHandle& handle)
+{
+    if (!IsSlotAlive(handle.index, handle.generation)) {
+        return;
+    }
+
+    if (sSlots[handle.index].isGroup) {
+        std::vector<TweenHandle> members = std::move(sSlots[handle.index].members);
+        ReleaseSlot(handle.index);
+        for (const TweenHandle& member : members) {
+            CancelTween(member);
+        }
+        return;
+    }
+
+    // 開始を待っているものは、ヒープに残ったまま世代の違いで無視される
+    if (sSlots[handle.index].poolIndex >= 0) {
+        RemoveFromPool(handle.index);
+    }
+    int groupIndex = sSlots[handle.index].groupIndex;
+    uint32_t groupGeneration = sSlots[handle.index].groupGeneration;
+    ReleaseSlot(handle.index);
+
+    // グループは取り消されたトゥイーンを待たなくなる（残りのトゥイーンがすべて終わっていれば、ここでグループが完了する）
+    if (groupIndex >= 0) {
+        NotifyGroupMemberFinished(groupIndex, groupGeneration);
+    }
+}
+
+void CompleteTween(const TweenHandle& handle)
+{
+    if (!IsSlotAlive(handle.index, handle.generation)) {
+        return;
+    }
+
+    if (sSlots[handle.index].isGroup) {
+        std::vector<TweenHandle> members = sSlots[handle.index].members;
+        for (const TweenHandle& member : members) {
+            CompleteTween(member);
+        }
+        return;
+    }
+
+    WriteFinalValue(sSlots[handle.index]);
+    FinishTween(handle.index);
+}
+
+void CancelAllTweens()
+{
+    for (int i = 0; i < (int)sSlots.size(); i++) {
+        if (sSlots[i].isInUse) {
+            ReleaseSlot(i);
+        }
+    }
+    for (TweenPool& pool : sPools) {
+        pool.elapsed.clear();
+        pool.inverseDuration.clear();
+        pool.weights.clear();
+        for (int i = 0; i < kMaxComponentCount; i++) {
+            pool.start[i].clear();
+            pool.delta[i].clear();
+        }
+        pool.targets.clear();
+        pool.slotIndices.clear();
+    }
+    for (int clock = 0; clock < TimerClockCount; clock++) {
+        sPendingTweens[clock].clear();
+    }
+}
+
+bool IsTweenActive(const TweenHandle& handle)
+{
+    return IsSlotAlive(handle.index, handle.generation);
+}
+
+int GetRunningTweenCount()
+{
+    int count = 0;
+    for (const TweenPool& pool : sPools) {
+        count += (int)pool.slotIndices.size();
+    }
+    return count;
+}
+
+void __UpdateTweens()
+{
+    if (!sIsPoolInitialized) {
+        return;
+    }
+
+    // 進行中のトゥイーンを進める
+    for (TweenPool& pool : sPools) {
+        if (!pool.slotIndices.empty()) {
+            AdvancePool(pool, GetClockDeltaTime(pool.clock));
+        }
+    }
+
+    // 最後まで進んだトゥイーンに最終的な値を書き込んでおく（完了時の関数で他のトゥイーンが取り消されることがあるので、終了の処理はハンドルで集めて最後に行う）
+    for (const TweenPool& pool : sPools) {
+        size_t count = pool.slotIndices.size();
+        for (size_t i = 0; i < count; i++) {
+            if (pool.elapsed[i] * pool.inverseDuration[i] >= 1.0f) {
+                TweenHandle handle;
+                handle.index = pool.slotIndices[i];
+                handle.generation = sSlots[handle.index].generation;
+                sFinishedTweens.push_back(handle);
+                WriteFinalValue(sSlots[handle.index]);
+            }
+        }
+    }
+
+    // 開始時刻を迎えたトゥイーンを開始する。
+    // 進めた後に開始するので、同じ変数を直前に変化させていたトゥイーンの最終的な値を、開始時の値として読み取れる。
+    for (int clock = 0; clock < TimerClockCount; clock++) {
+        double clockTime = GetClockTime((TimerClock)clock);
+        std::vector<PendingTween>& heap = sPendingTweens[clock];
+        while (!heap.empty() && heap.front().startTime <= clockTime) {
+            std::pop_heap(heap.begin(), heap.end(), IsLaterStart);
+            PendingTween pending = heap.back();
+            heap.pop_back();
+            if (!IsSlotAlive(pending.slotIndex, pending.generation)) {
+                continue;
+            }
+            // 長さが0のトゥイーンは、開始時の値を1フレームも残さずに、開始したフレームのうちに終了する
+            if (ActivateTween(pending.slotIndex, (float)(clockTime - pending.startTime))) {
+                TweenHandle handle;
+                handle.index = pending.slotIndex;
+                handle.generation = pending.generation;
+                sFinishedTweens.push_back(handle);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < sFinishedTweens.size(); i++) {
+        if (IsSlotAlive(sFinishedTweens[i].index, sFinishedTweens[i].generation)) {
+            FinishTween(sFinishedTweens[i].index);
+        }
+    }
+    sFinishedTweens.clear();
+}
+
@@ -0,0 +1,215 @@
+//
+//  Tween.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef Tween_hpp
+#define Tween_hpp
+
+#include "Color.hpp"
+#include "Quaternion.hpp"
+#include "TimerService.hpp"
+#include "Vector2.hpp"
+#include "Vector3.hpp"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+
+/// トゥイーンの補間の曲線を表す列挙型です。それぞれMathf::EaseIn()などの同名の関数と同じ曲線になります。
+enum TweenEase
+{
+    /// 線形の補間（Mathf::Lerp()）
+    TweenEaseLinear,
+
+    /// 始めがゆっくりの補間（Mathf::EaseIn()）
+    TweenEaseIn,
+
+    /// 終わりがゆっくりの補間（Mathf::EaseOut()）
+    TweenEaseOut,
+
+    /// 始めと終わりがゆっくりの補間（Mathf::EaseInOut()）
+    TweenEaseInOut,
+
+    /// エルミート補間（Mathf::SmoothStep()）
+    TweenEaseSmoothStep,
+
+    TweenEaseCount,
+};
+
+
+/// トゥイーンで変化させる値の型を表す列挙型
+enum TweenValueType
+{
+    /// 値を持たない、時間を空けるためだけのトゥイーン
+    TweenValueNone,
+
+    TweenValueFloat,
+    TweenValueVector2,
+    TweenValueVector3,
+    TweenValueColor,
+    TweenValueQuaternion,
+
+    TweenValueTypeCount,
+};
+
+
+/// StartTween()やStartTweenGroup()で開始したトゥイーンを識別するためのハンドルです。トゥイーンが終了すると無効になります。
+struct TweenHandle
+{
+    int         index;
+    uint32_t    generation;
+
+    TweenHandle()
+        : index(-1), generation(0)
+    {
+        // Do nothing
+    }
+};
+
+
+/// 開始する前のトゥイーンの設定です。Tween::To()で作成し、StartTween()に渡して開始します。
+///
+///     StartTween(Tween::To(&position, Vector2(100, 0), 0.5f, TweenEaseOut).Delay(0.2f).OnComplete([] { ... }));
+///
+/// トゥイーンは毎フレームUpdate()の直後に進み、指定した変数に補間した値を書き込みます。変数はトゥイーンが終わるまで破棄しないでください。
+class Tween
+{
+public:
+    /// targetの値を、開始した時点の値からtoまで、duration秒かけて変化させるトゥイーンを作成します。
+    static Tween    To(float *target, float to, float duration, TweenEase ease = TweenEaseLinear);
+
+    /// targetの値を、開始した時点の値からtoまで、duration秒かけて変化させるトゥイーンを作成します。
+    static Tween    To(Vector2 *target, const Vector2& to, float duration, TweenEase ease = TweenEaseLinear);
+
+    /// targetの値を、開始した時点の値からtoまで、duration秒かけて変化させるトゥイーンを作成します。
+    static Tween    To(Vector3 *target, const Vector3& to, float duration, TweenEase ease = TweenEaseLinear);
+
+    /// targetの色を、開始した時点の色からtoまで、duration秒かけて変化させるトゥイーンを作成します。
+    static Tween    To(Color *target, const Color& to, float duration, TweenEase ease = TweenEaseLinear);
+
+    /// targetの回転を、開始した時点の回転からtoまで、duration秒かけて変化させるトゥイーンを作成します。回転は近い方の向きに、正規化した線形補間で変化します。
+    static Tween    To(Quaternion *target, const Quaternion& to, float duration, TweenEase ease = TweenEaseLinear);
+
+    /// 何も変化させずに、指定した秒数だけ時間を空けるトゥイーンを作成します。TweenGroupの中で間隔を空けるときに使います。
+    static Tween    Interval(float seconds);
+
+public:
+    /// 開始した時点の値ではなく、指定した値から変化させます。値の型はTo()で指定した変数の型と同じにしてください。
+    Tween&  From(float value);
+    Tween&  From(const Vector2& value);
+    Tween&  From(const Vector3& value);
+    Tween&  From(const Color& value);
+    Tween&  From(const Quaternion& value);
+
+    /// 開始するまでの待ち時間を設定します。
+    Tween&  Delay(float seconds);
+
+    /// トゥイーンが最後まで進んだときに呼び出される関数を設定します。CancelTween()で取り消された場合は呼び出されません。
+    Tween&  OnComplete(std::function<void()> fn);
+
+    /// 時間を測る時計を設定します。TimerClockUnscaledを指定すると、Time::timeScaleを0にして一時停止している間も進みます。
+    Tween&  Clock(TimerClock clock);
+
+    /// 待ち時間を含めた、トゥイーンの長さを取得します。
+    float   TotalDuration() const;
+
+public:
+    TweenValueType  valueType;
+    float           *target;
+    float           from[4];
+    float           to[4];
+    bool            hasFrom;
+    float           duration;
+    float           delay;
+    TweenEase       ease;
+    TimerClock      clock;
+    std::function<void()>   onComplete;
+
+private:
+    Tween(TweenValueType valueType, float *target, const float *to, float duration, TweenEase ease);
+    void    SetFrom(TweenValueType valueType, const float *value);
+
+    friend class TweenGroup;
+
+};
+
+
+/// 複数のトゥイーンを、順番に（Sequence）または同時に（Parallel）実行するグループです。グループの中に別のグループを入れることもできます。
+///
+///     TweenGroup group = TweenGroup::Sequence();
+///     group.Add(Tween::To(&x, 1.0f, 0.5f)).Add(Tween::Interval(0.2f)).Add(Tween::To(&x, 0.0f, 0.5f));
+///     StartTweenGroup(group);
+///
+/// 各トゥイーンの開始する時刻はグループを開始した時点で決まるので、長く続くシーケンスでもフレームごとの誤差が積み重なることはありません。
+class TweenGroup
+{
+public:
+    /// 追加したものを、前のものが終わってから順番に実行するグループを作成します。
+    static TweenGroup   Sequence();
+
+    /// 追加したものを、グループの開始と同時にすべて実行するグループを作成します。
+    static TweenGroup   Parallel();
+
+public:
+    /// トゥイーンを追加します。
+    TweenGroup& Add(const Tween& tween);
+
+    /// 別のグループを、1つの要素として追加します。
+    TweenGroup& Add(const TweenGroup& group);
+
+    /// グループ全体の長さを取得します。
+    float       Duration() const;
+
+public:
+    /// グループの開始から、そのトゥイーンの開始（待ち時間を含む）までの時間と、トゥイーンの組
+    struct Entry
+    {
+        float   offset;
+        Tween   tween;
+    };
+
+    bool                isSequence;
+    float               duration;
+    std::vector<Entry>  entries;
+
+private:
+    explicit TweenGroup(bool isSequence);
+    float   AddOffset(float length);
+    void    AddEntry(float offset, const Tween& tween);
+
+};
+
+
+/// トゥイーンを開始します。
+TweenHandle     StartTween(const Tween& tween);
+
+/// グループに含まれるトゥイーンをすべて開始します。onCompleteは、グループのすべてのトゥイーンが最後まで進んだときに呼び出されます。
+TweenHandle     StartTweenGroup(const TweenGroup& group, std::function<void()> onComplete = nullptr);
+
+/// トゥイーンを途中で止めます。値はその時点のまま残り、完了時の関数は呼び出されません。グループのハンドルを渡すと、グループ全体を止めます。
+/// グループに属するトゥイーンを止めた場合、グループはそのトゥイーンを待たなくなり、ほかのトゥイーンがすべて終わった時点でグループの完了時の関数が呼び出されます。
+void    CancelTween(const TweenHandle& handle);
+
+/// トゥイーンを最後まで進めた状態にして終了します。値は最終的な値になり、完了時の関数が呼び出されます。
+/// グループのハンドルを渡すと、まだ終わっていないトゥイーンを開始する順に完了させてから、グループの完了時の関数を呼び出します。
+void    CompleteTween(const TweenHandle& handle);
+
+/// すべてのトゥイーンを止めます。
+void    CancelAllTweens();
+
+/// トゥイーンがまだ終了していないかどうかを判定します（開始を待っている間も含みます）。
+bool    IsTweenActive(const TweenHandle& handle);
+
+/// 値を変化させているトゥイーンの数を取得します（開始を待っているものは含みません）。
+int     GetRunningTweenCount();
+
+/// すべてのトゥイーンを1フレーム分進めます。フレームごとにUpdate()の直後に呼び出されます。
+void    __UpdateTweens();
+
+
+#endif /* Tween_hpp */
+
@@ -0,0 +1,25 @@
+//
+//  VertexFormat.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef VertexFormat_hpp
+#define VertexFormat_hpp
+
+
+/// 図形描画で頂点バッファに書き込む頂点のフォーマットを表す列挙型
+enum VertexFormat
+{
+    /// 位置をfloat×2、色をfloat×4で格納するフォーマット（1頂点24バイト）
+    VertexFormatStandard,
+
+    /// 位置を半精度浮動小数点数×2、色をRGBA8で格納するフォーマット（1頂点8バイト）
+    /// 座標の精度は有効数字11ビット程度に落ちますが、同じバッファに3倍の頂点を格納できます。
+    VertexFormatCompact,
+};
+
+
+#endif /* VertexFormat_hpp */
@@ -64,9 +64,9 @@ void Update()
 {
     t += Time::deltaTime;
 
-    for (auto triangle : triangles) {
-        triangle->Step();
-    }
+    ParallelFor(0, triangles.size(), 256, [](size_t i) {
+        triangles[i]->Step();
+    });
 
     if (Input::GetKey(KeyCode::Space)) {
         Clear(Color::lightorange);
@@ -0,0 +1,222 @@
+//
+//  BenchmarkScenes.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+// ヘッドレスのランナーで実行するベンチマークのシーンです。Game.cpp の代わりにリンクして、--sceneでシーンを選びます。
+//
+//     headless --scene triangles --frames 600 --quiet
+//
+// triangles        FillTriangles()で、1フレームにkTriangleCount個の三角形をまとめて描画する
+// triangles-each   同じ三角形を、FillTriangle()で1つずつ描画する
+// sort200k         遅延描画と同じDrawCommandListに、レイヤと深度の異なる20万個の描画コマンドを記録して並べ替える
+// particles        ParallelFor()で、50万個のパーティクルを毎フレーム更新する（--workersでワーカースレッドの数を変えて比べる）
+//
+// 要約の「throughput」の行が、公開されている描画関数を通して1秒あたりに処理できた三角形の数です（頂点を動かす処理の時間も含みます）。
+// sort200kでは、要約の「update」の時間が、20万個のコマンドの記録・並べ替え・同じ状態の範囲の作成にかかった時間です。
+// particlesでは、要約の「update」の時間が、すべてのパーティクルの更新にかかった時間です。
+
+#include "GameFramework.hpp"
+#include "HeadlessRenderer.hpp"
+#include "Settings.hpp"
+#include "DrawCommandList.hpp"
+#include <cstring>
+
+
+/// ベンチマークの1つのシーン
+struct BenchmarkScene
+{
+    const char  *name;
+    void        (*start)();
+    void        (*update)();
+};
+
+
+#pragma mark - 三角形の描画
+
+/// 頂点バッファ（METAL_MAX_POLYGON_COUNT個の三角形分）に、256バイト境界への揃えの分の余裕を残して収まる数
+static const size_t kTriangleCount = METAL_MAX_POLYGON_COUNT * 9 / 10;
+
+static std::vector<Vector2>     sTrianglePositions;
+static std::vector<Vector2>     sTriangleVelocities;
+static std::vector<Color>       sTriangleColors;
+
+static void StartTriangles()
+{
+    sTrianglePositions.resize(kTriangleCount * 3);
+    sTriangleVelocities.resize(kTriangleCount * 3);
+    sTriangleColors.resize(kTriangleCount * 3);
+    for (size_t i = 0; i < kTriangleCount * 3; i++) {
+        sTrianglePositions[i] = Vector2(Random::FloatRange(-1, 1), Random::FloatRange(-1, 1));
+        sTriangleVelocities[i] = Vector2(Random::FloatRange(-1, 1), Random::FloatRange(-1, 1));
+        sTriangleColors[i] = Color::Lerp(Color::lightblue, Color::blue.Alpha(0.0f), Random::FloatRange(0, 1));
+    }
+}
+
+/// 画面の端で跳ね返りながら頂点を動かす
+static void StepTriangles()
+{
+    for (size_t i = 0; i < sTrianglePositions.size(); i++) {
+        Vector2& pos = sTrianglePositions[i];
+        Vector2& velocity = sTriangleVelocities[i];
+        pos += velocity * Time::deltaTime;
+        if (pos.x < -1.0f || pos.x > 1.0f) {
+            velocity.x *= -1;
+        }
+        if (pos.y < -1.0f || pos.y > 1.0f) {
+            velocity.y *= -1;
+        }
+    }
+}
+
+static void UpdateTriangles()
+{
+    StepTriangles();
+    Clear(Color::black);
+    SetBlendMode(BlendModeAlpha);
+    FillTriangles(sTrianglePositions, sTriangleColors);
+}
+
+static void UpdateTrianglesEach()
+{
+    StepTriangles();
+    Clear(Color::black);
+    SetBlendMode(BlendModeAlpha);
+    for (size_t i = 0; i < sTrianglePositions.size(); i += 3) {
+        FillTriangle(sTrianglePositions[i], sTrianglePositions[i + 1], sTrianglePositions[i + 2],
+                     sTriangleColors[i], sTriangleColors[i + 1], sTriangleColors[i + 2]);
+    }
+}
+
+
+#pragma mark - 描画コマンドの並べ替え
+
+// 20万個の三角形は頂点バッファに収まらないので、SetLayer()とSetDepth()で記録したときと同じキーのコマンドを、DrawCommandListに直接記録する
+static const size_t kSortItemCount = 200000;
+
+/// 1つの描画コマンドの記録内容
+struct SortItem
+{
+    int         layer;
+    float       depth;
+    unsigned    textureID;
+};
+
+static std::vector<SortItem>    sSortItems;
+static DrawCommandList          sSortCommandList;
+
+static void StartSort()
+{
+    // 加算合成はテクスチャを切り替えてもセグメントが分かれないので、すべてのコマンドがレイヤ・深度・テクスチャの順に並べ替えられる
+    sSortItems.resize(kSortItemCount);
+    for (SortItem& item : sSortItems) {
+        item.layer = Random::IntRange(0, 7);
+        item.depth = Random::FloatRange(0, 1);
+        item.textureID = (unsigned)Random::IntRange(1, 8);
+    }
+}
+
+static void UpdateSort()
+{
+    Clear(Color::black);
+
+    sSortCommandList.Reset();
+    for (size_t i = 0; i < sSortItems.size(); i++) {
+        const SortItem& item = sSortItems[i];
+        sSortCommandList.Record(item.layer, item.depth, BlendModeAdd, VertexFormatStandard, item.textureID, (uint32_t)i * 3, 3);
+    }
+    sSortCommandList.Sort();
+    sSortCommandList.BuildRuns();
+
+    const std::vector<DrawCommand>& commands = sSortCommandList.Commands();
+    for (size_t i = 1; i < commands.size(); i++) {
+        if (commands[i - 1].key > commands[i].key) {
+            AbortGame("描画コマンドが並べ替えられていません。（%lu番目）", (unsigned long)i);
+        }
+    }
+}
+
+
+#pragma mark - パーティクルの更新
+
+static const size_t kParticleCount = 500000;
+static const size_t kParticleGrain = 4096;
+
+/// 1つのパーティクルの状態
+struct Particle
+{
+    Vector2 position;
+    Vector2 velocity;
+    float   life;
+};
+
+static std::vector<Particle>    sParticles;
+
+static void StartParticles()
+{
+    sParticles.resize(kParticleCount);
+    for (Particle& particle : sParticles) {
+        particle.position = Vector2(Random::FloatRange(-1, 1), Random::FloatRange(-1, 1));
+        particle.velocity = Vector2(Random::FloatRange(-0.5f, 0.5f), Random::FloatRange(0.0f, 1.0f));
+        particle.life = Random::FloatRange(0.5f, 3.0f);
+    }
+}
+
+static void UpdateParticles()
+{
+    float deltaTime = Time::deltaTime;
+    ParallelFor(0, sParticles.size(), kParticleGrain, [deltaTime](size_t i) {
+        // 重力と空気抵抗で動かし、床で跳ね返らせる。寿命が尽きたら真上に打ち上げ直す
+        Particle& particle = sParticles[i];
+        particle.velocity.y -= 2.0f * deltaTime;
+        particle.velocity *= 1.0f - 0.1f * deltaTime;
+        particle.position += particle.velocity * deltaTime;
+        if (particle.position.y < -1.0f) {
+            particle.position.y = -1.0f;
+            particle.velocity.y *= -0.6f;
+        }
+        particle.life -= deltaTime;
+        if (particle.life <= 0.0f) {
+            particle.velocity = Vector2(particle.velocity.x, 1.5f);
+            particle.life += 3.0f;
+        }
+    });
+
+    Clear(Color::black);
+}
+
+
+#pragma mark - シーンの選択
+
+static const BenchmarkScene sScenes[] = {
+    { "triangles",      StartTriangles,     UpdateTriangles },
+    { "triangles-each", StartTriangles,     UpdateTrianglesEach },
+    { "sort200k",       StartSort,          UpdateSort },
+    { "particles",      StartParticles,     UpdateParticles },
+};
+
+static const BenchmarkScene *sScene = &sScenes[0];
+
+bool SelectHeadlessScene(const char *name)
+{
+    for (const BenchmarkScene& scene : sScenes) {
+        if (strcmp(scene.name, name) == 0) {
+            sScene = &scene;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Start()
+{
+    sScene->start();
+}
+
+void Update()
+{
+    sScene->update();
+}
@@ -0,0 +1,367 @@
+//
+//  CoroutineTest.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+// コルーチンのスケジューラのテストです。
+//
+//     CoroutineTest [--iterations N]
+//
+// ゲームのループと同じ順番（入力の取り込み、時間の更新、Update()、__UpdateCoroutines()、フレーム数の更新）でフレームを進めながら、
+// 時間・フレーム数・キー・条件の関数による待機がそれぞれ正しいフレームで再開すること、入れ子のコルーチンと停止、
+// 終了したコルーチンのフレームがプールで再利用され、開始と終了を繰り返してもヒープを確保しないことを確かめます。
+
+#include "TestSupport.hpp"
+#include "Coroutine.hpp"
+#include "Input.hpp"
+#include "Time.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+
+/// グローバルのoperator newが呼ばれた回数
+static long long    sHeapAllocationCount = 0;
+
+void *operator new(size_t size)
+{
+    sHeapAllocationCount++;
+    void *p = malloc(size? size: 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+
+/// 1フレームの時間（2進数で割り切れる値にして、時間の比較に丸め誤差が入らないようにする）
+static const double kFrameTime = 0.125;
+
+/// 現在のフレームのUpdate()に相当する処理を行う関数
+static void (*sUpdate)() = nullptr;
+
+/// 1フレーム進める。sUpdateは、ゲームのUpdate()と同じく__UpdateCoroutines()の前に呼ばれる
+static void RunFrame()
+{
+    Input::__PublishInput();
+    Input::__UpdateTriggers();
+    Time::time += kFrameTime * Time::timeScale;
+    Time::unscaledTime += kFrameTime;
+    if (sUpdate) {
+        sUpdate();
+    }
+    __UpdateCoroutines();
+    Time::frameCount++;
+}
+
+
+#pragma mark - 時間とフレーム数
+
+static int      sStep = 0;
+static double   sResumedTime = 0.0;
+static int      sResumedFrame = 0;
+
+static Coroutine WaitSecondsCoroutine(float seconds)
+{
+    sStep = 1;
+    co_await WaitForSeconds(seconds);
+    sStep = 2;
+    sResumedTime = Time::time;
+    sResumedFrame = Time::frameCount;
+}
+
+/// 指定した秒数の後の最初のフレームで再開し、0秒なら中断しない
+static void TestWaitForSeconds()
+{
+    double startTime = Time::time;
+    CoroutineHandle handle = StartCoroutine(WaitSecondsCoroutine(1.0f));
+    TEST_CHECK(sStep == 1);
+    TEST_CHECK(IsCoroutineRunning(handle));
+    for (int i = 0; i < 7; i++) {
+        RunFrame();
+    }
+    TEST_CHECK(sStep == 1);
+    RunFrame();
+    TEST_CHECK(sStep == 2);
+    TEST_CHECK(sResumedTime == startTime + 1.0);
+    TEST_CHECK(!IsCoroutineRunning(handle));
+
+    // 待っている途中でtimeScaleを変えると、スケールした時間の進み方に合わせて再開が遅れる
+    StartCoroutine(WaitSecondsCoroutine(0.5f));
+    RunFrame();
+    Time::timeScale = 0.5f;
+    int frames = 1;
+    while (sStep != 2 && frames < 100) {
+        RunFrame();
+        frames++;
+    }
+    Time::timeScale = 1.0f;
+    TEST_CHECK(frames == 7);
+
+    // 0秒の待機は中断せずに、その場で最後まで進む
+    handle = StartCoroutine(WaitSecondsCoroutine(0.0f));
+    TEST_CHECK(sStep == 2);
+    TEST_CHECK(!IsCoroutineRunning(handle));
+}
+
+static Coroutine WaitFramesCoroutine(int frameCount)
+{
+    sStep = 1;
+    co_await WaitForFrames(frameCount);
+    sStep = 2;
+    sResumedFrame = Time::frameCount;
+}
+
+/// フレームの外で待ち始めると、次に始まるフレームを0として数え、WaitForFrames(1)はその次のフレームで再開する
+static void TestWaitForFrames()
+{
+    int startFrame = Time::frameCount;
+    StartCoroutine(WaitFramesCoroutine(1));
+    RunFrame();
+    TEST_CHECK(sStep == 1);
+    RunFrame();
+    TEST_CHECK(sStep == 2);
+    TEST_CHECK(sResumedFrame == startFrame + 1);
+
+    startFrame = Time::frameCount;
+    StartCoroutine(WaitFramesCoroutine(3));
+    for (int i = 0; i < 3; i++) {
+        RunFrame();
+    }
+    TEST_CHECK(sStep == 1);
+    RunFrame();
+    TEST_CHECK(sStep == 2);
+    TEST_CHECK(sResumedFrame == startFrame + 3);
+
+    StartCoroutine(WaitFramesCoroutine(0));
+    TEST_CHECK(sStep == 2);
+}
+
+
+#pragma mark - キー
+
+static int  sKeyResumeCount = 0;
+
+static Coroutine WaitKeyCoroutine()
+{
+    co_await WaitForKeyDown(KeyCode::Space | KeyCode::Return);
+    sKeyResumeCount++;
+}
+
+static void StartKeyWaitInUpdate()
+{
+    StartCoroutine(WaitKeyCoroutine());
+    sUpdate = nullptr;
+}
+
+/// 待ち始めたフレームのキー入力と、指定していないキーの入力では再開せず、指定したキーが押されたフレームで再開する
+static void TestWaitForKeyDown()
+{
+    sKeyResumeCount = 0;
+
+    // スペースキーが押されたフレームのUpdate()で待ち始める
+    Input::__ProcessKeyDown(KeyCode::Space);
+    sUpdate = StartKeyWaitInUpdate;
+    RunFrame();
+    TEST_CHECK(sKeyResumeCount == 0);
+
+    // 押し続けているだけでは再開しない
+    RunFrame();
+    TEST_CHECK(sKeyResumeCount == 0);
+    Input::__ProcessKeyUp(KeyCode::Space);
+    RunFrame();
+
+    // 別のキーでは再開しない
+    Input::__ProcessKeyDown(KeyCode::A);
+    RunFrame();
+    TEST_CHECK(sKeyResumeCount == 0);
+    Input::__ProcessKeyUp(KeyCode::A);
+    RunFrame();
+
+    Input::__ProcessKeyDown(KeyCode::Return);
+    RunFrame();
+    TEST_CHECK(sKeyResumeCount == 1);
+    Input::__ProcessKeyUp(KeyCode::Return);
+    RunFrame();
+    TEST_CHECK(GetRunningCoroutineCount() == 0);
+}
+
+
+#pragma mark - 条件の関数
+
+static bool sIsReady = false;
+static int  sPredicateCallCount = 0;
+
+static Coroutine WaitUntilCoroutine()
+{
+    sStep = 1;
+    co_await WaitUntil([]() {
+        sPredicateCallCount++;
+        return sIsReady;
+    });
+    sStep = 2;
+}
+
+/// 条件が成り立つまで毎フレーム判定され、成り立ったフレームで再開する。最初から成り立っていれば中断しない
+static void TestWaitUntil()
+{
+    sIsReady = false;
+    sPredicateCallCount = 0;
+    StartCoroutine(WaitUntilCoroutine());
+    TEST_CHECK(sPredicateCallCount == 1);
+    for (int i = 0; i < 5; i++) {
+        RunFrame();
+    }
+    TEST_CHECK(sStep == 1);
+    TEST_CHECK(sPredicateCallCount == 6);
+
+    sIsReady = true;
+    RunFrame();
+    TEST_CHECK(sStep == 2);
+    TEST_CHECK(sPredicateCallCount == 7);
+    RunFrame();
+    TEST_CHECK(sPredicateCallCount == 7);
+
+    StartCoroutine(WaitUntilCoroutine());
+    TEST_CHECK(sStep == 2);
+    TEST_CHECK(GetRunningCoroutineCount() == 0);
+}
+
+
+#pragma mark - 入れ子と停止
+
+static int  sChildStep = 0;
+static int  sParentStep = 0;
+
+static Coroutine ChildCoroutine()
+{
+    sChildStep = 1;
+    co_await WaitForFrames(2);
+    sChildStep = 2;
+}
+
+static Coroutine ParentCoroutine()
+{
+    sParentStep = 1;
+    co_await ChildCoroutine();
+    sParentStep = 2;
+    co_await WaitForFrames(1);
+    sParentStep = 3;
+}
+
+/// 子のコルーチンが終わると親が続きから再開し、待機中に停止したコルーチンは再開しない
+static void TestNestingAndStop()
+{
+    sChildStep = 0;
+    sParentStep = 0;
+    CoroutineHandle handle = StartCoroutine(ParentCoroutine());
+    TEST_CHECK(sParentStep == 1 && sChildStep == 1);
+    RunFrame();
+    RunFrame();
+    TEST_CHECK(sChildStep == 1);
+    RunFrame();
+    TEST_CHECK(sChildStep == 2 && sParentStep == 2);
+    TEST_CHECK(IsCoroutineRunning(handle));
+    RunFrame();
+    TEST_CHECK(sParentStep == 3);
+    TEST_CHECK(!IsCoroutineRunning(handle));
+
+    // 子のコルーチンを待っている間に停止する
+    sChildStep = 0;
+    sParentStep = 0;
+    handle = StartCoroutine(ParentCoroutine());
+    StopCoroutine(handle);
+    TEST_CHECK(!IsCoroutineRunning(handle));
+    for (int i = 0; i < 5; i++) {
+        RunFrame();
+    }
+    TEST_CHECK(sChildStep == 1 && sParentStep == 1);
+
+    // 停止したスロットを再利用しても、古いハンドルは無効のまま
+    CoroutineHandle reused = StartCoroutine(WaitFramesCoroutine(1));
+    TEST_CHECK(reused.index == handle.index);
+    TEST_CHECK(IsCoroutineRunning(reused));
+    TEST_CHECK(!IsCoroutineRunning(handle));
+    StopAllCoroutines();
+    TEST_CHECK(GetRunningCoroutineCount() == 0);
+}
+
+
+#pragma mark - フレームのプール
+
+static const void   *sFrameAddress = nullptr;
+
+static Coroutine PooledCoroutine(int frameCount)
+{
+    // 中断をまたいで使う変数はコルーチンのフレームに置かれるので、そのアドレスでフレームを識別できる
+    int waited = frameCount;
+    sFrameAddress = &waited;
+    co_await WaitForFrames(waited);
+}
+
+/// 終了したコルーチンのフレームは次のコルーチンで再利用され、開始と終了を繰り返してもヒープを確保しない
+static void TestFramePool(int iterations)
+{
+    StartCoroutine(PooledCoroutine(1));
+    const void *firstAddress = sFrameAddress;
+    RunFrame();
+    RunFrame();
+    TEST_CHECK(GetRunningCoroutineCount() == 0);
+    StartCoroutine(PooledCoroutine(1));
+    TEST_CHECK(sFrameAddress == firstAddress);
+    RunFrame();
+    RunFrame();
+
+    // 同時に動かす数だけ一度動かしておけば、スロット・待機のリスト・フレームのプールはそれ以上伸びない
+    const int kConcurrentCount = 200;
+    for (int i = 0; i < kConcurrentCount; i++) {
+        StartCoroutine(PooledCoroutine(1 + i % 3));
+    }
+    for (int i = 0; i < 4; i++) {
+        RunFrame();
+    }
+    TEST_CHECK(GetRunningCoroutineCount() == 0);
+
+    long long allocationCount = sHeapAllocationCount;
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        for (int i = 0; i < kConcurrentCount; i++) {
+            StartCoroutine(PooledCoroutine(1 + i % 3));
+        }
+        for (int i = 0; i < 4; i++) {
+            RunFrame();
+        }
+    }
+    TEST_CHECK(GetRunningCoroutineCount() == 0);
+    TEST_CHECK(sHeapAllocationCount == allocationCount);
+}
+
+int main(int argc, const char *argv[])
+{
+    int iterations = 100;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--iterations") == 0) {
+            iterations = atoi(argv[i + 1]);
+        }
+    }
+
+    TestWaitForSeconds();
+    TestWaitForFrames();
+    TestWaitForKeyDown();
+    TestWaitUntil();
+    TestNestingAndStop();
+    TestFramePool(iterations);
+    return TestResult("CoroutineTest");
+}
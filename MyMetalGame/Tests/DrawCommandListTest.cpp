@@ -0,0 +1,186 @@
+//
+//  DrawCommandListTest.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+// 遅延描画のコマンドリスト（DrawCommandList）の並べ替えのテストです。
+//
+//     DrawCommandListTest [--count N] [--seed N]
+//
+// ソートキーの各フィールド、レイヤと深度による順序、順序に依存するブレンドモードで呼び出し順序が維持されること、
+// 順序に依存しないブレンドモードで同じ状態がまとめられること、基数ソートが安定ソートであることを確かめます。
+
+#include "TestSupport.hpp"
+#include "DrawCommandList.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+
+/// 並べ替え後のコマンドの開始位置を、記録したときの順番の列として取得する（各コマンドは3頂点で、開始位置は記録順×3）
+static std::vector<uint32_t> SortedOrder(DrawCommandList& list)
+{
+    list.Sort();
+    std::vector<uint32_t> ret;
+    for (const DrawCommand& command : list.Commands()) {
+        ret.push_back(command.firstVertex / 3);
+    }
+    return ret;
+}
+
+/// ソートキーから各フィールドを取り出せる
+static void TestSortKey()
+{
+    uint64_t key = DrawCommandList::MakeSortKey(3, 0.5f, 7, BlendModeScreen, VertexFormatCompact, 42);
+    TEST_CHECK(DrawCommandList::BlendModeOfKey(key) == BlendModeScreen);
+    TEST_CHECK(DrawCommandList::VertexFormatOfKey(key) == VertexFormatCompact);
+    TEST_CHECK(DrawCommandList::TextureIDOfKey(key) == 42);
+
+    // テクスチャIDは上限に丸められる
+    key = DrawCommandList::MakeSortKey(0, 0.0f, 0, BlendModeAlpha, VertexFormatStandard, 100000);
+    TEST_CHECK(DrawCommandList::TextureIDOfKey(key) == DrawCommandList::kMaxTextureID);
+
+    // レイヤは深度より優先され、深度の大きいものが先になる
+    TEST_CHECK(DrawCommandList::MakeSortKey(-1, 0.0f, 0, BlendModeAlpha, VertexFormatStandard, 0) <
+               DrawCommandList::MakeSortKey(0, 1.0f, 0, BlendModeAlpha, VertexFormatStandard, 0));
+    TEST_CHECK(DrawCommandList::MakeSortKey(0, 0.9f, 0, BlendModeAlpha, VertexFormatStandard, 0) <
+               DrawCommandList::MakeSortKey(0, 0.1f, 0, BlendModeAlpha, VertexFormatStandard, 0));
+}
+
+/// 順序に依存するブレンドモードでは、頂点フォーマットやテクスチャを切り替えても呼び出し順序が維持される
+static void TestOrderDependentBlend()
+{
+    DrawCommandList list;
+    list.Record(0, 0.0f, BlendModeAlpha, VertexFormatStandard, 0, 0, 3);
+    list.Record(0, 0.0f, BlendModeAlpha, VertexFormatCompact, 0, 3, 3);
+    list.Record(0, 0.0f, BlendModeAlpha, VertexFormatStandard, 0, 6, 3);
+    list.Record(0, 0.0f, BlendModeAlpha, VertexFormatStandard, 2, 9, 3);
+    list.Record(0, 0.0f, BlendModeAlpha, VertexFormatStandard, 1, 12, 3);
+    list.Record(0, 0.0f, BlendModeAlpha, VertexFormatStandard, 2, 15, 3);
+    TEST_CHECK(SortedOrder(list) == std::vector<uint32_t>({ 0, 1, 2, 3, 4, 5 }));
+    TEST_CHECK(list.BuildRuns().size() == 6);
+}
+
+/// 順序に依存しないブレンドモードでは、同じ頂点フォーマットとテクスチャの描画がまとめられる
+static void TestOrderIndependentBlend()
+{
+    DrawCommandList list;
+    const VertexFormat formats[] = { VertexFormatStandard, VertexFormatCompact };
+    for (uint32_t i = 0; i < 12; i++) {
+        list.Record(0, 0.0f, BlendModeAdd, formats[i % 2], 1 + (i / 2) % 3, i * 3, 3);
+    }
+    list.Sort();
+    const std::vector<DrawRun>& runs = list.BuildRuns();
+    TEST_CHECK(runs.size() == 6);
+    uint32_t vertexCount = 0;
+    for (const DrawRun& run : runs) {
+        TEST_CHECK(run.blendMode == BlendModeAdd);
+        TEST_CHECK(run.commandCount == 2);
+        vertexCount += run.vertexCount;
+    }
+    TEST_CHECK(vertexCount == 36);
+
+    // ブレンドモードを切り替えた後の描画は、前のブレンドモードの描画と混ざらない
+    list.Reset();
+    list.Record(0, 0.0f, BlendModeAdd, VertexFormatStandard, 1, 0, 3);
+    list.Record(0, 0.0f, BlendModeAlpha, VertexFormatStandard, 1, 3, 3);
+    list.Record(0, 0.0f, BlendModeAdd, VertexFormatStandard, 1, 6, 3);
+    TEST_CHECK(SortedOrder(list) == std::vector<uint32_t>({ 0, 1, 2 }));
+}
+
+/// レイヤの順、同じレイヤでは深度の大きい順に描画され、レイヤを行き来してもほかのレイヤの順序は分断されない
+static void TestLayerAndDepth()
+{
+    DrawCommandList list;
+    list.Record(2, 0.0f, BlendModeAlpha, VertexFormatStandard, 0, 0, 3);
+    list.Record(0, 0.2f, BlendModeAlpha, VertexFormatStandard, 0, 3, 3);
+    list.Record(1, 0.0f, BlendModeAdd, VertexFormatStandard, 0, 6, 3);
+    list.Record(0, 0.8f, BlendModeAlpha, VertexFormatStandard, 0, 9, 3);
+    list.Record(-1, 0.0f, BlendModeAlpha, VertexFormatStandard, 0, 12, 3);
+    TEST_CHECK(SortedOrder(list) == std::vector<uint32_t>({ 4, 3, 1, 2, 0 }));
+    TEST_CHECK(list.LayerCount() == 4);
+
+    list.Sort();
+    const std::vector<DrawRun>& runs = list.BuildRuns();
+    TEST_CHECK(runs.size() == 3);
+    TEST_CHECK(runs[0].commandCount == 3);
+    TEST_CHECK(runs[1].blendMode == BlendModeAdd);
+}
+
+/// 同じキーで頂点が連続するコマンドは1つに延長され、連続しなければ別のコマンドになる
+static void TestMerge()
+{
+    DrawCommandList list;
+    list.Record(0, 0.0f, BlendModeAlpha, VertexFormatStandard, 0, 0, 3);
+    list.Record(0, 0.0f, BlendModeAlpha, VertexFormatStandard, 0, 3, 6);
+    TEST_CHECK(list.Count() == 1);
+    TEST_CHECK(list.Commands()[0].vertexCount == 9);
+    list.Record(0, 0.0f, BlendModeAlpha, VertexFormatStandard, 0, 12, 3);
+    TEST_CHECK(list.Count() == 2);
+}
+
+/// 順序に依存するブレンドモードで状態を切り替え続けると、セグメントの上限に達して吐き出しが必要になる
+static void TestSegmentLimit()
+{
+    DrawCommandList list;
+    for (uint32_t i = 0; !list.NeedsFlush() && i <= DrawCommandList::kMaxSegment + 1; i++) {
+        list.Record(0, 0.0f, BlendModeAlpha, (VertexFormat)(i % 2), 0, i * 3, 3);
+    }
+    TEST_CHECK(list.NeedsFlush());
+    TEST_CHECK(list.Count() == DrawCommandList::kMaxSegment + 1);
+}
+
+/// ランダムなキーを、std::stable_sort()と同じ順に並べ替える
+static void TestRadixSort(int count, unsigned seed)
+{
+    std::mt19937 random(seed);
+    DrawCommandList list;
+    for (uint32_t i = 0; i < (uint32_t)count; i++) {
+        int layer = (int)(random() % 5) - 2;
+        float depth = (float)(random() % 4) / 3;
+        BlendMode blendMode = (random() % 2 == 0)? BlendModeAlpha: BlendModeAdd;
+        VertexFormat vertexFormat = (VertexFormat)(random() % 2);
+        unsigned textureID = random() % 4;
+        list.Record(layer, depth, blendMode, vertexFormat, textureID, i * 3, 3);
+    }
+    std::vector<DrawCommand> expected = list.Commands();
+    std::stable_sort(expected.begin(), expected.end(), [](const DrawCommand& a, const DrawCommand& b) {
+        return a.key < b.key;
+    });
+
+    list.Sort();
+    const std::vector<DrawCommand>& commands = list.Commands();
+    TEST_CHECK(commands.size() == expected.size());
+    bool isSame = (commands.size() == expected.size());
+    for (size_t i = 0; isSame && i < commands.size(); i++) {
+        isSame = (commands[i].key == expected[i].key && commands[i].firstVertex == expected[i].firstVertex);
+    }
+    TEST_CHECK(isSame);
+}
+
+int main(int argc, const char *argv[])
+{
+    int count = 100000;
+    unsigned seed = 1;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--count") == 0) {
+            count = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            seed = (unsigned)atoi(argv[i + 1]);
+        }
+    }
+
+    TestSortKey();
+    TestOrderDependentBlend();
+    TestOrderIndependentBlend();
+    TestLayerAndDepth();
+    TestMerge();
+    TestSegmentLimit();
+    TestRadixSort(count, seed);
+    return TestResult("DrawCommandListTest");
+}
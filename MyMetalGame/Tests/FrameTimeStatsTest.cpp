@@ -0,0 +1,88 @@
+//
+//  FrameTimeStatsTest.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+// フレーム時間のヒストグラム（FrameTimeHistogram）のテストです。
+//
+//     FrameTimeStatsTest
+//
+// バケットの境界にある値（エンコードやコミットによく現れる1, 2, 4, 5, 8マイクロ秒など）をウィンドウが何周もするまで記録し、
+// 古い値が正しいバケットから取り除かれて、パーセンタイルが新しい値に追従することを確かめます。
+
+#include "TestSupport.hpp"
+#include "FrameTimeStats.hpp"
+
+
+/// バケットの境界にある値
+static const double kBoundaryValues[] = {
+    1.0e-6, 2.0e-6, 3.0e-6, 4.0e-6, 5.0e-6, 8.0e-6, 31.0e-6, 32.0e-6, 33.0e-6, 64.0e-6, 100.0e-6, 1.0e-3, 16.0e-3,
+};
+
+/// 同じ値だけでウィンドウを埋めると、すべてのパーセンタイルがその値のバケットになる
+static void TestUniformWindow()
+{
+    FrameTimeHistogram histogram;
+    for (double value : kBoundaryValues) {
+        for (int i = 0; i < FrameTimeHistogram::kWindowSize; i++) {
+            histogram.Record(value);
+        }
+        double expected = FrameTimeHistogram::BucketValue(FrameTimeHistogram::BucketOf((float)value));
+        TEST_CHECK(histogram.Count() == FrameTimeHistogram::kWindowSize);
+        TEST_CHECK(histogram.Percentile(0.0) == expected);
+        TEST_CHECK(histogram.Percentile(50.0) == expected);
+        TEST_CHECK(histogram.Percentile(99.0) == expected);
+        TEST_CHECK(histogram.Percentile(100.0) == expected);
+    }
+}
+
+/// 境界の値を混ぜて何周も記録した後に大きな値でウィンドウを埋め直すと、古い値はすべて集計から外れている
+static void TestWraparound()
+{
+    FrameTimeHistogram histogram;
+    const int kValueCount = (int)(sizeof(kBoundaryValues) / sizeof(kBoundaryValues[0]));
+    for (int i = 0; i < FrameTimeHistogram::kWindowSize * 5 + 7; i++) {
+        histogram.Record(kBoundaryValues[i % kValueCount]);
+    }
+    TEST_CHECK(histogram.Count() == FrameTimeHistogram::kWindowSize);
+
+    // 半分を10ミリ秒、残りを20ミリ秒で上書きする
+    for (int i = 0; i < FrameTimeHistogram::kWindowSize; i++) {
+        histogram.Record((i < FrameTimeHistogram::kWindowSize / 2)? 10.0e-3: 20.0e-3);
+    }
+    const double kRelativeError = 1.0 / 32;
+    TEST_CHECK_NEAR(histogram.Percentile(0.0), 10.0e-3, 10.0e-3 * kRelativeError);
+    TEST_CHECK_NEAR(histogram.Percentile(50.0), 10.0e-3, 10.0e-3 * kRelativeError);
+    TEST_CHECK_NEAR(histogram.Percentile(51.0), 20.0e-3, 20.0e-3 * kRelativeError);
+    TEST_CHECK_NEAR(histogram.Percentile(99.0), 20.0e-3, 20.0e-3 * kRelativeError);
+
+    FrameTimeSummary summary = histogram.Summarize(15.0e-3);
+    TEST_CHECK(summary.sampleCount == FrameTimeHistogram::kWindowSize);
+    TEST_CHECK(summary.hitchCount == FrameTimeHistogram::kWindowSize / 2);
+    TEST_CHECK_NEAR(summary.min, 10.0e-3, 1.0e-9);
+    TEST_CHECK_NEAR(summary.max, 20.0e-3, 1.0e-9);
+}
+
+/// 空のヒストグラムとClear()
+static void TestClear()
+{
+    FrameTimeHistogram histogram;
+    TEST_CHECK(histogram.Count() == 0);
+    TEST_CHECK(histogram.Percentile(50.0) == 0.0);
+    histogram.Record(5.0e-6);
+    histogram.Clear();
+    TEST_CHECK(histogram.Count() == 0);
+    histogram.Record(1.0e-3);
+    TEST_CHECK_NEAR(histogram.Percentile(50.0), 1.0e-3, 1.0e-3 / 32);
+}
+
+int main()
+{
+    TestUniformWindow();
+    TestWraparound();
+    TestClear();
+    return TestResult("FrameTimeStatsTest");
+}
@@ -0,0 +1,216 @@
+//
+//  InputRecordingTest.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+// 入力の記録と再生の往復のテストです。
+//
+//     InputRecordingTest [--frames N] [--seed N] [--path FILE]
+//
+// ゲームのループと同じ順番（__PublishInput()、__ApplyInputReplay()、__UpdateTriggers()、Time::__Update()、__RecordInputFrame()）でフレームを進めながら、
+// キー・マウスのボタン・マウスの位置・経過時間を疑似乱数で変化させたNフレームを記録し、それを再生して、次のことを確かめます。
+//
+// - 記録したフレーム数がそのまま再生され、再生し終えるとIsReplayingInput()がfalseになる。
+// - 各フレームの入力状態（押されている・押された・離されたキーとボタン、マウスの位置）と経過時間が、記録したときとビット単位で一致する。
+// - 再生の前に乱数シードと固定の経過時間を変えておいても、記録したときの乱数シードに戻り、同じ乱数の列が得られる。
+//
+// 何も変化しないフレームの連続と、書き出しのスレッドに渡すまとまりの境界を必ず含むように、入力を変化させる区間と止める区間を交互に入れます。
+
+#include "TestSupport.hpp"
+#include "Input.hpp"
+#include "InputRecording.hpp"
+#include "Random.hpp"
+#include "Time.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+
+/// 1フレームの終わりに取得した、ゲームから見える入力と経過時間
+struct FrameSnapshot
+{
+    KeyCodeType keyState;
+    KeyCodeType keyDown;
+    KeyCodeType keyUp;
+    bool        mouseButtons[2];
+    bool        mouseButtonsDown[2];
+    bool        mouseButtonsUp[2];
+    uint32_t    mouseXBits;
+    uint32_t    mouseYBits;
+    long long   deltaNanoseconds;
+    uint32_t    deltaTimeBits;
+    int         randomValue;
+};
+
+static uint32_t FloatToBits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+/// ゲームのループと同じ順番で1フレーム進め、Update()から見える値を取得する
+static FrameSnapshot RunFrame()
+{
+    Input::__PublishInput();
+    __ApplyInputReplay();
+    Input::__UpdateTriggers();
+    Time::__Update();
+    __RecordInputFrame();
+
+    FrameSnapshot snapshot;
+    snapshot.keyState = Input::__GetKeyState();
+    snapshot.keyDown = 0;
+    snapshot.keyUp = 0;
+    for (int bit = 0; bit < 64; bit++) {
+        KeyCodeType mask = (KeyCodeType)1 << bit;
+        snapshot.keyDown |= Input::GetKeyDown(mask)? mask: 0;
+        snapshot.keyUp |= Input::GetKeyUp(mask)? mask: 0;
+    }
+    for (int button = 0; button < 2; button++) {
+        snapshot.mouseButtons[button] = Input::GetMouseButton(button);
+        snapshot.mouseButtonsDown[button] = Input::GetMouseButtonDown(button);
+        snapshot.mouseButtonsUp[button] = Input::GetMouseButtonUp(button);
+    }
+    Vector2 mousePosition = Input::MousePosition();
+    snapshot.mouseXBits = FloatToBits(mousePosition.x);
+    snapshot.mouseYBits = FloatToBits(mousePosition.y);
+    snapshot.deltaNanoseconds = Time::__GetDeltaNanoseconds();
+    snapshot.deltaTimeBits = FloatToBits(Time::deltaTime);
+
+    // ゲームのUpdate()と同じように、毎フレーム乱数を使う
+    snapshot.randomValue = Random::IntValue();
+
+    Time::frameCount++;
+    return snapshot;
+}
+
+static bool IsSameSnapshot(const FrameSnapshot& a, const FrameSnapshot& b)
+{
+    for (int button = 0; button < 2; button++) {
+        if (a.mouseButtons[button] != b.mouseButtons[button] ||
+            a.mouseButtonsDown[button] != b.mouseButtonsDown[button] ||
+            a.mouseButtonsUp[button] != b.mouseButtonsUp[button]) {
+            return false;
+        }
+    }
+    return (a.keyState == b.keyState && a.keyDown == b.keyDown && a.keyUp == b.keyUp &&
+            a.mouseXBits == b.mouseXBits && a.mouseYBits == b.mouseYBits &&
+            a.deltaNanoseconds == b.deltaNanoseconds && a.deltaTimeBits == b.deltaTimeBits &&
+            a.randomValue == b.randomValue);
+}
+
+/// イベントの代わりに、疑似乱数で入力と経過時間を変化させる
+static void ChangeInput(std::mt19937& engine, KeyCodeType& keyState, bool *mouseButtons)
+{
+    KeyCodeType mask = (KeyCodeType)1 << (engine() % 64);
+    if (keyState & mask) {
+        Input::__ProcessKeyUp(mask);
+        keyState &= ~mask;
+    } else {
+        Input::__ProcessKeyDown(mask);
+        keyState |= mask;
+    }
+    if (engine() % 8 == 0) {
+        int button = (int)(engine() % 2);
+        mouseButtons[button] = !mouseButtons[button];
+        if (button == 0) {
+            mouseButtons[0]? Input::__ProcessMouseDown(): Input::__ProcessMouseUp();
+        } else {
+            mouseButtons[1]? Input::__ProcessMouseDownRight(): Input::__ProcessMouseUpRight();
+        }
+    }
+    std::uniform_real_distribution<float> position(-100.0f, 1100.0f);
+    Input::__ProcessMouseMove(Vector2(position(engine), position(engine)));
+    if (engine() % 4 == 0) {
+        std::uniform_real_distribution<float> jitter(0.5f, 2.0f);
+        Time::captureDeltaTime = jitter(engine) / 60;
+    }
+}
+
+/// キーとボタンをすべて離して、取り込んだ状態を空にする
+static void ReleaseAllInput()
+{
+    Input::__ProcessKeyUp(KeyCode::Any);
+    Input::__ProcessMouseUp();
+    Input::__ProcessMouseUpRight();
+    Input::__ProcessMouseMove(Vector2(0.0f, 0.0f));
+    Input::__PublishInput();
+    Input::__UpdateTriggers();
+    Input::__UpdateTriggers();
+}
+
+static void TestRoundTrip(int frameCount, unsigned seed, const std::string& path)
+{
+    const unsigned kRecordSeed = 12345;
+    Random::SetSeed(kRecordSeed);
+    Time::captureDeltaTime = 1.0f / 60;
+    StartInputRecording(path);
+
+    std::mt19937 engine(seed);
+    KeyCodeType keyState = 0;
+    bool mouseButtons[2] = { false, false };
+    std::vector<FrameSnapshot> recorded;
+    recorded.reserve(frameCount);
+    for (int frame = 0; frame < frameCount; frame++) {
+        // 64フレームごとに、入力を変化させる区間と、何も変化させない区間を交互に入れる
+        if ((frame / 64) % 2 == 0) {
+            ChangeInput(engine, keyState, mouseButtons);
+        }
+        recorded.push_back(RunFrame());
+    }
+    StopInputRecording();
+
+    // 記録したときとは違う乱数シードと経過時間にしておき、再生で記録したときの値に戻ることを確かめる
+    ReleaseAllInput();
+    Random::SetSeed(kRecordSeed + 1);
+    Time::captureDeltaTime = 1.0f / 30;
+
+    int replayFrameCount = StartInputReplay(path);
+    TEST_CHECK(replayFrameCount == frameCount);
+    TEST_CHECK(Random::GetSeed() == kRecordSeed);
+    TEST_CHECK(IsReplayingInput());
+
+    int mismatchCount = 0;
+    for (int frame = 0; frame < replayFrameCount; frame++) {
+        FrameSnapshot replayed = RunFrame();
+        if (frame < (int)recorded.size() && !IsSameSnapshot(recorded[frame], replayed)) {
+            if (mismatchCount == 0) {
+                fprintf(stderr, "frame %d: the replayed input differs from the recorded one\n", frame);
+            }
+            mismatchCount++;
+        }
+    }
+    TEST_CHECK(mismatchCount == 0);
+    TEST_CHECK(!IsReplayingInput());
+
+    // 再生し終えた後は、固定した経過時間に戻る
+    FrameSnapshot after = RunFrame();
+    TEST_CHECK(after.deltaNanoseconds == llround((1.0f / 30) * 1.0e9));
+}
+
+int main(int argc, const char *argv[])
+{
+    int frameCount = 3000;
+    unsigned seed = 1;
+    std::string path = "input_recording_test.gmir";
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--frames") == 0) {
+            frameCount = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            seed = (unsigned)strtoul(argv[i + 1], nullptr, 10);
+        } else if (strcmp(argv[i], "--path") == 0) {
+            path = argv[i + 1];
+        }
+    }
+
+    TestRoundTrip(frameCount, seed, path);
+    remove(path.c_str());
+    return TestResult("InputRecordingTest");
+}
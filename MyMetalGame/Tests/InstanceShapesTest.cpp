@@ -0,0 +1,189 @@
+//
+//  InstanceShapesTest.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+// インスタンス描画のCPU上の展開（ExpandInstances()とExpandInstanceVertex()）のテストです。
+//
+//     InstanceShapesTest
+//
+// 図形の頂点の変換、RGBA8にパックされた色の展開、図形の種類が混在する場合の面積ゼロの頂点による埋め合わせを確かめます。
+
+#include "TestSupport.hpp"
+#include "InstanceShapes.hpp"
+#include "Color.hpp"
+#include "Matrix4x4.hpp"
+#include "Vector2.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+/// Shaders.metal の unpack_unorm4x8_to_float() と同じ規則で、パックされた色を展開する
+static Color UnpackColor(uint32_t color)
+{
+    return Color((color & 0xff) / 255.0f, ((color >> 8) & 0xff) / 255.0f, ((color >> 16) & 0xff) / 255.0f, (color >> 24) / 255.0f);
+}
+
+/// 図形のテーブルは、三角形の頂点列として正しい範囲を持つ
+static void TestShapeTable()
+{
+    const InstanceShapeInfo *infos = GetInstanceShapeInfos();
+    uint32_t maxVertexCount = 0;
+    for (int shape = 0; shape < InstanceShapeCount; shape++) {
+        TEST_CHECK(infos[shape].vertexCount > 0);
+        TEST_CHECK(infos[shape].vertexCount % 3 == 0);
+        TEST_CHECK(infos[shape].firstVertex + infos[shape].vertexCount <= GetInstanceShapeVertexCount());
+        maxVertexCount = std::max(maxVertexCount, infos[shape].vertexCount);
+    }
+    TEST_CHECK(infos[InstanceShapeTriangle].vertexCount == 3);
+    TEST_CHECK(infos[InstanceShapeQuad].vertexCount == 6);
+    TEST_CHECK(GetInstanceShapeMaxVertexCount() == maxVertexCount);
+    TEST_CHECK(GetInstanceShapeMaxVertexCount() == infos[InstanceShapeCircle].vertexCount);
+}
+
+/// 位置・回転・拡大率と、変換行列のどちらで作ったインスタンスも、図形の頂点を同じように変換する
+static void TestTransform()
+{
+    const float kTolerance = 1e-4f;
+    const InstanceShapeInfo& quad = GetInstanceShapeInfos()[InstanceShapeQuad];
+    const float *shapeVertices = GetInstanceShapeVertices();
+
+    // 回転なし：正方形の頂点(±1, ±1)が、拡大されて平行移動する
+    InstanceData instance = InstanceData::Make(Vector2(10, 20), 0.0f, Vector2(3, 2), Color::white, InstanceShapeQuad);
+    std::vector<InstanceVertex> vertices;
+    ExpandInstances(&instance, 1, -1, vertices);
+    TEST_CHECK(vertices.size() == quad.vertexCount);
+    for (size_t i = 0; i < vertices.size(); i++) {
+        float vx = shapeVertices[(quad.firstVertex + i) * 2];
+        float vy = shapeVertices[(quad.firstVertex + i) * 2 + 1];
+        TEST_CHECK_NEAR(vertices[i].x, 10 + vx * 3, kTolerance);
+        TEST_CHECK_NEAR(vertices[i].y, 20 + vy * 2, kTolerance);
+    }
+
+    // 90度の回転：X軸が(0, 1)に、Y軸が(-1, 0)に移る
+    instance = InstanceData::Make(Vector2(-5, 5), (float)M_PI / 2, Vector2(2, 4), Color::white, InstanceShapeTriangle);
+    vertices.clear();
+    ExpandInstances(&instance, 1, -1, vertices);
+    TEST_CHECK(vertices.size() == 3);
+    const InstanceShapeInfo& triangle = GetInstanceShapeInfos()[InstanceShapeTriangle];
+    for (size_t i = 0; i < vertices.size(); i++) {
+        float vx = shapeVertices[(triangle.firstVertex + i) * 2];
+        float vy = shapeVertices[(triangle.firstVertex + i) * 2 + 1];
+        TEST_CHECK_NEAR(vertices[i].x, -5 - vy * 4, kTolerance);
+        TEST_CHECK_NEAR(vertices[i].y, 5 + vx * 2, kTolerance);
+    }
+
+    // 変換行列から作った場合は、行列で頂点を変換したものと一致する
+    Matrix4x4 matrix = Matrix4x4::Translation(7, -3) * Matrix4x4::RotationZ(0.5f) * Matrix4x4::Scale(1.5f, 0.5f);
+    instance = InstanceData::Make(matrix, Color::white, InstanceShapeQuad);
+    vertices.clear();
+    ExpandInstances(&instance, 1, -1, vertices);
+    TEST_CHECK(vertices.size() == quad.vertexCount);
+    for (size_t i = 0; i < vertices.size(); i++) {
+        Vector2 expected = matrix * Vector2(shapeVertices[(quad.firstVertex + i) * 2], shapeVertices[(quad.firstVertex + i) * 2 + 1]);
+        TEST_CHECK_NEAR(vertices[i].x, expected.x, kTolerance);
+        TEST_CHECK_NEAR(vertices[i].y, expected.y, kTolerance);
+    }
+}
+
+/// 色はRGBA8にパックされて、すべての頂点にそのまま渡り、シェーダと同じ規則で元の色に戻る
+static void TestColorUnpacking()
+{
+    Color color(0.25f, 0.5f, 0.75f, 1.0f);
+    InstanceData instance = InstanceData::Make(Vector2(0, 0), 0.0f, Vector2(1, 1), color, InstanceShapeCircle);
+    TEST_CHECK(instance.color == color.ToRGBA8());
+    TEST_CHECK((instance.color & 0xff) == 64);
+    TEST_CHECK((instance.color >> 24) == 255);
+
+    std::vector<InstanceVertex> vertices;
+    ExpandInstances(&instance, 1, -1, vertices);
+    bool isColorKept = true;
+    for (const InstanceVertex& vertex : vertices) {
+        isColorKept = isColorKept && (vertex.color == instance.color);
+    }
+    TEST_CHECK(isColorKept);
+
+    Color unpacked = UnpackColor(vertices[0].color);
+    TEST_CHECK_NEAR(unpacked.r, color.r, 0.5 / 255 + 1e-6);
+    TEST_CHECK_NEAR(unpacked.g, color.g, 0.5 / 255 + 1e-6);
+    TEST_CHECK_NEAR(unpacked.b, color.b, 0.5 / 255 + 1e-6);
+    TEST_CHECK_NEAR(unpacked.a, color.a, 0.5 / 255 + 1e-6);
+
+    // 範囲外の成分は0〜1に丸められる
+    Color clamped = UnpackColor(Color(-1.0f, 2.0f, 0.0f, 0.5f).ToRGBA8());
+    TEST_CHECK_NEAR(clamped.r, 0.0, 1e-6);
+    TEST_CHECK_NEAR(clamped.g, 1.0, 1e-6);
+    TEST_CHECK_NEAR(clamped.a, 128 / 255.0, 1e-6);
+}
+
+/// 図形の種類が混在する場合、各インスタンスは最大の頂点数で描画され、余りの頂点は面積ゼロの三角形になる
+static void TestDegeneratePadding()
+{
+    const InstanceShapeInfo *infos = GetInstanceShapeInfos();
+    uint32_t maxVertexCount = GetInstanceShapeMaxVertexCount();
+    std::vector<InstanceData> instances = {
+        InstanceData::Make(Vector2(1, 1), 0.0f, Vector2(1, 1), Color::red, InstanceShapeTriangle),
+        InstanceData::Make(Vector2(2, 2), 0.0f, Vector2(1, 1), Color::green, InstanceShapeCircle),
+        InstanceData::Make(Vector2(3, 3), 0.0f, Vector2(1, 1), Color::blue, InstanceShapeQuad),
+    };
+    // 範囲外の図形の種類は、シェーダと同じように最後の図形として扱われる
+    InstanceData outOfRange = instances[0];
+    outOfRange.shape = 100;
+    instances.push_back(outOfRange);
+
+    // GPUと同じようにインスタンスごとに最大の頂点数だけ展開すると、図形の頂点の後ろは原点に置いた透明の頂点で埋まる
+    std::vector<InstanceVertex> padded;
+    for (const InstanceData& instance : instances) {
+        uint32_t shape = std::min(instance.shape, (uint32_t)InstanceShapeCount - 1);
+        int degenerateCount = 0;
+        bool isPaddingAtEnd = true;
+        for (uint32_t vertexID = 0; vertexID < maxVertexCount; vertexID++) {
+            InstanceVertex vertex;
+            bool isReal = ExpandInstanceVertex(instance, vertexID, -1, vertex);
+            isPaddingAtEnd = isPaddingAtEnd && (isReal == (vertexID < infos[shape].vertexCount));
+            if (isReal) {
+                padded.push_back(vertex);
+            } else {
+                degenerateCount++;
+                TEST_CHECK(vertex.x == 0.0f && vertex.y == 0.0f && vertex.color == 0);
+            }
+        }
+        TEST_CHECK(isPaddingAtEnd);
+        TEST_CHECK(degenerateCount == (int)(maxVertexCount - infos[shape].vertexCount));
+        // 余りの頂点は3の倍数なので、実際の三角形と同じ三角形に混ざることはない
+        TEST_CHECK(degenerateCount % 3 == 0);
+    }
+
+    // ExpandInstances()は、余りの頂点を除いた同じ頂点列を返す
+    std::vector<InstanceVertex> vertices;
+    ExpandInstances(instances.data(), instances.size(), -1, vertices);
+    size_t expectedCount = infos[InstanceShapeTriangle].vertexCount + infos[InstanceShapeCircle].vertexCount +
+                           infos[InstanceShapeQuad].vertexCount + infos[InstanceShapeCircle].vertexCount;
+    TEST_CHECK(vertices.size() == expectedCount);
+    TEST_CHECK(vertices.size() == padded.size());
+    bool isSame = (vertices.size() == padded.size());
+    for (size_t i = 0; isSame && i < vertices.size(); i++) {
+        isSame = (vertices[i].x == padded[i].x && vertices[i].y == padded[i].y && vertices[i].color == padded[i].color);
+    }
+    TEST_CHECK(isSame);
+
+    // 図形を上書きすると、すべてのインスタンスが同じ頂点数になり、余りの頂点はない
+    vertices.clear();
+    ExpandInstances(instances.data(), instances.size(), InstanceShapeQuad, vertices);
+    TEST_CHECK(vertices.size() == instances.size() * infos[InstanceShapeQuad].vertexCount);
+    TEST_CHECK(vertices[0].color == Color::red.ToRGBA8());
+    TEST_CHECK(vertices.back().color == Color::red.ToRGBA8());
+}
+
+int main()
+{
+    TestShapeTable();
+    TestTransform();
+    TestColorUnpacking();
+    TestDegeneratePadding();
+    return TestResult("InstanceShapesTest");
+}
@@ -0,0 +1,147 @@
+//
+//  JobSystemTest.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+// ジョブシステムのテストです。ThreadSanitizerを有効にしてビルドすれば、キューの競合の検査にもなります。
+//
+//     JobSystemTest [--workers N] [--iterations N]
+//
+// ワーカースレッドの数を変えて、キューがあふれる場合、ジョブが盗まれる場合、依存関係がある場合、入れ子のParallelFor()を確かめます。
+
+#include "TestSupport.hpp"
+#include "JobSystem.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+
+/// 1つのスレッドから、キューの容量（4096）を超える数のジョブを投入する。
+/// 各ジョブはbeginで示されたインデックスに1回だけ印を付けるので、ジョブが失われたり、壊れた内容で実行されたりすれば検出できる。
+static void TestOverflowAndSteal(int iterations)
+{
+    const size_t kJobCount = 3 * 4096 + 17;
+    std::vector<std::atomic<int>> hits(kJobCount);
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        for (std::atomic<int>& hit : hits) {
+            hit.store(0, std::memory_order_relaxed);
+        }
+        JobCounter counter;
+        for (size_t i = 0; i < kJobCount; i++) {
+            RunJob([](void *data, size_t begin, size_t end) {
+                std::atomic<int> *hits = (std::atomic<int> *)data;
+                hits[begin].fetch_add((int)(end - begin), std::memory_order_relaxed);
+            }, hits.data(), i, i + 1, &counter);
+        }
+        WaitForCounter(counter);
+        TEST_CHECK(counter.PendingCount() == 0);
+
+        int wrongCount = 0;
+        for (std::atomic<int>& hit : hits) {
+            if (hit.load(std::memory_order_relaxed) != 1) {
+                wrongCount++;
+            }
+        }
+        TEST_CHECK(wrongCount == 0);
+    }
+}
+
+/// ParallelFor()で、すべてのインデックスがちょうど1回ずつ処理されることを確かめる
+static void TestParallelFor(int iterations)
+{
+    const size_t kCount = 1 << 18;
+    std::vector<int> values(kCount);
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        std::fill(values.begin(), values.end(), 0);
+        std::atomic<long long> sum(0);
+        ParallelFor(0, kCount, 64, [&](size_t i) {
+            values[i] += (int)i;
+            sum.fetch_add((long long)i, std::memory_order_relaxed);
+        });
+        TEST_CHECK(sum.load() == (long long)kCount * (kCount - 1) / 2);
+        bool isAllCorrect = true;
+        for (size_t i = 0; i < kCount; i++) {
+            isAllCorrect = isAllCorrect && (values[i] == (int)i);
+        }
+        TEST_CHECK(isAllCorrect);
+    }
+}
+
+/// 依存するカウンタを指定したジョブが、依存先のジョブがすべて終わってから実行されることを確かめる
+static void TestDependency(int iterations)
+{
+    const size_t kCount = 512;
+    std::vector<int> produced(kCount);
+    std::vector<int> consumed(kCount);
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        std::fill(produced.begin(), produced.end(), 0);
+        std::fill(consumed.begin(), consumed.end(), 0);
+        JobCounter producers;
+        JobCounter consumers;
+        for (size_t i = 0; i < kCount; i++) {
+            RunJob([](void *data, size_t begin, size_t) {
+                ((int *)data)[begin] = (int)begin + 1;
+            }, produced.data(), i, i + 1, &producers);
+        }
+        struct Buffers { const int *produced; int *consumed; } buffers = { produced.data(), consumed.data() };
+        for (size_t i = 0; i < kCount; i++) {
+            RunJob([](void *data, size_t begin, size_t) {
+                Buffers *buffers = (Buffers *)data;
+                // 依存先がすべて終わっているので、どの要素を読んでもよい
+                buffers->consumed[begin] = buffers->produced[kCount - 1 - begin];
+            }, &buffers, i, i + 1, &consumers, &producers);
+        }
+        WaitForCounter(consumers);
+        bool isAllCorrect = true;
+        for (size_t i = 0; i < kCount; i++) {
+            isAllCorrect = isAllCorrect && (consumed[i] == (int)(kCount - i));
+        }
+        TEST_CHECK(isAllCorrect);
+    }
+}
+
+/// ワーカースレッドの中からジョブを投入する（各ワーカースレッドのキューから、さらに盗まれる）
+static void TestNestedParallelFor(int iterations)
+{
+    const size_t kOuterCount = 64;
+    const size_t kInnerCount = 2048;
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        std::atomic<long long> total(0);
+        ParallelFor(0, kOuterCount, 1, [&](size_t) {
+            std::atomic<long long> sum(0);
+            ParallelFor(0, kInnerCount, 16, [&](size_t i) {
+                sum.fetch_add((long long)i, std::memory_order_relaxed);
+            });
+            total.fetch_add(sum.load(), std::memory_order_relaxed);
+        });
+        TEST_CHECK(total.load() == (long long)kOuterCount * kInnerCount * (kInnerCount - 1) / 2);
+    }
+}
+
+int main(int argc, const char *argv[])
+{
+    int maxWorkerCount = 4;
+    int iterations = 20;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--workers") == 0) {
+            maxWorkerCount = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--iterations") == 0) {
+            iterations = atoi(argv[i + 1]);
+        }
+    }
+
+    // ワーカースレッドがなく、待っているスレッドだけでジョブを実行する場合から順に試す
+    for (int workerCount = 0; workerCount <= maxWorkerCount; workerCount++) {
+        InitJobSystem(workerCount);
+        TestOverflowAndSteal(iterations);
+        TestParallelFor(iterations);
+        TestDependency(iterations);
+        TestNestedParallelFor(iterations);
+    }
+    ShutdownJobSystem();
+    return TestResult("JobSystemTest");
+}
@@ -0,0 +1,164 @@
+//
+//  RenderTargetPoolTest.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+// レンダーターゲットの管理（RenderTargetPool）のテストです。GPUのリソースは使わないので、CPUだけで確かめられます。
+//
+//     RenderTargetPoolTest
+
+#include "TestSupport.hpp"
+#include "RenderTargetPool.hpp"
+#include "RenderBackend.hpp"
+#include "DrawCommandList.hpp"
+
+
+static const size_t kBytesPerPixel = 4 + 8;
+
+
+/// 確保したターゲットは使用中で、内容はまだ描画されていない
+static void TestCreate()
+{
+    RenderTargetPool pool(kBytesPerPixel);
+    bool needsTexture = false;
+    int target0 = pool.Acquire(256, 128, needsTexture);
+    TEST_CHECK(needsTexture);
+    int target1 = pool.Acquire(64, 64, needsTexture);
+    TEST_CHECK(needsTexture);
+    TEST_CHECK(target0 != target1);
+    TEST_CHECK(pool.SlotCount() == 2);
+
+    TEST_CHECK(pool.IsInUse(target0));
+    TEST_CHECK(!pool.IsContentValid(target0));
+    const RenderTargetSlot& slot = pool.GetSlot(target0);
+    TEST_CHECK(slot.width == 256 && slot.height == 128);
+    TEST_CHECK(slot.byteSize == 256 * 128 * kBytesPerPixel);
+    TEST_CHECK(slot.lastRenderedFrame == -1);
+
+    // 範囲外のIDは使用中ではない
+    TEST_CHECK(!pool.IsInUse(-1));
+    TEST_CHECK(!pool.IsInUse(2));
+    TEST_CHECK(!pool.Release(2));
+}
+
+/// 描画すると内容が有効になり、無効化すると描画し直しが必要になる
+static void TestInvalidate()
+{
+    RenderTargetPool pool(kBytesPerPixel);
+    bool needsTexture = false;
+    int target0 = pool.Acquire(32, 32, needsTexture);
+    int target1 = pool.Acquire(32, 32, needsTexture);
+
+    pool.MarkRendered(target0, 5);
+    pool.MarkRendered(target1, 6);
+    TEST_CHECK(pool.IsContentValid(target0));
+    TEST_CHECK(pool.GetSlot(target0).lastRenderedFrame == 5);
+
+    pool.Invalidate(target0);
+    TEST_CHECK(!pool.IsContentValid(target0));
+    TEST_CHECK(pool.IsContentValid(target1));
+
+    pool.MarkRendered(target0, 7);
+    pool.InvalidateAll();
+    TEST_CHECK(!pool.IsContentValid(target0));
+    TEST_CHECK(!pool.IsContentValid(target1));
+
+    // 範囲外のIDを無効化しても何も起きない
+    pool.Invalidate(100);
+
+    // 解放済みのターゲットには描画を記録しない
+    pool.Release(target1);
+    pool.MarkRendered(target1, 8);
+    TEST_CHECK(!pool.IsContentValid(target1));
+}
+
+/// 解放したターゲットは、同じ大きさの確保でテクスチャごと再利用される
+static void TestReuse()
+{
+    RenderTargetPool pool(kBytesPerPixel);
+    bool needsTexture = false;
+    int target0 = pool.Acquire(128, 128, needsTexture);
+    int target1 = pool.Acquire(64, 32, needsTexture);
+    pool.MarkRendered(target0, 1);
+    TEST_CHECK(pool.Release(target0));
+    TEST_CHECK(!pool.IsInUse(target0));
+    TEST_CHECK(!pool.Release(target0));
+
+    // 大きさが違えば、解放済みのテクスチャは使わずに新しいスロットを作る
+    int target2 = pool.Acquire(64, 64, needsTexture);
+    TEST_CHECK(needsTexture);
+    TEST_CHECK(target2 != target0 && target2 != target1);
+
+    // 同じ大きさなら再利用され、前の内容は無効になっている
+    int target3 = pool.Acquire(128, 128, needsTexture);
+    TEST_CHECK(!needsTexture);
+    TEST_CHECK(target3 == target0);
+    TEST_CHECK(pool.IsInUse(target3));
+    TEST_CHECK(!pool.IsContentValid(target3));
+    TEST_CHECK(pool.GetSlot(target3).lastRenderedFrame == -1);
+
+    // Trim()でテクスチャを手放したスロットは、違う大きさの確保で使われる
+    pool.Release(target1);
+    std::vector<int> trimmed = pool.Trim();
+    TEST_CHECK(trimmed.size() == 1 && trimmed[0] == target1);
+    int target4 = pool.Acquire(16, 16, needsTexture);
+    TEST_CHECK(needsTexture);
+    TEST_CHECK(target4 == target1);
+    TEST_CHECK(pool.SlotCount() == 3);
+}
+
+/// 使用中と解放済みのバイト数が、確保・解放・再利用・Trim()を通して正しく数えられる
+static void TestMemoryTotals()
+{
+    RenderTargetPool pool(kBytesPerPixel);
+    const size_t kSizeA = 256 * 256 * kBytesPerPixel;
+    const size_t kSizeB = 100 * 50 * kBytesPerPixel;
+    bool needsTexture = false;
+    int targetA = pool.Acquire(256, 256, needsTexture);
+    int targetB = pool.Acquire(100, 50, needsTexture);
+    TEST_CHECK(pool.InUseBytes() == kSizeA + kSizeB);
+    TEST_CHECK(pool.PooledBytes() == 0);
+
+    pool.Release(targetA);
+    TEST_CHECK(pool.InUseBytes() == kSizeB);
+    TEST_CHECK(pool.PooledBytes() == kSizeA);
+
+    pool.Acquire(256, 256, needsTexture);
+    TEST_CHECK(pool.InUseBytes() == kSizeA + kSizeB);
+    TEST_CHECK(pool.PooledBytes() == 0);
+
+    pool.Release(targetA);
+    pool.Release(targetB);
+    TEST_CHECK(pool.InUseBytes() == 0);
+    TEST_CHECK(pool.PooledBytes() == kSizeA + kSizeB);
+
+    std::vector<int> trimmed = pool.Trim();
+    TEST_CHECK(trimmed.size() == 2);
+    TEST_CHECK(pool.InUseBytes() == 0);
+    TEST_CHECK(pool.PooledBytes() == 0);
+    TEST_CHECK(pool.GetSlot(targetA).byteSize == 0);
+
+    // 2回目のTrim()では何も手放さない
+    TEST_CHECK(pool.Trim().empty());
+}
+
+/// アトラスのページとレンダーターゲットのテクスチャIDが重ならない
+static void TestTextureIDRanges()
+{
+    unsigned lastAtlasPageID = kMaxAtlasPageCount;     // テクスチャIDはページ番号 + 1
+    TEST_CHECK(lastAtlasPageID < kRenderTargetTextureIDBase);
+    TEST_CHECK(kRenderTargetTextureIDBase <= DrawCommandList::kMaxTextureID);
+}
+
+int main()
+{
+    TestCreate();
+    TestInvalidate();
+    TestReuse();
+    TestMemoryTotals();
+    TestTextureIDRanges();
+    return TestResult("RenderTargetPoolTest");
+}
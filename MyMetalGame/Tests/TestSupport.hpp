@@ -0,0 +1,60 @@
+//
+//  TestSupport.hpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+#ifndef TestSupport_hpp
+#define TestSupport_hpp
+
+#include <cmath>
+#include <cstdio>
+
+
+// テストのプログラムで使う、最小限のチェック用のマクロです。
+// 各テストは独立したプログラムで、失敗したチェックの数を終了コードとして返します。
+
+
+/// 失敗したチェックの数
+inline int& __TestFailureCount()
+{
+    static int count = 0;
+    return count;
+}
+
+/// 条件が成り立つことを確認します。成り立たなければ、ファイル名と行番号を出力して失敗を数えます。
+#define TEST_CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            __TestFailureCount()++; \
+        } \
+    } while (0)
+
+/// 2つの浮動小数点数の差がtolerance以下であることを確認します。
+#define TEST_CHECK_NEAR(a, b, tolerance) \
+    do { \
+        double __a = (double)(a); \
+        double __b = (double)(b); \
+        if (!(std::fabs(__a - __b) <= (double)(tolerance))) { \
+            fprintf(stderr, "%s:%d: check failed: %s (%.9g) is not near %s (%.9g)\n", __FILE__, __LINE__, #a, __a, #b, __b); \
+            __TestFailureCount()++; \
+        } \
+    } while (0)
+
+/// テストの結果を出力して、main()から返す値を取得します。
+inline int TestResult(const char *name)
+{
+    int count = __TestFailureCount();
+    if (count == 0) {
+        printf("%s: OK\n", name);
+    } else {
+        printf("%s: %d check(s) failed\n", name, count);
+    }
+    return (count == 0)? 0: 1;
+}
+
+
+#endif /* TestSupport_hpp */
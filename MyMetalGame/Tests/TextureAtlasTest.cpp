@@ -0,0 +1,183 @@
+//
+//  TextureAtlasTest.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+// アトラスの詰め込み（SkylinePackerとTextureAtlasPacker）のテストです。
+//
+//     TextureAtlasTest [--count N] [--seed N]
+//
+// ページがあふれた場合、画像の間の余白、多数の画像を配置したあとに領域が重なっていないことを確かめます。
+
+#include "TestSupport.hpp"
+#include "TextureAtlas.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+
+/// 領域がページの中に収まっているかどうか
+static bool IsInsidePage(const AtlasRegion& region, int pageWidth, int pageHeight)
+{
+    return (region.x >= 0 && region.y >= 0 && region.x + region.width <= pageWidth && region.y + region.height <= pageHeight);
+}
+
+/// 同じページの2つの領域が、paddingピクセル以上離れているかどうか
+static bool IsSeparated(const AtlasRegion& a, const AtlasRegion& b, int padding)
+{
+    if (a.page != b.page) {
+        return true;
+    }
+    return (a.x + a.width + padding <= b.x || b.x + b.width + padding <= a.x ||
+            a.y + a.height + padding <= b.y || b.y + b.height + padding <= a.y);
+}
+
+/// 1枚のページに入りきらない場合は新しいページが追加され、ページより大きい画像は配置できない
+static void TestPageOverflow()
+{
+    TextureAtlasPacker packer(64, 64, 0);
+    AtlasRegion region;
+
+    // 32×32はちょうど4つで1ページが埋まる
+    for (int i = 0; i < 4; i++) {
+        TEST_CHECK(packer.Pack(32, 32, region));
+        TEST_CHECK(region.page == 0);
+    }
+    TEST_CHECK(packer.PageCount() == 1);
+    TEST_CHECK_NEAR(packer.PageOccupancy(0), 1.0, 1e-6);
+
+    TEST_CHECK(packer.Pack(32, 32, region));
+    TEST_CHECK(region.page == 1);
+    TEST_CHECK(region.x == 0 && region.y == 0);
+    TEST_CHECK(packer.PageCount() == 2);
+    TEST_CHECK_NEAR(packer.PageOccupancy(1), 0.25, 1e-6);
+
+    // 小さい画像は、空きのある最初のページに入る
+    TEST_CHECK(packer.Pack(16, 16, region));
+    TEST_CHECK(region.page == 1);
+
+    // ページより大きい画像と、大きさが0の画像は配置できず、ページも増えない
+    TEST_CHECK(!packer.Pack(65, 8, region));
+    TEST_CHECK(region.page == -1);
+    TEST_CHECK(!packer.Pack(8, 65, region));
+    TEST_CHECK(!packer.Pack(0, 8, region));
+    TEST_CHECK(packer.PageCount() == 2);
+    TEST_CHECK_NEAR(packer.PageOccupancy(2), 0.0, 1e-6);
+
+    // ページと同じ大きさの画像は、余白がページからはみ出すだけなので配置できる
+    TextureAtlasPacker paddedPacker(64, 64, 4);
+    TEST_CHECK(paddedPacker.Pack(64, 64, region));
+    TEST_CHECK(region.page == 0 && region.x == 0 && region.y == 0);
+    TEST_CHECK(paddedPacker.Pack(1, 1, region));
+    TEST_CHECK(region.page == 1);
+
+    packer.Clear();
+    TEST_CHECK(packer.PageCount() == 0);
+}
+
+/// 画像の右と下に余白が空けられる
+static void TestPadding()
+{
+    const int kPadding = 3;
+    TextureAtlasPacker packer(32, 32, kPadding);
+    AtlasRegion a, b, c;
+    TEST_CHECK(packer.Pack(10, 10, a));
+    TEST_CHECK(packer.Pack(10, 10, b));
+    TEST_CHECK(a.page == 0 && b.page == 0);
+    TEST_CHECK(a.x == 0 && a.y == 0);
+    TEST_CHECK(b.x == a.width + kPadding && b.y == 0);
+
+    // 残りの幅（32 - 26 = 6）には、余白を含めた幅で入るものだけが置かれる
+    TEST_CHECK(packer.Pack(3, 10, c));
+    TEST_CHECK(c.page == 0 && c.x == 26 && c.y == 0);
+
+    // 次の行は、余白の分だけ下に置かれる
+    AtlasRegion d;
+    TEST_CHECK(packer.Pack(20, 5, d));
+    TEST_CHECK(d.page == 0 && d.x == 0 && d.y == a.height + kPadding);
+
+    // 領域の大きさには余白を含めない
+    TEST_CHECK(d.width == 20 && d.height == 5);
+    TEST_CHECK(IsSeparated(a, b, kPadding) && IsSeparated(b, c, kPadding) && IsSeparated(a, d, kPadding));
+}
+
+/// 大きさの違う画像を多数配置しても、領域がページからはみ出したり、余白を含めて重なったりしない
+static void TestNoOverlap(int count, unsigned seed)
+{
+    const int kPageSize = 256;
+    const int kPadding = 2;
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> sizeDistribution(1, 48);
+
+    // 1つずつ配置する場合
+    TextureAtlasPacker packer(kPageSize, kPageSize, kPadding);
+    std::vector<AtlasRegion> regions;
+    for (int i = 0; i < count; i++) {
+        AtlasRegion region;
+        bool isPacked = packer.Pack(sizeDistribution(random), sizeDistribution(random), region);
+        TEST_CHECK(isPacked);
+        regions.push_back(region);
+    }
+
+    // まとめて配置する場合（結果は渡した順番のまま）
+    std::vector<AtlasRegion> sizes(count);
+    for (AtlasRegion& size : sizes) {
+        size.width = sizeDistribution(random);
+        size.height = sizeDistribution(random);
+    }
+    TextureAtlasPacker batchPacker(kPageSize, kPageSize, kPadding);
+    std::vector<AtlasRegion> batchRegions;
+    TEST_CHECK(batchPacker.PackAll(sizes, batchRegions));
+    TEST_CHECK(batchRegions.size() == sizes.size());
+    bool isOrderKept = true;
+    for (int i = 0; i < count; i++) {
+        isOrderKept = isOrderKept && (batchRegions[i].width == sizes[i].width && batchRegions[i].height == sizes[i].height);
+    }
+    TEST_CHECK(isOrderKept);
+
+    for (const std::vector<AtlasRegion> *list : { &regions, &batchRegions }) {
+        int outsideCount = 0;
+        int overlapCount = 0;
+        for (size_t i = 0; i < list->size(); i++) {
+            const AtlasRegion& region = (*list)[i];
+            if (!IsInsidePage(region, kPageSize, kPageSize)) {
+                outsideCount++;
+            }
+            for (size_t j = i + 1; j < list->size(); j++) {
+                if (!IsSeparated(region, (*list)[j], kPadding)) {
+                    overlapCount++;
+                }
+            }
+        }
+        TEST_CHECK(outsideCount == 0);
+        TEST_CHECK(overlapCount == 0);
+    }
+
+    // 多数の画像で複数のページが使われ、どのページの使用率も範囲内にある
+    TEST_CHECK(packer.PageCount() > 1);
+    for (int page = 0; page < packer.PageCount(); page++) {
+        TEST_CHECK(packer.PageOccupancy(page) > 0.0f && packer.PageOccupancy(page) <= 1.0f);
+    }
+}
+
+int main(int argc, const char *argv[])
+{
+    int count = 2000;
+    unsigned seed = 1;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--count") == 0) {
+            count = atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            seed = (unsigned)strtoul(argv[i + 1], nullptr, 10);
+        }
+    }
+
+    TestPageOverflow();
+    TestPadding();
+    TestNoOverlap(count, seed);
+    return TestResult("TextureAtlasTest");
+}
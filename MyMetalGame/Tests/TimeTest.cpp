@@ -0,0 +1,106 @@
+//
+//  TimeTest.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+// ゲームを長時間動かし続けたときの、時間の精度のテストです。
+//
+//     TimeTest [--days N]
+//
+// Time::captureDeltaTimeで1/60秒に固定したフレームを、N日分（デフォルトは30日。約1億5552万フレーム）続けて進めて、次のことを確かめます。
+//
+// - unscaledTimeは、ナノ秒単位の整数で積算しているので、何日経っても誤差はない（1フレームの時間×フレーム数と一致する）。
+// - timeは、timeScaleの変更に対応するために倍精度の差分で積算しているので、丸め誤差が少しずつ蓄積する。30日で1ミリ秒未満。
+// - timeの分解能は、30日経っても1フレームの時間との差が1マイクロ秒未満で、フレームごとの増分はほとんど変わらない。
+// - deltaTimeは時計の差から求めるので、経過時間に関係なく最初のフレームと同じ値のまま。
+// - FixedUpdate()は、1フレームの時間とfixedDeltaTimeがほぼ同じなら、フレームと同じ回数だけ呼び出される。
+// - 単精度では、30日（約259万秒）の時点で分解能が0.25秒になり、1フレームの時間を足しても値が変わらない（timeとunscaledTimeが倍精度である理由）。
+
+#include "TestSupport.hpp"
+#include "Time.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+
+static long long    sFixedUpdateCount = 0;
+
+static void CountFixedUpdate()
+{
+    sFixedUpdateCount++;
+}
+
+static void TestLongRun(int days)
+{
+    const long long kFrameCount = (long long)days * 24 * 60 * 60 * 60;
+    Time::captureDeltaTime = 1.0f / 60;
+    Time::fixedDeltaTime = 1.0f / 60;
+
+    Time::__Update();
+    Time::__RunFixedUpdate(CountFixedUpdate);
+    const long long deltaNanoseconds = Time::__GetDeltaNanoseconds();
+    const double exactDelta = deltaNanoseconds * 1.0e-9;
+    const float firstDeltaTime = Time::deltaTime;
+
+    double minStep = exactDelta;
+    double maxStep = exactDelta;
+    bool isDeltaTimeConstant = true;
+    double lastTime = Time::time;
+    for (long long i = 1; i < kFrameCount; i++) {
+        Time::__Update();
+        Time::__RunFixedUpdate(CountFixedUpdate);
+        double step = Time::time - lastTime;
+        minStep = std::min(minStep, step);
+        maxStep = std::max(maxStep, step);
+        isDeltaTimeConstant = isDeltaTimeConstant && (Time::deltaTime == firstDeltaTime);
+        lastTime = Time::time;
+    }
+
+    // unscaledTimeは、整数で積算した値と一致する
+    double exactTime = (double)(deltaNanoseconds * kFrameCount) * 1.0e-9;
+    TEST_CHECK(Time::unscaledTime == exactTime);
+
+    // timeの誤差は、30日で1ミリ秒未満
+    double timeError = std::fabs(Time::time - exactTime);
+    TEST_CHECK(timeError < 1.0e-3 * days / 30);
+
+    // フレームごとの増分は、最後まで1マイクロ秒未満の誤差で1フレームの時間と一致する
+    TEST_CHECK_NEAR(minStep, exactDelta, 1.0e-6);
+    TEST_CHECK_NEAR(maxStep, exactDelta, 1.0e-6);
+    TEST_CHECK(isDeltaTimeConstant);
+
+    TEST_CHECK(sFixedUpdateCount == kFrameCount);
+
+    printf("%d days (%lld frames): unscaledTime %.9f s, time error %.3e s, per-frame step %.12f..%.12f s\n",
+           days, kFrameCount, Time::unscaledTime, timeError, minStep, maxStep);
+}
+
+/// 単精度の時間では、長時間動かすと1フレームの時間を足しても値が変わらなくなる
+static void TestSinglePrecisionLimit()
+{
+    float thirtyDays = 30.0f * 24 * 60 * 60;
+    float frame = 1.0f / 60;
+    TEST_CHECK(thirtyDays + frame == thirtyDays);
+    TEST_CHECK(std::nextafter(thirtyDays, INFINITY) - thirtyDays == 0.25f);
+
+    double thirtyDaysDouble = 30.0 * 24 * 60 * 60;
+    TEST_CHECK(std::nextafter(thirtyDaysDouble, INFINITY) - thirtyDaysDouble < 1.0e-9);
+}
+
+int main(int argc, const char *argv[])
+{
+    int days = 30;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--days") == 0) {
+            days = atoi(argv[i + 1]);
+        }
+    }
+
+    TestSinglePrecisionLimit();
+    TestLongRun(days);
+    return TestResult("TimeTest");
+}
@@ -0,0 +1,210 @@
+//
+//  TimerServiceTest.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+// タイマー（After()・Every()）の階層化されたタイミングホイールのテストです。
+//
+//     TimerServiceTest
+//
+// Time::timeを1ミリ秒（1ティック）ずつ、または大きく飛ばして進めながら__UpdateTimers()を呼び出し、次のことを確かめます。
+//
+// - 256ティックと65536ティックの境界をまたいで上のレベルから下ろされたタイマーが、期限より早くも、期限の次のティックより遅くもなく発火する。
+// - 待機中に取り消したタイマーや、同じティックで先に発火したタイマーのコールバックから取り消したタイマーは発火しない。
+// - 繰り返しのタイマーは、1ミリ秒で割り切れない周期（1/60秒）でも登録した時点を基準に発火し続け、ずれが蓄積しない。
+
+#include "TestSupport.hpp"
+#include "TimerService.hpp"
+#include "Time.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+/// 現在のティック（1ミリ秒単位）
+static uint64_t sTick = 0;
+
+/// 時間をティックの中央に合わせて（丸めでティックがずれないように）、タイマーを更新する
+static void AdvanceTo(uint64_t tick)
+{
+    sTick = tick;
+    Time::time = (tick + 0.5) / 1000.0;
+    Time::unscaledTime = Time::time;
+    __UpdateTimers();
+}
+
+static void StepTo(uint64_t tick)
+{
+    while (sTick < tick) {
+        AdvanceTo(sTick + 1);
+    }
+}
+
+// 時間はティックの中央で進めるので、期限がティックの境界のわずかに後ろに丸められた場合は、次のティックの中央（1.5ティック後）に発火する
+static const double kMaxLateness = 1.5e-3 + 1.0e-6;
+
+/// 発火を記録するタイマー
+struct FiredTimer
+{
+    double  dueTime;
+    double  firedTime;
+    int     firedCount;
+};
+
+/// 指定したティックが期限になるように、After()でタイマーを登録する
+static TimerHandle AddAfter(FiredTimer& timer, uint64_t dueTick)
+{
+    timer.dueTime = dueTick / 1000.0;
+    timer.firedTime = -1.0;
+    timer.firedCount = 0;
+    FiredTimer *p = &timer;
+    return After((float)(timer.dueTime - Time::time), [p]() {
+        p->firedTime = Time::time;
+        p->firedCount++;
+    });
+}
+
+/// 上のレベルに入ったタイマーが、256・65536ティックの境界で下ろされて、期限どおりに発火する
+static void TestCascade()
+{
+    AdvanceTo(0);
+    const uint64_t kDueTicks[] = { 1, 255, 256, 257, 511, 512, 65535, 65536, 65537, 65536 + 256, 131072 + 3 };
+    const int kCount = (int)(sizeof(kDueTicks) / sizeof(kDueTicks[0]));
+    std::vector<FiredTimer> timers(kCount);
+    for (int i = 0; i < kCount; i++) {
+        AddAfter(timers[i], kDueTicks[i]);
+    }
+    TEST_CHECK(GetActiveTimerCount() == kCount);
+
+    StepTo(140000);
+    for (int i = 0; i < kCount; i++) {
+        TEST_CHECK(timers[i].firedCount == 1);
+        // floatの秒数で登録しているので、期限には数マイクロ秒の誤差を許す
+        TEST_CHECK(timers[i].firedTime >= timers[i].dueTime - 1.0e-5);
+        TEST_CHECK(timers[i].firedTime <= timers[i].dueTime + kMaxLateness + 1.0e-5);
+    }
+    TEST_CHECK(GetActiveTimerCount() == 0);
+}
+
+/// フレームの時間が大きく飛んだ場合も、途中の境界を越えたタイマーは1回ずつ期限の順に発火する
+static void TestLargeJump()
+{
+    uint64_t base = sTick;
+    const uint64_t kOffsets[] = { 300, 70000, 5, 65536 * 3 + 17, 256 };
+    const int kCount = (int)(sizeof(kOffsets) / sizeof(kOffsets[0]));
+    std::vector<FiredTimer> timers(kCount);
+    std::vector<int> order;
+    for (int i = 0; i < kCount; i++) {
+        timers[i].dueTime = (base + kOffsets[i]) / 1000.0;
+        timers[i].firedCount = 0;
+        After((float)(timers[i].dueTime - Time::time), [&timers, &order, i]() {
+            timers[i].firedCount++;
+            order.push_back(i);
+        });
+    }
+    AdvanceTo(base + 65536 * 4);
+    for (int i = 0; i < kCount; i++) {
+        TEST_CHECK(timers[i].firedCount == 1);
+    }
+    TEST_CHECK(order == std::vector<int>({ 2, 4, 0, 1, 3 }));
+}
+
+/// 待機中に取り消したタイマーと、同じティックの先のタイマーのコールバックで取り消したタイマーは発火しない
+static void TestCancel()
+{
+    uint64_t base = sTick;
+    FiredTimer cancelled, sameTick, victim, survivor;
+    TimerHandle cancelledHandle = AddAfter(cancelled, base + 70000);
+    AddAfter(survivor, base + 100);
+    TEST_CHECK(IsTimerActive(cancelledHandle));
+    CancelTimer(cancelledHandle);
+    TEST_CHECK(!IsTimerActive(cancelledHandle));
+    CancelTimer(cancelledHandle);
+
+    // 同じティックに期限を迎える2つのタイマーのうち、先に登録したほうが後のほうを取り消す
+    TimerHandle victimHandle;
+    sameTick.firedCount = 0;
+    After((float)((base + 50) / 1000.0 - Time::time), [&]() {
+        sameTick.firedCount++;
+        CancelTimer(victimHandle);
+    });
+    victimHandle = AddAfter(victim, base + 50);
+    TEST_CHECK(GetActiveTimerCount() == 3);
+
+    StepTo(base + 80000);
+    TEST_CHECK(cancelled.firedCount == 0);
+    TEST_CHECK(sameTick.firedCount == 1);
+    TEST_CHECK(victim.firedCount == 0);
+    TEST_CHECK(survivor.firedCount == 1);
+    TEST_CHECK(GetActiveTimerCount() == 0);
+
+    // 取り消したタイマーのノードは再利用されても、古いハンドルは無効のまま
+    FiredTimer reused;
+    TimerHandle reusedHandle = AddAfter(reused, sTick + 10);
+    TEST_CHECK(IsTimerActive(reusedHandle));
+    TEST_CHECK(!IsTimerActive(cancelledHandle));
+    CancelAllTimers();
+    TEST_CHECK(!IsTimerActive(reusedHandle));
+    TEST_CHECK(GetActiveTimerCount() == 0);
+}
+
+/// 1/60秒ごとのタイマーを1分間動かすと3600回発火し、どの発火も、登録した時点から周期の整数倍の期限から1.5ティック以内にある
+/// （周期を1ミリ秒に丸めると17ミリ秒ごとになり、1分間で約3530回しか発火しない）
+static void TestRepeating()
+{
+    const double kPeriod = (double)(1.0f / 60);
+    uint64_t base = sTick;
+    int count = 0;
+    double maxLateness = 0.0;
+    bool isJumping = false;
+    double startTime = Time::time;
+    TimerHandle handle = Every(1.0f / 60, [&]() {
+        count++;
+        // 時間を飛ばしたフレームでは、過ぎた周期の分だけ遅れて1回呼ばれる
+        if (!isJumping) {
+            double elapsed = Time::time - startTime;
+            maxLateness = std::max(maxLateness, elapsed - std::floor(elapsed / kPeriod) * kPeriod);
+        }
+    });
+    StepTo(base + 60000 + 2);
+    TEST_CHECK(count == 3600);
+    TEST_CHECK(maxLateness <= kMaxLateness);
+
+    // 1フレームで何周期も進めた場合は1回だけ呼ばれ、その後も周期の位相は保たれる
+    int countBeforeJump = count;
+    isJumping = true;
+    AdvanceTo(sTick + 1000);
+    isJumping = false;
+    TEST_CHECK(count == countBeforeJump + 1);
+    StepTo(sTick + 1000);
+    TEST_CHECK(count >= countBeforeJump + 1 + 59 && count <= countBeforeJump + 1 + 61);
+    TEST_CHECK(maxLateness <= kMaxLateness);
+
+    // コールバックの中で自分自身を取り消すと、それ以降は呼ばれない
+    int selfCancelCount = 0;
+    TimerHandle selfHandle;
+    selfHandle = Every(0.01f, [&]() {
+        selfCancelCount++;
+        if (selfCancelCount == 3) {
+            CancelTimer(selfHandle);
+        }
+    });
+    StepTo(sTick + 1000);
+    TEST_CHECK(selfCancelCount == 3);
+    TEST_CHECK(!IsTimerActive(selfHandle));
+
+    CancelTimer(handle);
+    TEST_CHECK(GetActiveTimerCount() == 0);
+}
+
+int main()
+{
+    TestCascade();
+    TestLargeJump();
+    TestCancel();
+    TestRepeating();
+    return TestResult("TimerServiceTest");
+}
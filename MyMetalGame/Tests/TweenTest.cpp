@@ -0,0 +1,263 @@
+//
+//  TweenTest.cpp
+//  MyMetalGame
+//
+//  Created by agent on 2026/10/19.
+//  Copyright (c) 2026 agent. All rights reserved.
+//
+
+// トゥイーンのテストです。
+//
+//     TweenTest
+//
+// ゲームのループと同じく、時間を進めてからUpdate()に相当する処理を行い、その後に__UpdateTweens()を呼び出してフレームを進めながら、次のことを確かめます。
+//
+// - どの曲線でも、開始したフレームでは開始時の値を、最後のフレームでは最終的な値をそのまま書き込み、途中の値はMathfの同名の関数と一致する。
+// - 長さが0のトゥイーンは、開始したフレームのうちに最終的な値を書き込んで終了し、開始時の値を書き込むことはない。
+// - シーケンスとパラレルのグループ（入れ子を含む）で、各トゥイーンがグループの開始からの正しい時刻に開始・終了し、グループの完了時の関数が1回だけ呼び出される。
+
+#include "TestSupport.hpp"
+#include "Mathf.hpp"
+#include "Time.hpp"
+#include "Tween.hpp"
+#include <cmath>
+
+
+/// 1フレームの時間（2進数で割り切れる値にして、時刻の比較に丸め誤差が入らないようにする）
+static const float kFrameTime = 0.125f;
+
+/// フレームを始める。この後、__UpdateTweens()を呼び出すまでがUpdate()に相当する
+static void BeginFrame()
+{
+    Time::deltaTime = kFrameTime;
+    Time::unscaledDeltaTime = kFrameTime;
+    Time::time += kFrameTime;
+    Time::unscaledTime += kFrameTime;
+}
+
+static void EndFrame()
+{
+    __UpdateTweens();
+    Time::frameCount++;
+}
+
+static void RunFrame()
+{
+    BeginFrame();
+    EndFrame();
+}
+
+static bool IsNear(float a, float b)
+{
+    return (fabsf(a - b) <= 1.0e-5f * fmaxf(1.0f, fabsf(b)));
+}
+
+
+#pragma mark - 曲線
+
+static float EvaluateMathf(TweenEase ease, float from, float to, float t)
+{
+    switch (ease) {
+        case TweenEaseIn:           return Mathf::EaseIn(from, to, t);
+        case TweenEaseOut:          return Mathf::EaseOut(from, to, t);
+        case TweenEaseInOut:        return Mathf::EaseInOut(from, to, t);
+        case TweenEaseSmoothStep:   return Mathf::SmoothStep(from, to, t);
+        default:                    return Mathf::Lerp(from, to, t);
+    }
+}
+
+/// 各曲線で、開始と終了のフレームの値が開始時の値と最終的な値に一致し、途中の値がMathfの関数と一致する
+static void TestEaseEndpoints()
+{
+    // 差を取って足し戻すと丸め誤差が出る値を使う
+    const float kFrom = 0.1f;
+    const float kTo = 0.7f;
+    const int kFrameCount = 8;
+
+    for (int ease = 0; ease < TweenEaseCount; ease++) {
+        float x = kFrom;
+        int completeCount = 0;
+
+        BeginFrame();
+        TweenHandle handle = StartTween(Tween::To(&x, kTo, kFrameTime * kFrameCount, (TweenEase)ease).OnComplete([&completeCount] { completeCount++; }));
+        EndFrame();
+        TEST_CHECK(x == kFrom);
+        TEST_CHECK(IsTweenActive(handle));
+
+        for (int frame = 1; frame < kFrameCount; frame++) {
+            RunFrame();
+            TEST_CHECK(IsNear(x, EvaluateMathf((TweenEase)ease, kFrom, kTo, (float)frame / kFrameCount)));
+            TEST_CHECK(completeCount == 0);
+        }
+        RunFrame();
+        TEST_CHECK(x == kTo);
+        TEST_CHECK(completeCount == 1);
+        TEST_CHECK(!IsTweenActive(handle));
+    }
+
+    // 差分が開始時の値の精度より小さい場合でも、最終的な値は正確になる
+    float y = 3.0f;
+    StartTween(Tween::To(&y, 1.0e-8f, kFrameTime));
+    RunFrame();
+    TEST_CHECK(y == 1.0e-8f);
+
+    // クォータニオンも、最後のフレームでは最終的な回転を書き込む
+    Quaternion rotation = Quaternion::identity;
+    Quaternion to = Quaternion::AngleAxis(130.0f, Vector3(0.3f, 1.0f, 0.2f).Normalized());
+    StartTween(Tween::To(&rotation, to, kFrameTime * 3, TweenEaseInOut));
+    for (int frame = 0; frame < 3; frame++) {
+        RunFrame();
+    }
+    TEST_CHECK(IsNear(rotation.x, to.x) && IsNear(rotation.y, to.y) && IsNear(rotation.z, to.z) && IsNear(rotation.w, to.w));
+    TEST_CHECK(GetRunningTweenCount() == 0);
+}
+
+
+#pragma mark - 長さが0のトゥイーン
+
+/// 長さが0のトゥイーンは、開始したフレームで最終的な値になり、開始時の値を書き込まない
+static void TestZeroDuration()
+{
+    float x = 0.0f;
+    int completeCount = 0;
+
+    BeginFrame();
+    TweenHandle handle = StartTween(Tween::To(&x, 5.0f, 0.0f).From(2.0f).OnComplete([&completeCount] { completeCount++; }));
+    EndFrame();
+    TEST_CHECK(x == 5.0f);
+    TEST_CHECK(completeCount == 1);
+    TEST_CHECK(!IsTweenActive(handle));
+    TEST_CHECK(GetRunningTweenCount() == 0);
+
+    // 待ち時間の後に開始するもの
+    x = 0.0f;
+    Vector2 position(1.0f, 1.0f);
+    BeginFrame();
+    StartTween(Tween::To(&x, 3.0f, 0.0f).Delay(kFrameTime * 2));
+    StartTween(Tween::To(&position, Vector2(4.0f, -4.0f), 0.0f).Delay(kFrameTime * 2));
+    EndFrame();
+    RunFrame();
+    TEST_CHECK(x == 0.0f);
+    TEST_CHECK(position.x == 1.0f && position.y == 1.0f);
+    RunFrame();
+    TEST_CHECK(x == 3.0f);
+    TEST_CHECK(position.x == 4.0f && position.y == -4.0f);
+    TEST_CHECK(GetRunningTweenCount() == 0);
+
+    // 負の長さも0として扱う
+    x = 0.0f;
+    BeginFrame();
+    StartTween(Tween::To(&x, 1.0f, -1.0f));
+    EndFrame();
+    TEST_CHECK(x == 1.0f);
+
+    // シーケンスの途中にあるもの：前のトゥイーンが終わったフレームで、次のトゥイーンの開始時の値を書き込む前に最終的な値になる
+    x = 0.0f;
+    int groupCompleteCount = 0;
+    TweenGroup group = TweenGroup::Sequence();
+    group.Add(Tween::To(&x, 1.0f, kFrameTime * 2)).Add(Tween::To(&x, 8.0f, 0.0f)).Add(Tween::To(&x, 0.0f, kFrameTime * 2));
+    BeginFrame();
+    StartTweenGroup(group, [&groupCompleteCount] { groupCompleteCount++; });
+    EndFrame();
+    RunFrame();
+    TEST_CHECK(x == 0.5f);
+    RunFrame();
+    TEST_CHECK(x == 8.0f);
+    RunFrame();
+    TEST_CHECK(x == 4.0f);
+    RunFrame();
+    TEST_CHECK(x == 0.0f);
+    TEST_CHECK(groupCompleteCount == 1);
+}
+
+
+#pragma mark - グループ
+
+/// シーケンスの各トゥイーンがグループの開始からの時刻どおりに動き、前のトゥイーンの最終的な値から次が始まる
+static void TestSequence()
+{
+    float x = 0.0f;
+    int completeCount = 0;
+    TweenGroup group = TweenGroup::Sequence();
+    group.Add(Tween::To(&x, 1.0f, 0.5f)).Add(Tween::Interval(0.25f)).Add(Tween::To(&x, 0.0f, 0.5f).Delay(0.25f));
+    TEST_CHECK(group.Duration() == 1.5f);
+
+    BeginFrame();
+    TweenHandle handle = StartTweenGroup(group, [&completeCount] { completeCount++; });
+    EndFrame();
+
+    // 0.5秒で1まで進み、間隔と待ち時間の0.5秒はそのまま、その後の0.5秒で0に戻る
+    const float kExpected[] = { 0.25f, 0.5f, 0.75f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.75f, 0.5f, 0.25f, 0.0f };
+    for (float expected : kExpected) {
+        TEST_CHECK(IsTweenActive(handle));
+        RunFrame();
+        TEST_CHECK(x == expected);
+    }
+    TEST_CHECK(completeCount == 1);
+    TEST_CHECK(!IsTweenActive(handle));
+
+    RunFrame();
+    TEST_CHECK(completeCount == 1);
+}
+
+/// パラレルのグループは最も長いものが終わったときに完了し、入れ子のシーケンスもグループの開始時刻から数える
+static void TestParallel()
+{
+    float a = 0.0f;
+    float b = 0.0f;
+    float c = 0.0f;
+    int completeCount = 0;
+
+    TweenGroup inner = TweenGroup::Sequence();
+    inner.Add(Tween::To(&b, 1.0f, 0.25f)).Add(Tween::To(&c, 1.0f, 0.5f));
+    TweenGroup group = TweenGroup::Parallel();
+    group.Add(Tween::To(&a, 1.0f, 0.5f)).Add(inner);
+    TEST_CHECK(group.Duration() == 0.75f);
+
+    BeginFrame();
+    TweenHandle handle = StartTweenGroup(group, [&completeCount] { completeCount++; });
+    EndFrame();
+    RunFrame();
+    TEST_CHECK(a == 0.25f && b == 0.5f && c == 0.0f);
+    RunFrame();
+    TEST_CHECK(a == 0.5f && b == 1.0f && c == 0.0f);
+    RunFrame();
+    TEST_CHECK(a == 0.75f && c == 0.25f);
+    RunFrame();
+    TEST_CHECK(a == 1.0f && c == 0.5f);
+    TEST_CHECK(completeCount == 0);
+    RunFrame();
+    RunFrame();
+    TEST_CHECK(c == 1.0f);
+    TEST_CHECK(completeCount == 1);
+    TEST_CHECK(!IsTweenActive(handle));
+
+    // 途中で取り消したグループは、値をその時点のまま残し、完了時の関数を呼び出さない
+    a = 0.0f;
+    handle = StartTweenGroup(group, [&completeCount] { completeCount++; });
+    RunFrame();
+    RunFrame();
+    CancelTween(handle);
+    float value = a;
+    RunFrame();
+    TEST_CHECK(a == value && a > 0.0f && a < 1.0f);
+    TEST_CHECK(completeCount == 1);
+
+    // CompleteTween()はすべての値を最終的な値にして、完了時の関数を1回だけ呼び出す
+    a = b = c = 0.0f;
+    handle = StartTweenGroup(group, [&completeCount] { completeCount++; });
+    RunFrame();
+    CompleteTween(handle);
+    TEST_CHECK(a == 1.0f && b == 1.0f && c == 1.0f);
+    TEST_CHECK(completeCount == 2);
+    TEST_CHECK(GetRunningTweenCount() == 0);
+}
+
+int main()
+{
+    TestEaseEndpoints();
+    TestZeroDuration();
+    TestSequence();
+    TestParallel();
+    return TestResult("TweenTest");
+}